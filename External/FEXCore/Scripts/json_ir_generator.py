@@ -46,6 +46,7 @@ class OpDefinition:
     NumElements: str
     OpClass: str
     HasSideEffects: bool
+    DependsOnFCW: bool
     RAOverride: int
     SwitchGen: bool
     ArgPrinter: bool
@@ -64,6 +65,7 @@ class OpDefinition:
         self.OpClass = None
         self.OpSize = 0
         self.HasSideEffects = False
+        self.DependsOnFCW = False
         self.RAOverride = -1
         self.SwitchGen = True
         self.ArgPrinter = True
@@ -213,6 +215,9 @@ def parse_ops(ops):
             if "HasSideEffects" in op_val:
                 OpDef.HasSideEffects = bool(op_val["HasSideEffects"])
 
+            if "DependsOnFCW" in op_val:
+                OpDef.DependsOnFCW = bool(op_val["DependsOnFCW"])
+
             if "ArgPrinter" in op_val:
                 OpDef.ArgPrinter = bool(op_val["ArgPrinter"])
 
@@ -370,6 +375,7 @@ def print_ir_sizes():
     output_file.write("[[nodiscard, gnu::const, gnu::visibility(\"default\")]] uint8_t GetArgs(IROps Op);\n")
     output_file.write("[[nodiscard, gnu::const, gnu::visibility(\"default\")]] FEXCore::IR::RegisterClassType GetRegClass(IROps Op);\n\n")
     output_file.write("[[nodiscard, gnu::const, gnu::visibility(\"default\")]] bool HasSideEffects(IROps Op);\n")
+    output_file.write("[[nodiscard, gnu::const, gnu::visibility(\"default\")]] bool DependsOnFCW(IROps Op);\n")
 
     output_file.write("#undef IROP_SIZES\n")
     output_file.write("#endif\n\n")
@@ -463,6 +469,23 @@ def print_ir_hassideeffects():
     output_file.write("#undef IROP_HASSIDEEFFECTS_IMPL\n")
     output_file.write("#endif\n\n")
 
+# x87 ops whose results depend on the guest's FCW, they can't be merged or moved across a FCW change
+def print_ir_dependsonfcw():
+    output_file.write("#ifdef IROP_DEPENDSONFCW_IMPL\n")
+
+    output_file.write("constexpr std::array<uint8_t, OP_LAST + 1> FCWDependent = {\n")
+    for op in IROps:
+        output_file.write("\t{},\n".format(("true" if op.DependsOnFCW else "false")))
+
+    output_file.write("};\n\n")
+
+    output_file.write("bool DependsOnFCW(IROps Op) {\n")
+    output_file.write("  return FCWDependent[Op];\n")
+    output_file.write("}\n")
+
+    output_file.write("#undef IROP_DEPENDSONFCW_IMPL\n")
+    output_file.write("#endif\n\n")
+
 # Print out IR argument printing
 def print_ir_arg_printer():
     output_file.write("#ifdef IROP_ARGPRINTER_HELPER\n")
@@ -743,6 +766,7 @@ print_ir_reg_classes()
 print_ir_getname()
 print_ir_getraargs()
 print_ir_hassideeffects()
+print_ir_dependsonfcw()
 print_ir_arg_printer()
 print_ir_allocator_helpers()
 print_ir_parser_switch_helper()
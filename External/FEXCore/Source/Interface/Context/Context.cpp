@@ -3,6 +3,7 @@
 #include "Interface/Core/Core.h"
 #include "Interface/Core/OpcodeDispatcher.h"
 #include "Interface/Core/X86Tables/X86Tables.h"
+#include "Interface/HLE/Thunks/Thunks.h"
 
 #include <FEXCore/Core/CoreState.h>
 #include <FEXCore/Core/Context.h>
@@ -193,6 +194,17 @@ namespace FEXCore::Context {
     return CTX->UnloadAOTIRCacheEntry(Entry);
   }
 
+  void AddNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Size, uintptr_t Offset, const std::string &Filename) {
+    CTX->AddNamedRegion(Base, Size, Offset, Filename);
+  }
+  void RemoveNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Size) {
+    CTX->RemoveNamedRegion(Base, Size);
+  }
+
+  void RegisterHostThunk(FEXCore::Context::Context *CTX, FEXCore::IR::SHA256Sum const &Sum, void (*Function)(void *ArgsRV)) {
+    CTX->ThunkHandler->RegisterThunk(Sum, Function);
+  }
+
 namespace Debug {
   void CompileRIP(FEXCore::Context::Context *CTX, uint64_t RIP) {
     CTX->CompileRIP(CTX->ParentThread, RIP);
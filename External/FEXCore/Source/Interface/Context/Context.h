@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Common/JitSymbols.h"
+#include "Interface/Core/BlockSamplingData.h"
 #include "Interface/Core/CPUID.h"
 #include "Interface/Core/HostFeatures.h"
 #include "Interface/Core/X86HelperGen.h"
 #include "Interface/Core/ObjectCache/ObjectCacheService.h"
+#include "Interface/Core/CompileService.h"
+#include "Interface/Core/SharedCodeCache.h"
 #include "Interface/IR/AOTIR.h"
 #include <FEXCore/Config/Config.h>
 #include <FEXCore/Core/Context.h>
@@ -23,6 +26,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <shared_mutex>
 #include <stddef.h>
 #include <string>
@@ -102,8 +106,16 @@ namespace FEXCore::Context {
       FEX_CONFIG_OPT(GlobalJITNaming, GLOBALJITNAMING);
       FEX_CONFIG_OPT(LibraryJITNaming, LIBRARYJITNAMING);
       FEX_CONFIG_OPT(BlockJITNaming, BLOCKJITNAMING);
+      FEX_CONFIG_OPT(BlockProfile, BLOCKPROFILE);
+      FEX_CONFIG_OPT(BlockProfileCycles, BLOCKPROFILECYCLES);
+      FEX_CONFIG_OPT(BlockProfileSignal, BLOCKPROFILESIGNAL);
       FEX_CONFIG_OPT(ParanoidTSO, PARANOIDTSO);
       FEX_CONFIG_OPT(CacheObjectCodeCompilation, CACHEOBJECTCODECOMPILATION);
+      FEX_CONFIG_OPT(SharedCodeCache, SHAREDCODECACHE);
+      FEX_CONFIG_OPT(CompileAheadThreads, COMPILEAHEADTHREADS);
+      FEX_CONFIG_OPT(TierUpThreshold, TIERUPTHRESHOLD);
+      FEX_CONFIG_OPT(ThreadStatePoolSize, THREADSTATEPOOLSIZE);
+      FEX_CONFIG_OPT(HostFlags, HOSTFLAGS);
       FEX_CONFIG_OPT(x87ReducedPrecision, X87REDUCEDPRECISION);
     } Config;
 
@@ -111,11 +123,19 @@ namespace FEXCore::Context {
     IntCallbackReturn InterpreterCallbackReturn;
 
     FEXCore::HostFeatures HostFeatures;
+    // CF/ZF/SF/OF of add/sub/cmp are calculated with HostNZCV, only worth it when it maps to one host instruction
+    bool HostNZCVFlags = false;
 
     std::mutex ThreadCreationMutex;
     uint64_t ThreadID{};
     FEXCore::Core::InternalThreadState* ParentThread;
     std::vector<FEXCore::Core::InternalThreadState*> Threads;
+    // Exited threads kept for CreateThread to reuse, guarded by ThreadCreationMutex
+    std::vector<FEXCore::Core::InternalThreadState*> ThreadStatePool;
+    // Block IR shared between all threads, only allocated if enabled
+    std::unique_ptr<FEXCore::SharedCodeCache> SharedCodeCache;
+    // Background compile-ahead workers, only allocated if enabled
+    std::shared_ptr<FEXCore::CompileService> CompileService;
     std::atomic_bool CoreShuttingDown{false};
 
     std::mutex IdleWaitMutex;
@@ -132,9 +152,8 @@ namespace FEXCore::Context {
     CustomCPUFactoryType CustomCPUFactory;
     FEXCore::Context::ExitHandler CustomExitHandler;
 
-#ifdef BLOCKSTATS
+    // Only allocated when BlockProfile is enabled
     std::unique_ptr<FEXCore::BlockSamplingData> BlockData;
-#endif
 
     SignalDelegator *SignalDelegation{};
     X86GeneratedCode X86CodeGen;
@@ -187,7 +206,29 @@ namespace FEXCore::Context {
       uint64_t StartAddr;
       uint64_t Length;
     };
-    [[nodiscard]] GenerateIRResult GenerateIR(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
+
+    enum class CompileTier {
+      // First compile of a block, only the single block when tiered compilation is enabled
+      Initial,
+      // Recompile of a block that crossed TierUpThreshold, with multiblock and loop-aware region formation
+      Hot,
+    };
+    /**
+     * @brief Decodes and optimizes the guest code at GuestRIP
+     *
+     * @param GuestCodeCopy Optional copy of the guest code that is read instead of GuestRIP, starting at GuestRIP
+     */
+    [[nodiscard]] GenerateIRResult GenerateIR(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, CompileTier Tier = CompileTier::Initial, uint8_t const *GuestCodeCopy = nullptr);
+
+    /**
+     * @brief Initializes everything that GenerateIR needs on a thread object
+     *
+     * @param State The internal FEX thread state object
+     *
+     * This is the frontend, the OpDispatcher and the pass pipeline, but not the lookup cache or CPU backend.
+     * InitializeCompiler calls this, it is only needed directly for threads that generate IR but never run guest code.
+     */
+    void InitializeIRGenerator(FEXCore::Core::InternalThreadState *State);
 
     struct CompileCodeResult {
       void* CompiledCode;
@@ -198,6 +239,8 @@ namespace FEXCore::Context {
       bool GeneratedIR;
       uint64_t StartAddr;
       uint64_t Length;
+      // DebugData was only allocated for this compile and is the caller's to free
+      bool OwnsDebugData;
     };
     [[nodiscard]] CompileCodeResult CompileCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
     uintptr_t CompileBlock(FEXCore::Core::CpuStateFrame *Frame, uint64_t GuestRIP);
@@ -205,6 +248,16 @@ namespace FEXCore::Context {
     // same as CompileBlock, but aborts on failure
     void CompileBlockJit(FEXCore::Core::CpuStateFrame *Frame, uint64_t GuestRIP);
 
+    /**
+     * @brief Recompiles a hot block at the higher tier and replaces it in the thread's lookup cache
+     *
+     * Called from the block's own entry once its execution counter expires.
+     * Links to the old code are severed and relink to the new code on their next use.
+     *
+     * @return The new host code, or zero if recompiling failed and the old code needs to keep running
+     */
+    uintptr_t TierUpBlock(FEXCore::Core::CpuStateFrame *Frame, uint64_t GuestRIP);
+
     // Used for thread creation from syscalls
     /**
      * @brief Used to create FEX thread objects in preparation for creating a true OS thread
@@ -269,6 +322,14 @@ namespace FEXCore::Context {
     IR::AOTIRCacheEntry *LoadAOTIRCacheEntry(const std::string &filename);
     void UnloadAOTIRCacheEntry(IR::AOTIRCacheEntry *Entry);
 
+    void AddNamedRegion(uintptr_t Base, uintptr_t Size, uintptr_t Offset, const std::string &filename);
+    void RemoveNamedRegion(uintptr_t Base, uintptr_t Size);
+
+    /**
+     * @brief Points the frontend of an AOT compile thread at a section, creating the frontend if the thread doesn't have one yet
+     */
+    void ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress, std::map<uint64_t, uint64_t> const *FunctionRanges);
+
     FEXCore::JITSymbols Symbols;
 
     // Public for threading
@@ -319,6 +380,25 @@ namespace FEXCore::Context {
      */
     void InitializeCompiler(FEXCore::Core::InternalThreadState* State);
 
+    /**
+     * @brief Creates the frontend decoder and OpDispatcher of a thread
+     *
+     * Guest threads only get these on their first compile, a thread that only runs cached code never needs them.
+     */
+    void InitializeFrontend(FEXCore::Core::InternalThreadState *State);
+
+    /**
+     * @brief Creates the pass pipeline of a thread, including RA
+     */
+    void InitializePassManager(FEXCore::Core::InternalThreadState *State);
+
+    /**
+     * @brief Returns an exited thread to its state from before CreateThread
+     *
+     * Compiler state and code buffers are kept, everything that belonged to the old guest thread is dropped.
+     */
+    void ResetThreadForReuse(FEXCore::Core::InternalThreadState *Thread);
+
     void WaitForIdleWithTimeout();
 
     void NotifyPause();
@@ -335,6 +415,10 @@ namespace FEXCore::Context {
     std::unique_ptr<FEXCore::CodeSerialize::CodeObjectSerializeService> CodeObjectCacheService;
 
     bool StartPaused = false;
+    // Blocks are compiled without multiblock first and recompiled once they cross TierUpThreshold
+    bool TieredCompilation = false;
+    // Known syscalls call their handler directly instead of going through the frame's syscall pointers
+    bool DirectSyscallHandlers = false;
     FEX_CONFIG_OPT(AppFilename, APP_FILENAME);
   };
 
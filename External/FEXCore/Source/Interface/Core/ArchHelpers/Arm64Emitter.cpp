@@ -69,7 +69,9 @@ void Arm64Emitter::LoadConstant(vixl::aarch64::Register Reg, uint64_t Constant,
 
   // If the aligned offset is within the 4GB window then we can use ADRP+ADD
   // and the number of move segments more than 1
-  if (RequiredMoveSegments > 1 && vixl::IsInt32(AlignedOffset)) {
+  // Code that gets serialized to the object cache can't use PC relative constants, the code will move on load
+  if (RequiredMoveSegments > 1 && vixl::IsInt32(AlignedOffset) &&
+      EmitterCTX->Config.CacheObjectCodeCompilation() == FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE) {
     // If this is 4k page aligned then we only need ADRP
     if ((AlignedOffset & 0xFFF) == 0) {
       adrp(Reg, AlignedOffset >> 12);
@@ -383,6 +385,31 @@ void Arm64Emitter::PlaceNamedSymbolLiteral(NamedSymbolLiteralPair &Lit) {
   Relocations.emplace_back(Lit.MoveABI);
 }
 
+Arm64Emitter::GuestRIPLiteralPair Arm64Emitter::InsertGuestRIPLiteral(uint64_t GuestRIP) {
+  Arm64Emitter::GuestRIPLiteralPair Lit {
+    .Lit = Literal(GuestRIP),
+    .MoveABI = {
+      .GuestRIPLiteral = {
+        .Header = {
+          .Type = FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_LITERAL,
+        },
+        .Offset = 0,
+        .GuestRIP = GuestRIP,
+      },
+    },
+  };
+  return Lit;
+}
+
+void Arm64Emitter::PlaceGuestRIPLiteral(GuestRIPLiteralPair &Lit) {
+  // Offset is the offset from the entrypoint of the block
+  auto CurrentCursor = GetCursorAddress<uint64_t>();
+  Lit.MoveABI.GuestRIPLiteral.Offset = CurrentCursor - GuestEntry;
+
+  place(&Lit.Lit);
+  Relocations.emplace_back(Lit.MoveABI);
+}
+
 void Arm64Emitter::InsertGuestRIPMove(vixl::aarch64::Register Reg, uint64_t Constant) {
   Relocation MoveABI{};
   MoveABI.GuestRIPMove.Header.Type = FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_MOVE;
@@ -396,7 +423,10 @@ void Arm64Emitter::InsertGuestRIPMove(vixl::aarch64::Register Reg, uint64_t Cons
   Relocations.emplace_back(MoveABI);
 }
 
-bool Arm64Emitter::ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations) {
+bool Arm64Emitter::ApplyRelocations(uint64_t GuestEntry, uint64_t OriginalGuestEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations) {
+  // Guest RIPs move with the block they were compiled in
+  const uint64_t GuestRIPDelta = GuestEntry - OriginalGuestEntry;
+
   size_t DataIndex{};
   for (size_t j = 0; j < NumRelocations; ++j) {
     const FEXCore::CPU::Relocation *Reloc = reinterpret_cast<const FEXCore::CPU::Relocation *>(&EntryRelocations[DataIndex]);
@@ -428,12 +458,7 @@ bool Arm64Emitter::ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uin
         break;
       }
       case FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_MOVE: {
-        // XXX: Reenable once the JIT Object Cache is upstream
-        // XXX: Should spin the relocation list, create a list of guest RIP moves, and ask for them all once, reduces lock contention.
-        uint64_t Pointer = ~0ULL; // EmitterCTX->JITObjectCache->FindRelocatedRIP(Reloc->GuestRIPMove.GuestRIP);
-        if (Pointer == ~0ULL) {
-          return false;
-        }
+        uint64_t Pointer = Reloc->GuestRIPMove.GuestRIP + GuestRIPDelta;
 
         // Relocation occurs at the cursorEntry + offset relative to that cursor.
         GetBuffer()->SetCursorOffset(CursorEntry + Reloc->GuestRIPMove.Offset);
@@ -441,6 +466,21 @@ bool Arm64Emitter::ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uin
         DataIndex += sizeof(Reloc->GuestRIPMove);
         break;
       }
+      case FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_LITERAL: {
+        uint64_t Pointer = Reloc->GuestRIPLiteral.GuestRIP + GuestRIPDelta;
+
+        // Relocation occurs at the cursorEntry + offset relative to that cursor.
+        GetBuffer()->SetCursorOffset(CursorEntry + Reloc->GuestRIPLiteral.Offset);
+
+        Literal<uint64_t> Lit(Pointer);
+        place(&Lit);
+
+        DataIndex += sizeof(Reloc->GuestRIPLiteral);
+        break;
+      }
+      default:
+        // Unknown relocation, likely from a newer FEX
+        return false;
     }
   }
 
@@ -133,10 +133,46 @@ protected:
      */
     void PlaceNamedSymbolLiteral(NamedSymbolLiteralPair &Lit);
 
+    /**
+     * @brief A literal pair relocation object for guest RIP literals
+     */
+    struct GuestRIPLiteralPair {
+      Literal<uint64_t> Lit;
+      Relocation MoveABI{};
+    };
+
+    /**
+     * @brief Inserts a guest RIP as a literal in memory
+     *
+     * Need to use `PlaceGuestRIPLiteral` with the return value to place the literal in the desired location
+     *
+     * @param GuestRIP - The guest RIP that will be relocated
+     *
+     * @return A temporary `GuestRIPLiteralPair`
+     */
+    GuestRIPLiteralPair InsertGuestRIPLiteral(uint64_t GuestRIP);
+
+    /**
+     * @brief Place the guest RIP literal relocation in memory
+     *
+     * @param Lit - Which literal to place
+     */
+    void PlaceGuestRIPLiteral(GuestRIPLiteralPair &Lit);
+
     std::vector<FEXCore::CPU::Relocation> Relocations;
 
-    ///< Relocation code loading
-    bool ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations);
+    /**
+     * @brief Applies serialized relocations to code that was copied in to the code buffer
+     *
+     * @param GuestEntry - The guest RIP that the code is being relocated to
+     * @param OriginalGuestEntry - The guest RIP that the code was compiled for
+     * @param CursorEntry - Code buffer offset that the code was copied to
+     * @param NumRelocations - Number of relocations in `EntryRelocations`
+     * @param EntryRelocations - Packed relocation list
+     *
+     * @return false if a relocation couldn't be resolved in this process
+     */
+    bool ApplyRelocations(uint64_t GuestEntry, uint64_t OriginalGuestEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations);
 
   /**  @} */
 
@@ -1,52 +1,193 @@
+/*
+$info$
+tags: glue|block-database
+desc: Per-block execution counters and the hot block report for BlockProfile
+$end_info$
+*/
+
 #include "Interface/Core/BlockSamplingData.h"
 #include <FEXCore/Utils/LogManager.h>
-#include <cstring>
-#include <fstream>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fmt/format.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 #include <utility>
+#include <vector>
+
+namespace {
+  static void* ReportThreadHandler(void *Arg) {
+    reinterpret_cast<FEXCore::BlockSamplingData*>(Arg)->ReportThread();
+    return nullptr;
+  }
+}
 
 namespace FEXCore {
-  void BlockSamplingData::DumpBlockData() {
-    std::fstream Output;
-    Output.open("output.csv", std::fstream::out | std::fstream::binary);
+  BlockSamplingData::BlockSamplingData(std::string_view OutputPath, bool SampleCycles)
+    : OutputPath {OutputPath}
+    , CycleSampling {SampleCycles} {
+  }
 
-    if (!Output.is_open())
+  BlockSamplingData::~BlockSamplingData() {
+    if (ReportWorker) {
+      ShuttingDown = true;
+      uint64_t Wake = 1;
+      write(WakeFD, &Wake, sizeof(Wake));
+
+      if (ReportWorker->joinable()) {
+        ReportWorker->join(nullptr);
+      }
+      close(WakeFD);
+    }
+
+    DumpBlockData();
+  }
+
+  void BlockSamplingData::StartReportThread() {
+    if (ReportWorker) {
       return;
+    }
 
-    Output << "Entry, Min, Max, Total, Calls, Average" << std::endl;
+    WakeFD = eventfd(0, EFD_CLOEXEC);
+    if (WakeFD == -1) {
+      LogMan::Msg::EFmt("Couldn't create the block profile report eventfd");
+      return;
+    }
 
-    for (auto it : SamplingMap) {
-      if (!it.second->TotalCalls)
-        continue;
+    // The thread must never receive the signal that asks for a report
+    uint64_t OldMask = FEXCore::Threads::SetSignalMask(~0ULL);
+    ReportWorker = FEXCore::Threads::Thread::Create(ReportThreadHandler, this);
+    FEXCore::Threads::SetSignalMask(OldMask);
+  }
 
-      Output << "0x" << std::hex << it.first
-             << ", " << std::dec << it.second->Min
-             << ", " << std::dec << it.second->Max
-             << ", " << std::dec << it.second->TotalTime
-             << ", " << std::dec << it.second->TotalCalls
-             << ", " << std::dec << ((double)it.second->TotalTime / (double)it.second->TotalCalls)
-             << std::endl;
+  void BlockSamplingData::RequestDump() {
+    if (WakeFD == -1) {
+      return;
     }
-    Output.close();
-    LogMan::Msg::DFmt("Dumped {} blocks of sampling data", SamplingMap.size());
+
+    // Only async-signal-safe operations, the signal can arrive while the thread holds malloc or stdio locks
+    DumpRequested.store(true, std::memory_order_release);
+    uint64_t Wake = 1;
+    write(WakeFD, &Wake, sizeof(Wake));
   }
 
-  BlockSamplingData::BlockData *BlockSamplingData::GetBlockData(uint64_t RIP) {
-    auto it = SamplingMap.find(RIP);
-    if (it != SamplingMap.end()) {
-      return it->second;
+  void BlockSamplingData::ReportThread() {
+    pthread_setname_np(pthread_self(), "BlockProfile");
+
+    while (!ShuttingDown.load(std::memory_order_acquire)) {
+      uint64_t Count{};
+      if (read(WakeFD, &Count, sizeof(Count)) == -1 && errno != EINTR) {
+        break;
+      }
+
+      if (DumpRequested.exchange(false, std::memory_order_acq_rel) && !ShuttingDown.load(std::memory_order_acquire)) {
+        DumpBlockData();
+      }
     }
-    BlockData *NewData = new BlockData{};
-    memset(NewData, 0, sizeof(BlockData));
-    NewData->Min = ~0ULL;
-    SamplingMap[RIP] = NewData;
-    return NewData;
   }
 
-  BlockSamplingData::~BlockSamplingData() {
-    DumpBlockData();
-    for (auto it : SamplingMap) {
-      delete it.second;
+  BlockSamplingData::BlockEntry *BlockSamplingData::GetEntry(uint64_t RIP) {
+    auto &Entry = SamplingMap[RIP];
+    if (!Entry) {
+      Entry = std::make_unique<BlockEntry>();
+      Entry->Data.Min = ~0ULL;
+    }
+    return Entry.get();
+  }
+
+  BlockSamplingData::BlockData *BlockSamplingData::GetBlockData(uint64_t RIP) {
+    std::lock_guard<std::mutex> lk(SamplingMutex);
+    return &GetEntry(RIP)->Data;
+  }
+
+  void BlockSamplingData::SetGuestInstructions(uint64_t RIP, uint64_t GuestInstructions) {
+    std::lock_guard<std::mutex> lk(SamplingMutex);
+    GetEntry(RIP)->GuestInstructions = GuestInstructions;
+  }
+
+  void BlockSamplingData::SetHostCodeSize(uint64_t RIP, uint64_t HostCodeSize) {
+    std::lock_guard<std::mutex> lk(SamplingMutex);
+    GetEntry(RIP)->HostCodeSize = HostCodeSize;
+  }
+
+  void BlockSamplingData::SetGuestLocation(uint64_t RIP, std::string_view Filename, uint64_t Offset) {
+    std::lock_guard<std::mutex> lk(SamplingMutex);
+    auto Entry = GetEntry(RIP);
+    Entry->Filename = Filename;
+    Entry->Offset = Offset;
+  }
+
+  void BlockSamplingData::DumpBlockData() {
+    std::lock_guard<std::mutex> lk(SamplingMutex);
+    WriteReport();
+  }
+
+  void BlockSamplingData::WriteReport() {
+    FILE *f = nullptr;
+    bool CloseAfter = false;
+
+    if (OutputPath == "stderr") {
+      f = stderr;
     }
-    SamplingMap.clear();
+    else if (OutputPath == "stdout") {
+      f = stdout;
+    }
+    else {
+      f = fopen(OutputPath.c_str(), "w");
+      CloseAfter = true;
+    }
+
+    if (!f) {
+      LogMan::Msg::EFmt("Couldn't open block profile output '{}'", OutputPath);
+      return;
+    }
+
+    std::vector<std::pair<uint64_t, BlockEntry const*>> Blocks;
+    Blocks.reserve(SamplingMap.size());
+    for (auto &[RIP, Entry] : SamplingMap) {
+      if (Entry->Data.TotalCalls) {
+        Blocks.emplace_back(RIP, Entry.get());
+      }
+    }
+
+    // Hottest first. Time is the better metric when it is sampled, otherwise fall back to the entry count
+    const bool SortByTime = CycleSampling;
+    std::sort(Blocks.begin(), Blocks.end(), [SortByTime](auto const &lhs, auto const &rhs) {
+      if (SortByTime && lhs.second->Data.TotalTime != rhs.second->Data.TotalTime) {
+        return lhs.second->Data.TotalTime > rhs.second->Data.TotalTime;
+      }
+      if (lhs.second->Data.TotalCalls != rhs.second->Data.TotalCalls) {
+        return lhs.second->Data.TotalCalls > rhs.second->Data.TotalCalls;
+      }
+      return lhs.first < rhs.first;
+    });
+
+    fmt::print(f, "RIP, Location, Calls, Guest instructions, Host code size, Total cycles, Min, Max, Average\n");
+
+    for (auto &[RIP, Entry] : Blocks) {
+      auto const &Data = Entry->Data;
+
+      std::string Location = Entry->Filename.empty() ? "<anon>" : fmt::format("{}+0x{:x}", Entry->Filename, Entry->Offset);
+
+      fmt::print(f, "0x{:x}, {}, {}, {}, {}", RIP, Location, Data.TotalCalls, Entry->GuestInstructions, Entry->HostCodeSize);
+
+      if (Data.TotalSamples) {
+        fmt::print(f, ", {}, {}, {}, {:.2f}\n", Data.TotalTime, Data.Min, Data.Max,
+                   static_cast<double>(Data.TotalTime) / static_cast<double>(Data.TotalSamples));
+      }
+      else {
+        fmt::print(f, ", 0, 0, 0, 0\n");
+      }
+    }
+
+    fflush(f);
+    if (CloseAfter) {
+      fclose(f);
+    }
+
+    LogMan::Msg::DFmt("Dumped {} blocks of sampling data", Blocks.size());
   }
 }
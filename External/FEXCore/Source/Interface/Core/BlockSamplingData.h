@@ -1,24 +1,90 @@
 #pragma once
 
+#include <FEXCore/Utils/Threads.h>
+
+#include <atomic>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace FEXCore {
+/**
+ * @brief Side table of per-block execution counters for the BlockProfile option
+ *
+ * The JITs embed a pointer to a block's BlockData in the generated code and update it without atomics.
+ * Counts from blocks that run concurrently on multiple threads can lose increments, which is fine for finding hot code.
+ */
 class BlockSamplingData {
 public:
+  // Written directly by JIT code, must remain standard layout
   struct BlockData {
-    uint64_t Start, End;
+    uint64_t Start;
+    uint64_t TotalSamples;
     uint64_t Min, Max;
     uint64_t TotalTime;
     uint64_t TotalCalls;
   };
 
-  BlockData *GetBlockData(uint64_t RIP);
+  BlockSamplingData(std::string_view OutputPath, bool SampleCycles);
   ~BlockSamplingData();
 
+  /**
+   * @brief Returns the counters for a block entry point, allocating them on first use
+   *
+   * The returned pointer is stable for the lifetime of this object
+   */
+  BlockData *GetBlockData(uint64_t RIP);
+
+  void SetGuestInstructions(uint64_t RIP, uint64_t GuestInstructions);
+  void SetHostCodeSize(uint64_t RIP, uint64_t HostCodeSize);
+  void SetGuestLocation(uint64_t RIP, std::string_view Filename, uint64_t Offset);
+
+  bool SampleCycles() const { return CycleSampling; }
+
+  /**
+   * @brief Writes the hot block report
+   */
   void DumpBlockData();
 
+  /**
+   * @brief Starts the thread that writes the reports asked for with RequestDump
+   */
+  void StartReportThread();
+
+  /**
+   * @brief Asks the report thread to write the hot block report
+   *
+   * Only sets a flag and wakes the thread, this is safe to call from a signal handler.
+   */
+  void RequestDump();
+
+  void ReportThread();
+
 private:
-  std::unordered_map<uint64_t, BlockData*> SamplingMap;
+  struct BlockEntry {
+    BlockData Data;
+    uint64_t GuestInstructions;
+    uint64_t HostCodeSize;
+    std::string Filename;
+    uint64_t Offset;
+  };
+
+  BlockEntry *GetEntry(uint64_t RIP);
+  void WriteReport();
+
+  std::string OutputPath;
+  bool CycleSampling;
+
+  std::mutex SamplingMutex;
+  std::unordered_map<uint64_t, std::unique_ptr<BlockEntry>> SamplingMap;
+
+  // eventfd the report thread sleeps on
+  int WakeFD {-1};
+  std::atomic_bool DumpRequested {false};
+  std::atomic_bool ShuttingDown {false};
+  std::unique_ptr<FEXCore::Threads::Thread> ReportWorker;
 };
 }
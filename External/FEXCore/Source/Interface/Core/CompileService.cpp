@@ -0,0 +1,264 @@
+/*
+$info$
+tags: glue|block-database
+desc: Background worker threads that generate IR for branch targets ahead of execution
+$end_info$
+*/
+
+#include "Interface/Context/Context.h"
+#include "Interface/Core/CompileService.h"
+#include "Interface/Core/Frontend.h"
+#include "Interface/Core/LookupCache.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/HLE/SyscallHandler.h>
+#include <FEXCore/Utils/LogManager.h>
+#include <FEXHeaderUtils/TypeDefines.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+  static void* ThreadHandler(void *Arg) {
+    FEXCore::CompileService *This = reinterpret_cast<FEXCore::CompileService*>(Arg);
+    This->WorkerThread();
+    return nullptr;
+  }
+}
+
+namespace FEXCore {
+  CompileService::CompileService(FEXCore::Context::Context *ctx, uint32_t NumWorkers)
+    : CTX {ctx} {
+    // Workers must never receive guest signals
+    uint64_t OldMask = FEXCore::Threads::SetSignalMask(~0ULL);
+    for (uint32_t i = 0; i < NumWorkers; ++i) {
+      Workers.emplace_back(FEXCore::Threads::Thread::Create(ThreadHandler, this));
+    }
+    FEXCore::Threads::SetSignalMask(OldMask);
+  }
+
+  CompileService::~CompileService() {
+    Shutdown();
+  }
+
+  void CompileService::Shutdown() {
+    {
+      std::lock_guard<std::mutex> lk(QueueMutex);
+      ShuttingDown = true;
+      WorkQueue.clear();
+    }
+
+    // Kick the worker threads
+    WorkAvailable.notify_all();
+
+    for (auto &Worker : Workers) {
+      if (Worker->joinable()) {
+        Worker->join(nullptr);
+      }
+    }
+
+    Workers.clear();
+  }
+
+  void CompileService::QueueCompileAhead(FEXCore::Core::InternalThreadState *Thread) {
+    if (Thread->CompileAheadTargets.empty()) {
+      return;
+    }
+
+    std::vector<uint64_t> Targets;
+    Targets.reserve(Thread->CompileAheadTargets.size());
+
+    for (auto Target : Thread->CompileAheadTargets) {
+      // Already compiled for this thread
+      if (Thread->LookupCache->FindBlock(Target)) {
+        continue;
+      }
+
+      // Workers read guest code without the guest faulting on it first.
+      // Only decode inside of file backed mappings where the target is known to be mapped.
+      if (!CTX->SyscallHandler->LookupAOTIRCacheEntry(Target).Entry) {
+        continue;
+      }
+
+      Targets.emplace_back(Target);
+    }
+
+    Thread->CompileAheadTargets.clear();
+
+    if (Targets.empty()) {
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(CompiledMutex);
+      std::erase_if(Targets, [this](uint64_t Target) {
+        return CompiledEntries.count(Target) != 0;
+      });
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(QueueMutex);
+      for (auto Target : Targets) {
+        if (ShuttingDown || WorkQueue.size() >= MAX_QUEUED_TARGETS) {
+          break;
+        }
+
+        if (PendingTargets.emplace(Target).second) {
+          WorkQueue.emplace_back(Target);
+        }
+      }
+    }
+
+    WorkAvailable.notify_all();
+  }
+
+  std::optional<FEXCore::Core::LocalIREntry> CompileService::TakeCompiledIR(uint64_t GuestRIP) {
+    CompiledEntry Compiled;
+
+    {
+      std::lock_guard<std::mutex> lk(CompiledMutex);
+      auto it = CompiledEntries.find(GuestRIP);
+      if (it == CompiledEntries.end()) {
+        return std::nullopt;
+      }
+
+      Compiled = std::move(it.value());
+      CompiledEntries.erase(it);
+    }
+
+    // Guest writes to code that wasn't tracked for SMC yet don't invalidate anything, only the bytes tell
+    if (memcmp(reinterpret_cast<void const*>(Compiled.Entry.StartAddr), Compiled.GuestCode.data(), Compiled.GuestCode.size()) != 0) {
+      return std::nullopt;
+    }
+
+    return std::move(Compiled.Entry);
+  }
+
+  void CompileService::Erase(uint64_t GuestRIP) {
+    // Only the guest thread's own entry is going away, other work in flight is still valid
+    std::lock_guard<std::mutex> lk(CompiledMutex);
+    CompiledEntries.erase(GuestRIP);
+  }
+
+  void CompileService::InvalidateRange(uint64_t Start, uint64_t Length) {
+    Generation.fetch_add(1, std::memory_order_acq_rel);
+
+    const uint64_t End = Start + Length;
+
+    std::lock_guard<std::mutex> lk(CompiledMutex);
+    for (auto it = CompiledEntries.begin(); it != CompiledEntries.end();) {
+      const auto &Entry = it->second.Entry;
+      if (Entry.StartAddr < End && Start < (Entry.StartAddr + Entry.Length)) {
+        it = CompiledEntries.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+
+  void CompileService::Clear() {
+    Generation.fetch_add(1, std::memory_order_acq_rel);
+
+    std::lock_guard<std::mutex> lk(CompiledMutex);
+    CompiledEntries.clear();
+  }
+
+  size_t CompileService::CopyGuestCode(uint64_t Base, uint8_t *Data) {
+    // process_vm_readv returns an error instead of faulting when the guest unmapped the code in the meantime.
+    // It doesn't split iovecs, one per page gets everything up to the first page that can't be read.
+    std::array<iovec, CODE_COPY_PAGES> Remote;
+    for (size_t i = 0; i < Remote.size(); ++i) {
+      Remote[i] = {
+        .iov_base = reinterpret_cast<void*>(Base + i * FHU::FEX_PAGE_SIZE),
+        .iov_len = FHU::FEX_PAGE_SIZE,
+      };
+    }
+
+    iovec Local {
+      .iov_base = Data,
+      .iov_len = CODE_COPY_PAGES * FHU::FEX_PAGE_SIZE,
+    };
+
+    const auto Result = ::process_vm_readv(::getpid(), &Local, 1, Remote.data(), Remote.size(), 0);
+    return Result < 0 ? 0 : Result;
+  }
+
+  void CompileService::WorkerThread() {
+    pthread_setname_np(pthread_self(), "CompileAhead");
+
+    // Every worker needs its own frontend and pass pipeline, none of it is thread safe
+    // This thread object never runs guest code so it doesn't get a lookup cache or backend
+    auto State = std::make_unique<FEXCore::Core::InternalThreadState>();
+    CTX->InitializeIRGenerator(State.get());
+
+    std::vector<uint8_t> CodeCopy(CODE_COPY_PAGES * FHU::FEX_PAGE_SIZE + CODE_COPY_SLACK);
+
+    while (true) {
+      uint64_t GuestRIP {};
+
+      {
+        std::unique_lock<std::mutex> lk(QueueMutex);
+        WorkAvailable.wait(lk, [this] { return ShuttingDown || !WorkQueue.empty(); });
+
+        if (ShuttingDown) {
+          break;
+        }
+
+        GuestRIP = WorkQueue.front();
+        WorkQueue.pop_front();
+      }
+
+      // Must be captured before copying so a concurrent invalidation can't be missed
+      const uint64_t ExpectedGeneration = Generation.load(std::memory_order_acquire);
+
+      // The copy starts at the page of the target so loop headers before it can be decoded as well
+      const uint64_t CopyBase = GuestRIP & FHU::FEX_PAGE_MASK;
+      const uint64_t CopyEnd = CopyBase + CopyGuestCode(CopyBase, CodeCopy.data());
+
+      if (CopyEnd > GuestRIP) {
+        // Anything decoded past the copy is an int3 and gets rejected below
+        std::fill(CodeCopy.begin() + (CopyEnd - CopyBase), CodeCopy.end(), 0xCC);
+        State->FrontendDecoder->SetSectionMaxAddress(CopyEnd);
+
+        auto [IRList, RAData, TotalInstructions, TotalInstructionsLength, StartAddr, Length] =
+          CTX->GenerateIR(State.get(), GuestRIP, FEXCore::Context::Context::CompileTier::Initial, &CodeCopy[GuestRIP - CopyBase]);
+
+        CompiledEntry Compiled {
+          .Entry = {
+            .StartAddr = StartAddr,
+            .Length = Length,
+            .IR = decltype(Compiled.Entry.IR)(IRList),
+            .RAData = decltype(Compiled.Entry.RAData)(RAData),
+            .DebugData = nullptr,
+          },
+        };
+
+        const bool InsideCopy = StartAddr >= CopyBase && (StartAddr + Length + CODE_COPY_SLACK) <= CopyEnd;
+
+        if (Compiled.Entry.IR && Compiled.Entry.RAData && InsideCopy) {
+          auto Code = CodeCopy.begin() + (StartAddr - CopyBase);
+          Compiled.GuestCode.assign(Code, Code + Length);
+
+          std::lock_guard<std::mutex> lk(CompiledMutex);
+
+          // Guest code was invalidated while this target was being compiled, the IR might be stale
+          if (Generation.load(std::memory_order_relaxed) == ExpectedGeneration &&
+              CompiledEntries.size() < MAX_COMPILED_ENTRIES) {
+            CompiledEntries.try_emplace(GuestRIP, std::move(Compiled));
+          }
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> lk(QueueMutex);
+        PendingTargets.erase(GuestRIP);
+      }
+    }
+  }
+}
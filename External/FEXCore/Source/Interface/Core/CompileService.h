@@ -0,0 +1,115 @@
+#pragma once
+#include <FEXCore/Debug/InternalThreadState.h>
+#include <FEXCore/Utils/Threads.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+#include <tsl/robin_map.h>
+
+namespace FEXCore::Context {
+  struct Context;
+}
+
+namespace FEXCore {
+/**
+ * @brief Background thread pool that compiles branch targets ahead of execution
+ *
+ * When a guest thread compiles a block, the direct branch targets leaving it that aren't compiled yet are handed to this service.
+ * Worker threads run the frontend, the OpDispatcher, the pass pipeline and RA for those targets with their own compiler state.
+ * The result is stored until the guest thread reaches the target, at which point only codegen remains on the guest thread.
+ *
+ * Workers never read guest memory directly, they decode a copy of it so a concurrent munmap can't fault on them.
+ * Code isn't tracked for SMC until its block is mapped, so the guest thread compares the copy against guest memory before
+ * taking the IR.
+ *
+ * Codegen itself can't happen on a worker since host code is bound to the thread that owns the code buffer.
+ *
+ * The service is process-wide, every guest thread holds a reference to it.
+ */
+class CompileService final {
+public:
+  CompileService(FEXCore::Context::Context *ctx, uint32_t NumWorkers);
+  ~CompileService();
+
+  /**
+   * @brief Stops and joins all worker threads, any queued work is dropped
+   */
+  void Shutdown();
+
+  /**
+   * @brief Queues the branch targets that the guest thread collected from its last decode
+   *
+   * Targets that are already compiled for the thread or not inside of tracked executable file mappings are skipped.
+   * Drains `Thread->CompileAheadTargets`.
+   */
+  void QueueCompileAhead(FEXCore::Core::InternalThreadState *Thread);
+
+  /**
+   * @brief Takes ownership of the precompiled IR for a guest RIP if a worker has finished it
+   *
+   * Reads the guest code of the entry, must be called from the guest thread that is about to run it.
+   */
+  std::optional<FEXCore::Core::LocalIREntry> TakeCompiledIR(uint64_t GuestRIP);
+
+  /**
+   * @brief Drops finished work for a single entry
+   */
+  void Erase(uint64_t GuestRIP);
+
+  /**
+   * @brief Drops finished work whose guest code overlaps [Start, Start + Length)
+   *
+   * Work that is in flight while this is called is discarded once it finishes.
+   */
+  void InvalidateRange(uint64_t Start, uint64_t Length);
+
+  void Clear();
+
+  void WorkerThread();
+
+private:
+  // Upper bounds so a thread that decodes a lot of code that it never runs can't grow these unbounded
+  constexpr static size_t MAX_QUEUED_TARGETS = 256;
+  constexpr static size_t MAX_COMPILED_ENTRIES = 4096;
+
+  // Guest code copied for a target, starting at the page of the target
+  constexpr static size_t CODE_COPY_PAGES = 2;
+  // Some ops read guest code past their own bytes, the SMC validation and the thunk hash.
+  // Decoded code has to end this far from the end of the copy, the copy is padded by the same amount.
+  constexpr static size_t CODE_COPY_SLACK = 64;
+
+  struct CompiledEntry {
+    FEXCore::Core::LocalIREntry Entry;
+    // Guest code of [Entry.StartAddr, Entry.StartAddr + Entry.Length) that the IR was generated from
+    std::vector<uint8_t> GuestCode;
+  };
+
+  /**
+   * @brief Copies guest code without faulting, returns the number of bytes copied up to the first unreadable page
+   */
+  static size_t CopyGuestCode(uint64_t Base, uint8_t *Data);
+
+  FEXCore::Context::Context *CTX;
+
+  std::vector<std::unique_ptr<FEXCore::Threads::Thread>> Workers;
+  std::atomic_bool ShuttingDown{false};
+
+  std::mutex QueueMutex;
+  std::condition_variable WorkAvailable;
+  std::deque<uint64_t> WorkQueue;
+  // Targets that are queued or being compiled, avoids doing the same work twice
+  std::set<uint64_t> PendingTargets;
+
+  std::mutex CompiledMutex;
+  // Bumped on every guest code invalidation, work that started before an invalidation is dropped
+  std::atomic<uint64_t> Generation{};
+  tsl::robin_map<uint64_t, CompiledEntry> CompiledEntries;
+};
+}
@@ -15,6 +15,7 @@ $end_info$
 #include "Interface/Core/GdbServer.h"
 #include "Interface/Core/ObjectCache/ObjectCacheService.h"
 #include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/Core/SharedCodeCache.h"
 #include "Interface/Core/Interpreter/InterpreterCore.h"
 #include "Interface/Core/JIT/JITCore.h"
 #include "Interface/HLE/Thunks/Thunks.h"
@@ -39,6 +40,7 @@ $end_info$
 #include <FEXCore/IR/RegisterAllocationData.h>
 #include <FEXCore/Utils/Allocator.h>
 #include <FEXCore/Utils/Event.h>
+#include <FEXCore/Utils/EventTrace.h>
 #include <FEXCore/Utils/LogManager.h>
 #include <FEXCore/Utils/Threads.h>
 #include <FEXHeaderUtils/Syscalls.h>
@@ -145,12 +147,31 @@ std::string_view const& GetGRegName(unsigned Reg) {
 namespace FEXCore::Context {
   Context::Context()
   : IRCaptureCache {this} {
-#ifdef BLOCKSTATS
-    BlockData = std::make_unique<FEXCore::BlockSamplingData>();
-#endif
-    if (Config.CacheObjectCodeCompilation() != FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE) {
+    if (Config.BlockProfile() != "no") {
+      BlockData = std::make_unique<FEXCore::BlockSamplingData>(Config.BlockProfile(), Config.BlockProfileCycles());
+    }
+
+    // Cached object code can't contain the profiling counters, they are at a different address every run
+    if (!BlockData &&
+        Config.CacheObjectCodeCompilation() != FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE) {
       CodeObjectCacheService = std::make_unique<FEXCore::CodeSerialize::CodeObjectSerializeService>(this);
     }
+
+    if (Config.SharedCodeCache()) {
+      SharedCodeCache = std::make_unique<FEXCore::SharedCodeCache>();
+    }
+
+    // The tier up counters embed their guest RIP, which object code relocation doesn't know about
+    TieredCompilation = Config.TierUpThreshold() &&
+                        Config.Core == FEXCore::Config::CONFIG_IRJIT &&
+                        !CodeObjectCacheService;
+
+    // The handler's host address is embedded in the code, which object code relocation doesn't know about
+    DirectSyscallHandlers = Config.CacheObjectCodeCompilation() == FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE;
+
+#if _M_ARM_64
+    HostNZCVFlags = Config.HostFlags() && Config.Core == FEXCore::Config::CONFIG_IRJIT;
+#endif
   }
 
   Context::~Context() {
@@ -159,6 +180,10 @@ namespace FEXCore::Context {
         CodeObjectCacheService->Shutdown();
       }
 
+      if (CompileService) {
+        CompileService->Shutdown();
+      }
+
       for (auto &Thread : Threads) {
         if (Thread->ExecutionThread->joinable()) {
           Thread->ExecutionThread->join(nullptr);
@@ -169,6 +194,11 @@ namespace FEXCore::Context {
         delete Thread;
       }
       Threads.clear();
+
+      for (auto &Thread : ThreadStatePool) {
+        delete Thread;
+      }
+      ThreadStatePool.clear();
     }
   }
 
@@ -218,6 +248,15 @@ namespace FEXCore::Context {
       break;
     }
 
+    if (BlockData && Config.BlockProfileSignal()) {
+      // The report allocates and does file IO, the handler only wakes the thread that writes it
+      BlockData->StartReportThread();
+      RegisterHostSignalHandler(Config.BlockProfileSignal(), [](FEXCore::Core::InternalThreadState *Thread, int Signal, void *info, void *ucontext) -> bool {
+        Thread->CTX->BlockData->RequestDump();
+        return true;
+      }, true);
+    }
+
     // Initialize GDBServer after the signal handlers are installed
     // It may install its own handlers that need to be executed AFTER the CPU cores
     if (Config.GdbServer) {
@@ -229,6 +268,11 @@ namespace FEXCore::Context {
 
     ThunkHandler.reset(FEXCore::ThunkHandler::Create());
 
+    // Worker compiler state is created from the syscall handler, so this needs to wait until it's set
+    if (Config.CompileAheadThreads() && Config.Core == FEXCore::Config::CONFIG_IRJIT) {
+      CompileService = std::make_shared<FEXCore::CompileService>(this, Config.CompileAheadThreads());
+    }
+
     LocalLoader = Loader;
     using namespace FEXCore::Core;
 
@@ -502,11 +546,22 @@ namespace FEXCore::Context {
     Thread->StartRunning.NotifyAll();
   }
 
-  void Context::InitializeCompiler(FEXCore::Core::InternalThreadState* State) {
+  void Context::InitializeFrontend(FEXCore::Core::InternalThreadState *State) {
     State->OpDispatcher = std::make_unique<FEXCore::IR::OpDispatchBuilder>(this);
     State->OpDispatcher->SetMultiblock(Config.Multiblock);
-    State->LookupCache = std::make_unique<FEXCore::LookupCache>(this);
     State->FrontendDecoder = std::make_unique<FEXCore::Frontend::Decoder>(this);
+
+    if (State->CompileService) {
+      State->FrontendDecoder->SetExternalBranches(&State->CompileAheadTargets);
+    }
+  }
+
+  void Context::InitializeIRGenerator(FEXCore::Core::InternalThreadState *State) {
+    InitializeFrontend(State);
+    InitializePassManager(State);
+  }
+
+  void Context::InitializePassManager(FEXCore::Core::InternalThreadState *State) {
     State->PassManager = std::make_unique<FEXCore::IR::PassManager>();
     State->PassManager->RegisterExitHandler([this]() {
         Stop(false /* Ignore current thread */);
@@ -525,6 +580,18 @@ namespace FEXCore::Context {
 
     State->PassManager->RegisterSyscallHandler(SyscallHandler);
 
+    if (Config.Core == FEXCore::Config::CONFIG_IRJIT) {
+      State->PassManager->InsertRegisterAllocationPass(DoSRA);
+    }
+  }
+
+  void Context::InitializeCompiler(FEXCore::Core::InternalThreadState* State) {
+    // The frontend is created by GenerateIR on the first compile
+    // The backends bind the RA pass when they are created, so the pass pipeline can't wait
+    InitializePassManager(State);
+    State->LookupCache = std::make_unique<FEXCore::LookupCache>(this);
+    State->CompileService = CompileService;
+
     // Create CPU backend
     switch (Config.Core) {
 #ifdef INTERPRETER_ENABLED
@@ -533,8 +600,6 @@ namespace FEXCore::Context {
       break;
 #endif
     case FEXCore::Config::CONFIG_IRJIT:
-      State->PassManager->InsertRegisterAllocationPass(DoSRA);
-
 #if (_M_X86_64 && JIT_X86_64)
       State->CPUBackend = FEXCore::CPU::CreateX86JITCore(this, State);
 #elif (_M_ARM_64 && JIT_ARM64)
@@ -551,15 +616,35 @@ namespace FEXCore::Context {
       ERROR_AND_DIE_FMT("Unknown core configuration");
       break;
     }
+
+    if (TieredCompilation) {
+      State->CPUBackend->SetTierUpThreshold(Config.TierUpThreshold());
+    }
   }
 
   FEXCore::Core::InternalThreadState* Context::CreateThread(FEXCore::Core::CPUState *NewThreadState, uint64_t ParentTID) {
     FEXCore::Core::InternalThreadState *Thread{};
 
-    // Grab the new thread object
+    // Grab the new thread object, an exited one if there is one around
     {
       std::lock_guard<std::mutex> lk(ThreadCreationMutex);
-      Thread = Threads.emplace_back(new FEXCore::Core::InternalThreadState{});
+      if (!ThreadStatePool.empty()) {
+        Thread = ThreadStatePool.back();
+        ThreadStatePool.pop_back();
+      }
+    }
+
+    const bool Reused = Thread != nullptr;
+    if (Reused) {
+      ResetThreadForReuse(Thread);
+    }
+    else {
+      Thread = new FEXCore::Core::InternalThreadState{};
+    }
+
+    {
+      std::lock_guard<std::mutex> lk(ThreadCreationMutex);
+      Threads.emplace_back(Thread);
       Thread->ThreadManager.TID = ++ThreadID;
     }
 
@@ -570,12 +655,48 @@ namespace FEXCore::Context {
     // Set up the thread manager state
     Thread->ThreadManager.parent_tid = ParentTID;
 
-    InitializeCompiler(Thread);
+    if (!Reused) {
+      InitializeCompiler(Thread);
+    }
     InitializeThreadData(Thread);
 
     return Thread;
   }
 
+  void Context::ResetThreadForReuse(FEXCore::Core::InternalThreadState *Thread) {
+    Thread->RunningEvents.Running = false;
+    Thread->RunningEvents.WaitingToStart = true;
+    Thread->RunningEvents.EarlyExit = false;
+    Thread->RunningEvents.ThreadSleeping = false;
+    Thread->SignalReason = FEXCore::Core::SignalEvent::Nothing;
+
+    Thread->ExecutionThread.reset();
+    Thread->StartRunning.Reset();
+    Thread->ThreadWaiting.Reset();
+
+    // Code of the old thread is only valid as long as nothing changed guest memory, start empty like a new thread
+    Thread->LocalIRCache.clear();
+    Thread->LookupCache->ClearCache();
+    Thread->CPUBackend->ClearCache();
+    Thread->CompileAheadTargets.clear();
+
+    Thread->ThreadManager.set_child_tid = nullptr;
+    Thread->ThreadManager.clear_child_tid = nullptr;
+    Thread->ThreadManager.robust_list_head = 0;
+
+    Thread->Stats.InstructionsExecuted = 0;
+    Thread->Stats.BlocksCompiled = 0;
+    Thread->StatusCode = 0;
+    Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_WAITING;
+    Thread->DestroyedByParent = false;
+
+    Thread->CurrentFrame = &Thread->BaseFrameState;
+    Thread->BaseFrameState.ReturningStackLocation = 0;
+    Thread->BaseFrameState.InSyscallInfo = 0;
+    Thread->BaseFrameState.ReturnStack = {};
+    Thread->BaseFrameState.ReturnStackIndex = 0;
+  }
+
   void Context::DestroyThread(FEXCore::Core::InternalThreadState *Thread) {
     // remove new thread object
     {
@@ -592,6 +713,16 @@ namespace FEXCore::Context {
       // To be able to delete a thread from itself, we need to detached the std::thread object
       Thread->ExecutionThread->detach();
     }
+
+    if (!CoreShuttingDown && Thread->CPUBackend && Thread->CPUBackend->CanBeReused()) {
+      std::lock_guard<std::mutex> lk(ThreadCreationMutex);
+      if (ThreadStatePool.size() < Config.ThreadStatePoolSize()) {
+        // Nothing may touch the thread after this, CreateThread can pick it up right away
+        ThreadStatePool.emplace_back(Thread);
+        return;
+      }
+    }
+
     delete Thread;
   }
 
@@ -654,6 +785,14 @@ namespace FEXCore::Context {
 
     if (AlsoClearIRCache) {
       Thread->LocalIRCache.clear();
+
+      if (SharedCodeCache) {
+        SharedCodeCache->Clear();
+      }
+
+      if (CompileService) {
+        CompileService->Clear();
+      }
     }
   }
 
@@ -710,21 +849,36 @@ namespace FEXCore::Context {
     }
   }
 
-  Context::GenerateIRResult Context::GenerateIR(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
-    uint8_t const *GuestCode{};
-    GuestCode = reinterpret_cast<uint8_t const*>(GuestRIP);
+  Context::GenerateIRResult Context::GenerateIR(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, CompileTier Tier, uint8_t const *GuestCodeCopy) {
+    uint8_t const *GuestCode = GuestCodeCopy ?: reinterpret_cast<uint8_t const*>(GuestRIP);
 
     bool HadDispatchError {false};
 
     uint64_t TotalInstructions {0};
     uint64_t TotalInstructionsLength {0};
 
-    Thread->FrontendDecoder->DecodeInstructionsAtEntry(GuestCode, GuestRIP);
+    FEXCore::Frontend::Decoder::BlockShape Shape {
+      .Multiblock = Config.Multiblock,
+      .LoopAware = Config.Multiblock,
+    };
+
+    if (TieredCompilation) {
+      // Keep first compiles cheap, only code that proves to be hot gets large regions
+      Shape.Multiblock = Tier == CompileTier::Hot;
+      Shape.LoopAware = Tier == CompileTier::Hot;
+    }
+
+    if (!Thread->FrontendDecoder) {
+      InitializeFrontend(Thread);
+    }
+
+    Thread->FrontendDecoder->DecodeInstructionsAtEntry(GuestCode, GuestRIP, Shape);
 
     auto CodeBlocks = Thread->FrontendDecoder->GetDecodedBlocks();
 
     Thread->OpDispatcher->ReownOrClaimBuffer();
     Thread->OpDispatcher->ResetWorkingList();
+    Thread->OpDispatcher->SetGuestCode(GuestCode, GuestRIP);
     Thread->OpDispatcher->BeginFunction(GuestRIP, CodeBlocks);
 
     const uint8_t GPRSize = GetGPRSize();
@@ -750,9 +904,10 @@ namespace FEXCore::Context {
         bool IsLocked = DecodedInfo->Flags & FEXCore::X86Tables::DecodeFlags::FLAG_LOCK;
 
         if (Config.SMCChecks == FEXCore::Config::CONFIG_SMC_FULL) {
-          auto ExistingCodePtr = reinterpret_cast<uint64_t*>(Block.Entry + BlockInstructionsLength);
+          const uint64_t CodeOffset = Block.Entry + BlockInstructionsLength - GuestRIP;
+          auto ExistingCodePtr = reinterpret_cast<uint64_t const*>(GuestCode + CodeOffset);
 
-          auto CodeChanged = Thread->OpDispatcher->_ValidateCode(ExistingCodePtr[0], ExistingCodePtr[1], (uintptr_t)ExistingCodePtr - GuestRIP, DecodedInfo->InstSize);
+          auto CodeChanged = Thread->OpDispatcher->_ValidateCode(ExistingCodePtr[0], ExistingCodePtr[1], CodeOffset, DecodedInfo->InstSize);
 
           auto InvalidateCodeCond = Thread->OpDispatcher->_CondJump(CodeChanged);
 
@@ -852,6 +1007,10 @@ namespace FEXCore::Context {
     Thread->OpDispatcher->DelayedDisownBuffer();
     Thread->FrontendDecoder->DelayedDisownBuffer();
 
+    if (BlockData) {
+      BlockData->SetGuestInstructions(GuestRIP, TotalInstructions);
+    }
+
     return {
       .IRList = IRList,
       .RAData = RAData.release(),
@@ -892,14 +1051,16 @@ namespace FEXCore::Context {
       if (CodeCacheEntry) {
         auto CompiledCode = Thread->CPUBackend->RelocateJITObjectCode(GuestRIP, CodeCacheEntry);
         if (CompiledCode) {
+          // Guest code range is still needed so the block mapping gets SMC tracking
+          const auto *Data = CodeCacheEntry->Data;
           return {
             .CompiledCode = CompiledCode,
             .IRData      = nullptr, // No IR data generated
             .DebugData   = nullptr, // nullptr here ensures that code serialization doesn't occur on from cache read
             .RAData      = nullptr, // No RA data generated
             .GeneratedIR = false, // nullptr here ensures IR cache mechanisms won't run
-            .StartAddr   = 0, // Unused
-            .Length      = 0, // Unused
+            .StartAddr   = GuestRIP - Data->GuestRIPOffset + Data->GuestCodeOffset,
+            .Length      = Data->GuestCodeLength,
           };
         }
       }
@@ -909,6 +1070,7 @@ namespace FEXCore::Context {
     {
       auto [IRCopy, RACopy, DebugDataCopy, _StartAddr, _Length, _GeneratedIR] = IRCaptureCache.PreGenerateIRFetch(GuestRIP, IRList);
       if (_GeneratedIR) {
+        // These blocks skip GenerateIR, so the block profile reports zero guest instructions for them
         // Setup pointers to internal structures
         IRList = IRCopy;
         RAData = RACopy;
@@ -919,10 +1081,58 @@ namespace FEXCore::Context {
       }
     }
 
+    // Process-wide IR cache, only usable when the backend doesn't hold on to the IR
+    const bool UseSharedCache = SharedCodeCache && !Thread->CPUBackend->NeedsRetainedIRCopy();
+    uint64_t SharedCacheGeneration {};
+
+    if (IRList == nullptr && Thread->CompileService) {
+      // A compile-ahead worker might have already generated the IR
+      auto Entry = Thread->CompileService->TakeCompiledIR(GuestRIP);
+      if (Entry) {
+        // Ownership moves to the caller the same as freshly generated IR
+        IRList = Entry->IR.release();
+        RAData = Entry->RAData.release();
+        DebugData = new FEXCore::Core::DebugData();
+        StartAddr = Entry->StartAddr;
+        Length = Entry->Length;
+
+        Thread->Stats.BlocksCompiled.fetch_add(1);
+
+        GeneratedIR = true;
+      }
+    }
+
+    if (IRList == nullptr && UseSharedCache) {
+      // Keeps the entry alive while the backend consumes it
+      auto SharedEntry = SharedCodeCache->Find(GuestRIP);
+      if (SharedEntry) {
+        // Debug data describes this thread's host code so every hit gets its own
+        auto SharedDebugData = new FEXCore::Core::DebugData();
+        auto CompiledCode = Thread->CPUBackend->CompileCode(GuestRIP, SharedEntry->IR.get(), SharedDebugData, SharedEntry->RAData.get());
+        return {
+          .CompiledCode = CompiledCode,
+          .IRData      = nullptr, // IR is owned by the shared cache
+          .DebugData   = SharedDebugData,
+          .RAData      = nullptr,
+          .GeneratedIR = false, // Ensures IR cache mechanisms won't run
+          .StartAddr   = SharedEntry->StartAddr,
+          .Length      = SharedEntry->Length,
+          .OwnsDebugData = true,
+        };
+      }
+
+      // Must be captured before decoding so a concurrent invalidation can't be missed
+      SharedCacheGeneration = SharedCodeCache->GetGeneration();
+    }
+
     if (IRList == nullptr) {
       // Generate IR + Meta Info
       auto [IRCopy, RACopy, TotalInstructions, TotalInstructionsLength, _StartAddr, _Length] = GenerateIR(Thread, GuestRIP);
 
+      if (UseSharedCache && IRCopy && RACopy) {
+        SharedCodeCache->Publish(GuestRIP, SharedCacheGeneration, _StartAddr, _Length, IRCopy->CreateCopy(), RACopy->CreateCopy());
+      }
+
       // Setup pointers to internal structures
       IRList = IRCopy;
       RAData = RACopy;
@@ -963,6 +1173,15 @@ namespace FEXCore::Context {
     }
   }
 
+  static void TraceBlockCompile(uint64_t TraceStart, uint64_t GuestRIP, void *CodePtr, uint64_t StartAddr, uint64_t Length) {
+    FEXCore::EventTrace::Add({
+      .Timestamp = TraceStart,
+      .Duration = static_cast<uint32_t>(FEXCore::EventTrace::Now() - TraceStart),
+      .Type = FEXCore::EventTrace::EventType::BLOCK_COMPILE,
+      .Args = {GuestRIP, reinterpret_cast<uint64_t>(CodePtr), StartAddr, Length},
+    });
+  }
+
   uintptr_t Context::CompileBlock(FEXCore::Core::CpuStateFrame *Frame, uint64_t GuestRIP) {
     auto Thread = Frame->Thread;
 
@@ -972,6 +1191,9 @@ namespace FEXCore::Context {
       return HostCode;
     }
 
+    const bool Trace = FEXCore::EventTrace::IsEnabled();
+    const uint64_t TraceStart = Trace ? FEXCore::EventTrace::Now() : 0;
+
     void *CodePtr {};
     FEXCore::IR::IRListView *IRList {};
     FEXCore::Core::DebugData *DebugData {};
@@ -980,7 +1202,9 @@ namespace FEXCore::Context {
     bool GeneratedIR {};
     uint64_t StartAddr {}, Length {};
 
-    auto [Code, IR, Data, RA, Generated, _StartAddr, _Length] = CompileCode(Thread, GuestRIP);
+    auto [Code, IR, Data, RA, Generated, _StartAddr, _Length, OwnsDebugData] = CompileCode(Thread, GuestRIP);
+    // Only needed for naming and serialization below
+    std::unique_ptr<FEXCore::Core::DebugData> OwnedDebugData {OwnsDebugData ? Data : nullptr};
     CodePtr = Code;
     IRList = IR;
     DebugData = Data;
@@ -993,6 +1217,10 @@ namespace FEXCore::Context {
       return 0;
     }
 
+    if (Trace) {
+      TraceBlockCompile(TraceStart, GuestRIP, CodePtr, StartAddr, Length);
+    }
+
     // The core managed to compile the code.
     if (Config.BlockJITNaming()) {
       if (DebugData) {
@@ -1016,6 +1244,13 @@ namespace FEXCore::Context {
       }
     }
 
+    if (BlockData) {
+      auto GuestRIPLookup = this->SyscallHandler->LookupAOTIRCacheEntry(GuestRIP);
+      if (GuestRIPLookup.Entry) {
+        BlockData->SetGuestLocation(GuestRIP, GuestRIPLookup.Entry->Filename, GuestRIP - GuestRIPLookup.Offset);
+      }
+    }
+
     // Tell the object cache service to serialize the code if enabled
     if (CodeObjectCacheService &&
         Config.CacheObjectCodeCompilation == FEXCore::Config::ConfigObjectCodeHandler::CONFIG_READWRITE &&
@@ -1023,6 +1258,7 @@ namespace FEXCore::Context {
       CodeObjectCacheService->AsyncAddSerializationJob(std::make_unique<CodeSerialize::AsyncJobHandler::SerializationJobData>(
         CodeSerialize::AsyncJobHandler::SerializationJobData {
           .GuestRIP = GuestRIP,
+          .GuestCodeStart = StartAddr,
           .GuestCodeLength = Length,
           .GuestCodeHash = 0,
           .HostCodeBegin = CodePtr,
@@ -1054,6 +1290,61 @@ namespace FEXCore::Context {
     // Insert to lookup cache
     AddBlockMapping(Thread, GuestRIP, CodePtr, StartAddr, Length);
 
+    // Only once the block is mapped, so it doesn't get queued as its own target
+    if (Thread->CompileService) {
+      Thread->CompileService->QueueCompileAhead(Thread);
+    }
+
+    return (uintptr_t)CodePtr;
+  }
+
+  uintptr_t Context::TierUpBlock(FEXCore::Core::CpuStateFrame *Frame, uint64_t GuestRIP) {
+    auto Thread = Frame->Thread;
+
+    // Nothing else may touch this thread's blocks until the new code replaced the old
+    std::lock_guard<std::recursive_mutex> lk(Thread->LookupCache->WriteLock);
+
+    const bool Trace = FEXCore::EventTrace::IsEnabled();
+    const uint64_t TraceStart = Trace ? FEXCore::EventTrace::Now() : 0;
+
+    auto [IRCopy, RACopy, TotalInstructions, TotalInstructionsLength, StartAddr, Length] = GenerateIR(Thread, GuestRIP, CompileTier::Hot);
+
+    std::unique_ptr<FEXCore::IR::IRListView, FEXCore::IR::IRListViewDeleter> IRList {IRCopy};
+    std::unique_ptr<FEXCore::IR::RegisterAllocationData, FEXCore::IR::RegisterAllocationDataDeleter> RAData {RACopy};
+
+    if (!IRList || !RAData) {
+      return 0;
+    }
+
+    Thread->Stats.BlocksCompiled.fetch_add(1);
+
+    // Hot code never tiers up again
+    auto DebugData = std::make_unique<FEXCore::Core::DebugData>();
+    Thread->CPUBackend->SetTierUpThreshold(0);
+    auto CodePtr = Thread->CPUBackend->CompileCode(GuestRIP, IRList.get(), DebugData.get(), RAData.get());
+    Thread->CPUBackend->SetTierUpThreshold(Config.TierUpThreshold());
+    Thread->CPUBackend->ClearRelocations();
+
+    if (CodePtr == nullptr) {
+      return 0;
+    }
+
+    if (Trace) {
+      TraceBlockCompile(TraceStart, GuestRIP, CodePtr, StartAddr, Length);
+    }
+
+    if (Config.BlockJITNaming()) {
+      Symbols.Register(CodePtr, GuestRIP, DebugData->HostCodeSize);
+    }
+
+    if (Thread->LookupCache->ReplaceBlockMapping(GuestRIP, CodePtr, StartAddr, Length)) {
+      SyscallHandler->MarkGuestExecutableRange(StartAddr, Length);
+    }
+
+    if (Thread->CompileService) {
+      Thread->CompileService->QueueCompileAhead(Thread);
+    }
+
     return (uintptr_t)CodePtr;
   }
 
@@ -1063,6 +1354,11 @@ namespace FEXCore::Context {
 
     InitializeThreadTLSData(Thread);
 
+    if (FEXCore::EventTrace::IsEnabled()) {
+      // Signal handlers can't allocate the ring themselves
+      FEXCore::EventTrace::RegisterThread();
+    }
+
     ++IdleWaitRefCount;
 
     // Now notify the thread that we are initialized
@@ -1117,19 +1413,63 @@ namespace FEXCore::Context {
   static void InvalidateGuestThreadCodeRange(FEXCore::Core::InternalThreadState *Thread, uint64_t Start, uint64_t Length) {
     std::lock_guard<std::recursive_mutex> lk(Thread->LookupCache->WriteLock);
 
-    auto lower = Thread->LookupCache->CodePages.lower_bound(Start >> 12);
-    auto upper = Thread->LookupCache->CodePages.upper_bound((Start + Length - 1) >> 12);
+    auto &CodePages = Thread->LookupCache->CodePages;
+    const uint64_t StartPage = Start >> 12;
+    const uint64_t EndPage = (Start + Length - 1) >> 12;
+
+    // The pages are dropped from CodePages entirely, leaving empty entries behind would grow it forever
+    std::vector<uint64_t> Blocks;
+    auto InvalidatePage = [&Blocks](std::vector<uint64_t> const &PageBlocks) {
+      Blocks.insert(Blocks.end(), PageBlocks.begin(), PageBlocks.end());
+    };
 
-    for (auto it = lower; it != upper; it++) {
-      for (auto Address: it->second) {
-        Context::RemoveThreadCodeEntry(Thread, Address);
+    // Large ranges (munmap of a whole library) are cheaper to handle by walking the pages that contain code
+    if ((EndPage - StartPage) < CodePages.size()) {
+      for (auto Page = StartPage; Page <= EndPage; ++Page) {
+        auto it = CodePages.find(Page);
+        if (it != CodePages.end()) {
+          InvalidatePage(it->second);
+          CodePages.erase(it);
+        }
+      }
+    }
+    else {
+      for (auto it = CodePages.begin(); it != CodePages.end();) {
+        if (it->first >= StartPage && it->first <= EndPage) {
+          InvalidatePage(it->second);
+          it = CodePages.erase(it);
+        }
+        else {
+          ++it;
+        }
       }
-      it->second.clear();
+    }
+
+    for (auto Address : Blocks) {
+      Context::RemoveThreadCodeEntry(Thread, Address);
     }
   }
 
   void InvalidateGuestCodeRange(FEXCore::Context::Context *CTX, uint64_t Start, uint64_t Length) {
+    if (FEXCore::EventTrace::IsEnabled()) {
+      // Write faults on tracked code pages get here from the signal handler
+      FEXCore::EventTrace::AddFromSignal({
+        .Timestamp = FEXCore::EventTrace::Now(),
+        .Type = FEXCore::EventTrace::EventType::SMC_INVALIDATE,
+        .Args = {Start, Length},
+      });
+    }
+
     std::lock_guard<std::mutex> lk(CTX->ThreadCreationMutex);
+
+    if (CTX->SharedCodeCache) {
+      CTX->SharedCodeCache->InvalidateRange(Start, Length);
+    }
+
+    if (CTX->CompileService) {
+      CTX->CompileService->InvalidateRange(Start, Length);
+    }
+
     for (auto &Thread : CTX->Threads) {
       if (Thread->RunningEvents.Running.load()) {
         InvalidateGuestThreadCodeRange(Thread, Start, Length);
@@ -1142,6 +1482,14 @@ namespace FEXCore::Context {
 
     Thread->LocalIRCache.erase(GuestRIP);
     Thread->LookupCache->Erase(GuestRIP);
+
+    if (Thread->CTX->SharedCodeCache) {
+      Thread->CTX->SharedCodeCache->Erase(GuestRIP);
+    }
+
+    if (Thread->CompileService) {
+      Thread->CompileService->Erase(GuestRIP);
+    }
   }
 
   // Debug interface
@@ -1208,8 +1556,30 @@ namespace FEXCore::Context {
     }
   }
 
-  void ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress) {
+  void Context::AddNamedRegion(uintptr_t Base, uintptr_t Size, uintptr_t Offset, const std::string &filename) {
+    if (CodeObjectCacheService) {
+      CodeObjectCacheService->AsyncAddNamedRegionJob(Base, Size, Offset, filename);
+    }
+  }
+
+  void Context::RemoveNamedRegion(uintptr_t Base, uintptr_t Size) {
+    if (CodeObjectCacheService) {
+      CodeObjectCacheService->AsyncRemoveNamedRegionJob(Base, Size);
+    }
+  }
+
+  void Context::ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress, std::map<uint64_t, uint64_t> const *FunctionRanges) {
+    // Threads only get a frontend on their first compile, AOT generation configures it before that
+    if (!Thread->FrontendDecoder) {
+      InitializeFrontend(Thread);
+    }
+
     Thread->FrontendDecoder->SetExternalBranches(ExternalBranches);
     Thread->FrontendDecoder->SetSectionMaxAddress(SectionMaxAddress);
+    Thread->FrontendDecoder->SetFunctionRanges(FunctionRanges);
+  }
+
+  void ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress, std::map<uint64_t, uint64_t> const *FunctionRanges) {
+    Thread->CTX->ConfigureAOTGen(Thread, ExternalBranches, SectionMaxAddress, FunctionRanges);
   }
 }
@@ -35,7 +35,7 @@ namespace FEXCore::CPU {
 using namespace vixl;
 using namespace vixl::aarch64;
 
-static constexpr size_t MAX_DISPATCHER_CODE_SIZE = 4096;
+static constexpr size_t MAX_DISPATCHER_CODE_SIZE = 4096 * 2;
 #define STATE x28
 
 Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread, DispatcherConfig &config)
@@ -59,6 +59,30 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
   Literal l_CompileBlock {GetCompileBlockPtr()};
   Literal l_ExitFunctionLink {config.ExitFunctionLink};
   Literal l_ExitFunctionLinkThis {config.ExitFunctionLinkThis};
+  Literal l_IndirectBranchLink {config.IndirectBranchLink};
+  Literal l_TierUpLink {config.TierUpLink};
+  Literal l_CodeRegions {reinterpret_cast<uintptr_t>(config.CodeRegions)};
+
+  // Counts a lookup of the block in x3 towards its code region, clobbers x0 and x1
+  auto CountCodeRegionUse = [&]() {
+    if (!config.CodeRegions) {
+      return;
+    }
+
+    aarch64::Label Skip{};
+    ldr(x0, &l_CodeRegions);
+    ldr(x1, MemOperand(x0, offsetof(CodeRegionUsage, Base)));
+    cbz(x1, &Skip);
+    sub(x1, x3, x1);
+    lsr(x1, x1, config.CodeRegions->RegionShift);
+    cmp(x1, CodeRegionUsage::NUM_REGIONS);
+    b(&Skip, Condition::hs);
+    add(x0, x0, Operand(x1, Shift::LSL, 3));
+    ldr(x1, MemOperand(x0, offsetof(CodeRegionUsage, Hits)));
+    add(x1, x1, 1);
+    str(x1, MemOperand(x0, offsetof(CodeRegionUsage, Hits)));
+    bind(&Skip);
+  };
 
   // Push all the register we need to save
   PushCalleeSavedRegisters();
@@ -104,6 +128,7 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
   cmp(x0, RipReg);
   b(&FullLookup, Condition::ne);
 
+  CountCodeRegionUse();
   if (!config.ExecuteBlocksWithCall) {
     br(x3);
   } else {
@@ -162,6 +187,7 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
       and_(x1, RipReg, LookupCache::L1_ENTRIES_MASK);
       add(x0, x0, Operand(x1, Shift::LSL, 4));
       stp(x3, x2, MemOperand(x0));
+      CountCodeRegionUse();
 
       // Jump to the block
       if (!config.ExecuteBlocksWithCall) {
@@ -207,8 +233,10 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
   }
 
   constexpr bool SignalSafeCompile = true;
-  {
-    ExitFunctionLinkerAddress = GetCursorAddress<uint64_t>();
+
+  // Linkers are called from JIT code with LR pointing at the link record, they return the host code to continue at
+  auto EmitLinker = [&](auto *LinkFunction) {
+    const auto LinkerAddress = GetCursorAddress<uint64_t>();
     if (SRAEnabled)
       SpillStaticRegs();
 
@@ -235,7 +263,7 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
     mov(x1, STATE);
     mov(x2, lr);
 
-    ldr(x3, &l_ExitFunctionLink);
+    ldr(x3, LinkFunction);
     blr(x3);
 
     if (SignalSafeCompile) {
@@ -259,7 +287,13 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
     if (SRAEnabled)
       FillStaticRegs();
     br(x0);
-  }
+
+    return LinkerAddress;
+  };
+
+  ExitFunctionLinkerAddress = EmitLinker(&l_ExitFunctionLink);
+  IndirectBranchLinkerAddress = EmitLinker(&l_IndirectBranchLink);
+  TierUpLinkerAddress = EmitLinker(&l_TierUpLink);
 
   // Need to create the block
   {
@@ -524,6 +558,9 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
   place(&l_CompileBlock);
   place(&l_ExitFunctionLink);
   place(&l_ExitFunctionLinkThis);
+  place(&l_IndirectBranchLink);
+  place(&l_TierUpLink);
+  place(&l_CodeRegions);
 
 
   FinalizeCode();
@@ -552,6 +589,8 @@ Arm64Dispatcher::Arm64Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::
     Pointers.OverflowExceptionHandler = OverflowExceptionInstructionAddress;
     Pointers.SignalReturnHandler = SignalHandlerReturnAddress;
     Pointers.L1Pointer = Thread->LookupCache->GetL1Pointer();
+    Pointers.IndirectBranchLinker = IndirectBranchLinkerAddress;
+    Pointers.TierUpLinker = TierUpLinkerAddress;
     Pointers.LUDIVHandler = LUDIVHandler;
     Pointers.LDIVHandler = LDIVHandler;
     Pointers.LUREMHandler = LUREMHandler;
@@ -23,11 +23,42 @@ struct InternalThreadState;
 
 namespace FEXCore::CPU {
 
+// Execution counter of a first tier block, the tier up linker gets a pointer to it
+// Lives outside of the code buffer so counting doesn't write to pages that are being executed
+struct TierUpRecord {
+  uint64_t GuestRIP;
+  // Block entries left until the block gets recompiled
+  uint32_t Remaining;
+};
+
+/**
+ * @brief Use counters for the regions of a JIT's code buffer
+ *
+ * Bumped by the dispatcher for every block it finds in its L1 or L2 cache, and by the JIT whenever it links to a block,
+ * so blocks that are only ever reached through the dispatcher still keep their region from being evicted.
+ */
+struct CodeRegionUsage {
+  static constexpr size_t NUM_REGIONS = 8;
+
+  // Start of the code buffer once it is split in to regions, zero before that
+  uintptr_t Base;
+  // log2 of the region size
+  uint32_t RegionShift;
+  uint32_t Pad;
+  uint64_t Hits[NUM_REGIONS];
+};
+
 struct DispatcherConfig {
   bool ExecuteBlocksWithCall = false;
   uintptr_t ExitFunctionLink = 0;
   uintptr_t ExitFunctionLinkThis = 0;
+  // Shares ExitFunctionLinkThis
+  uintptr_t IndirectBranchLink = 0;
+  // Shares ExitFunctionLinkThis
+  uintptr_t TierUpLink = 0;
   bool StaticRegisterAssignment = false;
+  // Counted in on every block lookup when set
+  CodeRegionUsage *CodeRegions = nullptr;
 };
 
 class Dispatcher {
@@ -47,6 +78,8 @@ public:
   uint64_t ThreadPauseHandlerAddress{};
   uint64_t ThreadPauseHandlerAddressSpillSRA{};
   uint64_t ExitFunctionLinkerAddress{};
+  uint64_t IndirectBranchLinkerAddress{};
+  uint64_t TierUpLinkerAddress{};
   uint64_t SignalHandlerReturnAddress{};
   uint64_t UnimplementedInstructionAddress{};
   uint64_t OverflowExceptionInstructionAddress{};
@@ -254,8 +254,9 @@ X86Dispatcher::X86Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::Inte
     jmp(LoopTop);
   }
 
-  {
-    ExitFunctionLinkerAddress = getCurr<uint64_t>();
+  // Linkers are called from JIT code with rax pointing at the link record, they jump to the host code to continue at
+  auto EmitLinker = [&](uintptr_t LinkFunction) {
+    const auto LinkerAddress = getCurr<uint64_t>();
     if (SignalSafeCompile) {
       // When compiling code, mask all signals to reduce the chance of reentrant allocations
       // RDI: SETMASK
@@ -287,7 +288,7 @@ X86Dispatcher::X86Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::Inte
     mov(rsi, STATE);
     mov(rdx, rax); // rax is set at the block end
 
-    mov(rax, config.ExitFunctionLink);
+    mov(rax, LinkFunction);
     call(rax);
 
     if (SignalSafeCompile) {
@@ -311,7 +312,13 @@ X86Dispatcher::X86Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::Inte
     else {
       jmp(rax);
     }
-  }
+
+    return LinkerAddress;
+  };
+
+  ExitFunctionLinkerAddress = EmitLinker(config.ExitFunctionLink);
+  IndirectBranchLinkerAddress = EmitLinker(config.IndirectBranchLink);
+  TierUpLinkerAddress = EmitLinker(config.TierUpLink);
 
   {
     // Pause handler
@@ -442,6 +449,8 @@ X86Dispatcher::X86Dispatcher(FEXCore::Context::Context *ctx, FEXCore::Core::Inte
     Pointers.OverflowExceptionHandler = OverflowExceptionInstructionAddress;
     Pointers.SignalReturnHandler = SignalHandlerReturnAddress;
     Pointers.L1Pointer = Thread->LookupCache->GetL1Pointer();
+    Pointers.IndirectBranchLinker = IndirectBranchLinkerAddress;
+    Pointers.TierUpLinker = TierUpLinkerAddress;
   }
 }
 
@@ -1048,7 +1048,7 @@ bool Decoder::DecodeInstruction(uint64_t PC) {
 }
 
 void Decoder::BranchTargetInMultiblockRange() {
-  if (!CTX->Config.Multiblock)
+  if (!Shape.Multiblock && !ExternalBranches)
     return;
 
   // If the RIP setting is conditional AND within our symbol range then it can be considered for multiblock
@@ -1090,6 +1090,18 @@ void Decoder::BranchTargetInMultiblockRange() {
     TargetRIP &= 0xFFFFFFFFU;
   }
 
+  if (!Shape.Multiblock) {
+    // Without multiblock every branch leaves the block, so both sides are external
+    // Branches back to the entry stay inside of the block
+    if (TargetRIP != EntryPoint) {
+      ExternalBranches->insert(TargetRIP);
+    }
+    if (Conditional) {
+      ExternalBranches->insert(DecodeInst->PC + DecodeInst->InstSize);
+    }
+    return;
+  }
+
   // If the target RIP is within the symbol ranges then we are golden
   if (TargetRIP >= SymbolMinAddress && TargetRIP < SymbolMaxAddress) {
     // Update our conditional branch ranges before we return
@@ -1116,6 +1128,27 @@ void Decoder::BranchTargetInMultiblockRange() {
   }
 }
 
+bool Decoder::FindFunctionRange(uint64_t PC) {
+  if (!FunctionRanges) {
+    return false;
+  }
+
+  auto Function = FunctionRanges->upper_bound(PC);
+  if (Function == FunctionRanges->begin()) {
+    return false;
+  }
+  --Function;
+
+  if (PC >= Function->second) {
+    return false;
+  }
+
+  // Branches that leave the function are region boundaries, like calls and returns
+  SymbolMinAddress = Function->first;
+  SymbolMaxAddress = std::min(Function->second, SectionMaxAddress);
+  return true;
+}
+
 const uint8_t *Decoder::AdjustAddrForSpecialRegion(uint8_t const* _InstStream, uint64_t EntryPoint, uint64_t RIP) {
   constexpr uint64_t VSyscall_Base = 0xFFFF'FFFF'FF60'0000ULL;
   constexpr uint64_t VSyscall_End = VSyscall_Base + 0x1000;
@@ -1135,7 +1168,8 @@ const uint8_t *Decoder::AdjustAddrForSpecialRegion(uint8_t const* _InstStream, u
   return _InstStream - EntryPoint + RIP;
 }
 
-void Decoder::DecodeInstructionsAtEntry(uint8_t const* _InstStream, uint64_t PC) {
+void Decoder::DecodeInstructionsAtEntry(uint8_t const* _InstStream, uint64_t PC, BlockShape const &_Shape) {
+  Shape = _Shape;
   Blocks.clear();
   BlocksToDecode.clear();
   HasBlocks.clear();
@@ -1145,11 +1179,12 @@ void Decoder::DecodeInstructionsAtEntry(uint8_t const* _InstStream, uint64_t PC)
   MaxCondBranchBackwards = ~0ULL;
   DecodedBuffer = PoolObject.ReownOrClaimBuffer();
 
-  // XXX: Load symbol data
-  SymbolAvailable = false;
   EntryPoint = PC;
   InstStream = _InstStream;
 
+  // With symbols the whole function containing the entry is decoded as one region
+  SymbolAvailable = Shape.Multiblock && FindFunctionRange(PC);
+
   uint64_t TotalInstructions{};
 
   // If we don't have symbols available then we become a bit optimistic about multiblock ranges
@@ -1157,6 +1192,12 @@ void Decoder::DecodeInstructionsAtEntry(uint8_t const* _InstStream, uint64_t PC)
     // If we don't have a symbol available then assume all branches are valid for multiblock
     SymbolMaxAddress = SectionMaxAddress;
     SymbolMinAddress = EntryPoint;
+
+    // Entering in the middle of a loop, pull in its header as well
+    // Code before the entry is only known to be mapped on the same page
+    if (Shape.LoopAware) {
+      SymbolMinAddress = EntryPoint & ~0xFFFULL;
+    }
   }
 
   DecodedMinAddress = EntryPoint;
@@ -1244,7 +1285,11 @@ void Decoder::DecodeInstructionsAtEntry(uint8_t const* _InstStream, uint64_t PC)
 
 
   // sort for better branching
-  std::sort(Blocks.begin(), Blocks.end(), [](const FEXCore::Frontend::Decoder::DecodedBlocks& a, const FEXCore::Frontend::Decoder::DecodedBlocks& b) {
+  // The entry block must stay first, blocks before it only exist with loop-aware decoding
+  std::sort(Blocks.begin(), Blocks.end(), [EntryPoint = EntryPoint](const FEXCore::Frontend::Decoder::DecodedBlocks& a, const FEXCore::Frontend::Decoder::DecodedBlocks& b) {
+    if ((a.Entry == EntryPoint) != (b.Entry == EntryPoint)) {
+      return a.Entry == EntryPoint;
+    }
     return a.Entry < b.Entry;
   });
 }
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cstdint>
+#include <map>
 #include <set>
 #include <stddef.h>
 #include <vector>
@@ -25,9 +26,16 @@ public:
     bool HasInvalidInstruction{};
   };
 
+  // How far decoding follows branches from the entry point
+  struct BlockShape final {
+    bool Multiblock{};
+    // Multiblock also follows backward branches to code before the entry, within the entry's page
+    bool LoopAware{};
+  };
+
   Decoder(FEXCore::Context::Context *ctx);
   ~Decoder();
-  void DecodeInstructionsAtEntry(uint8_t const* InstStream, uint64_t PC);
+  void DecodeInstructionsAtEntry(uint8_t const* InstStream, uint64_t PC, BlockShape const &Shape);
 
   std::vector<DecodedBlocks> const *GetDecodedBlocks() const {
     return &Blocks;
@@ -38,6 +46,8 @@ public:
 
   void SetSectionMaxAddress(uint64_t v) { SectionMaxAddress = v; }
   void SetExternalBranches(std::set<uint64_t> *v) { ExternalBranches = v; }
+  // Function start to function end, from the guest's ELF symbols
+  void SetFunctionRanges(std::map<uint64_t, uint64_t> const *v) { FunctionRanges = v; }
 
   void DelayedDisownBuffer() {
     PoolObject.DelayedDisownBuffer();
@@ -79,6 +89,7 @@ private:
   FEXCore::X86Tables::DecodedInst *DecodeInst;
 
   // This is for multiblock data tracking
+  BlockShape Shape{};
   bool SymbolAvailable {false};
   uint64_t EntryPoint {};
   uint64_t MaxCondBranchForward {};
@@ -91,6 +102,9 @@ private:
   std::set<uint64_t> BlocksToDecode;
   std::set<uint64_t> HasBlocks;
   std::set<uint64_t> *ExternalBranches {nullptr};
+  std::map<uint64_t, uint64_t> const *FunctionRanges {nullptr};
+
+  bool FindFunctionRange(uint64_t PC);
 
   // ModRM rm decoding
   using DecodeModRMPtr = void (FEXCore::Frontend::Decoder::*)(X86Tables::DecodedOperand *Operand, X86Tables::ModRMDecoded ModRM);
@@ -16,6 +16,34 @@ DEF_OP(GetHostFlag) {
   auto Op = IROp->C<IR::IROp_GetHostFlag>();
   GD = (*GetSrc<uint64_t*>(Data->SSAData, Op->Header.Args[0]) >> Op->Flag) & 1;
 }
+
+DEF_OP(HostNZCV) {
+  auto Op = IROp->C<IR::IROp_HostNZCV>();
+  const uint32_t Bits = Op->SrcSize * 8;
+  const uint64_t Mask = Bits == 64 ? ~0ULL : ((1ULL << Bits) - 1);
+  const uint64_t SignBit = 1ULL << (Bits - 1);
+
+  const uint64_t Src1 = *GetSrc<uint64_t*>(Data->SSAData, Op->Src1) & Mask;
+  const uint64_t Src2 = *GetSrc<uint64_t*>(Data->SSAData, Op->Src2) & Mask;
+
+  uint64_t Res{};
+  bool C{}, V{};
+  if (Op->IsSub) {
+    Res = (Src1 - Src2) & Mask;
+    // AArch64 carry is set when there is no borrow
+    C = Src1 >= Src2;
+    V = ((Src1 ^ Src2) & (Src1 ^ Res)) & SignBit;
+  }
+  else {
+    Res = (Src1 + Src2) & Mask;
+    C = Res < Src1;
+    V = (~(Src1 ^ Src2) & (Src1 ^ Res)) & SignBit;
+  }
+
+  const bool N = Res & SignBit;
+  const bool Z = Res == 0;
+  GD = (uint64_t(N) << 31) | (uint64_t(Z) << 30) | (uint64_t(C) << 29) | (uint64_t(V) << 28);
+}
 #undef DEF_OP
 
 } // namespace FEXCore::CPU
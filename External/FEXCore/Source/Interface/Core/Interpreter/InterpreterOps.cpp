@@ -117,6 +117,8 @@ constexpr OpHandlerArray InterpreterOpHandlers = [] {
   REGISTER_OP(SIGNALRETURN,           SignalReturn);
   REGISTER_OP(CALLBACKRETURN,         CallbackReturn);
   REGISTER_OP(EXITFUNCTION,           ExitFunction);
+  // The interpreter doesn't link blocks, there is nothing to return to
+  REGISTER_OP(PUSHRETURNSTACK,        NoOp);
   REGISTER_OP(JUMP,                   Jump);
   REGISTER_OP(CONDJUMP,               CondJump);
   REGISTER_OP(SYSCALL,                Syscall);
@@ -139,6 +141,7 @@ constexpr OpHandlerArray InterpreterOpHandlers = [] {
 
   // Flag ops
   REGISTER_OP(GETHOSTFLAG,            GetHostFlag);
+  REGISTER_OP(HOSTNZCV,               HostNZCV);
 
   // Memory ops
   REGISTER_OP(LOADCONTEXT,            LoadContext);
@@ -155,8 +158,8 @@ constexpr OpHandlerArray InterpreterOpHandlers = [] {
   REGISTER_OP(STOREMEM,               StoreMem);
   REGISTER_OP(LOADMEMTSO,             LoadMem);
   REGISTER_OP(STOREMEMTSO,            StoreMem);
-  REGISTER_OP(VLOADMEMELEMENT,        VLoadMemElement);
-  REGISTER_OP(VSTOREMEMELEMENT,       VStoreMemElement);
+  REGISTER_OP(MEMSET,                 MemSet);
+  REGISTER_OP(MEMCPY,                 MemCpy);
   REGISTER_OP(CACHELINECLEAR,         CacheLineClear);
   REGISTER_OP(CACHELINEZERO,          CacheLineZero);
 
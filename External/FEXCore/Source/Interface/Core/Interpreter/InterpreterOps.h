@@ -169,6 +169,7 @@ namespace FEXCore::CPU {
 
   ///< Flag ops
   DEF_OP(GetHostFlag);
+  DEF_OP(HostNZCV);
 
   ///< Memory ops
   DEF_OP(LoadContext);
@@ -183,8 +184,8 @@ namespace FEXCore::CPU {
   DEF_OP(StoreFlag);
   DEF_OP(LoadMem);
   DEF_OP(StoreMem);
-  DEF_OP(VLoadMemElement);
-  DEF_OP(VStoreMemElement);
+  DEF_OP(MemSet);
+  DEF_OP(MemCpy);
   DEF_OP(CacheLineClear);
   DEF_OP(CacheLineZero);
 
@@ -8,7 +8,9 @@ $end_info$
 #include "Interface/Core/Interpreter/InterpreterOps.h"
 #include "Interface/Core/Interpreter/InterpreterDefines.h"
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 
 namespace FEXCore::CPU {
 static inline void CacheLineFlush(char *Addr) {
@@ -225,34 +227,57 @@ DEF_OP(StoreMem) {
   }
 }
 
-DEF_OP(VLoadMemElement) {
-  auto Op = IROp->C<IR::IROp_VLoadMemElement>();
-  void const *MemData = *GetSrc<void const**>(Data->SSAData, Op->Header.Args[0]);
+DEF_OP(MemSet) {
+  auto Op = IROp->C<IR::IROp_MemSet>();
 
-  memcpy(GDP, GetSrc<void*>(Data->SSAData, Op->Header.Args[1]), 16);
-  memcpy(reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(GDP) + (Op->Header.ElementSize * Op->Index)),
-    MemData, Op->Header.ElementSize);
+  uintptr_t MemData = *GetSrc<uintptr_t*>(Data->SSAData, Op->Addr);
+  uint64_t Value = *GetSrc<uint64_t*>(Data->SSAData, Op->Value);
+  uint64_t Length = *GetSrc<uint64_t*>(Data->SSAData, Op->Length);
+  bool Backwards = *GetSrc<uint64_t*>(Data->SSAData, Op->Direction) != 0;
+
+  // Storing downwards fills the same range as storing upwards from the last element
+  if (Backwards && Length) {
+    MemData -= (Length - 1) * Op->Size;
+  }
+
+  if (Op->IsAtomic) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  for (uint64_t i = 0; i < Length; ++i) {
+    // Little endian host, the low bytes of the value are the element
+    memcpy(reinterpret_cast<void*>(MemData + i * Op->Size), &Value, Op->Size);
+  }
+
+  if (Op->IsAtomic) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
 }
 
-DEF_OP(VStoreMemElement) {
-  #define STORE_DATA(x, y) \
-    case x: { \
-      y *MemData = *GetSrc<y**>(Data->SSAData, Op->Header.Args[0]); \
-      memcpy(MemData, &GetSrc<y*>(Data->SSAData, Op->Header.Args[1])[Op->Index], sizeof(y)); \
-      break; \
-    }
+DEF_OP(MemCpy) {
+  auto Op = IROp->C<IR::IROp_MemCpy>();
 
-  auto Op = IROp->C<IR::IROp_VStoreMemElement>();
-  uint8_t OpSize = IROp->Size;
+  uintptr_t Dest = *GetSrc<uintptr_t*>(Data->SSAData, Op->Dest);
+  uintptr_t Src = *GetSrc<uintptr_t*>(Data->SSAData, Op->Src);
+  uint64_t Length = *GetSrc<uint64_t*>(Data->SSAData, Op->Length);
+  int64_t Stride = *GetSrc<uint64_t*>(Data->SSAData, Op->Direction) != 0 ? -Op->Size : Op->Size;
 
-  switch (OpSize) {
-    STORE_DATA(1, uint8_t)
-    STORE_DATA(2, uint16_t)
-    STORE_DATA(4, uint32_t)
-    STORE_DATA(8, uint64_t)
-    default: LOGMAN_MSG_A_FMT("Unhandled StoreMem size"); break;
+  if (Op->IsAtomic) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  // One element at a time so overlapping ranges behave like the guest instruction
+  for (uint64_t i = 0; i < Length; ++i) {
+    uint64_t Element;
+    memcpy(&Element, reinterpret_cast<void const*>(Src), Op->Size);
+    memcpy(reinterpret_cast<void*>(Dest), &Element, Op->Size);
+    Src += Stride;
+    Dest += Stride;
+  }
+
+  if (Op->IsAtomic) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
   }
-  #undef STORE_DATA
 }
 
 DEF_OP(CacheLineClear) {
@@ -47,7 +47,7 @@ DEF_OP(EntrypointOffset) {
     Mask = 0xFFFF'FFFFULL;
   }
 
-  LoadConstant(Dst, Constant & Mask);
+  InsertGuestRIPMove(Dst, Constant & Mask);
 }
 
 DEF_OP(InlineConstant) {
@@ -67,23 +67,87 @@ DEF_OP(ExitFunction) {
 
   Label FullLookup;
 
+  EmitBlockProfileSample();
   ResetStack();
 
   aarch64::Register RipReg;
   uint64_t NewRIP;
 
   if (IsInlineConstant(Op->NewRIP, &NewRIP) || IsInlineEntrypointOffset(Op->NewRIP, &NewRIP)) {
-    Literal l_BranchHost{Dispatcher->ExitFunctionLinkerAddress};
-    Literal l_BranchGuest{NewRIP};
+    auto l_BranchHost = InsertNamedSymbolLiteral(FEXCore::CPU::RelocNamedSymbolLiteral::NamedSymbol::SYMBOL_LITERAL_EXITFUNCTION_LINKER);
+    auto l_BranchGuest = InsertGuestRIPLiteral(NewRIP);
 
-    ldr(x0, &l_BranchHost);
+    ldr(x0, &l_BranchHost.Lit);
     blr(x0);
 
-    place(&l_BranchHost);
-    place(&l_BranchGuest);
+    PlaceNamedSymbolLiteral(l_BranchHost);
+    PlaceGuestRIPLiteral(l_BranchGuest);
   } else {
     RipReg = GetReg<RA_64>(Op->Header.Args[0].ID());
 
+    if (Op->IsReturn) {
+      Label ReturnMiss;
+
+      // Pop the return stack, this happens even on a miss so it stays in step with the guest's calls
+      ldr(TMP1, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)));
+      add(TMP2, STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStack));
+      add(TMP2, TMP2, Operand(TMP1, Shift::LSL, 4));
+      sub(TMP1, TMP1, 1);
+      and_(TMP1, TMP1, FEXCore::Core::RETURN_STACK_SIZE - 1);
+      str(TMP1, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)));
+
+      // Only use the entry if it is for this RIP and isn't empty
+      ldp(TMP3, TMP4, MemOperand(TMP2));
+      cmp(TMP3, RipReg);
+      ccmp(TMP4, 0, ZFlag, Condition::eq);
+      b(&ReturnMiss, Condition::eq);
+      br(TMP4);
+
+      bind(&ReturnMiss);
+    }
+    else {
+      using IndirectBranchCache = LookupCache::IndirectBranchCache;
+      Label L1Lookup;
+      Label Table;
+
+      // Check the inline cache of this site's recent targets
+      adr(TMP1, &Table);
+      for (size_t i = 0; i < IndirectBranchCache::NUM_ENTRIES; ++i) {
+        Label NextEntry;
+        ldp(TMP2, TMP3, MemOperand(TMP1, offsetof(IndirectBranchCache, Entries) + i * sizeof(LookupCache::IndirectBranchCacheEntry)));
+        cmp(TMP2, RipReg);
+        b(&NextEntry, Condition::ne);
+        add(TMP3, TMP1, TMP3);
+        br(TMP3);
+        bind(&NextEntry);
+      }
+
+      // Empty entries land here as well
+      // Only call the linker while there are entries left to fill, sites with more targets than that use the L1 cache
+      const auto MissAddress = GetCursorAddress<uint64_t>();
+      ldr(TMP2, MemOperand(TMP1, offsetof(IndirectBranchCache, EmptyEntries)));
+      cbz(TMP2, &L1Lookup);
+      str(RipReg, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, State.rip)));
+
+      // The linker gets the table through LR, keep it aligned
+      if (GetCursorAddress<uint64_t>() % 8) {
+        nop();
+      }
+      ldr(TMP2, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.IndirectBranchLinker)));
+      blr(TMP2);
+
+      bind(&Table);
+      const auto MissOffset = static_cast<int64_t>(MissAddress - GetCursorAddress<uint64_t>());
+      dc64(MissOffset);
+      dc64(IndirectBranchCache::NUM_ENTRIES);
+      for (size_t i = 0; i < IndirectBranchCache::NUM_ENTRIES; ++i) {
+        dc64(0);
+        dc64(MissOffset);
+      }
+
+      bind(&L1Lookup);
+    }
+
     // L1 Cache
     ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.L1Pointer)));
 
@@ -102,11 +166,50 @@ DEF_OP(ExitFunction) {
   }
 }
 
+DEF_OP(PushReturnStack) {
+  auto Op = IROp->C<IR::IROp_PushReturnStack>();
+
+  uint64_t ReturnRIP;
+  Label LandingPad;
+
+  ldr(TMP1, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)));
+  add(TMP1, TMP1, 1);
+  and_(TMP1, TMP1, FEXCore::Core::RETURN_STACK_SIZE - 1);
+  str(TMP1, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)));
+  add(TMP2, STATE, offsetof(FEXCore::Core::CpuStateFrame, ReturnStack));
+  add(TMP2, TMP2, Operand(TMP1, Shift::LSL, 4));
+
+  if (IsInlineConstant(Op->ReturnRIP, &ReturnRIP) || IsInlineEntrypointOffset(Op->ReturnRIP, &ReturnRIP)) {
+    Label Skip;
+
+    // Landing pad for the RET, this is the same linkable exit as a constant ExitFunction
+    // Once linked it becomes a direct branch to the block after the CALL
+    auto l_BranchHost = InsertNamedSymbolLiteral(FEXCore::CPU::RelocNamedSymbolLiteral::NamedSymbol::SYMBOL_LITERAL_EXITFUNCTION_LINKER);
+    auto l_BranchGuest = InsertGuestRIPLiteral(ReturnRIP);
+
+    b(&Skip);
+    bind(&LandingPad);
+    ldr(x0, &l_BranchHost.Lit);
+    blr(x0);
+
+    PlaceNamedSymbolLiteral(l_BranchHost);
+    PlaceGuestRIPLiteral(l_BranchGuest);
+    bind(&Skip);
+
+    ldr(TMP3, &l_BranchGuest.Lit);
+    adr(TMP4, &LandingPad);
+    stp(TMP3, TMP4, MemOperand(TMP2));
+  } else {
+    // No landing pad without a constant return address, push an empty entry so the stack stays balanced
+    stp(GetReg<RA_64>(Op->ReturnRIP.ID()), xzr, MemOperand(TMP2));
+  }
+}
+
 DEF_OP(Jump) {
   const auto Op = IROp->C<IR::IROp_Jump>();
   const auto ArgID = Op->Args(0).ID();
 
-  PendingTargetLabel = &JumpTargets.try_emplace(ArgID).first->second;
+  PendingTargetLabel = GetBranchTarget(ArgID);
 }
 
 #define GRCMP(Node) (Op->CompareSize == 4 ? GetReg<RA_32>(Node) : GetReg<RA_64>(Node))
@@ -144,7 +247,7 @@ static Condition MapBranchCC(IR::CondClassType Cond) {
 DEF_OP(CondJump) {
   auto Op = IROp->C<IR::IROp_CondJump>();
 
-  Label *TrueTargetLabel = &JumpTargets.try_emplace(Op->TrueBlock.ID()).first->second;
+  Label *TrueTargetLabel = GetBranchTarget(Op->TrueBlock.ID());
 
   uint64_t Const;
   const bool isConst = IsInlineConstant(Op->Cmp2, &Const);
@@ -171,7 +274,7 @@ DEF_OP(CondJump) {
     b(TrueTargetLabel, MapBranchCC(Op->Cond));
   }
 
-  PendingTargetLabel = &JumpTargets.try_emplace(Op->FalseBlock.ID()).first->second;
+  PendingTargetLabel = GetBranchTarget(Op->FalseBlock.ID());
 }
 
 DEF_OP(Syscall) {
@@ -192,18 +295,55 @@ DEF_OP(Syscall) {
     SpillStaticRegs(true, CALLER_GPR_MASK, CALLER_FPR_MASK);
   }
 
+  uint64_t SyscallID{};
+  const bool KnownSyscall = IsInlineConstant(Op->SyscallID, &SyscallID);
+  void *DirectHandler{};
+  uint32_t NumArgs = FEXCore::HLE::SyscallArguments::MAX_ARGS;
+  if (KnownSyscall) {
+    auto SyscallDef = CTX->SyscallHandler->GetSyscallABI(SyscallID);
+    if (CTX->DirectSyscallHandlers) {
+      DirectHandler = SyscallDef.DirectHandler;
+    }
+    NumArgs = SyscallDef.NumArgs;
+  }
+
   uint64_t SPOffset = AlignUp(FEXCore::HLE::SyscallArguments::MAX_ARGS * 8, 16);
   sub(sp, sp, SPOffset);
   for (uint32_t i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++i) {
     if (Op->Header.Args[i].IsInvalid()) continue;
+    if (i == 0 && KnownSyscall) {
+      // The syscall number is inlined once it is known
+      LoadConstant(x0, SyscallID);
+      str(x0, MemOperand(sp, 0));
+      continue;
+    }
     str(GetReg<RA_64>(Op->Header.Args[i].ID()), MemOperand(sp, i * 8));
   }
 
-  ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.SyscallHandlerObj)));
-  ldr(x3, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.SyscallHandlerFunc)));
-  mov(x1, STATE);
-  mov(x2, sp);
-  blr(x3);
+  if (DirectHandler) {
+    // Call the handler directly
+    // X0: Frame
+    // X1-X6: Arguments
+    // Arguments go through the stack so sources that overlap the argument registers aren't overwritten
+    const std::array<vixl::aarch64::Register, FEXCore::HLE::SyscallArguments::MAX_ARGS-1> RegArgs = {{
+      x1, x2, x3, x4, x5, x6
+    }};
+
+    for (uint32_t i = 0; i < NumArgs; ++i) {
+      ldr(RegArgs[i], MemOperand(sp, (i + 1) * 8));
+    }
+
+    mov(x0, STATE);
+    LoadConstant(x7, reinterpret_cast<uintptr_t>(DirectHandler));
+    blr(x7);
+  }
+  else {
+    ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.SyscallHandlerObj)));
+    ldr(x3, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.SyscallHandlerFunc)));
+    mov(x1, STATE);
+    mov(x2, sp);
+    blr(x3);
+  }
 
   add(sp, sp, SPOffset);
 
@@ -385,8 +525,7 @@ DEF_OP(Thunk) {
 
   mov(x0, GetReg<RA_64>(Op->Header.Args[0].ID()));
 
-  auto thunkFn = ThreadState->CTX->ThunkHandler->LookupThunk(Op->ThunkNameHash);
-  LoadConstant(x2, (uintptr_t)thunkFn);
+  InsertNamedThunkRelocation(x2, Op->ThunkNameHash);
   blr(x2);
 
   PopDynamicRegsAndLR();
@@ -401,7 +540,7 @@ DEF_OP(ValidateCode) {
   int idx = 0;
 
   LoadConstant(GetReg<RA_64>(Node), 0);
-  LoadConstant(x0, Entry + Op->Offset);
+  InsertGuestRIPMove(x0, Entry + Op->Offset);
   LoadConstant(x1, 1);
 
   while (len >= 8)
@@ -450,7 +589,7 @@ DEF_OP(RemoveThreadCodeEntry) {
   PushDynamicRegsAndLR();
 
   mov(x0, STATE);
-  LoadConstant(x1, Entry);
+  InsertGuestRIPMove(x1, Entry);
 
   ldr(x2, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.RemoveThreadCodeEntryFromJIT)));
   SpillStaticRegs();
@@ -494,6 +633,7 @@ void Arm64JITCore::RegisterBranchHandlers() {
   REGISTER_OP(SIGNALRETURN,      SignalReturn);
   REGISTER_OP(CALLBACKRETURN,    CallbackReturn);
   REGISTER_OP(EXITFUNCTION,      ExitFunction);
+  REGISTER_OP(PUSHRETURNSTACK,   PushReturnStack);
   REGISTER_OP(JUMP,              Jump);
   REGISTER_OP(CONDJUMP,          CondJump);
   REGISTER_OP(SYSCALL,           Syscall);
@@ -16,10 +16,53 @@ DEF_OP(GetHostFlag) {
   ubfx(GetReg<RA_64>(Node), GetReg<RA_64>(Op->Header.Args[0].ID()), Op->Flag, 1);
 }
 
+DEF_OP(HostNZCV) {
+  auto Op = IROp->C<IR::IROp_HostNZCV>();
+  const auto Src1 = GetReg<RA_64>(Op->Src1.ID());
+  const auto Src2 = GetReg<RA_64>(Op->Src2.ID());
+
+  switch (Op->SrcSize) {
+    case 1:
+    case 2: {
+      // Move the operands to the top of a W register so NZCV matches the narrow operation
+      const uint32_t Shift = 32 - Op->SrcSize * 8;
+      lsl(TMP1.W(), Src1.W(), Shift);
+      lsl(TMP2.W(), Src2.W(), Shift);
+      if (Op->IsSub) {
+        cmp(TMP1.W(), TMP2.W());
+      }
+      else {
+        cmn(TMP1.W(), TMP2.W());
+      }
+      break;
+    }
+    case 4:
+      if (Op->IsSub) {
+        cmp(Src1.W(), Src2.W());
+      }
+      else {
+        cmn(Src1.W(), Src2.W());
+      }
+      break;
+    case 8:
+      if (Op->IsSub) {
+        cmp(Src1, Src2);
+      }
+      else {
+        cmn(Src1, Src2);
+      }
+      break;
+    default: LOGMAN_MSG_A_FMT("Unhandled HostNZCV size: {}", Op->SrcSize);
+  }
+
+  mrs(GetReg<RA_64>(Node), NZCV);
+}
+
 #undef DEF_OP
 void Arm64JITCore::RegisterFlagHandlers() {
 #define REGISTER_OP(op, x) OpHandlers[FEXCore::IR::IROps::OP_##op] = &Arm64JITCore::Op_##x
   REGISTER_OP(GETHOSTFLAG, GetHostFlag);
+  REGISTER_OP(HOSTNZCV,    HostNZCV);
 #undef REGISTER_OP
 }
 }
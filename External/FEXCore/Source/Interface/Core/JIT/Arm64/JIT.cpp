@@ -436,7 +436,11 @@ Arm64JITCore::Arm64JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::Intern
     DispatcherConfig config;
     config.ExitFunctionLink = reinterpret_cast<uintptr_t>(&ExitFunctionLink);
     config.ExitFunctionLinkThis = reinterpret_cast<uintptr_t>(this);
+    config.IndirectBranchLink = reinterpret_cast<uintptr_t>(&IndirectBranchLink);
+    config.TierUpLink = reinterpret_cast<uintptr_t>(&TierUpLink);
     config.StaticRegisterAssignment = ctx->Config.StaticRegisterAllocation;
+    RegionUsage.RegionShift = std::countr_zero(CODE_REGION_SIZE);
+    config.CodeRegions = &RegionUsage;
 
     Dispatcher = std::make_unique<Arm64Dispatcher>(CTX, ThreadState, config);
     DispatchPtr = Dispatcher->DispatchPtr;
@@ -522,7 +526,29 @@ void Arm64JITCore::EmitDetectionString() {
 void Arm64JITCore::ClearCache() {
   // Get the backing code buffer
   auto Buffer = GetBuffer();
+
+  // Everything gets thrown away, region hotness doesn't carry over
+  RegionUsage.Base = 0;
+  for (auto &Hits : RegionUsage.Hits) {
+    Hits = 0;
+  }
+
+  // Return stack landing pads live in the code that is being thrown away
+  ThreadState->CurrentFrame->ReturnStack = {};
+
   if (Dispatcher->SignalHandlerRefCounter == 0) {
+    // Only safe once no first tier code can run anymore
+    TierUpRecords.clear();
+    for (auto &Region : CodeRegions) {
+      Region.TierUpRecords.clear();
+    }
+
+    if (CurrentCodeBuffer == &ActiveCodeRegion) {
+      // Go back to emitting in to the full initial code buffer
+      *Buffer = vixl::CodeBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
+      CurrentCodeBuffer = &InitialCodeBuffer;
+    }
+
     if (!CodeBuffers.empty()) {
       // If we have more than one code buffer we are tracking then walk them and delete
       // This is a cleanup step
@@ -550,6 +576,13 @@ void Arm64JITCore::ClearCache() {
       InitialCodeBuffer = AllocateNewCodeBuffer(InitialCodeBuffer.Size);
       *Buffer = vixl::CodeBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
     }
+
+    if (InitialCodeBuffer.Size == MAX_CODE_SIZE) {
+      // A block must never straddle two regions, evicting one of them would leave the other half of the block behind.
+      // Fill the regions one at a time, EvictCodeRegion moves on to the next unused region while there is one.
+      BeginCodeRegion(0);
+      RegionUsage.Base = reinterpret_cast<uintptr_t>(InitialCodeBuffer.Ptr);
+    }
   }
   else {
     // We have signal handlers that have generated code
@@ -562,6 +595,68 @@ void Arm64JITCore::ClearCache() {
   EmitDetectionString();
 }
 
+bool Arm64JITCore::EvictCodeRegion() {
+  // Regions only exist once the code buffer has stopped growing.
+  // Signal handlers might be executing code in any region, in which case the caller needs to fall back to ClearCache.
+  if (InitialCodeBuffer.Size != MAX_CODE_SIZE ||
+      !CodeBuffers.empty() ||
+      Dispatcher->SignalHandlerRefCounter != 0) {
+    return false;
+  }
+
+  const auto CursorAddress = GetCursorAddress<uintptr_t>();
+  const auto BufferBase = reinterpret_cast<uintptr_t>(InitialCodeBuffer.Ptr);
+  const size_t CurrentRegion = std::min((CursorAddress - BufferBase) / CODE_REGION_SIZE, NUM_CODE_REGIONS - 1);
+
+  // Pick the coldest region, ties go to the one that was written longest ago
+  size_t Victim = (CurrentRegion + 1) % NUM_CODE_REGIONS;
+  for (size_t i = 2; i < NUM_CODE_REGIONS; ++i) {
+    const size_t Region = (CurrentRegion + i) % NUM_CODE_REGIONS;
+    if (RegionUsage.Hits[Region] < RegionUsage.Hits[Victim]) {
+      Victim = Region;
+    }
+  }
+
+  // Age every region so blocks that were only hot in the past don't pin their region forever
+  for (auto &Hits : RegionUsage.Hits) {
+    Hits >>= 1;
+  }
+  RegionUsage.Hits[Victim] = 0;
+  // Nothing can reach the victim's first tier code anymore once its blocks are erased below
+  CodeRegions[Victim].TierUpRecords.clear();
+
+  // This also resets the indirect branch cache entries elsewhere that point in to the region, they are block links of their target
+  auto RegionBase = InitialCodeBuffer.Ptr + Victim * CODE_REGION_SIZE;
+  ThreadState->LookupCache->EraseHostCodeRange(reinterpret_cast<uintptr_t>(RegionBase), reinterpret_cast<uintptr_t>(RegionBase) + CODE_REGION_SIZE);
+  ThreadState->CurrentFrame->ReturnStack = {};
+
+  BeginCodeRegion(Victim);
+  EmitDetectionString();
+
+  return true;
+}
+
+void Arm64JITCore::BeginCodeRegion(size_t Region) {
+  ActiveCodeRegion = CodeBuffer {
+    .Ptr = InitialCodeBuffer.Ptr + Region * CODE_REGION_SIZE,
+    .Size = CODE_REGION_SIZE,
+  };
+  CurrentCodeBuffer = &ActiveCodeRegion;
+  *GetBuffer() = vixl::CodeBuffer(ActiveCodeRegion.Ptr, ActiveCodeRegion.Size);
+}
+
+void Arm64JITCore::MarkCodeRegionUsed(uintptr_t HostCode) {
+  // Same check as the dispatcher does on lookups
+  if (!RegionUsage.Base) {
+    return;
+  }
+
+  const size_t Region = (HostCode - RegionUsage.Base) >> RegionUsage.RegionShift;
+  if (Region < NUM_CODE_REGIONS) {
+    ++RegionUsage.Hits[Region];
+  }
+}
+
 Arm64JITCore::~Arm64JITCore() {
   for (auto CodeBuffer : CodeBuffers) {
     FreeCodeBuffer(CodeBuffer);
@@ -715,7 +810,8 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
 
   // Fairly excessive buffer range to make sure we don't overflow
   uint32_t BufferRange = SSACount * 16;
-  if ((GetCursorOffset() + BufferRange) > CurrentCodeBuffer->Size) {
+  if ((GetCursorOffset() + BufferRange) > CurrentCodeBuffer->Size &&
+      !EvictCodeRegion()) {
     ThreadState->CTX->ClearCodeCache(ThreadState, false);
   }
 
@@ -741,6 +837,14 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
 
   GuestEntry = GetCursorAddress<uint64_t>();
 
+  // Loops back to the entry block branch directly, unless the entry has checks that need to run on every pass.
+  // Those loops leave their spill slots and start over at the top, so single stepping and tier up still see each iteration.
+  aarch64::Label EntryChecks;
+  aarch64::Label EntryBackEdge;
+  bind(&EntryChecks);
+  EntryBlockID = IR->GetHeader()->Blocks.ID();
+  EntryBackEdgeLabel = (CTX->GetGdbServerStatus() || TierUpThreshold) ? &EntryBackEdge : nullptr;
+
   if (CTX->GetGdbServerStatus()) {
     aarch64::Label RunBlock;
 
@@ -756,7 +860,7 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
     cbz(w0, &RunBlock);
     {
       // Make sure RIP is syncronized to the context
-      LoadConstant(x0, Entry);
+      InsertGuestRIPMove(x0, Entry);
       str(x0, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, State.rip)));
 
       // Stop the thread
@@ -768,6 +872,11 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
 
   //LOGMAN_THROW_A_FMT(RAData->HasFullRA(), "Arm64 JIT only works with RA");
 
+  // Needs to happen before the stack is touched, the linker continues at the top of the new code
+  if (TierUpThreshold) {
+    EmitTierUpCounter();
+  }
+
   SpillSlots = RAData->SpillSlots();
 
   if (SpillSlots) {
@@ -779,6 +888,11 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
     }
   }
 
+  SamplingData = CTX->BlockData ? CTX->BlockData->GetBlockData(Entry) : nullptr;
+  if (SamplingData) {
+    EmitBlockProfileEntry();
+  }
+
   PendingTargetLabel = nullptr;
 
   for (auto [BlockNode, BlockHeader] : IR->GetBlocks()) {
@@ -823,6 +937,13 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
   }
   PendingTargetLabel = nullptr;
 
+  if (EntryBackEdge.IsLinked()) {
+    bind(&EntryBackEdge);
+    ResetStack();
+    b(&EntryChecks);
+  }
+  EntryBackEdgeLabel = nullptr;
+
   FinalizeCode();
 
   auto CodeEnd = GetCursorAddress<uint64_t>();
@@ -833,11 +954,151 @@ void *Arm64JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IR
     DebugData->Relocations = &Relocations;
   }
 
+  if (SamplingData) {
+    CTX->BlockData->SetHostCodeSize(Entry, reinterpret_cast<uintptr_t>(CodeEnd) - reinterpret_cast<uintptr_t>(GuestEntry));
+    SamplingData = nullptr;
+  }
+
   this->IR = nullptr;
 
   return reinterpret_cast<void*>(GuestEntry);
 }
 
+void *Arm64JITCore::RelocateJITObjectCode(uint64_t Entry, CodeSerialize::CodeObjectFileSection const *SerializationData) {
+  const auto *Data = SerializationData->Data;
+  const size_t HostCodeLength = Data->HostCodeLength;
+
+  if ((GetCursorOffset() + HostCodeLength) > CurrentCodeBuffer->Size &&
+      !EvictCodeRegion()) {
+    ThreadState->CTX->ClearCodeCache(ThreadState, false);
+  }
+
+  GuestEntry = GetCursorAddress<uint64_t>();
+  const auto CursorEntry = GetCursorOffset();
+
+  // Copy the unrelocated code in to the code buffer, relocations are then emitted over the top of it
+  GetBuffer()->EmitData(SerializationData->HostCode, HostCodeLength);
+  const auto CursorEnd = GetCursorOffset();
+
+  if (!ApplyRelocations(Entry, Data->OriginalGuestRIP, CursorEntry, SerializationData->NumRelocations, SerializationData->Relocations)) {
+    // Something couldn't be resolved in this process, rewind and let the caller compile the block instead
+    GetBuffer()->SetCursorOffset(CursorEntry);
+    return nullptr;
+  }
+
+  GetBuffer()->SetCursorOffset(CursorEnd);
+
+  CPU.EnsureIAndDCacheCoherency(reinterpret_cast<void*>(GuestEntry), HostCodeLength);
+
+  return reinterpret_cast<void*>(GuestEntry);
+}
+
+Label *Arm64JITCore::GetBranchTarget(IR::NodeID Node) {
+  if (EntryBackEdgeLabel && Node == EntryBlockID) {
+    return EntryBackEdgeLabel;
+  }
+
+  return &JumpTargets.try_emplace(Node).first->second;
+}
+
+// Restores a direct branch link back to the call in to the linker
+static void DelinkBranch(LookupCache::BlockLinkRecord const &Record) {
+  uintptr_t branch = Record.HostLink - 8;
+
+  vixl::aarch64::Assembler emit((uint8_t*)(branch), 24);
+  vixl::CodeBufferCheckScope scope(&emit, 24, vixl::CodeBufferCheckScope::kDontReserveBufferSpace, vixl::CodeBufferCheckScope::kNoAssert);
+  Literal l_BranchHost{Record.DelinkerData};
+  emit.ldr(x0, &l_BranchHost);
+  emit.blr(x0);
+  emit.place(&l_BranchHost);
+  emit.FinalizeCode();
+  vixl::aarch64::CPU::EnsureIAndDCacheCoherency((void*)branch, 24);
+}
+
+// Restores a soft link through the record's pointer back to the linker
+static void DelinkRecord(LookupCache::BlockLinkRecord const &Record) {
+  reinterpret_cast<uint64_t*>(Record.HostLink)[0] = Record.DelinkerData;
+}
+
+void Arm64JITCore::EmitTierUpCounter() {
+  using namespace aarch64;
+  aarch64::Label Continue;
+
+  auto &Records = CurrentCodeBuffer == &ActiveCodeRegion ?
+    CodeRegions[(ActiveCodeRegion.Ptr - InitialCodeBuffer.Ptr) / CODE_REGION_SIZE].TierUpRecords :
+    TierUpRecords;
+
+  auto Record = &Records.emplace_back(TierUpRecord {
+    .GuestRIP = Entry,
+    .Remaining = TierUpThreshold,
+  });
+
+  // Count down the block entries left until the block gets recompiled
+  LoadConstant(TMP1, reinterpret_cast<uintptr_t>(Record));
+  ldr(TMP2.W(), MemOperand(TMP1, offsetof(TierUpRecord, Remaining)));
+  sub(TMP2.W(), TMP2.W(), 1);
+  str(TMP2.W(), MemOperand(TMP1, offsetof(TierUpRecord, Remaining)));
+  cbnz(TMP2.W(), &Continue);
+
+  // The linker gets the record through LR and never returns
+  ldr(TMP2, MemOperand(STATE, offsetof(FEXCore::Core::CpuStateFrame, Pointers.AArch64.TierUpLinker)));
+  mov(lr, TMP1);
+  br(TMP2);
+
+  bind(&Continue);
+}
+
+void Arm64JITCore::EmitBlockProfileEntry() {
+  using namespace aarch64;
+
+  // Plain load/add/store, lost increments from racing threads are acceptable for a profile
+  LoadConstant(TMP1, reinterpret_cast<uintptr_t>(SamplingData));
+  ldr(TMP2, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalCalls)));
+  add(TMP2, TMP2, 1);
+  str(TMP2, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalCalls)));
+
+  if (CTX->BlockData->SampleCycles()) {
+    mrs(TMP2, CNTVCT_EL0);
+    str(TMP2, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Start)));
+  }
+}
+
+void Arm64JITCore::EmitBlockProfileSample() {
+  using namespace aarch64;
+
+  if (!SamplingData || !CTX->BlockData->SampleCycles()) {
+    return;
+  }
+
+  LoadConstant(TMP1, reinterpret_cast<uintptr_t>(SamplingData));
+
+  // Calculate time spent in block
+  mrs(TMP2, CNTVCT_EL0);
+  ldr(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Start)));
+  sub(TMP2, TMP2, TMP3);
+
+  // Add time to total time
+  ldr(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalTime)));
+  add(TMP3, TMP3, TMP2);
+  str(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalTime)));
+
+  ldr(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalSamples)));
+  add(TMP3, TMP3, 1);
+  str(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, TotalSamples)));
+
+  // Calculate min
+  ldr(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Min)));
+  cmp(TMP3, TMP2);
+  csel(TMP3, TMP2, TMP3, Condition::hi);
+  str(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Min)));
+
+  // Calculate max
+  ldr(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Max)));
+  cmp(TMP3, TMP2);
+  csel(TMP3, TMP2, TMP3, Condition::lo);
+  str(TMP3, MemOperand(TMP1, offsetof(BlockSamplingData::BlockData, Max)));
+}
+
 uint64_t Arm64JITCore::ExitFunctionLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, uint64_t *record) {
   auto Thread = Frame->Thread;
   auto GuestRip = record[1];
@@ -850,6 +1111,9 @@ uint64_t Arm64JITCore::ExitFunctionLink(Arm64JITCore *core, FEXCore::Core::CpuSt
     return core->Dispatcher->AbsoluteLoopTopAddress;
   }
 
+  // Blocks that keep getting linked to keep their code region from being evicted
+  core->MarkCodeRegionUsed(HostCode);
+
   uintptr_t branch = (uintptr_t)(record) - 8;
   auto LinkerAddress = core->Dispatcher->ExitFunctionLinkerAddress;
 
@@ -864,29 +1128,54 @@ uint64_t Arm64JITCore::ExitFunctionLink(Arm64JITCore *core, FEXCore::Core::CpuSt
     vixl::aarch64::CPU::EnsureIAndDCacheCoherency((void*)branch, 24);
 
     // Add de-linking handler
-    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [branch, LinkerAddress]{
-      vixl::aarch64::Assembler emit((uint8_t*)(branch), 24);
-      vixl::CodeBufferCheckScope scope(&emit, 24, vixl::CodeBufferCheckScope::kDontReserveBufferSpace, vixl::CodeBufferCheckScope::kNoAssert);
-      Literal l_BranchHost{LinkerAddress};
-      emit.ldr(x0, &l_BranchHost);
-      emit.blr(x0);
-      emit.place(&l_BranchHost);
-      emit.FinalizeCode();
-      vixl::aarch64::CPU::EnsureIAndDCacheCoherency((void*)branch, 24);
+    Thread->LookupCache->AddBlockLink(GuestRip, LookupCache::BlockLinkRecord {
+      .HostLink = (uintptr_t)record,
+      .DelinkerData = LinkerAddress,
+      .Delinker = DelinkBranch,
     });
   } else {
     // fallback case - do a soft-er link by patching the pointer
     record[0] = HostCode;
 
     // Add de-linking handler
-    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [record, LinkerAddress]{
-      record[0] = LinkerAddress;
+    Thread->LookupCache->AddBlockLink(GuestRip, LookupCache::BlockLinkRecord {
+      .HostLink = (uintptr_t)record,
+      .DelinkerData = LinkerAddress,
+      .Delinker = DelinkRecord,
     });
   }
 
   return HostCode;
 }
 
+uint64_t Arm64JITCore::IndirectBranchLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, LookupCache::IndirectBranchCache *Cache) {
+  // The branch already stored the target RIP
+  auto HostCode = Frame->Thread->LookupCache->LinkIndirectBranchCache(Cache, Frame->State.rip);
+
+  if (!HostCode) {
+    return core->Dispatcher->AbsoluteLoopTopAddress;
+  }
+
+  core->MarkCodeRegionUsed(HostCode);
+
+  return HostCode;
+}
+
+uint64_t Arm64JITCore::TierUpLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, TierUpRecord *Record) {
+  // Compiling can clear or evict the code and the record along with it
+  const uint64_t GuestRIP = Record->GuestRIP;
+  auto HostCode = core->CTX->TierUpBlock(Frame, GuestRIP);
+
+  if (!HostCode) {
+    // The first tier code might be gone as well, start the block over through the dispatcher.
+    // Its counter wrapped around so this won't retry soon.
+    Frame->State.rip = GuestRIP;
+    return core->Dispatcher->AbsoluteLoopTopAddress;
+  }
+
+  return HostCode;
+}
+
 std::unique_ptr<CPUBackend> CreateArm64JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
   return std::make_unique<Arm64JITCore>(ctx, Thread);
 }
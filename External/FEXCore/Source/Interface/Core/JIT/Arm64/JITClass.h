@@ -7,7 +7,9 @@ $end_info$
 #pragma once
 
 #include "Interface/Core/ArchHelpers/Arm64Emitter.h"
+#include "Interface/Core/BlockSamplingData.h"
 #include "Interface/Core/Dispatcher/Dispatcher.h"
+#include "Interface/Core/LookupCache.h"
 
 #include "aarch64/assembler-aarch64.h"
 #include "aarch64/disasm-aarch64.h"
@@ -17,6 +19,10 @@ $end_info$
 #include <FEXCore/IR/IR.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
 
+#include <array>
+#include <bit>
+#include <deque>
+
 #define STATE x28
 #define TMP1 x0
 #define TMP2 x1
@@ -53,11 +59,14 @@ public:
                                   FEXCore::Core::DebugData *DebugData,
                                   FEXCore::IR::RegisterAllocationData *RAData) override;
 
+  [[nodiscard]] void *RelocateJITObjectCode(uint64_t Entry, CodeSerialize::CodeObjectFileSection const *SerializationData) override;
+
   [[nodiscard]] void *MapRegion(void* HostPtr, uint64_t, uint64_t) override { return HostPtr; }
 
   [[nodiscard]] bool NeedsOpDispatch() override { return true; }
 
   void ClearCache() override;
+  bool CanBeReused() const override { return Dispatcher->SignalHandlerRefCounter == 0; }
 
   static constexpr size_t INITIAL_CODE_SIZE = 1024 * 1024 * 16;
   [[nodiscard]] CodeBuffer AllocateNewCodeBuffer(size_t Size);
@@ -81,6 +90,10 @@ private:
   uint64_t Entry;
 
   std::map<IR::NodeID, aarch64::Label> JumpTargets;
+  // Set while compiling code with block entry checks, back edges to the entry block go through it instead
+  Label *EntryBackEdgeLabel{};
+  IR::NodeID EntryBlockID{};
+  Label *GetBranchTarget(IR::NodeID Node);
 
   /**
    * @name Register Allocation
@@ -167,13 +180,52 @@ private:
 
   // We don't want to mvoe above 128MB atm because that means we will have to encode longer jumps
   static constexpr size_t MAX_CODE_SIZE = 1024 * 1024 * 128;
+
+  // Once the initial code buffer has grown to MAX_CODE_SIZE it doesn't get flushed when full anymore.
+  // Instead it is treated as a set of regions and only the coldest region gets evicted and reused.
+  // Code is always emitted in to a single region at a time so no block crosses a region boundary.
+  static constexpr size_t NUM_CODE_REGIONS = CodeRegionUsage::NUM_REGIONS;
+  static constexpr size_t CODE_REGION_SIZE = MAX_CODE_SIZE / NUM_CODE_REGIONS;
+  static_assert(std::has_single_bit(CODE_REGION_SIZE), "The dispatcher finds a block's region with a shift");
+
+  struct CodeRegion {
+    // Tier up records of the first tier blocks in this region, released with the region's code
+    std::deque<TierUpRecord> TierUpRecords;
+  };
+  std::array<CodeRegion, NUM_CODE_REGIONS> CodeRegions{};
+  // Hits are halved on every eviction so blocks that were only hot in the past don't pin their region forever
+  CodeRegionUsage RegionUsage{};
+
+  // Describes the region that is being emitted in to when it isn't the full initial code buffer
+  CodeBuffer ActiveCodeRegion{};
+
+  /**
+   * @brief Evicts the coldest code region and starts emitting code in to it
+   *
+   * @return false if regions can't be used right now and the whole cache needs to be cleared instead
+   */
+  bool EvictCodeRegion();
+  // Points the emitter at the start of the given region of the initial code buffer
+  void BeginCodeRegion(size_t Region);
+  void MarkCodeRegionUsed(uintptr_t HostCode);
   static constexpr size_t MAX_DISPATCHER_CODE_SIZE = 4096 * 2;
 
 #if DEBUG
   vixl::aarch64::Disassembler Disasm;
 #endif
 
+  // Counters for the block being compiled when BlockProfile is enabled
+  BlockSamplingData::BlockData *SamplingData{};
+  void EmitBlockProfileEntry();
+  void EmitTierUpCounter();
+  // Stable addresses, first tier code points directly at its record
+  // Only used while the code buffer is still growing, CodeRegion holds them afterwards
+  std::deque<TierUpRecord> TierUpRecords;
+  void EmitBlockProfileSample();
+
   static uint64_t ExitFunctionLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, uint64_t *record);
+  static uint64_t IndirectBranchLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, LookupCache::IndirectBranchCache *Cache);
+  static uint64_t TierUpLink(Arm64JITCore *core, FEXCore::Core::CpuStateFrame *Frame, TierUpRecord *Record);
 
   // This is purely a debugging aid for developers to see if they are in JIT code space when inspecting raw memory
   void EmitDetectionString();
@@ -274,6 +326,7 @@ private:
   DEF_OP(SignalReturn);
   DEF_OP(CallbackReturn);
   DEF_OP(ExitFunction);
+  DEF_OP(PushReturnStack);
   DEF_OP(Jump);
   DEF_OP(CondJump);
   DEF_OP(Syscall);
@@ -296,6 +349,7 @@ private:
 
   ///< Flag ops
   DEF_OP(GetHostFlag);
+  DEF_OP(HostNZCV);
 
   ///< Memory ops
   DEF_OP(LoadContext);
@@ -314,8 +368,8 @@ private:
   DEF_OP(StoreMemTSO);
   DEF_OP(ParanoidLoadMemTSO);
   DEF_OP(ParanoidStoreMemTSO);
-  DEF_OP(VLoadMemElement);
-  DEF_OP(VStoreMemElement);
+  DEF_OP(MemSet);
+  DEF_OP(MemCpy);
   DEF_OP(CacheLineClear);
   DEF_OP(CacheLineZero);
 
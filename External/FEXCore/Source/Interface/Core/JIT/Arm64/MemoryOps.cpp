@@ -981,12 +981,169 @@ DEF_OP(ParanoidStoreMemTSO) {
   }
 }
 
-DEF_OP(VLoadMemElement) {
-  LOGMAN_MSG_A_FMT("Unimplemented");
+DEF_OP(MemSet) {
+  auto Op = IROp->C<IR::IROp_MemSet>();
+  const uint8_t Size = Op->Size;
+  // Two vector registers worth of elements are stored per iteration
+  const uint32_t WideElements = 32 / Size;
+
+  auto MemReg = GetReg<RA_64>(Op->Addr.ID());
+  auto Value = GetReg<RA_64>(Op->Value.ID());
+  auto Length = GetReg<RA_64>(Op->Length.ID());
+  auto Direction = GetReg<RA_64>(Op->Direction.ID());
+
+  if (Op->IsAtomic) {
+    dmb(InnerShareable, BarrierAll);
+  }
+
+  // TMP1 = Lowest address to store to
+  // TMP2 = Number of elements remaining
+  Label Forward;
+  mov(TMP1, MemReg);
+  mov(TMP2, Length);
+  cbz(Direction, &Forward);
+  // Storing downwards fills the same range as storing upwards from the last element
+  sub(TMP1, TMP1, Operand(TMP2, LSL, (int)std::log2(Size)));
+  add(TMP1, TMP1, Size);
+  bind(&Forward);
+
+  switch (Size) {
+    case 1: dup(VTMP1.V16B(), Value.W()); break;
+    case 2: dup(VTMP1.V8H(), Value.W()); break;
+    case 4: dup(VTMP1.V4S(), Value.W()); break;
+    case 8: dup(VTMP1.V2D(), Value); break;
+    default: LOGMAN_MSG_A_FMT("Unhandled MemSet size: {}", Size);
+  }
+
+  Label WideLoop;
+  Label TailLoop;
+  Label Done;
+  bind(&WideLoop);
+  cmp(TMP2, WideElements);
+  b(&TailLoop, Condition::lo);
+  stp(VTMP1.Q(), VTMP1.Q(), MemOperand(TMP1, 32, PostIndex));
+  sub(TMP2, TMP2, WideElements);
+  b(&WideLoop);
+
+  bind(&TailLoop);
+  cbz(TMP2, &Done);
+  switch (Size) {
+    case 1: strb(Value.W(), MemOperand(TMP1, 1, PostIndex)); break;
+    case 2: strh(Value.W(), MemOperand(TMP1, 2, PostIndex)); break;
+    case 4: str(Value.W(), MemOperand(TMP1, 4, PostIndex)); break;
+    case 8: str(Value, MemOperand(TMP1, 8, PostIndex)); break;
+  }
+  sub(TMP2, TMP2, 1);
+  b(&TailLoop);
+  bind(&Done);
+
+  if (Op->IsAtomic) {
+    dmb(InnerShareable, BarrierAll);
+  }
 }
 
-DEF_OP(VStoreMemElement) {
-  LOGMAN_MSG_A_FMT("Unimplemented");
+DEF_OP(MemCpy) {
+  auto Op = IROp->C<IR::IROp_MemCpy>();
+  const uint8_t Size = Op->Size;
+  const uint32_t WideElements = 32 / Size;
+
+  auto DestReg = GetReg<RA_64>(Op->Dest.ID());
+  auto SrcReg = GetReg<RA_64>(Op->Src.ID());
+  auto Length = GetReg<RA_64>(Op->Length.ID());
+  auto Direction = GetReg<RA_64>(Op->Direction.ID());
+
+  if (Op->IsAtomic) {
+    dmb(InnerShareable, BarrierAll);
+  }
+
+  // TMP1 = Dest, TMP2 = Src, TMP3 = Number of elements remaining
+  mov(TMP1, DestReg);
+  mov(TMP2, SrcReg);
+  mov(TMP3, Length);
+
+  auto LoadElement = [this, Size](int32_t Stride) {
+    switch (Size) {
+      case 1: ldrb(TMP4.W(), MemOperand(TMP2, Stride, PostIndex)); break;
+      case 2: ldrh(TMP4.W(), MemOperand(TMP2, Stride, PostIndex)); break;
+      case 4: ldr(TMP4.W(), MemOperand(TMP2, Stride, PostIndex)); break;
+      case 8: ldr(TMP4, MemOperand(TMP2, Stride, PostIndex)); break;
+      default: LOGMAN_MSG_A_FMT("Unhandled MemCpy size: {}", Size);
+    }
+  };
+
+  auto StoreElement = [this, Size](int32_t Stride) {
+    switch (Size) {
+      case 1: strb(TMP4.W(), MemOperand(TMP1, Stride, PostIndex)); break;
+      case 2: strh(TMP4.W(), MemOperand(TMP1, Stride, PostIndex)); break;
+      case 4: str(TMP4.W(), MemOperand(TMP1, Stride, PostIndex)); break;
+      case 8: str(TMP4, MemOperand(TMP1, Stride, PostIndex)); break;
+    }
+  };
+
+  Label Backward;
+  Label ForwardWide;
+  Label ForwardTail;
+  Label BackwardWide;
+  Label BackwardWideEnd;
+  Label BackwardTail;
+  Label Done;
+
+  cbnz(Direction, &Backward);
+
+  // When Dest is less than 32 bytes after Src, a wide copy would read source bytes before
+  // the guest semantics have overwritten them. Copy one element at a time instead.
+  sub(TMP4, TMP1, TMP2);
+  cmp(TMP4, 32);
+  b(&ForwardTail, Condition::lo);
+
+  bind(&ForwardWide);
+  cmp(TMP3, WideElements);
+  b(&ForwardTail, Condition::lo);
+  ldp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP2, 32, PostIndex));
+  stp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP1, 32, PostIndex));
+  sub(TMP3, TMP3, WideElements);
+  b(&ForwardWide);
+
+  bind(&ForwardTail);
+  cbz(TMP3, &Done);
+  LoadElement(Size);
+  StoreElement(Size);
+  sub(TMP3, TMP3, 1);
+  b(&ForwardTail);
+
+  bind(&Backward);
+  // Same as forward, but with Dest less than 32 bytes before Src
+  sub(TMP4, TMP2, TMP1);
+  cmp(TMP4, 32);
+  b(&BackwardTail, Condition::lo);
+
+  // Point at the start of the 32 byte chunk that ends with the current element
+  sub(TMP1, TMP1, 32 - Size);
+  sub(TMP2, TMP2, 32 - Size);
+  bind(&BackwardWide);
+  cmp(TMP3, WideElements);
+  b(&BackwardWideEnd, Condition::lo);
+  ldp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP2, -32, PostIndex));
+  stp(VTMP1.Q(), VTMP2.Q(), MemOperand(TMP1, -32, PostIndex));
+  sub(TMP3, TMP3, WideElements);
+  b(&BackwardWide);
+
+  bind(&BackwardWideEnd);
+  add(TMP1, TMP1, 32 - Size);
+  add(TMP2, TMP2, 32 - Size);
+
+  bind(&BackwardTail);
+  cbz(TMP3, &Done);
+  LoadElement(-Size);
+  StoreElement(-Size);
+  sub(TMP3, TMP3, 1);
+  b(&BackwardTail);
+
+  bind(&Done);
+
+  if (Op->IsAtomic) {
+    dmb(InnerShareable, BarrierAll);
+  }
 }
 
 DEF_OP(CacheLineClear) {
@@ -1049,8 +1206,8 @@ void Arm64JITCore::RegisterMemoryHandlers() {
     REGISTER_OP(LOADMEMTSO,          LoadMemTSO);
     REGISTER_OP(STOREMEMTSO,         StoreMemTSO);
   }
-  REGISTER_OP(VLOADMEMELEMENT,     VLoadMemElement);
-  REGISTER_OP(VSTOREMEMELEMENT,    VStoreMemElement);
+  REGISTER_OP(MEMSET,              MemSet);
+  REGISTER_OP(MEMCPY,              MemCpy);
   REGISTER_OP(CACHELINECLEAR,      CacheLineClear);
   REGISTER_OP(CACHELINEZERO,       CacheLineZero);
 #undef REGISTER_OP
@@ -76,6 +76,7 @@ DEF_OP(ExitFunction) {
   Label FullLookup;
   auto Op = IROp->C<IR::IROp_ExitFunction>();
 
+  EmitBlockProfileSample();
 
   if (SpillSlots) {
     add(rsp, SpillSlots * 16);
@@ -97,6 +98,69 @@ DEF_OP(ExitFunction) {
   } else {
     Xbyak::Reg RipReg = GetSrc<RA_64>(Op->NewRIP.ID());
 
+    if (Op->IsReturn) {
+      Label ReturnMiss;
+
+      // Pop the return stack, this happens even on a miss so it stays in step with the guest's calls
+      mov(TMP1, qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)]);
+      mov(TMP2, TMP1);
+      sub(TMP1, 1);
+      and_(TMP1, FEXCore::Core::RETURN_STACK_SIZE - 1);
+      mov(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)], TMP1);
+      shl(TMP2, 4);
+
+      // Only use the entry if it is for this RIP and isn't empty
+      Xbyak::RegExp Entry = STATE + TMP2 + offsetof(FEXCore::Core::CpuStateFrame, ReturnStack);
+      cmp(qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, GuestRIP)], RipReg);
+      jne(ReturnMiss);
+      mov(TMP3, qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, HostCode)]);
+      test(TMP3, TMP3);
+      jz(ReturnMiss);
+      jmp(TMP3);
+
+      L(ReturnMiss);
+    }
+    else {
+      using IndirectBranchCache = LookupCache::IndirectBranchCache;
+      Label L1Lookup;
+      Label Table;
+
+      // Check the inline cache of this site's recent targets
+      lea(TMP1, ptr[rip + Table]);
+      for (size_t i = 0; i < IndirectBranchCache::NUM_ENTRIES; ++i) {
+        Label NextEntry;
+        const auto EntryOffset = offsetof(IndirectBranchCache, Entries) + i * sizeof(LookupCache::IndirectBranchCacheEntry);
+        cmp(qword [TMP1 + EntryOffset + offsetof(LookupCache::IndirectBranchCacheEntry, GuestRIP)], RipReg);
+        jne(NextEntry);
+        mov(TMP2, qword [TMP1 + EntryOffset + offsetof(LookupCache::IndirectBranchCacheEntry, HostOffset)]);
+        add(TMP2, TMP1);
+        jmp(TMP2);
+        L(NextEntry);
+      }
+
+      // Empty entries land here as well
+      // Only call the linker while there are entries left to fill, sites with more targets than that use the L1 cache
+      const auto MissAddress = getCurr<uint64_t>();
+      cmp(qword [TMP1 + offsetof(IndirectBranchCache, EmptyEntries)], 0);
+      je(L1Lookup, T_NEAR);
+      mov(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, State.rip)], RipReg);
+
+      // The linker gets the table through rax
+      jmp(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, Pointers.X86.IndirectBranchLinker)]);
+
+      align(8);
+      L(Table);
+      const auto MissOffset = static_cast<int64_t>(MissAddress - getCurr<uint64_t>());
+      dq(MissOffset);
+      dq(IndirectBranchCache::NUM_ENTRIES);
+      for (size_t i = 0; i < IndirectBranchCache::NUM_ENTRIES; ++i) {
+        dq(0);
+        dq(MissOffset);
+      }
+
+      L(L1Lookup);
+    }
+
     // L1 Cache
     mov(rcx, qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, Pointers.X86.L1Pointer)]);
 
@@ -115,17 +179,55 @@ DEF_OP(ExitFunction) {
     mov(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, State.rip)], RipReg);
     jmp(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, Pointers.X86.DispatcherLoopTop)]);
   }
+}
+
+DEF_OP(PushReturnStack) {
+  auto Op = IROp->C<IR::IROp_PushReturnStack>();
+
+  uint64_t ReturnRIP;
+
+  mov(TMP1, qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)]);
+  add(TMP1, 1);
+  and_(TMP1, FEXCore::Core::RETURN_STACK_SIZE - 1);
+  mov(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, ReturnStackIndex)], TMP1);
+  shl(TMP1, 4);
+
+  Xbyak::RegExp Entry = STATE + TMP1 + offsetof(FEXCore::Core::CpuStateFrame, ReturnStack);
+
+  if (IsInlineConstant(Op->ReturnRIP, &ReturnRIP) || IsInlineEntrypointOffset(Op->ReturnRIP, &ReturnRIP)) {
+    Label LandingPad;
+    Label Skip;
+    Label l_BranchHost;
+    Label l_BranchGuest;
+
+    // Landing pad for the RET, this is the same linkable exit as a constant ExitFunction
+    jmp(Skip, T_NEAR);
+    L(LandingPad);
+    lea(rax, ptr[rip + l_BranchHost]);
+    jmp(qword[rax]);
+
+    L(l_BranchHost);
+    dq(Dispatcher->ExitFunctionLinkerAddress);
+    L(l_BranchGuest);
+    dq(ReturnRIP);
+    L(Skip);
 
-#ifdef BLOCKSTATS
-  ExitBlock();
-#endif
+    mov(TMP2, qword [rip + l_BranchGuest]);
+    mov(qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, GuestRIP)], TMP2);
+    lea(TMP2, ptr[rip + LandingPad]);
+    mov(qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, HostCode)], TMP2);
+  } else {
+    // No landing pad without a constant return address, push an empty entry so the stack stays balanced
+    mov(qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, GuestRIP)], GetSrc<RA_64>(Op->ReturnRIP.ID()));
+    mov(qword [Entry + offsetof(FEXCore::Core::ReturnStackEntry, HostCode)], 0);
+  }
 }
 
 DEF_OP(Jump) {
   const auto Op = IROp->C<IR::IROp_Jump>();
   const auto ArgID = Op->Args(0).ID();
 
-  PendingTargetLabel = &JumpTargets.try_emplace(ArgID).first->second;
+  PendingTargetLabel = GetBranchTarget(ArgID);
 }
 
 #define GRCMP(Node) (Op->CompareSize == 4 ? GetSrc<RA_32>(Node) : GetSrc<RA_64>(Node))
@@ -133,7 +235,7 @@ DEF_OP(Jump) {
 DEF_OP(CondJump) {
   auto Op = IROp->C<IR::IROp_CondJump>();
 
-  Label *TrueTargetLabel = &JumpTargets.try_emplace(Op->TrueBlock.ID()).first->second;
+  Label *TrueTargetLabel = GetBranchTarget(Op->TrueBlock.ID());
 
   if (IsGPR(Op->Cmp1.ID())) {
     uint64_t Const;
@@ -154,11 +256,59 @@ DEF_OP(CondJump) {
 
   (this->*JCC)(*TrueTargetLabel, T_NEAR);
 
-  PendingTargetLabel = &JumpTargets.try_emplace(Op->FalseBlock.ID()).first->second;
+  PendingTargetLabel = GetBranchTarget(Op->FalseBlock.ID());
 }
 
 DEF_OP(Syscall) {
   auto Op = IROp->C<IR::IROp_Syscall>();
+
+  uint64_t SyscallID{};
+  const bool KnownSyscall = IsInlineConstant(Op->SyscallID, &SyscallID);
+
+  if (KnownSyscall) {
+    auto SyscallDef = CTX->SyscallHandler->GetSyscallABI(SyscallID);
+    if (SyscallDef.DirectHandler && CTX->DirectSyscallHandlers) {
+      // Call the handler directly
+      // Frame: rdi
+      // Args: rsi, rdx, rcx, r8, r9, then the stack
+      //
+      // Result: RAX
+      const std::array<Xbyak::Reg64, 5> RegArgs = { rsi, rdx, rcx, r8, r9 };
+      const uint32_t NumArgs = SyscallDef.NumArgs;
+      const uint32_t NumStackArgs = NumArgs > RegArgs.size() ? NumArgs - RegArgs.size() : 0;
+      const bool NeedsAlignment = (RA64.size() + NumStackArgs) & 1;
+
+      for (auto &Reg : RA64)
+        push(Reg);
+
+      if (NeedsAlignment)
+        sub(rsp, 8);
+
+      // Go through the stack so sources that overlap the argument registers aren't overwritten
+      // Header.Args[0] is the syscall number
+      for (uint32_t i = NumArgs; i > 0; --i) {
+        push(GetSrc<RA_64>(Op->Header.Args[i].ID()));
+      }
+
+      for (uint32_t i = 0; i < NumArgs - NumStackArgs; ++i) {
+        pop(RegArgs[i]);
+      }
+
+      mov(rdi, STATE);
+      mov(rax, reinterpret_cast<uintptr_t>(SyscallDef.DirectHandler));
+      call(rax);
+
+      if (NumStackArgs || NeedsAlignment)
+        add(rsp, (NumStackArgs + NeedsAlignment) * 8);
+
+      for (uint32_t i = RA64.size(); i > 0; --i)
+        pop(RA64[i - 1]);
+
+      mov (GetDst<RA_64>(Node), rax);
+      return;
+    }
+  }
+
   // XXX: This is very terrible, but I don't care for right now
 
   auto NumPush = RA64.size();
@@ -174,12 +324,21 @@ DEF_OP(Syscall) {
   // Result: RAX
 
   // These are pushed in reverse order because stacks
-  for (uint32_t i = FEXCore::HLE::SyscallArguments::MAX_ARGS; i > 0; --i) {
+  for (uint32_t i = FEXCore::HLE::SyscallArguments::MAX_ARGS; i > 1; --i) {
     if (Op->Header.Args[i - 1].IsInvalid()) continue;
     push(GetSrc<RA_64>(Op->Header.Args[i - 1].ID()));
     ++NumPush;
   }
 
+  // The syscall number is inlined once it is known
+  if (KnownSyscall) {
+    push(static_cast<uint32_t>(SyscallID));
+  }
+  else {
+    push(GetSrc<RA_64>(Op->Header.Args[0].ID()));
+  }
+  ++NumPush;
+
   mov(rsi, STATE); // Move thread in to rsi
   mov(rdi, qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, Pointers.X86.SyscallHandlerObj)]);
   mov(rdx, rsp);
@@ -193,7 +352,14 @@ DEF_OP(Syscall) {
     add(rsp, 8); // Align
 
   // Reload arguments just in case they are sill live after the fact
-  for (uint32_t i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++i) {
+  if (KnownSyscall) {
+    add(rsp, 8);
+  }
+  else {
+    pop(GetSrc<RA_64>(Op->Header.Args[0].ID()));
+  }
+
+  for (uint32_t i = 1; i < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++i) {
     if (Op->Header.Args[i].IsInvalid()) continue;
     pop(GetSrc<RA_64>(Op->Header.Args[i].ID()));
   }
@@ -204,6 +370,51 @@ DEF_OP(Syscall) {
   mov (GetDst<RA_64>(Node), rax);
 }
 
+DEF_OP(InlineSyscall) {
+  auto Op = IROp->C<IR::IROp_InlineSyscall>();
+  // Host syscall ABI
+  // rax: SyscallNumber & Return
+  // Args: rdi, rsi, rdx, r10, r8, r9
+  // rcx and r11 are clobbered
+
+  // One argument is removed from the SyscallArguments::MAX_ARGS since the first argument was syscall number
+  const std::array<Xbyak::Reg64, FEXCore::HLE::SyscallArguments::MAX_ARGS-1> RegArgs = {
+    rdi, rsi, rdx, r10, r8, r9
+  };
+
+  for (auto &Reg : RA64)
+    push(Reg);
+
+  // Go through the stack so sources that overlap the argument registers aren't overwritten
+  uint32_t NumArgs{};
+  for (uint32_t i = 0; i < FEXCore::HLE::SyscallArguments::MAX_ARGS-1; ++i) {
+    if (Op->Header.Args[i].IsInvalid()) break;
+    push(GetSrc<RA_64>(Op->Header.Args[i].ID()));
+    ++NumArgs;
+  }
+
+  for (uint32_t i = NumArgs; i > 0; --i) {
+    pop(RegArgs[i - 1]);
+    if (!CTX->Config.Is64BitMode()) {
+      // 32-bit guests can leave garbage in the upper bits
+      mov(RegArgs[i - 1].cvt32(), RegArgs[i - 1].cvt32());
+    }
+  }
+
+  mov(eax, Op->HostSyscallNumber);
+  syscall();
+
+  for (uint32_t i = RA64.size(); i > 0; --i)
+    pop(RA64[i - 1]);
+
+  if (CTX->Config.Is64BitMode()) {
+    mov(GetDst<RA_64>(Node), rax);
+  }
+  else {
+    mov(GetDst<RA_32>(Node), eax);
+  }
+}
+
 DEF_OP(Thunk) {
   auto Op = IROp->C<IR::IROp_Thunk>();
 
@@ -325,9 +536,11 @@ void X86JITCore::RegisterBranchHandlers() {
   REGISTER_OP(SIGNALRETURN,      SignalReturn);
   REGISTER_OP(CALLBACKRETURN,    CallbackReturn);
   REGISTER_OP(EXITFUNCTION,      ExitFunction);
+  REGISTER_OP(PUSHRETURNSTACK,   PushReturnStack);
   REGISTER_OP(JUMP,              Jump);
   REGISTER_OP(CONDJUMP,          CondJump);
   REGISTER_OP(SYSCALL,           Syscall);
+  REGISTER_OP(INLINESYSCALL,     InlineSyscall);
   REGISTER_OP(THUNK,             Thunk);
   REGISTER_OP(VALIDATECODE,      ValidateCode);
   REGISTER_OP(REMOVETHREADCODEENTRY,   RemoveThreadCodeEntry);
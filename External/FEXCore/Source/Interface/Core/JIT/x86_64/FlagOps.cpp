@@ -24,10 +24,59 @@ DEF_OP(GetHostFlag) {
   mov(GetDst<RA_64>(Node), rax);
 }
 
+DEF_OP(HostNZCV) {
+  auto Op = IROp->C<IR::IROp_HostNZCV>();
+
+  mov(TMP1, GetSrc<RA_64>(Op->Src1.ID()));
+  mov(TMP2, GetSrc<RA_64>(Op->Src2.ID()));
+
+  switch (Op->SrcSize) {
+    case 1:
+      if (Op->IsSub) cmp(al, cl); else add(al, cl);
+      break;
+    case 2:
+      if (Op->IsSub) cmp(ax, cx); else add(ax, cx);
+      break;
+    case 4:
+      if (Op->IsSub) cmp(eax, ecx); else add(eax, ecx);
+      break;
+    case 8:
+      if (Op->IsSub) cmp(rax, rcx); else add(rax, rcx);
+      break;
+    default: LOGMAN_MSG_A_FMT("Unhandled HostNZCV size: {}", Op->SrcSize);
+  }
+
+  // Grab everything before anything else touches EFLAGS
+  // AArch64 carry is inverted for subtraction
+  sets(al);
+  setz(cl);
+  if (Op->IsSub) {
+    setnc(dl);
+  }
+  else {
+    setc(dl);
+  }
+  seto(dil);
+
+  movzx(eax, al);
+  shl(eax, 31);
+  movzx(ecx, cl);
+  shl(ecx, 30);
+  or_(eax, ecx);
+  movzx(edx, dl);
+  shl(edx, 29);
+  or_(eax, edx);
+  movzx(edi, dil);
+  shl(edi, 28);
+  or_(eax, edi);
+  mov(GetDst<RA_32>(Node), eax);
+}
+
 #undef DEF_OP
 void X86JITCore::RegisterFlagHandlers() {
 #define REGISTER_OP(op, x) OpHandlers[FEXCore::IR::IROps::OP_##op] = &X86JITCore::Op_##x
   REGISTER_OP(GETHOSTFLAG, GetHostFlag);
+  REGISTER_OP(HOSTNZCV,    HostNZCV);
 #undef REGISTER_OP
 }
 }
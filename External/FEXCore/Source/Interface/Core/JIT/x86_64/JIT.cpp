@@ -359,6 +359,8 @@ X86JITCore::X86JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalTh
   DispatcherConfig config;
   config.ExitFunctionLink = reinterpret_cast<uintptr_t>(&ExitFunctionLink);
   config.ExitFunctionLinkThis = reinterpret_cast<uintptr_t>(this);
+  config.IndirectBranchLink = reinterpret_cast<uintptr_t>(&IndirectBranchLink);
+  config.TierUpLink = reinterpret_cast<uintptr_t>(&TierUpLink);
   config.StaticRegisterAssignment = ctx->Config.StaticRegisterAllocation;
 
   Dispatcher = std::make_unique<X86Dispatcher>(CTX, ThreadState, config);
@@ -429,7 +431,13 @@ void X86JITCore::EmitDetectionString() {
 }
 
 void X86JITCore::ClearCache() {
+  // Return stack landing pads live in the code that is being thrown away
+  ThreadState->CurrentFrame->ReturnStack = {};
+
   if (Dispatcher->SignalHandlerRefCounter == 0) {
+    // Only safe once no first tier code can run anymore
+    TierUpRecords.clear();
+
     if (!CodeBuffers.empty()) {
       // If we have more than one code buffer we are tracking then walk them and delete
       // This is a cleanup step
@@ -645,6 +653,7 @@ void *X86JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IRLi
   // Fairly excessive buffer range to make sure we don't overflow
   uint32_t BufferRange = SSACount * 16;
   if ((getSize() + BufferRange) > CurrentCodeBuffer->Size) {
+    // Unlike the Arm64 JIT this doesn't evict cold code regions yet, running out of space flushes everything
     ThreadState->CTX->ClearCodeCache(ThreadState, false);
   }
 
@@ -652,6 +661,15 @@ void *X86JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IRLi
   CursorEntry = getSize();
   this->IR = IR;
 
+  // Loops back to the entry block branch directly, unless the entry has checks that need to run on every pass.
+  // Those loops leave their spill slots and start over at the top, so single stepping and tier up still see each iteration.
+  Label EntryChecks;
+  Label EntryBackEdge;
+  L(EntryChecks);
+  EntryBlockID = IR->GetHeader()->Blocks.ID();
+  EntryBackEdgeLabel = (CTX->GetGdbServerStatus() || TierUpThreshold) ? &EntryBackEdge : nullptr;
+  EntryBackEdgeUsed = false;
+
   if (CTX->GetGdbServerStatus()) {
     Label RunBlock;
 
@@ -673,55 +691,22 @@ void *X86JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IRLi
 
   LOGMAN_THROW_A_FMT(RAData != nullptr, "Needs RA");
 
+  // Needs to happen before the stack is touched, the linker continues at the top of the new code
+  if (TierUpThreshold) {
+    EmitTierUpCounter();
+  }
+
   SpillSlots = RAData->SpillSlots();
 
   if (SpillSlots) {
     sub(rsp, SpillSlots * 16);
   }
 
-#ifdef BLOCKSTATS
-  BlockSamplingData::BlockData *SamplingData = CTX->BlockData->GetBlockData(Entry);
-  if (GetSamplingData) {
-    mov(rcx, reinterpret_cast<uintptr_t>(SamplingData));
-    rdtsc();
-    shl(rdx, 32);
-    or_(rax, rdx);
-    mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Start)], rax);
+  SamplingData = CTX->BlockData ? CTX->BlockData->GetBlockData(Entry) : nullptr;
+  if (SamplingData) {
+    EmitBlockProfileEntry();
   }
 
-  auto ExitBlock = [&]() {
-    if (GetSamplingData) {
-      mov(rcx, reinterpret_cast<uintptr_t>(SamplingData));
-      // Get time
-      rdtsc();
-      shl(rdx, 32);
-      or_(rax, rdx);
-
-      // Calculate time spent in block
-      mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Start)]);
-      sub(rax, rdx);
-
-      // Add time to total time
-      add(qword [rcx + offsetof(BlockSamplingData::BlockData, TotalTime)], rax);
-
-      // Increment call count
-      inc(qword [rcx + offsetof(BlockSamplingData::BlockData, TotalCalls)]);
-
-      // Calculate min
-      mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Min)]);
-      cmp(rdx, rax);
-      cmova(rdx, rax);
-      mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Min)], rdx);
-
-      // Calculate max
-      mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Max)]);
-      cmp(rdx, rax);
-      cmovb(rdx, rax);
-      mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Max)], rdx);
-    }
-  };
-#endif
-
   PendingTargetLabel = nullptr;
 
   for (auto [BlockNode, BlockHeader] : IR->GetBlocks()) {
@@ -795,6 +780,15 @@ void *X86JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IRLi
   }
   PendingTargetLabel = nullptr;
 
+  if (EntryBackEdgeUsed) {
+    L(EntryBackEdge);
+    if (SpillSlots) {
+      add(rsp, SpillSlots * 16);
+    }
+    jmp(EntryChecks, T_NEAR);
+  }
+  EntryBackEdgeLabel = nullptr;
+
   void *GuestExit = getCurr<void*>();
   this->IR = nullptr;
 
@@ -805,9 +799,85 @@ void *X86JITCore::CompileCode(uint64_t Entry, [[maybe_unused]] FEXCore::IR::IRLi
     DebugData->Relocations = &Relocations;
   }
 
+  if (SamplingData) {
+    CTX->BlockData->SetHostCodeSize(Entry, reinterpret_cast<uintptr_t>(GuestExit) - reinterpret_cast<uintptr_t>(GuestEntry));
+    SamplingData = nullptr;
+  }
+
   return GuestEntry;
 }
 
+Label *X86JITCore::GetBranchTarget(IR::NodeID Node) {
+  if (EntryBackEdgeLabel && Node == EntryBlockID) {
+    EntryBackEdgeUsed = true;
+    return EntryBackEdgeLabel;
+  }
+
+  return &JumpTargets.try_emplace(Node).first->second;
+}
+
+void X86JITCore::EmitTierUpCounter() {
+  Label Continue;
+
+  auto Record = &TierUpRecords.emplace_back(TierUpRecord {
+    .GuestRIP = Entry,
+    .Remaining = TierUpThreshold,
+  });
+
+  // Count down the block entries left until the block gets recompiled
+  // The linker gets the record through rax
+  mov(rax, reinterpret_cast<uintptr_t>(Record));
+  dec(dword [rax + offsetof(TierUpRecord, Remaining)]);
+  jnz(Continue, T_NEAR);
+  jmp(qword [STATE + offsetof(FEXCore::Core::CpuStateFrame, Pointers.X86.TierUpLinker)]);
+
+  L(Continue);
+}
+
+void X86JITCore::EmitBlockProfileEntry() {
+  mov(rcx, reinterpret_cast<uintptr_t>(SamplingData));
+  inc(qword [rcx + offsetof(BlockSamplingData::BlockData, TotalCalls)]);
+
+  if (CTX->BlockData->SampleCycles()) {
+    rdtsc();
+    shl(rdx, 32);
+    or_(rax, rdx);
+    mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Start)], rax);
+  }
+}
+
+void X86JITCore::EmitBlockProfileSample() {
+  if (!SamplingData || !CTX->BlockData->SampleCycles()) {
+    return;
+  }
+
+  mov(rcx, reinterpret_cast<uintptr_t>(SamplingData));
+  // Get time
+  rdtsc();
+  shl(rdx, 32);
+  or_(rax, rdx);
+
+  // Calculate time spent in block
+  mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Start)]);
+  sub(rax, rdx);
+
+  // Add time to total time
+  add(qword [rcx + offsetof(BlockSamplingData::BlockData, TotalTime)], rax);
+  inc(qword [rcx + offsetof(BlockSamplingData::BlockData, TotalSamples)]);
+
+  // Calculate min
+  mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Min)]);
+  cmp(rdx, rax);
+  cmova(rdx, rax);
+  mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Min)], rdx);
+
+  // Calculate max
+  mov(rdx, qword [rcx + offsetof(BlockSamplingData::BlockData, Max)]);
+  cmp(rdx, rax);
+  cmovb(rdx, rax);
+  mov(qword [rcx + offsetof(BlockSamplingData::BlockData, Max)], rdx);
+}
+
 uint64_t X86JITCore::ExitFunctionLink(X86JITCore *core, FEXCore::Core::CpuStateFrame *Frame, uint64_t *record) {
   auto Thread = Frame->Thread;
   auto GuestRip = record[1];
@@ -820,15 +890,45 @@ uint64_t X86JITCore::ExitFunctionLink(X86JITCore *core, FEXCore::Core::CpuStateF
   }
 
   auto LinkerAddress = core->Dispatcher->ExitFunctionLinkerAddress;
-  Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [record, LinkerAddress]{
-    // undo the link
-    record[0] = LinkerAddress;
+  Thread->LookupCache->AddBlockLink(GuestRip, LookupCache::BlockLinkRecord {
+    .HostLink = (uintptr_t)record,
+    .DelinkerData = LinkerAddress,
+    .Delinker = [](LookupCache::BlockLinkRecord const &Record) {
+      // undo the link
+      reinterpret_cast<uint64_t*>(Record.HostLink)[0] = Record.DelinkerData;
+    },
   });
 
   record[0] = HostCode;
   return HostCode;
 }
 
+uint64_t X86JITCore::IndirectBranchLink(X86JITCore *core, FEXCore::Core::CpuStateFrame *Frame, LookupCache::IndirectBranchCache *Cache) {
+  // The branch already stored the target RIP
+  auto HostCode = Frame->Thread->LookupCache->LinkIndirectBranchCache(Cache, Frame->State.rip);
+
+  if (!HostCode) {
+    return core->Dispatcher->AbsoluteLoopTopAddress;
+  }
+
+  return HostCode;
+}
+
+uint64_t X86JITCore::TierUpLink(X86JITCore *core, FEXCore::Core::CpuStateFrame *Frame, TierUpRecord *Record) {
+  // Compiling can clear or evict the code and the record along with it
+  const uint64_t GuestRIP = Record->GuestRIP;
+  auto HostCode = core->CTX->TierUpBlock(Frame, GuestRIP);
+
+  if (!HostCode) {
+    // The first tier code might be gone as well, start the block over through the dispatcher.
+    // Its counter wrapped around so this won't retry soon.
+    Frame->State.rip = GuestRIP;
+    return core->Dispatcher->AbsoluteLoopTopAddress;
+  }
+
+  return HostCode;
+}
+
 std::unique_ptr<CPUBackend> CreateX86JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
   return std::make_unique<X86JITCore>(ctx, Thread, AllocateNewCodeBuffer(ctx, X86JITCore::INITIAL_CODE_SIZE));
 }
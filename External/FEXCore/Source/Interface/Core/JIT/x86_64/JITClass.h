@@ -8,6 +8,7 @@ $end_info$
 
 #include "Interface/Core/BlockSamplingData.h"
 #include "Interface/Core/Dispatcher/Dispatcher.h"
+#include "Interface/Core/LookupCache.h"
 #include "Interface/Core/ObjectCache/Relocations.h"
 
 #define XBYAK64
@@ -22,6 +23,7 @@ using namespace Xbyak;
 #include <FEXCore/Utils/MathUtils.h>
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 
+#include <deque>
 #include <tuple>
 
 namespace FEXCore::CPU {
@@ -74,6 +76,7 @@ public:
   [[nodiscard]] bool NeedsOpDispatch() override { return true; }
 
   void ClearCache() override;
+  bool CanBeReused() const override { return Dispatcher->SignalHandlerRefCounter == 0; }
 
   static constexpr size_t INITIAL_CODE_SIZE = 1024 * 1024 * 16;
   static constexpr size_t MAX_CODE_SIZE = 1024 * 1024 * 256;
@@ -140,7 +143,7 @@ private:
     std::vector<FEXCore::CPU::Relocation> Relocations;
 
     ///< Relocation code loading
-    bool ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations);
+    bool ApplyRelocations(uint64_t GuestEntry, uint64_t OriginalGuestEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations);
 
     /**
     * @brief Current guest RIP entrypoint
@@ -156,6 +159,11 @@ private:
   uint64_t Entry;
 
   std::unordered_map<IR::NodeID, Label> JumpTargets;
+  // Set while compiling code with block entry checks, back edges to the entry block go through it instead
+  Label *EntryBackEdgeLabel{};
+  bool EntryBackEdgeUsed{};
+  IR::NodeID EntryBlockID{};
+  Label *GetBranchTarget(IR::NodeID Node);
   Xbyak::util::Cpu Features{};
 
   bool MemoryDebug = false;
@@ -206,15 +214,21 @@ private:
   IR::RegisterAllocationPass *RAPass;
   FEXCore::IR::RegisterAllocationData *RAData;
 
-#ifdef BLOCKSTATS
-  bool GetSamplingData {true};
-#endif
+  // Counters for the block being compiled when BlockProfile is enabled
+  BlockSamplingData::BlockData *SamplingData{};
+  void EmitBlockProfileEntry();
+  void EmitTierUpCounter();
+  // Stable addresses, first tier code points directly at its record
+  std::deque<TierUpRecord> TierUpRecords;
+  void EmitBlockProfileSample();
 
   void EmplaceNewCodeBuffer(CodeBuffer Buffer) {
     CurrentCodeBuffer = &CodeBuffers.emplace_back(Buffer);
   }
 
   static uint64_t ExitFunctionLink(X86JITCore* code, FEXCore::Core::CpuStateFrame *Frame, uint64_t *record);
+  static uint64_t IndirectBranchLink(X86JITCore* code, FEXCore::Core::CpuStateFrame *Frame, LookupCache::IndirectBranchCache *Cache);
+  static uint64_t TierUpLink(X86JITCore* code, FEXCore::Core::CpuStateFrame *Frame, TierUpRecord *Record);
 
   // This is purely a debugging aid for developers to see if they are in JIT code space when inspecting raw memory
   void EmitDetectionString();
@@ -335,9 +349,11 @@ private:
   DEF_OP(SignalReturn);
   DEF_OP(CallbackReturn);
   DEF_OP(ExitFunction);
+  DEF_OP(PushReturnStack);
   DEF_OP(Jump);
   DEF_OP(CondJump);
   DEF_OP(Syscall);
+  DEF_OP(InlineSyscall);
   DEF_OP(Thunk);
   DEF_OP(ValidateCode);
   DEF_OP(RemoveThreadCodeEntry);
@@ -357,6 +373,7 @@ private:
 
   ///< Flag ops
   DEF_OP(GetHostFlag);
+  DEF_OP(HostNZCV);
 
   ///< Memory ops
   DEF_OP(LoadContext);
@@ -369,8 +386,8 @@ private:
   DEF_OP(StoreFlag);
   DEF_OP(LoadMem);
   DEF_OP(StoreMem);
-  DEF_OP(VLoadMemElement);
-  DEF_OP(VStoreMemElement);
+  DEF_OP(MemSet);
+  DEF_OP(MemCpy);
   DEF_OP(CacheLineClear);
   DEF_OP(CacheLineZero);
 
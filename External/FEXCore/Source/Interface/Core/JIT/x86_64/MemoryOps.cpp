@@ -579,12 +579,61 @@ DEF_OP(StoreMem) {
   }
 }
 
-DEF_OP(VLoadMemElement) {
-  LOGMAN_MSG_A_FMT("Unimplemented");
+DEF_OP(MemSet) {
+  auto Op = IROp->C<IR::IROp_MemSet>();
+
+  // The host string instructions already match the guest semantics, including TSO.
+  // Enhanced REP STOS picks the widest stores the host supports.
+  Xbyak::Label Forward;
+  test(GetSrc<RA_64>(Op->Direction.ID()), GetSrc<RA_64>(Op->Direction.ID()));
+  jz(Forward);
+  std();
+  L(Forward);
+
+  mov(TMP4, GetSrc<RA_64>(Op->Addr.ID()));
+  mov(TMP2, GetSrc<RA_64>(Op->Length.ID()));
+  mov(TMP1, GetSrc<RA_64>(Op->Value.ID()));
+
+  rep();
+  switch (Op->Size) {
+    case 1: stosb(); break;
+    case 2: stosw(); break;
+    case 4: stosd(); break;
+    case 8: stosq(); break;
+    default: LOGMAN_MSG_A_FMT("Unhandled MemSet size: {}", Op->Size);
+  }
+
+  // The host ABI expects DF to be clear
+  cld();
 }
 
-DEF_OP(VStoreMemElement) {
-  LOGMAN_MSG_A_FMT("Unimplemented");
+DEF_OP(MemCpy) {
+  auto Op = IROp->C<IR::IROp_MemCpy>();
+
+  Xbyak::Label Forward;
+  test(GetSrc<RA_64>(Op->Direction.ID()), GetSrc<RA_64>(Op->Direction.ID()));
+  jz(Forward);
+  std();
+  L(Forward);
+
+  mov(TMP4, GetSrc<RA_64>(Op->Dest.ID()));
+  mov(TMP2, GetSrc<RA_64>(Op->Length.ID()));
+
+  // rsi is an allocatable register, keep it alive around the copy
+  push(rsi);
+  mov(rsi, GetSrc<RA_64>(Op->Src.ID()));
+
+  rep();
+  switch (Op->Size) {
+    case 1: movsb(); break;
+    case 2: movsw(); break;
+    case 4: movsd(); break;
+    case 8: movsq(); break;
+    default: LOGMAN_MSG_A_FMT("Unhandled MemCpy size: {}", Op->Size);
+  }
+
+  pop(rsi);
+  cld();
 }
 
 DEF_OP(CacheLineClear) {
@@ -629,8 +678,8 @@ void X86JITCore::RegisterMemoryHandlers() {
   REGISTER_OP(STOREMEM,            StoreMem);
   REGISTER_OP(LOADMEMTSO,          LoadMem);
   REGISTER_OP(STOREMEMTSO,         StoreMem);
-  REGISTER_OP(VLOADMEMELEMENT,     VLoadMemElement);
-  REGISTER_OP(VSTOREMEMELEMENT,    VStoreMemElement);
+  REGISTER_OP(MEMSET,              MemSet);
+  REGISTER_OP(MEMCPY,              MemCpy);
   REGISTER_OP(CACHELINECLEAR,      CacheLineClear);
   REGISTER_OP(CACHELINEZERO,       CacheLineZero);
 #undef REGISTER_OP
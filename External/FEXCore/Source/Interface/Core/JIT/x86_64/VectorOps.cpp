@@ -1569,29 +1569,21 @@ DEF_OP(VDupElement) {
     case 1: {
       // First extract the index
       pextrb(eax, GetSrc(Op->Header.Args[0].ID()), Op->Index);
-      // Insert it in to the first element of the destination
-      pinsrb(GetDst(Node), eax, 0);
-      pinsrb(GetDst(Node), eax, 1);
-      // Shuffle low elements
-      vpshuflw(GetDst(Node), GetSrc(Op->Header.Args[0].ID()), 0);
-      // Insert element in to the first upper 64bit element
-      pinsrb(GetDst(Node), eax, 8);
-      pinsrb(GetDst(Node), eax, 9);
-      // Shuffle high elements
-      vpshufhw(GetDst(Node), GetSrc(Op->Header.Args[0].ID()), 0);
+      // Move it in to the first element of the destination
+      vmovd(GetDst(Node), eax);
+      // Shuffling with all zero indices copies the first byte everywhere
+      vpxor(xmm15, xmm15, xmm15);
+      vpshufb(GetDst(Node), GetDst(Node), xmm15);
       break;
     }
     case 2: {
       // First extract the index
       pextrw(eax, GetSrc(Op->Header.Args[0].ID()), Op->Index);
-      // Insert it in to the first element of the destination
-      pinsrw(GetDst(Node), eax, 0);
-      // Shuffle low elements
-      vpshuflw(GetDst(Node), GetSrc(Op->Header.Args[0].ID()), 0);
-      // Insert element in to the first upper 64bit element
-      pinsrw(GetDst(Node), eax, 4);
-      // Shuffle high elements
-      vpshufhw(GetDst(Node), GetSrc(Op->Header.Args[0].ID()), 0);
+      // Move it in to the first element of the destination
+      vmovd(GetDst(Node), eax);
+      // Copy it across the low 64bits, then copy the first 32bits across the register
+      vpshuflw(GetDst(Node), GetDst(Node), 0);
+      vpshufd(GetDst(Node), GetDst(Node), 0);
       break;
     }
     case 4: {
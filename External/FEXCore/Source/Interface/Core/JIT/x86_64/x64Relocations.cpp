@@ -86,7 +86,10 @@ void X86JITCore::InsertGuestRIPMove(Xbyak::Reg Reg, uint64_t Constant) {
   Relocations.emplace_back(MoveABI);
 }
 
-bool X86JITCore::ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations) {
+bool X86JITCore::ApplyRelocations(uint64_t GuestEntry, uint64_t OriginalGuestEntry, uint64_t CursorEntry, size_t NumRelocations, const char* EntryRelocations) {
+  // Guest RIPs move with the block they were compiled in
+  const uint64_t GuestRIPDelta = GuestEntry - OriginalGuestEntry;
+
   size_t DataIndex{};
   for (size_t j = 0; j < NumRelocations; ++j) {
     const FEXCore::CPU::Relocation *Reloc = reinterpret_cast<const FEXCore::CPU::Relocation *>(&EntryRelocations[DataIndex]);
@@ -116,19 +119,27 @@ bool X86JITCore::ApplyRelocations(uint64_t GuestEntry, uint64_t CodeEntry, uint6
         DataIndex += sizeof(Reloc->NamedThunkMove);
         break;
       }
-      case FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_MOVE:
-        // XXX: Reenable once the JIT Object Cache is upstream
-        // XXX: Should spin the relocation list, create a list of guest RIP moves, and ask for them all once, reduces lock contention.
-        uint64_t Pointer = ~0ULL; // EmitterCTX->JITObjectCache->FindRelocatedRIP(Reloc->GuestRIPMove.GuestRIP);
-        if (Pointer == ~0ULL) {
-          return false;
-        }
+      case FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_MOVE: {
+        uint64_t Pointer = Reloc->GuestRIPMove.GuestRIP + GuestRIPDelta;
 
         // Relocation occurs at the cursorEntry + offset relative to that cursor.
         setSize(CursorEntry + Reloc->GuestRIPMove.Offset);
         LoadConstantWithPadding(Xbyak::Reg64(Reloc->GuestRIPMove.RegisterIndex), Pointer);
         DataIndex += sizeof(Reloc->GuestRIPMove);
         break;
+      }
+      case FEXCore::CPU::RelocationTypes::RELOC_GUEST_RIP_LITERAL: {
+        uint64_t Pointer = Reloc->GuestRIPLiteral.GuestRIP + GuestRIPDelta;
+
+        // Relocation occurs at the cursorEntry + offset relative to that cursor.
+        setSize(CursorEntry + Reloc->GuestRIPLiteral.Offset);
+        dq(Pointer);
+        DataIndex += sizeof(Reloc->GuestRIPLiteral);
+        break;
+      }
+      default:
+        // Unknown relocation, likely from a newer FEX
+        return false;
     }
   }
 
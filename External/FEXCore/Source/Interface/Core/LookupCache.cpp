@@ -62,14 +62,18 @@ void LookupCache::HintUsedRange(uint64_t Address, uint64_t Size) {
 
 void LookupCache::ClearL2Cache() {
   std::lock_guard<std::recursive_mutex> lk(WriteLock);
+  L2WriteScope Scope {this};
   // Clear out the page memory
   madvise(reinterpret_cast<void*>(PagePointer), ctx->Config.VirtualMemSize / 4096 * 8, MADV_DONTNEED);
   madvise(reinterpret_cast<void*>(PageMemory), CODE_SIZE, MADV_DONTNEED);
   AllocateOffset = 0;
+  BackedPages.clear();
+  EvictCursor = 0;
 }
 
 void LookupCache::ClearCache() {
   std::lock_guard<std::recursive_mutex> lk(WriteLock);
+  L2WriteScope Scope {this};
 
   // Clear L1
   madvise(reinterpret_cast<void*>(L1Pointer), L1_SIZE, MADV_DONTNEED);
@@ -81,5 +85,81 @@ void LookupCache::ClearCache() {
   BlockList.clear();
 }
 
+void LookupCache::EraseHostCodeRange(uintptr_t HostStart, uintptr_t HostEnd) {
+  std::lock_guard<std::recursive_mutex> lk(WriteLock);
+
+  // The code that these links would patch on delinking is about to be overwritten
+  for (auto it = BlockLinks.begin(); it != BlockLinks.end();) {
+    auto &Links = it.value();
+    std::erase_if(Links, [HostStart, HostEnd](BlockLinkRecord const &Record) {
+      return Record.HostLink >= HostStart && Record.HostLink < HostEnd;
+    });
+
+    if (Links.empty()) {
+      it = BlockLinks.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  std::vector<uint64_t> EvictedBlocks;
+  for (auto [GuestCode, HostCode] : BlockList) {
+    if (HostCode >= HostStart && HostCode < HostEnd) {
+      EvictedBlocks.emplace_back(GuestCode);
+    }
+  }
+
+  // Erase severs any remaining links from blocks outside of the range
+  for (auto GuestCode : EvictedBlocks) {
+    Erase(GuestCode);
+  }
+}
+
+// Resets a filled indirect branch cache entry back to the miss path
+static void DelinkIndirectBranchCacheEntry(LookupCache::BlockLinkRecord const &Record) {
+  auto Cache = reinterpret_cast<LookupCache::IndirectBranchCache*>(Record.DelinkerData);
+  auto Entry = reinterpret_cast<LookupCache::IndirectBranchCacheEntry*>(Record.HostLink);
+
+  // The entry might have been reused for a different target since, which is harmless to reset
+  if (Entry->HostOffset == Cache->MissOffset) {
+    return;
+  }
+
+  // The owning thread can be checking this entry while it is being reset
+  // Clearing the RIP first means that a torn read only ever sees the miss path paired with a live RIP
+  std::atomic_ref<uint64_t>(Entry->GuestRIP).store(0, std::memory_order_relaxed);
+  std::atomic_ref<int64_t>(Entry->HostOffset).store(Cache->MissOffset, std::memory_order_relaxed);
+  ++Cache->EmptyEntries;
 }
 
+uintptr_t LookupCache::LinkIndirectBranchCache(IndirectBranchCache *Cache, uint64_t GuestRIP) {
+  // Keeps delinking from other threads out while the entry is filled
+  std::lock_guard<std::recursive_mutex> lk(WriteLock);
+
+  auto HostCode = FindBlock(GuestRIP);
+  if (!HostCode || !Cache->EmptyEntries) {
+    return HostCode;
+  }
+
+  for (auto &Entry : Cache->Entries) {
+    if (Entry.HostOffset != Cache->MissOffset) {
+      continue;
+    }
+
+    Entry.HostOffset = static_cast<int64_t>(HostCode - reinterpret_cast<uintptr_t>(Cache));
+    Entry.GuestRIP = GuestRIP;
+    --Cache->EmptyEntries;
+
+    AddBlockLink(GuestRIP, BlockLinkRecord {
+      .HostLink = reinterpret_cast<uintptr_t>(&Entry),
+      .DelinkerData = reinterpret_cast<uintptr_t>(Cache),
+      .Delinker = DelinkIndirectBranchCacheEntry,
+    });
+    break;
+  }
+
+  return HostCode;
+}
+
+}
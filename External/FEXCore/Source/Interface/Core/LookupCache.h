@@ -1,13 +1,14 @@
 #pragma once
 #include <FEXCore/Utils/LogManager.h>
 
+#include <atomic>
 #include <cstdint>
-#include <functional>
-#include <map>
 #include <stddef.h>
 #include <utility>
 #include <vector>
 #include <mutex>
+#include <sys/mman.h>
+#include <tsl/robin_map.h>
 
 namespace FEXCore {
 namespace Context {
@@ -22,6 +23,44 @@ public:
     uintptr_t GuestCode;
   };
 
+  struct BlockLinkRecord;
+  using BlockDelinkerFunc = void(*)(BlockLinkRecord const &Record);
+
+  /**
+   * @brief A patched link from the exit of one block to the entry of another
+   *
+   * When the destination block goes away the delinker gets called with this record to restore the unlinked exit.
+   */
+  struct BlockLinkRecord {
+    // Address of the patched link inside of the linking block's code
+    uintptr_t HostLink;
+    // Backend specific data that the delinker needs, usually the address of the linker to restore
+    uintptr_t DelinkerData;
+    BlockDelinkerFunc Delinker;
+  };
+
+  struct IndirectBranchCacheEntry {
+    uint64_t GuestRIP;
+    // Offset of the host code from the start of the IndirectBranchCache
+    int64_t HostOffset;
+  };
+
+  /**
+   * @brief Per-site cache of recently seen targets that the JITs emit at indirect branches
+   *
+   * Lives in the code buffer next to the branch, which checks the entries inline before doing a full lookup.
+   * Host code is stored as offsets from the start of the table so that the block's code stays position independent.
+   * Empty entries have a GuestRIP of zero and point at the site's miss path, so a guest branch to zero still takes the miss path.
+   */
+  struct IndirectBranchCache {
+    constexpr static size_t NUM_ENTRIES = 2;
+
+    int64_t MissOffset;
+    // The miss path only calls in to the linker while there are empty entries
+    uint64_t EmptyEntries;
+    IndirectBranchCacheEntry Entries[NUM_ENTRIES];
+  };
+
   LookupCache(FEXCore::Context::Context *CTX);
   ~LookupCache();
 
@@ -35,42 +74,37 @@ public:
       return L1Entry.HostCode;
     }
 
-    // L2 and L3 need to be locked
-    std::lock_guard<std::recursive_mutex> lk(WriteLock);
-
-    // Try L2
-    const auto PageIndex = (Address & (VirtualMemSize -1)) >> 12;
-    const auto PageOffset = Address & (0x0FFF);
-
-    const auto Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
-    auto LocalPagePointer = Pointers[PageIndex];
-
-    // Do we a page pointer for this address?
-    if (LocalPagePointer) {
-      // Find there pointer for the address in the blocks
-      auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
-
-      if (BlockPointers[PageOffset].GuestCode == Address)
-      {
+    // Try L2 without the lock, only bail to the lock if a writer is active or raced with us
+    const auto Sequence = L2Sequence.load(std::memory_order_acquire);
+    if ((Sequence & 1) == 0) {
+      const auto HostCode = FindBlockInL2(Address);
+      if (HostCode) {
+        L1Entry.HostCode = HostCode;
         L1Entry.GuestCode = Address;
-        L1Entry.HostCode = BlockPointers[PageOffset].HostCode;
-        return L1Entry.HostCode;
+
+        // Pairs with the increment in L2WriteScope.
+        // Any writer that starts after this check observes the L1 entry that was just written and clears it if needed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (L2Sequence.load(std::memory_order_relaxed) == Sequence) {
+          return HostCode;
+        }
+
+        // A writer raced with the lookup, the L1 entry that was just filled might already be stale
+        std::lock_guard<std::recursive_mutex> lk(WriteLock);
+        if (L1Entry.GuestCode == Address) {
+          L1Entry.GuestCode = 0;
+        }
+        return FindBlockLocked(Address);
       }
     }
-    
-    // Try L3
-    auto HostCode = BlockList.find(Address);
 
-    if (HostCode != BlockList.end()) {
-      CacheBlockMapping(Address, HostCode->second);
-      return HostCode->second;
-    }
-      
-    // Failed to find
-    return 0;
+    // L3 needs to be locked
+    std::lock_guard<std::recursive_mutex> lk(WriteLock);
+    return FindBlockLocked(Address);
   }
 
-  std::map<uint64_t, std::vector<uint64_t>> CodePages;
+  // Guest page to the block entries that contain code from that page
+  tsl::robin_map<uint64_t, std::vector<uint64_t>> CodePages;
 
   // Returns true if new pages are marked as containing code
   bool AddBlockMapping(uint64_t Address, void *HostCode, uint64_t Start, uint64_t Length) {
@@ -85,8 +119,9 @@ public:
     bool rv = false;
 
     for (auto CurrentPage = Start >> 12, EndPage = (Start + Length) >> 12; CurrentPage <= EndPage; CurrentPage++) {
-      rv |= CodePages[CurrentPage].size() == 0;
-      CodePages[CurrentPage].push_back(Address);
+      auto &PageBlocks = CodePages[CurrentPage];
+      rv |= PageBlocks.size() == 0;
+      PageBlocks.push_back(Address);
     }
 
     // There is no need to update L1 or L2, they will get updated on first lookup
@@ -101,12 +136,15 @@ public:
   void Erase(uint64_t Address) {
 
     std::lock_guard<std::recursive_mutex> lk(WriteLock);
+    L2WriteScope Scope {this};
 
     // Sever any links to this block
-    auto lower = BlockLinks.lower_bound({Address, 0});
-    auto upper = BlockLinks.upper_bound({Address, UINTPTR_MAX});
-    for (auto it = lower; it != upper; it = BlockLinks.erase(it)) {
-      it->second();
+    auto Links = BlockLinks.find(Address);
+    if (Links != BlockLinks.end()) {
+      for (auto const &Record : Links->second) {
+        Record.Delinker(Record);
+      }
+      BlockLinks.erase(Links);
     }
 
     // Remove from BlockList
@@ -135,20 +173,57 @@ public:
 
     // Page exists, just set the offset to zero
     auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
-    BlockPointers[PageOffset].GuestCode = 0;
-    BlockPointers[PageOffset].HostCode = 0;
+    std::atomic_ref<uintptr_t>(BlockPointers[PageOffset].GuestCode).store(0, std::memory_order_relaxed);
+    std::atomic_ref<uintptr_t>(BlockPointers[PageOffset].HostCode).store(0, std::memory_order_relaxed);
   }
 
 
-  void AddBlockLink(uint64_t GuestDestination, uintptr_t HostLink, const std::function<void()> &delinker) {
+  /**
+   * @brief Swaps the host code of a block for a recompiled version
+   *
+   * Links to the old code are severed so they relink to the new code on their next use.
+   *
+   * @return true if new pages are marked as containing code
+   */
+  bool ReplaceBlockMapping(uint64_t Address, void *HostCode, uint64_t Start, uint64_t Length) {
+    std::lock_guard<std::recursive_mutex> lk(WriteLock);
+    Erase(Address);
+    return AddBlockMapping(Address, HostCode, Start, Length);
+  }
+
+  void AddBlockLink(uint64_t GuestDestination, BlockLinkRecord const &Record) {
     std::lock_guard<std::recursive_mutex> lk(WriteLock);
 
-    BlockLinks.insert({{GuestDestination, HostLink}, delinker});
+    auto &Links = BlockLinks[GuestDestination];
+    for (auto const &Link : Links) {
+      if (Link.HostLink == Record.HostLink) {
+        // Already linked, the first delinker wins
+        return;
+      }
+    }
+    Links.emplace_back(Record);
   }
 
   void ClearCache();
   void ClearL2Cache();
 
+  /**
+   * @brief Removes every block whose host code lives in [HostStart, HostEnd)
+   *
+   * Used when a CPU backend evicts part of its code buffer.
+   * Links from surviving blocks in to the range are severed, links that live inside the range are dropped without being run.
+   */
+  void EraseHostCodeRange(uintptr_t HostStart, uintptr_t HostEnd);
+
+  /**
+   * @brief Fills an empty entry of an indirect branch cache with the block for GuestRIP
+   *
+   * The entry is reset to empty through a block link when the block goes away.
+   *
+   * @return The host code for GuestRIP, or zero if it isn't compiled
+   */
+  uintptr_t LinkIndirectBranchCache(IndirectBranchCache *Cache, uint64_t GuestRIP);
+
   void HintUsedRange(uint64_t Address, uint64_t Size);
 
   uintptr_t GetL1Pointer() const { return L1Pointer; }
@@ -158,16 +233,86 @@ public:
   constexpr static size_t L1_ENTRIES = 1 * 1024 * 1024; // Must be a power of 2
   constexpr static size_t L1_ENTRIES_MASK = L1_ENTRIES - 1;
 
-  // This needs to be taken before reads or writes to L2, L3, CodePages, Thread::LocalIRCache,
-  // and before writes to L1. Concurrent access from a thread that this LookupCache doesn't belong to 
+  // This needs to be taken before writes to L2, reads or writes to L3, CodePages, Thread::LocalIRCache,
+  // and before writes to L1 other than the owning thread filling it from FindBlock.
+  // Concurrent access from a thread that this LookupCache doesn't belong to
   // may only happen during cross thread invalidation (::Erase).
   // All other operations must be done from the owning thread.
   // Some care is taken so that L1 lookups can be done without locks, and even tearing is unlikely to lead to a crash.
   // This approach has not been fully vetted yet.
-  // Also note that L1 lookups might be inlined in the JIT Dispatcher and/or block ends.
+  // L2 reads are lock-free and validated against L2Sequence, which writers bump through L2WriteScope.
+  // Also note that L1 and L2 lookups might be inlined in the JIT Dispatcher and/or block ends.
   std::recursive_mutex WriteLock;
 
 private:
+  /**
+   * @brief Marks a section that modifies L2, or L1 entries of a thread that might be doing a lock-free lookup
+   *
+   * L2 is a seqlock, the sequence is odd while a writer is active.
+   * Sections nest, only the outermost one touches the sequence. Needs WriteLock to be held.
+   */
+  class L2WriteScope final {
+  public:
+    explicit L2WriteScope(LookupCache *Cache)
+      : Cache {Cache} {
+      if (Cache->L2WriteDepth++ == 0) {
+        Cache->L2Sequence.fetch_add(1, std::memory_order_seq_cst);
+      }
+    }
+
+    ~L2WriteScope() {
+      if (--Cache->L2WriteDepth == 0) {
+        Cache->L2Sequence.fetch_add(1, std::memory_order_release);
+      }
+    }
+
+  private:
+    LookupCache *Cache;
+  };
+
+  uintptr_t FindBlockInL2(uint64_t Address) const {
+    const auto PageIndex = (Address & (VirtualMemSize -1)) >> 12;
+    const auto PageOffset = Address & (0x0FFF);
+
+    // Pages can be released by another thread at any point, relaxed loads are enough since the sequence validates the result
+    auto Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
+    const auto LocalPagePointer = std::atomic_ref<uintptr_t>(Pointers[PageIndex]).load(std::memory_order_relaxed);
+
+    // Do we a page pointer for this address?
+    if (!LocalPagePointer) {
+      return 0;
+    }
+
+    // Find there pointer for the address in the blocks
+    auto &Entry = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer)[PageOffset];
+    const auto HostCode = std::atomic_ref<uintptr_t>(Entry.HostCode).load(std::memory_order_relaxed);
+    const auto GuestCode = std::atomic_ref<uintptr_t>(Entry.GuestCode).load(std::memory_order_relaxed);
+
+    return GuestCode == Address ? HostCode : 0;
+  }
+
+  // WriteLock must be held
+  uintptr_t FindBlockLocked(uint64_t Address) {
+    // Try L2
+    if (auto HostCode = FindBlockInL2(Address)) {
+      auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1Pointer)[Address & L1_ENTRIES_MASK];
+      L1Entry.GuestCode = Address;
+      L1Entry.HostCode = HostCode;
+      return HostCode;
+    }
+
+    // Try L3
+    auto HostCode = BlockList.find(Address);
+
+    if (HostCode != BlockList.end()) {
+      CacheBlockMapping(Address, HostCode->second);
+      return HostCode->second;
+    }
+
+    // Failed to find
+    return 0;
+  }
+
   void CacheBlockMapping(uint64_t Address, uintptr_t HostCode) { 
     std::lock_guard<std::recursive_mutex> lk(WriteLock);
 
@@ -186,15 +331,10 @@ private:
     uint64_t LocalPagePointer = Pointers[Address];
     if (!LocalPagePointer) {
       // We don't have a page pointer for this address
-      // Allocate one now if we can
-      uintptr_t NewPageBacking = AllocateBackingForPage();
-      if (!NewPageBacking) {
-        // Couldn't allocate, clear L2 and retry
-        ClearL2Cache();
-        CacheBlockMapping(Address, HostCode);
-        return;
-      }
-      Pointers[Address] = NewPageBacking;
+      // Allocate one now, this evicts the backing of another page once the backing memory is used up
+      L2WriteScope Scope {this};
+      uintptr_t NewPageBacking = AllocateBackingForPage(Address);
+      std::atomic_ref<uintptr_t>(Pointers[Address]).store(NewPageBacking, std::memory_order_relaxed);
       LocalPagePointer = NewPageBacking;
     }
 
@@ -202,51 +342,59 @@ private:
     auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
 
     // This silently replaces existing mappings
-    BlockPointers[PageOffset].GuestCode = FullAddress;
-    BlockPointers[PageOffset].HostCode = HostCode;
+    L2WriteScope Scope {this};
+    std::atomic_ref<uintptr_t>(BlockPointers[PageOffset].GuestCode).store(FullAddress, std::memory_order_relaxed);
+    std::atomic_ref<uintptr_t>(BlockPointers[PageOffset].HostCode).store(HostCode, std::memory_order_relaxed);
   }
 
-  uintptr_t AllocateBackingForPage() {
+  // WriteLock must be held and an L2WriteScope must be active
+  uintptr_t AllocateBackingForPage(uint64_t PageIndex) {
     uintptr_t NewBase = AllocateOffset;
     uintptr_t NewEnd = AllocateOffset + SIZE_PER_PAGE;
 
-    if (NewEnd >= CODE_SIZE) {
-      // We ran out of block backing space. Need to clear the block cache and tell the JIT cores to clear their caches as well
-      // Tell whatever is calling this that it needs to do it.
-      return 0;
+    if (NewEnd <= CODE_SIZE) {
+      AllocateOffset = NewEnd;
+      BackedPages.push_back(PageIndex);
+      return PageMemory + NewBase;
     }
 
-    AllocateOffset = NewEnd;
-    return PageMemory + NewBase;
+    // We ran out of block backing space, take over the backing that was handed out the longest time ago.
+    // L2 only caches L3, so the blocks of the evicted page stay compiled and get cached again on their next lookup.
+    const size_t Slot = EvictCursor;
+    EvictCursor = (EvictCursor + 1) % BackedPages.size();
+
+    auto Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
+    std::atomic_ref<uintptr_t>(Pointers[BackedPages[Slot]]).store(0, std::memory_order_relaxed);
+    BackedPages[Slot] = PageIndex;
+
+    const uintptr_t Backing = PageMemory + Slot * SIZE_PER_PAGE;
+    madvise(reinterpret_cast<void*>(Backing), SIZE_PER_PAGE, MADV_DONTNEED);
+    return Backing;
   }
 
   uintptr_t PagePointer;
   uintptr_t PageMemory;
   uintptr_t L1Pointer;
 
-  struct BlockLinkTag {
-    uint64_t GuestDestination;
-    uintptr_t HostLink;
-
-    bool operator <(const BlockLinkTag& other) const {
-      if (GuestDestination < other.GuestDestination)
-        return true;
-      else if (GuestDestination == other.GuestDestination)
-        return HostLink < other.HostLink;
-      else
-        return false;
-    }
-  };
-
-
-  std::map<BlockLinkTag, std::function<void()>> BlockLinks;
-  std::map<uint64_t, uint64_t> BlockList;
+  // Guest destination to every link that jumps directly to it
+  tsl::robin_map<uint64_t, std::vector<BlockLinkRecord>> BlockLinks;
+  // Guest entry to host code, the L3 that backs L1 and L2
+  tsl::robin_map<uint64_t, uint64_t> BlockList;
 
   constexpr static size_t CODE_SIZE = 128 * 1024 * 1024;
   constexpr static size_t SIZE_PER_PAGE = 4096 * sizeof(LookupCacheEntry);
   constexpr static size_t L1_SIZE = L1_ENTRIES * sizeof(LookupCacheEntry);
 
   size_t AllocateOffset {};
+  // Guest page index that each allocated page backing belongs to, in allocation order
+  std::vector<uint64_t> BackedPages;
+  // Next page backing to evict once the backing memory is used up
+  size_t EvictCursor {};
+
+  // Odd while L2 is being written to
+  std::atomic<uint64_t> L2Sequence{};
+  // Nesting depth of L2WriteScope, protected by WriteLock
+  uint32_t L2WriteDepth{};
 
   FEXCore::Context::Context *ctx;
   uint64_t VirtualMemSize{};
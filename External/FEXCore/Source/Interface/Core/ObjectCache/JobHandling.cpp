@@ -37,7 +37,8 @@ namespace FEXCore::CodeSerialize {
 
         auto &EntryMap = CodeObjectCacheService->GetEntryMap();
 
-        auto it = EntryMap.emplace(Base, std::move(Entry));
+        // try_emplace leaves Entry untouched if the insert fails, it's still needed for the overwrite
+        auto it = EntryMap.try_emplace(Base, std::move(Entry));
         if (!it.second) {
           // This happens when an application overwrites a previous region without unmapping what was there
 
@@ -45,6 +46,10 @@ namespace FEXCore::CodeSerialize {
           // Once this passes then we know that this section has been loaded.
           it.first->second->NamedJobRefCountMutex.lock();
 
+          // Wait for any outstanding serialization jobs on this entry to complete
+          it.first->second->ObjectJobRefCountMutex.lock();
+          it.first->second->ObjectJobRefCountMutex.unlock();
+
           // Finalize anything the region needs to do first.
           CodeObjectCacheService->DoCodeRegionClosure(it.first->second->Base, it.first->second.get());
 
@@ -57,6 +62,9 @@ namespace FEXCore::CodeSerialize {
             CodeObjectCacheService->GetUnrelocatedEntryMap().erase(it.first->second->EntryHeader.OriginalBase);
           }
 
+          // Nothing can be waiting on the old entry while we hold the map lock, safe to release before destruction
+          it.first->second->NamedJobRefCountMutex.unlock();
+
           // Now overwrite the entry in the map
           it = EntryMap.insert_or_assign(Base, std::move(Entry));
           EntryIterator = it.first;
@@ -93,6 +101,10 @@ namespace FEXCore::CodeSerialize {
         // Once this passes it will have been loaded
         it->second->NamedJobRefCountMutex.lock();
 
+        // Wait for any outstanding serialization jobs on this entry to complete
+        it->second->ObjectJobRefCountMutex.lock();
+        it->second->ObjectJobRefCountMutex.unlock();
+
         // Take the pointer from the map
         EntryPointer = std::move(it->second);
 
@@ -122,6 +134,45 @@ namespace FEXCore::CodeSerialize {
   }
 
   void AsyncJobHandler::AsyncAddSerializationJob(std::unique_ptr<SerializationJobData> Data) {
-    // XXX: Actually add serialization job
+    // This function adds a code serialization *JOB* to the serialization queue
+    // This needs to be as fast as possible to keep out of the way of the JIT
+    {
+      std::shared_lock lk {CodeObjectCacheService->GetEntryMapMutex()};
+
+      auto &EntryMap = CodeObjectCacheService->GetEntryMap();
+
+      // Find the named region that this code belongs to
+      auto it = EntryMap.upper_bound(Data->GuestRIP);
+      if (it == EntryMap.begin()) {
+        return;
+      }
+      --it;
+
+      const auto RegionEnd = it->second->Base + it->second->Size;
+      if (Data->GuestRIP >= RegionEnd ||
+          Data->GuestCodeStart < it->second->Base ||
+          (Data->GuestCodeStart + Data->GuestCodeLength) > RegionEnd) {
+        // Code that isn't fully backed by a named region can't be serialized
+        return;
+      }
+
+      // Hold the region's job ref counter so it can't be removed until this job is complete
+      it->second->ObjectJobRefCountMutex.lock_shared();
+      Data->ObjectJobRefCountMutexPtr = &it->second->ObjectJobRefCountMutex;
+      Data->CodeRegionIterator = it;
+    }
+
+    // Hash the guest code now, before it has a chance to change
+    Data->GuestCodeHash = XXH3_64bits(reinterpret_cast<const void*>(Data->GuestCodeStart), Data->GuestCodeLength);
+
+    // Block linking backpatches the host code once it starts executing, take a copy while it is still pristine
+    const char *HostCodeBegin = reinterpret_cast<const char*>(Data->HostCodeBegin);
+    Data->HostCode.assign(HostCodeBegin, HostCodeBegin + Data->HostCodeLength);
+    Data->HostCodeHash = XXH3_64bits(Data->HostCode.data(), Data->HostCode.size());
+
+    // Thread can't shut down or clear its code cache until this job is complete
+    Data->ThreadJobRefCount->lock_shared();
+
+    CodeObjectCacheService->AddSerializationJobToQueue(std::move(Data));
   }
 }
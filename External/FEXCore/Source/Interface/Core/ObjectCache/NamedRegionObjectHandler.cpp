@@ -2,6 +2,17 @@
 #include "Interface/Core/ObjectCache/ObjectCacheService.h"
 
 #include <FEXCore/Config/Config.h>
+#include <FEXCore/Utils/Allocator.h>
+#include <FEXCore/Utils/LogManager.h>
+#include <FEXCore/Utils/MathUtils.h>
+
+#include <fcntl.h>
+#include <filesystem>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <xxhash.h>
 
 namespace FEXCore::CodeSerialize {
   NamedRegionObjectHandler::NamedRegionObjectHandler(FEXCore::Context::Context *ctx) {
@@ -21,19 +32,124 @@ namespace FEXCore::CodeSerialize {
     DefaultSerializationConfig.Is64BitMode = ctx->Config.Is64BitMode;
     DefaultSerializationConfig.SMCChecks = ctx->Config.SMCChecks;
     DefaultSerializationConfig.x87ReducedPrecision = ctx->Config.x87ReducedPrecision;
+
+    CacheDirectory = FEXCore::Config::GetDataDirectory() + "cache/";
+
+    std::error_code ec{};
+    std::filesystem::create_directories(CacheDirectory, ec);
+  }
+
+  void NamedRegionObjectHandler::LoadObjectFile(CodeRegionEntry *Entry) {
+    int fd = open(Entry->ObjectEntrySourceFilename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      // Nothing cached for this region yet
+      return;
+    }
+
+    struct stat buf{};
+    if (fstat(fd, &buf) == -1 ||
+        buf.st_size < static_cast<off_t>(sizeof(CodeObjectSerializationHeader))) {
+      close(fd);
+      return;
+    }
+
+    // Map the file private, other processes can keep appending to it while we are running
+    const size_t FileSize = buf.st_size;
+    void *Data = FEXCore::Allocator::mmap(nullptr, FileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (Data == MAP_FAILED) {
+      return;
+    }
+
+    Entry->CodeData = reinterpret_cast<char*>(Data);
+    Entry->FileSize = FileSize;
+
+    const auto *Header = reinterpret_cast<const CodeObjectSerializationHeader*>(Entry->CodeData);
+    if (!(Header->Config == DefaultSerializationConfig)) {
+      // Same file name with a different configuration means a different FEX version, the writer will stop appending
+      LogMan::Msg::IFmt("Code object cache: Config mismatch for {}", Entry->ObjectEntrySourceFilename);
+      return;
+    }
+
+    // Walk the objects once to find where they are
+    size_t CurrentOffset = sizeof(CodeObjectSerializationHeader);
+    while ((CurrentOffset + sizeof(CodeSerializationData)) <= FileSize) {
+      const auto *Object = reinterpret_cast<const CodeSerializationData*>(Entry->CodeData + CurrentOffset);
+      const size_t Remaining = FileSize - CurrentOffset - sizeof(CodeSerializationData);
+
+      // A process that crashed or ran out of disk space mid-write leaves a truncated object at the end, stop there
+      if (Object->RelocationsSize > Remaining ||
+          Object->HostCodeLength > Remaining ||
+          (Object->RelocationsSize % alignof(FEXCore::CPU::Relocation)) != 0) {
+        break;
+      }
+
+      const size_t ObjectSize = sizeof(CodeSerializationData) + Object->RelocationsSize + FEXCore::AlignUp(Object->HostCodeLength, sizeof(uint64_t));
+      if ((CurrentOffset + ObjectSize) > FileSize) {
+        break;
+      }
+
+      const char *Relocations = Entry->CodeData + CurrentOffset + sizeof(CodeSerializationData);
+      Entry->FileCodeSections.emplace_back(CodeObjectFileSection {
+        .Serialized = true,
+        .Invalid = false,
+        .Data = Object,
+        .HostCode = Relocations + Object->RelocationsSize,
+        .NumRelocations = Object->NumRelocations,
+        .Relocations = Relocations,
+      });
+
+      CurrentOffset += ObjectSize;
+    }
+
+    // Sections won't move anymore, build the lookup map
+    // Later objects for the same RIP were serialized more recently and win
+    Entry->SectionLookupMap.reserve(Entry->FileCodeSections.size());
+    for (auto &Section : Entry->FileCodeSections) {
+      Entry->SectionLookupMap.insert_or_assign(Section.Data->GuestRIPOffset, &Section);
+    }
   }
 
   void NamedRegionObjectHandler::AddNamedRegionObject(CodeRegionMapType::iterator Entry, const std::string &base_filename, const std::string &filename, bool Executable) {
-    // XXX: Add named region objects
+    CodeRegionEntry *RegionEntry = Entry->second.get();
+
+    // Objects are keyed by the identity of the file that backs the region and the offset of the region in the file
+    // A file that has been replaced on disk gets a new object file rather than a pile of stale objects
+    struct stat buf{};
+    if (!Executable || stat(filename.c_str(), &buf) == -1) {
+      RegionEntry->StillSerializing = false;
+      RegionEntry->NamedJobRefCountMutex.unlock();
+      return;
+    }
+
+    const uint64_t FileIdentity[] = {
+      XXH3_64bits(filename.c_str(), filename.size()),
+      static_cast<uint64_t>(buf.st_size),
+      static_cast<uint64_t>(buf.st_mtim.tv_sec),
+      static_cast<uint64_t>(buf.st_mtim.tv_nsec),
+    };
 
-    // XXX: Until entry loading is complete just claim it is loaded
-    Entry->second->NamedJobRefCountMutex.unlock();
+    RegionEntry->ObjectEntrySourceFilename = fmt::format("{}{}-{:016x}-{:x}-{:016x}.fco",
+      CacheDirectory,
+      base_filename,
+      XXH3_64bits(FileIdentity, sizeof(FileIdentity)),
+      RegionEntry->Offset,
+      CodeObjectSerializationConfig::GetHash(DefaultSerializationConfig));
+
+    LoadObjectFile(RegionEntry);
+
+    // Entry is loaded, unblock anything waiting on it
+    RegionEntry->NamedJobRefCountMutex.unlock();
   }
 
   void NamedRegionObjectHandler::RemoveNamedRegionObject(uintptr_t Base, uintptr_t Size, std::unique_ptr<CodeRegionEntry> Entry) {
-    // XXX: Remove named region objects
+    // File data was already unmapped when the entry was pulled from the map, only the serialization FD remains
+    if (Entry->CurrentSerializedFD != -1) {
+      close(Entry->CurrentSerializedFD);
+      Entry->CurrentSerializedFD = -1;
+    }
 
-    // XXX: Until entry loading is complete just claim it is loaded
     Entry->NamedJobRefCountMutex.unlock();
   }
 
@@ -1,8 +1,17 @@
 #include "Interface/Core/ObjectCache/ObjectCacheService.h"
 
 #include <FEXCore/Config/Config.h>
+#include <FEXCore/Utils/LogManager.h>
+#include <FEXCore/Utils/MathUtils.h>
 
+#include <fcntl.h>
+#include <iterator>
 #include <memory>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <xxhash.h>
 
 namespace {
   static void* ThreadHandler(void *Arg) {
@@ -51,12 +60,166 @@ namespace FEXCore::CodeSerialize {
       // Don't do closure on canary
       return;
     }
-    // XXX: Do code region closure
+
+    // Close out the serialization file, everything has been written with writev so there is nothing to flush
+    if (it->CurrentSerializedFD != -1) {
+      close(it->CurrentSerializedFD);
+      it->CurrentSerializedFD = -1;
+    }
   }
 
   CodeObjectFileSection const *CodeObjectSerializeService::FetchCodeObjectFromCache(uint64_t GuestRIP) {
-    // XXX: Actually fetch code objects from cache
-    return nullptr;
+    std::shared_lock lk {EntryMapMutex};
+
+    // Find the named region that contains this RIP
+    // The canary at the end of the map means upper_bound always has something to step back from
+    auto it = AddressToEntryMap.upper_bound(GuestRIP);
+    if (it == AddressToEntryMap.begin()) {
+      return nullptr;
+    }
+    --it;
+
+    CodeRegionEntry *Entry = it->second.get();
+    if (GuestRIP >= (Entry->Base + Entry->Size)) {
+      return nullptr;
+    }
+
+    // Wait for the async thread to finish loading the region if it hasn't yet
+    std::shared_lock lk2 {Entry->NamedJobRefCountMutex};
+
+    auto SectionIt = Entry->SectionLookupMap.find(GuestRIP - Entry->Base);
+    if (SectionIt == Entry->SectionLookupMap.end()) {
+      return nullptr;
+    }
+
+    const CodeObjectFileSection *Section = SectionIt->second;
+    if (Section->Invalid) {
+      return nullptr;
+    }
+
+    // Only use the object if the guest code it was compiled from is still the same
+    const auto *Data = Section->Data;
+    if ((Data->GuestCodeOffset + Data->GuestCodeLength) > Entry->Size) {
+      return nullptr;
+    }
+
+    auto GuestCodeHash = XXH3_64bits(reinterpret_cast<const void*>(Entry->Base + Data->GuestCodeOffset), Data->GuestCodeLength);
+    if (GuestCodeHash != Data->GuestCodeHash) {
+      return nullptr;
+    }
+
+    return Section;
+  }
+
+  void CodeObjectSerializeService::SerializeCodeObject(CodeRegionEntry *Entry, AsyncJobHandler::SerializationJobData *Data) {
+    if (!Entry->StillSerializing) {
+      return;
+    }
+
+    if (Entry->CurrentSerializedFD == -1) {
+      int fd = open(Entry->ObjectEntrySourceFilename.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+      if (fd == -1) {
+        Entry->StillSerializing = false;
+        return;
+      }
+
+      // Multiple FEX processes can be appending to the same file
+      // Hold the file lock while checking or writing the file header
+      flock(fd, LOCK_EX);
+
+      bool Valid = false;
+      struct stat buf{};
+      if (fstat(fd, &buf) == 0) {
+        if (buf.st_size == 0) {
+          Valid = write(fd, &Entry->EntryHeader, sizeof(Entry->EntryHeader)) == sizeof(Entry->EntryHeader);
+        }
+        else {
+          CodeObjectSerializationHeader Header{};
+          Valid = pread(fd, &Header, sizeof(Header), 0) == sizeof(Header) &&
+                  Header.Config == Entry->EntryHeader.Config;
+        }
+      }
+
+      flock(fd, LOCK_UN);
+
+      if (!Valid) {
+        LogMan::Msg::IFmt("Code object cache: Disabling serialization for {}", Entry->ObjectEntrySourceFilename);
+        close(fd);
+        Entry->StillSerializing = false;
+        return;
+      }
+
+      Entry->CurrentSerializedFD = fd;
+    }
+
+    // Pack the relocations down to their real sizes
+    std::vector<char> PackedRelocations;
+    for (auto &Reloc : Data->Relocations) {
+      const size_t RelocSize = FEXCore::CPU::GetPackedRelocationSize(Reloc.Header.Type);
+      const char *RelocData = reinterpret_cast<const char*>(&Reloc);
+      PackedRelocations.insert(PackedRelocations.end(), RelocData, RelocData + RelocSize);
+    }
+
+    CodeSerializationData Header {
+      .GuestRIPOffset = Data->GuestRIP - Entry->Base,
+      .OriginalGuestRIP = Data->GuestRIP,
+      .GuestCodeOffset = Data->GuestCodeStart - Entry->Base,
+      .GuestCodeLength = Data->GuestCodeLength,
+      .GuestCodeHash = Data->GuestCodeHash,
+      .HostCodeLength = Data->HostCode.size(),
+      .NumRelocations = Data->Relocations.size(),
+      .RelocationsSize = PackedRelocations.size(),
+    };
+
+    // Keep the next object's header aligned
+    static constexpr uint64_t Padding{};
+    const size_t PaddingSize = FEXCore::AlignUp(Data->HostCode.size(), sizeof(uint64_t)) - Data->HostCode.size();
+
+    const struct iovec iov[] = {
+      { .iov_base = &Header, .iov_len = sizeof(Header) },
+      { .iov_base = PackedRelocations.data(), .iov_len = PackedRelocations.size() },
+      { .iov_base = Data->HostCode.data(), .iov_len = Data->HostCode.size() },
+      { .iov_base = const_cast<uint64_t*>(&Padding), .iov_len = PaddingSize },
+    };
+    const ssize_t TotalSize = sizeof(Header) + PackedRelocations.size() + Data->HostCode.size() + PaddingSize;
+
+    flock(Entry->CurrentSerializedFD, LOCK_EX);
+    const ssize_t Written = writev(Entry->CurrentSerializedFD, iov, std::size(iov));
+    flock(Entry->CurrentSerializedFD, LOCK_UN);
+
+    if (Written != TotalSize) {
+      // Partial writes leave a truncated object at the end of the file which the loader will skip
+      // Anything appended after it would be lost, so stop serializing this region
+      Entry->StillSerializing = false;
+    }
+  }
+
+  void CodeObjectSerializeService::HandleSerializationJobs() {
+    // Walk through all of our jobs sequentially until the work queue is empty
+    while (SerializationQueueJobs.load()) {
+      std::unique_ptr<AsyncJobHandler::SerializationJobData> Job;
+
+      {
+        // Lock the work queue mutex for a short moment and grab an item from the list
+        std::unique_lock lk {SerializationQueueMutex};
+        if (!SerializationQueue.empty()) {
+          Job = std::move(SerializationQueue.front());
+          SerializationQueue.pop();
+        }
+
+        // Atomically update the number of jobs
+        --SerializationQueueJobs;
+      }
+
+      if (Job) {
+        // The region iterator is guaranteed to be alive while we hold its job ref count
+        SerializeCodeObject(Job->CodeRegionIterator->second.get(), Job.get());
+
+        // Job is complete, release the ref counters so region removal and thread shutdown can continue
+        Job->ObjectJobRefCountMutexPtr->unlock_shared();
+        Job->ThreadJobRefCount->unlock_shared();
+      }
+    }
   }
 
   void CodeObjectSerializeService::ExecutionThread() {
@@ -70,9 +233,14 @@ namespace FEXCore::CodeSerialize {
       // Handle named region async jobs first. Highest priority
       NamedRegionHandler.HandleNamedRegionObjectJobs();
 
-      // XXX: Handle code serialization jobs second.
+      // Handle code serialization jobs second.
+      HandleSerializationJobs();
     }
 
+    // Drain anything that was queued while shutting down, threads might be waiting on their job ref counts
+    NamedRegionHandler.HandleNamedRegionObjectJobs();
+    HandleSerializationJobs();
+
     // Do final code region closures on thread shutdown
     for (auto &it : AddressToEntryMap) {
       DoCodeRegionClosure(it.first, it.second.get());
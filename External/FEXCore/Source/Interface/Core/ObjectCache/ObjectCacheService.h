@@ -7,8 +7,11 @@
 #include <FEXCore/Utils/Event.h>
 #include <FEXCore/Utils/Threads.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
 #include <shared_mutex>
 #include <string>
 #include <vector>
@@ -17,8 +20,31 @@
 namespace FEXCore::CodeSerialize {
   // XXX: Does this need to be signal safe?
   using CodeSerializationMutex = std::shared_mutex;
+
+  /**
+   * @brief The header of a single serialized code object in an object cache file
+   *
+   * Objects are appended to the file back to back after the file header.
+   * Each object is laid out as:
+   * [CodeSerializationData]
+   * [Packed relocations, `RelocationsSize` bytes]
+   * [Host code, `HostCodeLength` bytes, padded to 8 bytes]
+   */
   struct CodeSerializationData {
+    // Offset of the block entry from the base of the named region
+    uint64_t GuestRIPOffset;
+    // The guest RIP at the time of compilation, guest RIP relocations are relative to this
+    uint64_t OriginalGuestRIP;
+    // Guest code range that the block was compiled from, offset from the base of the named region
+    uint64_t GuestCodeOffset;
+    uint64_t GuestCodeLength;
+    // Hash of the guest code range, an object is only used if the guest code still matches
+    uint64_t GuestCodeHash;
+    uint64_t HostCodeLength;
+    uint64_t NumRelocations;
+    uint64_t RelocationsSize;
   };
+  static_assert(sizeof(CodeSerializationData) % alignof(FEXCore::CPU::Relocation) == 0, "Relocations need to remain aligned");
 
   struct CodeObjectFileSection {
     bool Serialized;
@@ -144,7 +170,7 @@ namespace FEXCore::CodeSerialize {
        */
       struct SerializationJobData {
         uint64_t GuestRIP;        ///< The RIP for the guest
-        // XXX: Support multiblock
+        uint64_t GuestCodeStart;  ///< The lowest guest address that the block was compiled from
         uint64_t GuestCodeLength; ///< The Guest's code length
         uint64_t GuestCodeHash;   ///< Hash of the guest code
 
@@ -162,6 +188,9 @@ namespace FEXCore::CodeSerialize {
         // Relatively small number of entries most of the time
         std::vector<FEXCore::CPU::Relocation> Relocations;
 
+        // Copy of the host code taken when the job is added, before block linking can backpatch it
+        std::vector<char> HostCode;
+
         /**
          * @name Objects filled in from the Code Object Serialization service when a job is added
          * @{ */
@@ -312,6 +341,9 @@ namespace FEXCore::CodeSerialize {
       // Code serialization config for our current process configuration
       CodeObjectSerializationConfig DefaultSerializationConfig;
 
+      // Folder that the object cache files live in
+      std::string CacheDirectory;
+
       // Atomic counter for number of jobs in the queue without needing to pull the mutex to check
       std::atomic<uint64_t> NamedWorkQueueJobs{};
 
@@ -328,6 +360,13 @@ namespace FEXCore::CodeSerialize {
        * @{ */
         void AddNamedRegionObject(CodeRegionMapType::iterator Entry, const std::string &base_filename, const std::string &filename, bool Executable);
         void RemoveNamedRegionObject(uintptr_t Base, uintptr_t Size, std::unique_ptr<CodeRegionEntry> Entry);
+
+        /**
+         * @brief Maps an existing object cache file for the entry and builds its section lookup map
+         *
+         * Missing, mismatched, or truncated files are not an error, objects that can't be loaded get recompiled.
+         */
+        void LoadObjectFile(CodeRegionEntry *Entry);
       /**  @} */
   };
 
@@ -439,9 +478,37 @@ namespace FEXCore::CodeSerialize {
        */
       void NotifyWork() { WorkAvailable.NotifyOne(); }
 
+      /**
+       * @brief Adds a fully set up serialization job to the serialization queue
+       */
+      void AddSerializationJobToQueue(std::unique_ptr<AsyncJobHandler::SerializationJobData> Data) {
+        {
+          std::unique_lock lk {SerializationQueueMutex};
+          SerializationQueue.emplace(std::move(Data));
+          ++SerializationQueueJobs;
+        }
+        NotifyWork();
+      }
+
     private:
       FEXCore::Context::Context *CTX;
 
+      /**
+       * @name Code serialization job handling
+       * @{ */
+        void HandleSerializationJobs();
+
+        /**
+         * @brief Appends a code object to the region's object cache file
+         */
+        void SerializeCodeObject(CodeRegionEntry *Entry, AsyncJobHandler::SerializationJobData *Data);
+
+        // Atomic counter for number of jobs in the queue without needing to pull the mutex to check
+        std::atomic<uint64_t> SerializationQueueJobs{};
+        std::mutex SerializationQueueMutex{};
+        std::queue<std::unique_ptr<AsyncJobHandler::SerializationJobData>> SerializationQueue{};
+      /**  @} */
+
       Event WorkAvailable{};
       std::unique_ptr<FEXCore::Threads::Thread> WorkerThread;
       std::atomic_bool WorkerThreadShuttingDown {false};
@@ -18,6 +18,10 @@ namespace FEXCore::CPU {
     // 64-bit mov on x86-64
     // Aligned to struct RelocGuestRIPMove
     RELOC_GUEST_RIP_MOVE,
+
+    // 8 byte literal in memory for a guest RIP
+    // Aligned to struct RelocGuestRIPLiteral
+    RELOC_GUEST_RIP_LITERAL,
   };
 
   struct RelocationTypeHeader final {
@@ -65,6 +69,16 @@ namespace FEXCore::CPU {
     uint64_t GuestRIP;
   };
 
+  struct RelocGuestRIPLiteral final {
+    RelocationTypeHeader Header{};
+
+    // Offset in to the code section to begin the relocation
+    uint64_t Offset{};
+
+    // The unrelocated RIP that is stored in the literal
+    uint64_t GuestRIP;
+  };
+
   union Relocation {
     RelocationTypeHeader Header{};
 
@@ -74,5 +88,22 @@ namespace FEXCore::CPU {
     RelocNamedThunkMove NamedThunkMove;
 
     RelocGuestRIPMove GuestRIPMove;
+
+    RelocGuestRIPLiteral GuestRIPLiteral;
   };
+
+  /**
+   * @brief Returns the size of a relocation when it is packed in to a serialized relocation list
+   *
+   * Relocations are stored back to back at the size of their type, not the size of the union.
+   */
+  inline size_t GetPackedRelocationSize(RelocationTypes Type) {
+    switch (Type) {
+      case RelocationTypes::RELOC_NAMED_SYMBOL_LITERAL: return sizeof(RelocNamedSymbolLiteral);
+      case RelocationTypes::RELOC_NAMED_THUNK_MOVE: return sizeof(RelocNamedThunkMove);
+      case RelocationTypes::RELOC_GUEST_RIP_MOVE: return sizeof(RelocGuestRIPMove);
+      case RelocationTypes::RELOC_GUEST_RIP_LITERAL: return sizeof(RelocGuestRIPLiteral);
+    }
+    return sizeof(Relocation);
+  }
 }
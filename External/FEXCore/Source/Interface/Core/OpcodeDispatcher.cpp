@@ -18,9 +18,11 @@ $end_info$
 #include <FEXCore/IR/IREmitter.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
 #include <FEXCore/Utils/LogManager.h>
+#include <FEXHeaderUtils/TypeDefines.h>
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <tuple>
 
@@ -123,7 +125,7 @@ void OpDispatchBuilder::ThunkOp(OpcodeArgs) {
 
   const uint32_t RSPOffset = GPROffset(X86State::REG_RSP);
   const uint8_t GPRSize = CTX->GetGPRSize();
-  uint8_t *sha256 = (uint8_t *)(Op->PC + 2);
+  uint8_t *sha256 = (uint8_t *)(Op->PC + 2 + GuestCodeOffset);
 
   _Thunk(
     _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI)),
@@ -195,7 +197,7 @@ void OpDispatchBuilder::RETOp(OpcodeArgs) {
   _StoreContext(GPRSize, GPRClass, NewSP, RSPOffset);
 
   // Store the new RIP
-  _ExitFunction(NewRIP);
+  _ExitFunction(NewRIP, true);
   BlockSetRIP = true;
 }
 
@@ -753,6 +755,9 @@ void OpDispatchBuilder::CALLOp(OpcodeArgs) {
 
   _StoreMem(GPRClass, GPRSize, NewSP, ConstantPCReturn, GPRSize);
 
+  // Let the matching RET come straight back here
+  _PushReturnStack(ConstantPCReturn);
+
   // Store the RIP
   _ExitFunction(NewRIP); // If we get here then leave the function now
 }
@@ -761,8 +766,16 @@ void OpDispatchBuilder::CALLAbsoluteOp(OpcodeArgs) {
   const uint32_t RSPOffset = GPROffset(X86State::REG_RSP);
   const uint8_t GPRSize = CTX->GetGPRSize();
 
-  // Calculate flags early.
-  CalculateDeferredFlags();
+  // ABI Optimization: Flags don't survive calls or rets
+  if (CTX->Config.ABILocalFlags) {
+    _InvalidateFlags(~0UL); // all flags
+    // Deferred flags are invalidated now
+    InvalidateDeferredFlags();
+  }
+  else {
+    // Calculate flags early.
+    CalculateDeferredFlags();
+  }
 
   BlockSetRIP = true;
 
@@ -781,6 +794,9 @@ void OpDispatchBuilder::CALLAbsoluteOp(OpcodeArgs) {
 
   _StoreMem(GPRClass, Size, NewSP, ConstantPCReturn, Size);
 
+  // Let the matching RET come straight back here
+  _PushReturnStack(ConstantPCReturn);
+
   // Store the RIP
   _ExitFunction(JMPPCOffset); // If we get here then leave the function now
 }
@@ -1077,7 +1093,20 @@ void OpDispatchBuilder::CondJUMPOp(OpcodeArgs) {
 
   // Fallback
   {
-    auto CondJump = _CondJump(SrcCond);
+    IRPair<IROp_CondJump> CondJump{};
+    auto SrcCondOp = GetOpHeader(WrapNode(SrcCond));
+    if (SrcCondOp->Op == OP_SELECT) {
+      // Branch on the compare that SelectCC produced instead of materializing 0/1 and testing that.
+      // After a cmp or test this becomes a single compare and conditional branch in the backend
+      auto Select = SrcCondOp->C<IROp_Select>();
+      LOGMAN_THROW_A_FMT(UnwrapNode(Select->TrueVal) == TakeBranch.Node && UnwrapNode(Select->FalseVal) == DoNotTakeBranch.Node,
+                         "SelectCC returned an unexpected select");
+      CondJump = _CondJump(UnwrapNode(Select->Cmp1), UnwrapNode(Select->Cmp2),
+                           InvalidNode, InvalidNode, Select->Cond, Select->CompareSize);
+    }
+    else {
+      CondJump = _CondJump(SrcCond);
+    }
 
     // Taking branch block
     if (TrueBlock != JumpTargets.end()) {
@@ -1284,21 +1313,22 @@ void OpDispatchBuilder::JUMPOp(OpcodeArgs) {
   }
 
   // This is just an unconditional relative literal jump
+  // Without multiblock the entry is still a jump target, so blocks that jump back to themselves loop without leaving the JIT
+  auto JumpBlock = JumpTargets.find(TargetRIP);
+  if (JumpBlock != JumpTargets.end()) {
+    _Jump(GetNewJumpBlock(TargetRIP));
+    return;
+  }
+
   if (Multiblock) {
-    auto JumpBlock = JumpTargets.find(TargetRIP);
-    if (JumpBlock != JumpTargets.end()) {
-      _Jump(GetNewJumpBlock(TargetRIP));
-    }
-    else {
-      // If the block isn't a jump target then we need to create an exit block
-      auto Jump = _Jump();
+    // If the block isn't a jump target then we need to create an exit block
+    auto Jump = _Jump();
 
-      // Place after this block for fallthrough behavior
-      auto JumpTarget = CreateNewCodeBlockAfter(GetCurrentBlock());
-      SetJumpTarget(Jump, JumpTarget);
-      SetCurrentCodeBlock(JumpTarget);
-      _ExitFunction(GetRelocatedPC(Op, TargetOffset));
-    }
+    // Place after this block for fallthrough behavior
+    auto JumpTarget = CreateNewCodeBlockAfter(GetCurrentBlock());
+    SetJumpTarget(Jump, JumpTarget);
+    SetCurrentCodeBlock(JumpTarget);
+    _ExitFunction(GetRelocatedPC(Op, TargetOffset));
     return;
   }
 
@@ -3521,22 +3551,8 @@ void OpDispatchBuilder::STOSOp(OpcodeArgs) {
     _StoreContext(GPRSize, GPRClass, TailDest, GPROffset(X86State::REG_RDI));
   }
   else {
-    // Calculate deffered flags.
-    // This block is ending and it needs flag status
-    CalculateDeferredFlags();
-
-    // Create all our blocks
-    auto LoopHead = CreateNewCodeBlockAfter(GetCurrentBlock());
-    auto LoopTail = CreateNewCodeBlockAfter(LoopHead);
-    auto LoopEnd = CreateNewCodeBlockAfter(LoopTail);
-
-    // At the time this was written, our RA can't handle accessing nodes across blocks.
-    // So we need to re-load and re-calculate essential values each iteration of the loop.
-
-    // First thing we need to do is finish this block and jump to the start of the loop.
+    OrderedNode *Src = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
 
-    // RA can now better allocate things, move these ops before the header, to avoid accessing
-    // DF on every iteration
     auto SizeConst = _Constant(Size);
     auto NegSizeConst = _Constant(-Size);
 
@@ -3546,45 +3562,45 @@ void OpDispatchBuilder::STOSOp(OpcodeArgs) {
         DF,  _Constant(0),
         SizeConst, NegSizeConst);
 
-    _Jump(LoopHead);
+    auto JumpStart = _Jump();
+    // Make sure to start a new block after ending this one
+    auto LoopStart = CreateNewCodeBlockAfter(GetCurrentBlock());
+    SetJumpTarget(JumpStart, LoopStart);
+    SetCurrentCodeBlock(LoopStart);
 
-    SetCurrentCodeBlock(LoopHead);
-    {
-      OrderedNode *Counter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
-      // Can we end the block?
-      _CondJump(Counter, LoopEnd, LoopTail, {COND_EQ});
-    }
+    OrderedNode *Counter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
+
+    // Can we end the block?
+    auto CondJump = _CondJump(Counter, {COND_EQ});
 
+    auto LoopTail = CreateNewCodeBlockAfter(LoopStart);
+    SetFalseJumpTarget(CondJump, LoopTail);
     SetCurrentCodeBlock(LoopTail);
+
+    // Working loop, one guest page per iteration
     {
-      OrderedNode *Src = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-      OrderedNode *Dest = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
+      OrderedNode *RDI = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
 
       // Only ES prefix
-      Dest = AppendSegmentOffset(Dest, 0, FEXCore::X86Tables::DecodeFlags::FLAG_ES_PREFIX, true);
+      OrderedNode *Dest = AppendSegmentOffset(RDI, 0, FEXCore::X86Tables::DecodeFlags::FLAG_ES_PREFIX, true);
 
-      // Store to memory where RDI points
-      _StoreMemAutoTSO(GPRClass, Size, Dest, Src, Size);
+      OrderedNode *Elements = StringPageElements(Dest, DF, Size);
+      Elements = _Select(FEXCore::IR::COND_ULT, Elements, Counter, Elements, Counter);
 
-      OrderedNode *TailCounter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
-      OrderedNode *TailDest = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
+      _MemSet(CTX->Config.TSOEnabled, Size, Dest, Src, Elements, DF);
 
-      // Decrement counter
-      TailCounter = _Sub(TailCounter, _Constant(1));
-
-      // Store the counter so we don't have to deal with PHI here
-      _StoreContext(GPRSize, GPRClass, TailCounter, GPROffset(X86State::REG_RCX));
+      // Store the progress so a fault in the next page sees the elements already written
+      _StoreContext(GPRSize, GPRClass, _Sub(Counter, Elements), GPROffset(X86State::REG_RCX));
+      RDI = _Add(RDI, _Mul(Elements, PtrDir));
+      _StoreContext(GPRSize, GPRClass, RDI, GPROffset(X86State::REG_RDI));
 
-      // Offset the pointer
-      TailDest = _Add(TailDest, PtrDir);
-      _StoreContext(GPRSize, GPRClass, TailDest, GPROffset(X86State::REG_RDI));
-
-      // Jump back to the start, we have more work to do
-      _Jump(LoopHead);
+      auto Loop = _Jump();
+      SetJumpTarget(Loop, LoopStart);
     }
 
     // Make sure to start a new block after ending this one
-
+    auto LoopEnd = CreateNewCodeBlockAfter(LoopTail);
+    SetTrueJumpTarget(CondJump, LoopEnd);
     SetCurrentCodeBlock(LoopEnd);
   }
 }
@@ -3607,62 +3623,50 @@ void OpDispatchBuilder::MOVSOp(OpcodeArgs) {
   auto PtrDir = _Select(FEXCore::IR::COND_EQ, DF,  _Constant(0), SizeConst, NegSizeConst);
 
   if (Op->Flags & (FEXCore::X86Tables::DecodeFlags::FLAG_REP_PREFIX | FEXCore::X86Tables::DecodeFlags::FLAG_REPNE_PREFIX)) {
-    // Calculate flags early. because end of block
-    CalculateDeferredFlags();
-
-    // Create all our blocks
-    auto LoopHead = CreateNewCodeBlockAfter(GetCurrentBlock());
-    auto LoopTail = CreateNewCodeBlockAfter(LoopHead);
-    auto LoopEnd = CreateNewCodeBlockAfter(LoopTail);
-
-
-    // At the time this was written, our RA can't handle accessing nodes across blocks.
-    // So we need to re-load and re-calculate essential values each iteration of the loop.
-
-    // First thing we need to do is finish this block and jump to the start of the loop.
+    auto JumpStart = _Jump();
+    // Make sure to start a new block after ending this one
+    auto LoopStart = CreateNewCodeBlockAfter(GetCurrentBlock());
+    SetJumpTarget(JumpStart, LoopStart);
+    SetCurrentCodeBlock(LoopStart);
 
-    _Jump(LoopHead);
+    OrderedNode *Counter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
 
-    SetCurrentCodeBlock(LoopHead);
-    {
-      OrderedNode *Counter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
-      _CondJump(Counter, LoopEnd, LoopTail, {COND_EQ});
-    }
+    // Can we end the block?
+    auto CondJump = _CondJump(Counter, {COND_EQ});
 
+    auto LoopTail = CreateNewCodeBlockAfter(LoopStart);
+    SetFalseJumpTarget(CondJump, LoopTail);
     SetCurrentCodeBlock(LoopTail);
-    {
-      OrderedNode *Src = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RSI));
-      OrderedNode *Dest = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
-      Dest = AppendSegmentOffset(Dest, 0, FEXCore::X86Tables::DecodeFlags::FLAG_ES_PREFIX, true);
-      Src = AppendSegmentOffset(Src, Op->Flags, FEXCore::X86Tables::DecodeFlags::FLAG_DS_PREFIX);
-
-      Src = _LoadMemAutoTSO(GPRClass, Size, Src, Size);
-
-      // Store to memory where RDI points
-      _StoreMemAutoTSO(GPRClass, Size, Dest, Src, Size);
 
-      OrderedNode *TailCounter = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RCX));
-
-      // Decrement counter
-      TailCounter = _Sub(TailCounter, _Constant(1));
-
-      // Store the counter so we don't have to deal with PHI here
-      _StoreContext(GPRSize, GPRClass, TailCounter, GPROffset(X86State::REG_RCX));
-
-      // Offset the pointer
-      OrderedNode *TailSrc = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RSI));
-      OrderedNode *TailDest = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
-      TailSrc = _Add(TailSrc, PtrDir);
-      TailDest = _Add(TailDest, PtrDir);
-      _StoreContext(GPRSize, GPRClass, TailSrc, GPROffset(X86State::REG_RSI));
-      _StoreContext(GPRSize, GPRClass, TailDest, GPROffset(X86State::REG_RDI));
-
-      // Jump back to the start, we have more work to do
-      _Jump(LoopHead);
+    // Working loop, stops wherever either pointer crosses a guest page
+    {
+      OrderedNode *RSI = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RSI));
+      OrderedNode *RDI = _LoadContext(GPRSize, GPRClass, GPROffset(X86State::REG_RDI));
+      OrderedNode *Dest = AppendSegmentOffset(RDI, 0, FEXCore::X86Tables::DecodeFlags::FLAG_ES_PREFIX, true);
+      OrderedNode *Src = AppendSegmentOffset(RSI, Op->Flags, FEXCore::X86Tables::DecodeFlags::FLAG_DS_PREFIX);
+
+      OrderedNode *Elements = StringPageElements(Dest, DF, Size);
+      OrderedNode *SrcElements = StringPageElements(Src, DF, Size);
+      Elements = _Select(FEXCore::IR::COND_ULT, Elements, SrcElements, Elements, SrcElements);
+      Elements = _Select(FEXCore::IR::COND_ULT, Elements, Counter, Elements, Counter);
+
+      _MemCpy(CTX->Config.TSOEnabled, Size, Dest, Src, Elements, DF);
+
+      // Store the progress so a fault in the next page sees the elements already copied
+      auto Offset = _Mul(Elements, PtrDir);
+      _StoreContext(GPRSize, GPRClass, _Sub(Counter, Elements), GPROffset(X86State::REG_RCX));
+      RSI = _Add(RSI, Offset);
+      RDI = _Add(RDI, Offset);
+      _StoreContext(GPRSize, GPRClass, RSI, GPROffset(X86State::REG_RSI));
+      _StoreContext(GPRSize, GPRClass, RDI, GPROffset(X86State::REG_RDI));
+
+      auto Loop = _Jump();
+      SetJumpTarget(Loop, LoopStart);
     }
 
     // Make sure to start a new block after ending this one
-
+    auto LoopEnd = CreateNewCodeBlockAfter(LoopTail);
+    SetTrueJumpTarget(CondJump, LoopEnd);
     SetCurrentCodeBlock(LoopEnd);
   }
   else {
@@ -4554,6 +4558,21 @@ uint32_t OpDispatchBuilder::GetDstBitSize(X86Tables::DecodedOp Op) const {
   return GetDstSize(Op) * 8;
 }
 
+OrderedNode *OpDispatchBuilder::StringPageElements(OrderedNode *Addr, OrderedNode *DF, uint8_t Size) {
+  // Every element of the run touches the same guest page as the first one.
+  // A fault can then only happen on the first element, before anything of the run was written,
+  // so the RCX/RSI/RDI progress stored after the previous run is the state the guest must see.
+  auto PageOffset = _And(Addr, _Constant(FHU::FEX_PAGE_SIZE - 1));
+  auto Remaining = _Select(FEXCore::IR::COND_EQ,
+    DF, _Constant(0),
+    _Sub(_Constant(FHU::FEX_PAGE_SIZE), PageOffset), _Add(PageOffset, _Constant(Size)));
+  OrderedNode *Elements = _Lshr(Remaining, _Constant(std::countr_zero(Size)));
+
+  // An element straddling the page boundary runs on its own
+  Elements = _Select(FEXCore::IR::COND_UGT, Remaining, _Constant(FHU::FEX_PAGE_SIZE), _Constant(1), Elements);
+  return _Select(FEXCore::IR::COND_EQ, Elements, _Constant(0), _Constant(1), Elements);
+}
+
 OrderedNode *OpDispatchBuilder::AppendSegmentOffset(OrderedNode *Value, uint32_t Flags, uint32_t DefaultPrefix, bool Override) {
   const uint8_t GPRSize = CTX->GetGPRSize();
 
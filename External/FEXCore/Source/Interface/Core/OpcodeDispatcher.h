@@ -626,6 +626,9 @@ public:
 
   void SetMultiblock(bool _Multiblock) { Multiblock = _Multiblock; }
 
+  // Where guest code bytes are read from, the same place the decoder read them
+  void SetGuestCode(uint8_t const *Code, uint64_t RIP) { GuestCodeOffset = reinterpret_cast<uintptr_t>(Code) - RIP; }
+
   bool HandledLock = false;
 private:
   bool DecodeFailure{false};
@@ -633,6 +636,8 @@ private:
   OrderedNode *Current_HeaderNode{};
 
   OrderedNode *AppendSegmentOffset(OrderedNode *Value, uint32_t Flags, uint32_t DefaultPrefix = 0, bool Override = false);
+  // Number of REP string elements from Addr up to the end of its guest page in the DF direction, at least one
+  OrderedNode *StringPageElements(OrderedNode *Addr, OrderedNode *DF, uint8_t Size);
 
   enum class MemoryAccessType {
     // Choose TSO or Non-TSO depending on access type
@@ -786,6 +791,8 @@ private:
   void CalculcateFlags_SBB(uint8_t SrcSize, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, OrderedNode *CF);
   void CalculcateFlags_SUB(uint8_t SrcSize, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, bool UpdateCF = true);
   void CalculcateFlags_ADD(uint8_t SrcSize, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, bool UpdateCF = true);
+  // Sets SF/ZF/OF, and CF if asked for, from the result of HostNZCV
+  void CalculateFlagsFromNZCV(OrderedNode *NZCV, bool IsSub, bool UpdateCF);
   void CalculcateFlags_MUL(uint8_t SrcSize, OrderedNode *Res, OrderedNode *High);
   void CalculcateFlags_UMUL(OrderedNode *High);
   void CalculcateFlags_Logical(uint8_t SrcSize, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2);
@@ -1225,6 +1232,7 @@ private:
 
   bool Multiblock{};
   uint64_t Entry;
+  uintptr_t GuestCodeOffset{};
 
   OrderedNode* _StoreMemAutoTSO(FEXCore::IR::RegisterClassType Class, uint8_t Size, OrderedNode *Addr, OrderedNode *Value, uint8_t Align = 1) {
     if (CTX->Config.TSOEnabled)
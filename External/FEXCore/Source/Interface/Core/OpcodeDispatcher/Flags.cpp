@@ -410,14 +410,6 @@ void OpDispatchBuilder::CalculcateFlags_SUB(uint8_t SrcSize, OrderedNode *Res, O
     SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
   }
 
-  // SF
-  {
-    auto SignBitConst = _Constant(SrcSize * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
   // PF
   if (!CTX->Config.ABINoPF) {
     auto EightBitMask = _Constant(0xFF);
@@ -428,6 +420,20 @@ void OpDispatchBuilder::CalculcateFlags_SUB(uint8_t SrcSize, OrderedNode *Res, O
     _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
   }
 
+  if (CTX->HostNZCVFlags) {
+    // A single adds/subs on the host gives us the rest
+    CalculateFlagsFromNZCV(_HostNZCV(SrcSize, Src1, Src2, true), true, UpdateCF);
+    return;
+  }
+
+  // SF
+  {
+    auto SignBitConst = _Constant(SrcSize * 8 - 1);
+
+    auto LshrOp = _Lshr(Res, SignBitConst);
+    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
+  }
+
   // ZF
   {
     auto ZeroConst = _Constant(0);
@@ -467,14 +473,6 @@ void OpDispatchBuilder::CalculcateFlags_ADD(uint8_t SrcSize, OrderedNode *Res, O
     SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
   }
 
-  // SF
-  {
-    auto SignBitConst = _Constant(SrcSize * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
   // PF
   if (!CTX->Config.ABINoPF) {
     auto EightBitMask = _Constant(0xFF);
@@ -485,6 +483,20 @@ void OpDispatchBuilder::CalculcateFlags_ADD(uint8_t SrcSize, OrderedNode *Res, O
     _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
   }
 
+  if (CTX->HostNZCVFlags) {
+    // A single adds/subs on the host gives us the rest
+    CalculateFlagsFromNZCV(_HostNZCV(SrcSize, Src1, Src2, false), false, UpdateCF);
+    return;
+  }
+
+  // SF
+  {
+    auto SignBitConst = _Constant(SrcSize * 8 - 1);
+
+    auto LshrOp = _Lshr(Res, SignBitConst);
+    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
+  }
+
   // ZF
   {
     auto SelectOp = _Select(FEXCore::IR::COND_EQ,
@@ -527,6 +539,23 @@ void OpDispatchBuilder::CalculcateFlags_ADD(uint8_t SrcSize, OrderedNode *Res, O
   }
 }
 
+void OpDispatchBuilder::CalculateFlagsFromNZCV(OrderedNode *NZCV, bool IsSub, bool UpdateCF) {
+  // AArch64 NZCV layout from HostNZCV
+  SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(_Bfe(1, 31, NZCV));
+  SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(_Bfe(1, 30, NZCV));
+
+  if (UpdateCF) {
+    OrderedNode *CF = _Bfe(1, 29, NZCV);
+    if (IsSub) {
+      // AArch64 sets carry when the subtraction doesn't borrow, x86 sets it when it does
+      CF = _Xor(CF, _Constant(1));
+    }
+    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(CF);
+  }
+
+  SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(_Bfe(1, 28, NZCV));
+}
+
 void OpDispatchBuilder::CalculcateFlags_MUL(uint8_t SrcSize, OrderedNode *Res, OrderedNode *High) {
   // PF/AF/ZF/SF
   // Undefined
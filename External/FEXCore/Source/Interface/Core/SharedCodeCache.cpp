@@ -0,0 +1,99 @@
+/*
+$info$
+tags: glue|block-database
+desc: Process-wide cache of block IR and RA data shared between guest threads
+$end_info$
+*/
+
+#include "Interface/Core/SharedCodeCache.h"
+
+#include <mutex>
+
+namespace FEXCore {
+bool SharedCodeCache::Publish(uint64_t GuestRIP, uint64_t ExpectedGeneration, uint64_t StartAddr, uint64_t Length,
+                              FEXCore::IR::IRListView *IR, FEXCore::IR::RegisterAllocationData *RAData) {
+  auto NewEntry = std::make_shared<Entry>();
+  NewEntry->StartAddr = StartAddr;
+  NewEntry->Length = Length;
+  NewEntry->IR.reset(IR);
+  NewEntry->RAData.reset(RAData);
+
+  std::unique_lock lk(Mutex);
+
+  // Guest code was invalidated while this block was being compiled, the IR might be stale
+  if (Generation.load(std::memory_order_relaxed) != ExpectedGeneration) {
+    return false;
+  }
+
+  // Another thread might have raced us to publish the same block, first one wins
+  auto [it, Inserted] = Entries.try_emplace(GuestRIP, std::move(NewEntry));
+  if (!Inserted) {
+    return false;
+  }
+
+  for (auto CurrentPage = StartAddr >> 12, EndPage = (StartAddr + Length) >> 12; CurrentPage <= EndPage; CurrentPage++) {
+    CodePages[CurrentPage].push_back(GuestRIP);
+  }
+
+  return true;
+}
+
+void SharedCodeCache::EraseLocked(uint64_t GuestRIP) {
+  auto it = Entries.find(GuestRIP);
+  if (it == Entries.end()) {
+    return;
+  }
+
+  // Drop the block from every page it was registered on so the page lists don't grow without bound
+  const auto StartAddr = it->second->StartAddr;
+  const auto Length = it->second->Length;
+  for (auto CurrentPage = StartAddr >> 12, EndPage = (StartAddr + Length) >> 12; CurrentPage <= EndPage; CurrentPage++) {
+    auto Page = CodePages.find(CurrentPage);
+    if (Page == CodePages.end()) {
+      continue;
+    }
+
+    std::erase(Page->second, GuestRIP);
+    if (Page->second.empty()) {
+      CodePages.erase(Page);
+    }
+  }
+
+  Entries.erase(it);
+}
+
+void SharedCodeCache::Erase(uint64_t GuestRIP) {
+  // No generation bump, that would drop every other thread's in flight publish for one block.
+  // A stale publish of this block gets caught by the block's own code check again.
+  std::unique_lock lk(Mutex);
+  EraseLocked(GuestRIP);
+}
+
+void SharedCodeCache::InvalidateRange(uint64_t Start, uint64_t Length) {
+  std::unique_lock lk(Mutex);
+
+  // Always bump the generation, even if nothing is cached yet for this range.
+  // A block that is currently being compiled might cover it.
+  Generation.fetch_add(1, std::memory_order_acq_rel);
+
+  auto lower = CodePages.lower_bound(Start >> 12);
+  auto upper = CodePages.upper_bound((Start + Length - 1) >> 12);
+
+  // Collect first, erasing an entry also touches the page lists of pages outside of the range
+  std::vector<uint64_t> Addresses;
+  for (auto it = lower; it != upper; it = CodePages.erase(it)) {
+    Addresses.insert(Addresses.end(), it->second.begin(), it->second.end());
+  }
+
+  for (auto Address : Addresses) {
+    EraseLocked(Address);
+  }
+}
+
+void SharedCodeCache::Clear() {
+  std::unique_lock lk(Mutex);
+  Generation.fetch_add(1, std::memory_order_acq_rel);
+  Entries.clear();
+  CodePages.clear();
+}
+}
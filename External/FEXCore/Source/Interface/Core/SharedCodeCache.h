@@ -0,0 +1,94 @@
+#pragma once
+#include <FEXCore/IR/IntrusiveIRList.h>
+#include <FEXCore/IR/RegisterAllocationData.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+#include <tsl/robin_map.h>
+
+namespace FEXCore {
+/**
+ * @brief Process-wide cache of compiled block IR that is shared between guest threads
+ *
+ * The host code that a CPU backend emits is bound to the thread that compiled it.
+ * It embeds pointers to that thread's dispatcher and gets backpatched by block linking.
+ * What is identical between threads is everything up to codegen: decoding, the OpDispatcher, the pass pipeline and RA.
+ * This cache stores that result so a block only goes through the frontend and optimizer once per process.
+ *
+ * Readers only take a shared lock and never contend with each other, publishing and invalidation serialize on the unique lock.
+ * Entries are reference counted so an invalidation can't free IR that another thread is in the middle of running codegen on.
+ */
+class SharedCodeCache final {
+public:
+  struct Entry {
+    uint64_t StartAddr;
+    uint64_t Length;
+    std::unique_ptr<FEXCore::IR::IRListView, FEXCore::IR::IRListViewDeleter> IR;
+    std::unique_ptr<FEXCore::IR::RegisterAllocationData, FEXCore::IR::RegisterAllocationDataDeleter> RAData;
+  };
+
+  using EntryRef = std::shared_ptr<const Entry>;
+
+  /**
+   * @brief Finds the shared entry for a guest RIP
+   *
+   * @return A reference to the entry that keeps it alive while held, or nullptr if it doesn't exist
+   */
+  EntryRef Find(uint64_t GuestRIP) {
+    std::shared_lock lk(Mutex);
+    auto it = Entries.find(GuestRIP);
+    if (it == Entries.end()) {
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Returns the current invalidation generation
+   *
+   * Must be read before starting to generate IR for a block that will be published.
+   * Any guest code range invalidation that occurs while the IR is generated bumps the generation and causes the publish to be dropped.
+   */
+  uint64_t GetGeneration() const {
+    return Generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Publishes a block for other threads to pick up
+   *
+   * Takes ownership of the IR and RA data copies.
+   *
+   * @return true if the entry was published
+   */
+  bool Publish(uint64_t GuestRIP, uint64_t ExpectedGeneration, uint64_t StartAddr, uint64_t Length,
+               FEXCore::IR::IRListView *IR, FEXCore::IR::RegisterAllocationData *RAData);
+
+  /**
+   * @brief Removes a single entry from the cache
+   *
+   * Used when a block notices its own code changed, doesn't affect blocks that are being compiled.
+   */
+  void Erase(uint64_t GuestRIP);
+
+  /**
+   * @brief Removes every entry whose guest code overlaps [Start, Start + Length)
+   */
+  void InvalidateRange(uint64_t Start, uint64_t Length);
+
+  void Clear();
+
+private:
+  void EraseLocked(uint64_t GuestRIP);
+
+  std::shared_mutex Mutex;
+  std::atomic<uint64_t> Generation{};
+
+  tsl::robin_map<uint64_t, EntryRef> Entries;
+  // Guest page to the block entries that contain code from that page
+  std::map<uint64_t, std::vector<uint64_t>> CodePages;
+};
+}
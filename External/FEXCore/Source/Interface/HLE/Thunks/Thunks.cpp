@@ -117,6 +117,12 @@ namespace FEXCore {
             }
         }
 
+        void RegisterThunk(const IR::SHA256Sum &sha256, ThunkedFunction *Fn) {
+            std::unique_lock lk(ThunksMutex);
+
+            Thunks[sha256] = Fn;
+        }
+
         void RegisterTLSState(FEXCore::Core::InternalThreadState *Thread) {
             ::Thread = Thread;
         }
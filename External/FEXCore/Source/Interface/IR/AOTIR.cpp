@@ -371,6 +371,7 @@ namespace FEXCore::IR {
       fileid += CTX->Config.TSOEnabled ? "T" : "t";
       fileid += CTX->Config.ABILocalFlags ? "L" : "l";
       fileid += CTX->Config.ABINoPF ? "p" : "P";
+      fileid += CTX->HostNZCVFlags ? "N" : "n";
 
       std::unique_lock lk(AOTIRCacheLock);
 
@@ -20,7 +20,7 @@ void PassManager::AddDefaultPasses(FEXCore::Context::Context *ctx, bool InlineCo
   FEX_CONFIG_OPT(DisablePasses, O0);
 
   if (!DisablePasses()) {
-    InsertPass(CreateContextLoadStoreElimination());
+    InsertPass(CreateContextLoadStoreElimination(InlineConstants && StaticRegisterAllocation));
 
     if (Is64BitMode()) {
       // This needs to run after RCLSE
@@ -31,10 +31,15 @@ void PassManager::AddDefaultPasses(FEXCore::Context::Context *ctx, bool InlineCo
     InsertPass(CreateDeadStoreElimination());
     InsertPass(CreatePassDeadCodeElimination());
     InsertPass(CreateConstProp(InlineConstants, ctx->HostFeatures.SupportsTSOImm9));
-
-    ////// InsertPass(CreateDeadFlagCalculationEliminination());
-
-    InsertPass(CreateSyscallOptimization());
+    // Runs after ConstProp so folded constants and inlined arguments compare equal
+    InsertPass(CreateValueNumbering());
+    // Same register idioms need the loads of both sources merged first
+    InsertPass(CreateVectorOpFusion());
+    InsertPass(CreateLoopInvariantCodeMotion(InlineConstants && StaticRegisterAllocation));
+    // Flag calculations feeding the removed stores are cleaned up by the following DCE
+    InsertPass(CreateDeadFlagCalculationEliminination());
+
+    InsertPass(CreateSyscallOptimization(InlineConstants));
     InsertPass(CreatePassDeadCodeElimination());
 
     // only do SRA if enabled and JIT
@@ -62,7 +67,9 @@ void PassManager::AddDefaultValidationPasses() {
 }
 
 void PassManager::InsertRegisterAllocationPass(bool OptimizeSRA) {
-  InsertPass(IR::CreateRegisterAllocationPass(GetPass("Compaction"), OptimizeSRA), "RA");
+  FEX_CONFIG_OPT(LinearScanRA, LINEARSCANRA);
+
+  InsertPass(IR::CreateRegisterAllocationPass(GetPass("Compaction"), OptimizeSRA, LinearScanRA()), "RA");
 }
 
 bool PassManager::Run(IREmitter *IREmit) {
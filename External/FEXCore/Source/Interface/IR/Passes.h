@@ -12,15 +12,18 @@ class RegisterAllocationPass;
 class RegisterAllocationData;
 
 std::unique_ptr<FEXCore::IR::Pass> CreateConstProp(bool InlineConstants, bool SupportsTSOImm9);
-std::unique_ptr<FEXCore::IR::Pass> CreateContextLoadStoreElimination();
-std::unique_ptr<FEXCore::IR::Pass> CreateSyscallOptimization();
+std::unique_ptr<FEXCore::IR::Pass> CreateContextLoadStoreElimination(bool StaticRegisterAllocation);
+std::unique_ptr<FEXCore::IR::Pass> CreateSyscallOptimization(bool InlineConstants);
 std::unique_ptr<FEXCore::IR::Pass> CreateDeadFlagCalculationEliminination();
 std::unique_ptr<FEXCore::IR::Pass> CreateDeadStoreElimination();
 std::unique_ptr<FEXCore::IR::Pass> CreatePassDeadCodeElimination();
 std::unique_ptr<FEXCore::IR::Pass> CreateIRCompaction(FEXCore::Utils::IntrusivePooledAllocator &Allocator);
-std::unique_ptr<FEXCore::IR::RegisterAllocationPass> CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA);
+std::unique_ptr<FEXCore::IR::RegisterAllocationPass> CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA, bool LinearScan);
 std::unique_ptr<FEXCore::IR::Pass> CreateStaticRegisterAllocationPass();
 std::unique_ptr<FEXCore::IR::Pass> CreateLongDivideEliminationPass();
+std::unique_ptr<FEXCore::IR::Pass> CreateValueNumbering();
+std::unique_ptr<FEXCore::IR::Pass> CreateLoopInvariantCodeMotion(bool StaticRegisterAllocation);
+std::unique_ptr<FEXCore::IR::Pass> CreateVectorOpFusion();
 
 namespace Validation {
 std::unique_ptr<FEXCore::IR::Pass> CreateIRValidation();
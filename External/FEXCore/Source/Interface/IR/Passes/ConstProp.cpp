@@ -910,22 +910,24 @@ bool ConstProp::ConstantInlining(IREmitter *IREmit, const IRListView& CurrentIR)
         break;
       }
       case OP_EXITFUNCTION:
+      case OP_PUSHRETURNSTACK:
       {
-        auto Op = IROp->C<IR::IROp_ExitFunction>();
+        // Both take the guest RIP as their first argument
+        auto NewRIPArg = IROp->Args[0];
 
         uint64_t Constant{};
-        if (IREmit->IsValueConstant(Op->NewRIP, &Constant)) {
+        if (IREmit->IsValueConstant(NewRIPArg, &Constant)) {
 
-          IREmit->SetWriteCursor(CurrentIR.GetNode(Op->NewRIP));
+          IREmit->SetWriteCursor(CurrentIR.GetNode(NewRIPArg));
 
           IREmit->ReplaceNodeArgument(CodeNode, 0, IREmit->_InlineConstant(Constant));
 
           Changed = true;
         } else {
-          auto NewRIP = IREmit->GetOpHeader(Op->NewRIP);
+          auto NewRIP = IREmit->GetOpHeader(NewRIPArg);
           if (NewRIP->Op == OP_ENTRYPOINTOFFSET) {
             auto EO = NewRIP->C<IR::IROp_EntrypointOffset>();
-            IREmit->SetWriteCursor(CurrentIR.GetNode(Op->NewRIP));
+            IREmit->SetWriteCursor(CurrentIR.GetNode(NewRIPArg));
 
             IREmit->ReplaceNodeArgument(CodeNode, 0, IREmit->_InlineEntrypointOffset(EO->Offset, EO->Header.Size));
             Changed = true;
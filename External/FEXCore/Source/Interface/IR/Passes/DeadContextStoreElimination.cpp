@@ -14,6 +14,7 @@ $end_info$
 #include <FEXCore/IR/IntrusiveIRList.h>
 #include <FEXCore/Utils/LogManager.h>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <stddef.h>
@@ -321,6 +322,43 @@ namespace {
     SetAccess(Offset++, DefaultAccess[15]);
   }
 
+  // Turns a block's exit state in to the entry state of a successor that can only be reached from that block.
+  // Other successors may observe the stores, so they have to stay and the successor must not remove them.
+  // A full width store of a value that is the same width is as good as having read that value back.
+  // With SRA the GPRs and XMMs already live in host registers across blocks, a global live range would only add pressure.
+  static void PrepareSuccessorAccesses(FEXCore::IR::IREmitter *IREmit, ContextInfo *ContextClassificationInfo, bool StaticRegisterAllocation) {
+    constexpr size_t FlagsBegin = offsetof(FEXCore::Core::CPUState, flags[0]);
+    constexpr size_t FlagsEnd = FlagsBegin + sizeof(FEXCore::Core::CPUState::flags);
+    constexpr size_t StaticBegin = offsetof(FEXCore::Core::CPUState, gregs[0]);
+    constexpr size_t StaticEnd = offsetof(FEXCore::Core::CPUState, xmm[16][0]);
+
+    for (auto &Info : ContextClassificationInfo->ClassificationInfo) {
+      if (StaticRegisterAllocation && Info.Class.Offset >= StaticBegin && Info.Class.Offset < StaticEnd) {
+        if (!IsInvalidAccess(Info.Accessed)) {
+          Info.Accessed = ACCESS_NONE;
+          Info.AccessRegClass = FEXCore::IR::InvalidClass;
+          Info.AccessOffset = 0;
+        }
+      }
+      else if (IsWriteAccess(Info.Accessed)) {
+        // Flag loads are always replaced with the stored value
+        const bool IsFlag = Info.Class.Offset >= FlagsBegin && Info.Class.Offset < FlagsEnd;
+
+        if (IsFlag ||
+            (IsFullAccess(Info.Accessed) && IREmit->GetOpSize(Info.Node) == Info.AccessSize)) {
+          Info.Accessed = ACCESS_READ;
+        }
+        else {
+          Info.Accessed = ACCESS_NONE;
+          Info.AccessRegClass = FEXCore::IR::InvalidClass;
+          Info.AccessOffset = 0;
+        }
+      }
+
+      Info.StoreNode = nullptr;
+    }
+  }
+
   struct BlockInfo {
     std::vector<FEXCore::IR::OrderedNode *> Predecessors;
     std::vector<FEXCore::IR::OrderedNode *> Successors;
@@ -330,13 +368,15 @@ namespace {
 
 class RCLSE final : public FEXCore::IR::Pass {
 public:
-  RCLSE() {
+  explicit RCLSE(bool _StaticRegisterAllocation)
+    : StaticRegisterAllocation {_StaticRegisterAllocation} {
     ClassifyContextStruct(&ClassifiedStruct);
     DCE = FEXCore::IR::CreatePassDeadCodeElimination();
   }
   bool Run(FEXCore::IR::IREmitter *IREmit) override;
 private:
   std::unique_ptr<FEXCore::IR::Pass> DCE;
+  bool StaticRegisterAllocation;
 
   ContextInfo ClassifiedStruct;
   std::unordered_map<FEXCore::IR::NodeID, BlockInfo> OffsetToBlockMap;
@@ -482,8 +522,24 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
   for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
     auto BlockOp = BlockHeader->CW<FEXCore::IR::IROp_CodeBlock>();
     auto BlockEnd = IREmit->GetIterator(BlockOp->Last);
-
-    ResetClassificationAccesses(&LocalInfo);
+    const auto BlockID = CurrentIR.GetID(BlockNode);
+    auto &CurrentBlock = OffsetToBlockMap[BlockID];
+
+    // A block with a single predecessor that was already visited starts with the predecessor's exit state.
+    // The predecessor dominates this block, so its values can be used directly without a phi.
+    // Blocks are sorted, so the predecessor has a lower ID unless this is a backwards edge.
+    auto &Predecessors = CurrentBlock.Predecessors;
+    const bool SinglePredecessor = !Predecessors.empty() &&
+      std::all_of(Predecessors.begin(), Predecessors.end(), [&](auto Predecessor) { return Predecessor == Predecessors[0]; }) &&
+      CurrentIR.GetID(Predecessors[0]) < BlockID;
+
+    if (SinglePredecessor) {
+      auto &Incoming = OffsetToBlockMap[CurrentIR.GetID(Predecessors[0])].OutgoingClassifiedStruct.ClassificationInfo;
+      std::copy(Incoming.begin(), Incoming.end(), LocalInfo.ClassificationInfo.begin());
+    }
+    else {
+      ResetClassificationAccesses(&LocalInfo);
+    }
 
     for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
       if (IROp->Op == OP_STORECONTEXT) {
@@ -685,6 +741,12 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
         ResetClassificationAccesses(&LocalInfo);
       }
     }
+
+    if (!CurrentBlock.Successors.empty()) {
+      auto &Outgoing = CurrentBlock.OutgoingClassifiedStruct;
+      Outgoing.ClassificationInfo = LocalInfo.ClassificationInfo;
+      PrepareSuccessorAccesses(IREmit, &Outgoing, StaticRegisterAllocation);
+    }
   }
 
   IREmit->SetWriteCursor(OriginalWriteCursor);
@@ -693,8 +755,8 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
 }
 
 bool RCLSE::Run(FEXCore::IR::IREmitter *IREmit) {
-  // XXX: We don't do cross-block optimizations yet
-  //CalculateControlFlowInfo(IREmit);
+  // Loads are forwarded in to blocks with a single predecessor
+  CalculateControlFlowInfo(IREmit);
   bool Changed = false;
 
   // Run up to 5 times
@@ -710,8 +772,8 @@ bool RCLSE::Run(FEXCore::IR::IREmitter *IREmit) {
 
 namespace FEXCore::IR {
 
-std::unique_ptr<FEXCore::IR::Pass> CreateContextLoadStoreElimination() {
-  return std::make_unique<RCLSE>();
+std::unique_ptr<FEXCore::IR::Pass> CreateContextLoadStoreElimination(bool StaticRegisterAllocation) {
+  return std::make_unique<RCLSE>(StaticRegisterAllocation);
 }
 
 }
@@ -0,0 +1,603 @@
+/*
+$info$
+tags: ir|opts
+desc: Finds loops in the multiblock CFG and hoists loop invariant values in to the loop preheader
+$end_info$
+*/
+
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/Core/CoreState.h>
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace FEXCore::IR {
+
+class LoopInvariantCodeMotion final : public FEXCore::IR::Pass {
+public:
+  explicit LoopInvariantCodeMotion(bool _StaticRegisterAllocation)
+    : StaticRegisterAllocation {_StaticRegisterAllocation} {
+  }
+
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  struct BlockInfo {
+    OrderedNode *Node;
+    std::vector<uint32_t> Successors;
+    std::vector<uint32_t> Predecessors;
+    uint32_t RPONumber {~0U};
+    uint32_t IDom {~0U};
+  };
+
+  struct Loop {
+    uint32_t Header;
+    uint32_t Preheader;
+    // In IR order
+    std::vector<uint32_t> Blocks;
+  };
+
+  struct ContextRange {
+    uint32_t Offset;
+    uint32_t Size;
+  };
+
+  void BuildControlFlowGraph(IRListView const &CurrentIR);
+  bool Dominates(uint32_t A, uint32_t B) const;
+  void FindLoops();
+
+  bool HoistLoop(IREmitter *IREmit, Loop const &CurrentLoop);
+  bool CanHoist(IROp_Header const *IROp) const;
+  OrderedNode *CopyToPreheader(IREmitter *IREmit, OrderedNode *Node);
+  bool ReassociateInvariants(IREmitter *IREmit, OrderedNode *CodeNode);
+
+  bool StaticRegisterAllocation;
+
+  std::vector<BlockInfo> Blocks;
+  std::vector<Loop> Loops;
+
+  // State for the loop currently being hoisted
+  std::unordered_set<OrderedNode*> LoopNodes;
+  std::vector<ContextRange> ContextWrites;
+  OrderedNode *PreheaderExit{};
+};
+
+namespace {
+  // Cheap to recreate, only hoisted when something that is hoisted uses them
+  bool IsRematerializable(IROps Op) {
+    switch (Op) {
+      case OP_CONSTANT:
+      case OP_INLINECONSTANT:
+      case OP_INLINEENTRYPOINTOFFSET:
+      case OP_ENTRYPOINTOFFSET:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Side effects that can't change any state a hoisted value depends on
+  bool IsLoopLocalSideEffect(IROps Op) {
+    switch (Op) {
+      case OP_DUMMY:
+      case OP_BEGINBLOCK:
+      case OP_ENDBLOCK:
+      case OP_JUMP:
+      case OP_CONDJUMP:
+      // Context writes are tracked separately
+      case OP_STORECONTEXT:
+      case OP_STOREFLAG:
+      case OP_INVALIDATEFLAGS:
+      // Guest memory, nothing that is hoisted reads it
+      case OP_STOREMEM:
+      case OP_STOREMEMTSO:
+      case OP_FENCE:
+      case OP_INLINECONSTANT:
+      case OP_INLINEENTRYPOINTOFFSET:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  uint32_t FlagOffset(uint32_t Flag) {
+    return offsetof(FEXCore::Core::CPUState, flags[0]) + Flag;
+  }
+}
+
+void LoopInvariantCodeMotion::BuildControlFlowGraph(IRListView const &CurrentIR) {
+  std::unordered_map<uint32_t, uint32_t> BlockIndex;
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    BlockIndex[CurrentIR.GetID(BlockNode).Value] = Blocks.size();
+    Blocks.push_back({BlockNode});
+  }
+
+  for (auto &Block : Blocks) {
+    const uint32_t Index = &Block - &Blocks[0];
+    auto AddEdge = [&](OrderedNodeWrapper Target) {
+      const uint32_t TargetIndex = BlockIndex.at(Target.ID().Value);
+      Block.Successors.push_back(TargetIndex);
+      Blocks[TargetIndex].Predecessors.push_back(Index);
+    };
+
+    auto CodeBlock = CurrentIR.GetOp<IROp_CodeBlock>(Block.Node);
+    auto LastOp = CurrentIR.GetNode(CurrentIR.GetNode(CodeBlock->Last)->Header.Previous)->Op(CurrentIR.GetData());
+    if (LastOp->Op == OP_JUMP) {
+      AddEdge(LastOp->C<IROp_Jump>()->TargetBlock);
+    }
+    else if (LastOp->Op == OP_CONDJUMP) {
+      auto Op = LastOp->C<IROp_CondJump>();
+      AddEdge(Op->TrueBlock);
+      AddEdge(Op->FalseBlock);
+    }
+  }
+
+  // Reverse post order from the entry block
+  std::vector<uint32_t> PostOrder;
+  {
+    std::vector<std::pair<uint32_t, size_t>> Stack;
+    std::vector<bool> Visited(Blocks.size());
+    Stack.emplace_back(0, 0);
+    Visited[0] = true;
+    while (!Stack.empty()) {
+      auto &[Index, NextSuccessor] = Stack.back();
+      if (NextSuccessor < Blocks[Index].Successors.size()) {
+        const uint32_t Successor = Blocks[Index].Successors[NextSuccessor++];
+        if (!Visited[Successor]) {
+          Visited[Successor] = true;
+          Stack.emplace_back(Successor, 0);
+        }
+      }
+      else {
+        PostOrder.push_back(Index);
+        Stack.pop_back();
+      }
+    }
+  }
+
+  std::vector<uint32_t> RPO(PostOrder.rbegin(), PostOrder.rend());
+  for (size_t i = 0; i < RPO.size(); ++i) {
+    Blocks[RPO[i]].RPONumber = i;
+  }
+
+  // Cooper, Harvey and Kennedy's iterative dominator algorithm
+  auto Intersect = [this](uint32_t A, uint32_t B) {
+    while (A != B) {
+      while (Blocks[A].RPONumber > Blocks[B].RPONumber) {
+        A = Blocks[A].IDom;
+      }
+      while (Blocks[B].RPONumber > Blocks[A].RPONumber) {
+        B = Blocks[B].IDom;
+      }
+    }
+    return A;
+  };
+
+  Blocks[0].IDom = 0;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (size_t i = 1; i < RPO.size(); ++i) {
+      auto &Block = Blocks[RPO[i]];
+      uint32_t NewIDom = ~0U;
+      for (auto Pred : Block.Predecessors) {
+        if (Blocks[Pred].IDom == ~0U) {
+          // Not processed yet, or unreachable
+          continue;
+        }
+        NewIDom = NewIDom == ~0U ? Pred : Intersect(Pred, NewIDom);
+      }
+
+      if (Block.IDom != NewIDom) {
+        Block.IDom = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+}
+
+bool LoopInvariantCodeMotion::Dominates(uint32_t A, uint32_t B) const {
+  if (Blocks[B].IDom == ~0U) {
+    // Unreachable
+    return false;
+  }
+
+  while (B != A) {
+    if (B == 0) {
+      return false;
+    }
+    B = Blocks[B].IDom;
+  }
+  return true;
+}
+
+/**
+ * @brief Finds the natural loops of the CFG
+ *
+ * An edge to a block that dominates the source of the edge is a back edge, and its target is the loop header.
+ * The loop is every block that can reach a back edge without passing through the header.
+ * Back edges sharing a header form one loop.
+ *
+ * Loops are only usable if the header has exactly one predecessor outside of the loop, and that block only jumps to the header.
+ * That predecessor is the preheader, it runs once every time the loop is entered.
+ */
+void LoopInvariantCodeMotion::FindLoops() {
+  for (uint32_t Header = 0; Header < Blocks.size(); ++Header) {
+    std::vector<bool> InLoop(Blocks.size());
+    std::vector<uint32_t> Worklist;
+
+    for (auto Pred : Blocks[Header].Predecessors) {
+      if (Dominates(Header, Pred) && !InLoop[Pred]) {
+        InLoop[Pred] = true;
+        Worklist.push_back(Pred);
+      }
+    }
+
+    if (Worklist.empty()) {
+      continue;
+    }
+
+    InLoop[Header] = true;
+    while (!Worklist.empty()) {
+      const uint32_t Block = Worklist.back();
+      Worklist.pop_back();
+
+      if (Block == Header) {
+        continue;
+      }
+
+      for (auto Pred : Blocks[Block].Predecessors) {
+        if (!InLoop[Pred]) {
+          InLoop[Pred] = true;
+          Worklist.push_back(Pred);
+        }
+      }
+    }
+
+    uint32_t Preheader = ~0U;
+    bool SinglePreheader = true;
+    for (auto Pred : Blocks[Header].Predecessors) {
+      if (InLoop[Pred]) {
+        continue;
+      }
+
+      SinglePreheader &= Preheader == ~0U || Preheader == Pred;
+      Preheader = Pred;
+    }
+
+    if (!SinglePreheader || Preheader == ~0U || Blocks[Preheader].Successors.size() != 1) {
+      continue;
+    }
+
+    Loop NewLoop {Header, Preheader};
+    for (uint32_t i = 0; i < Blocks.size(); ++i) {
+      if (InLoop[i]) {
+        NewLoop.Blocks.push_back(i);
+      }
+    }
+
+    Loops.emplace_back(std::move(NewLoop));
+  }
+
+  // Inner loops first, values hoisted out of them land in the outer loop and can be hoisted again
+  std::stable_sort(Loops.begin(), Loops.end(), [](Loop const &Lhs, Loop const &Rhs) {
+    return Lhs.Blocks.size() < Rhs.Blocks.size();
+  });
+}
+
+bool LoopInvariantCodeMotion::CanHoist(IROp_Header const *IROp) const {
+  if (!IROp->HasDest) {
+    return false;
+  }
+
+  auto Overlaps = [this](uint32_t Offset, uint32_t Size) {
+    return std::any_of(ContextWrites.begin(), ContextWrites.end(), [Offset, Size](ContextRange const &Write) {
+      return Offset < (Write.Offset + Write.Size) && Write.Offset < (Offset + Size);
+    });
+  };
+
+  switch (IROp->Op) {
+    case OP_LOADCONTEXT: {
+      auto Op = IROp->C<IROp_LoadContext>();
+
+      // With SRA the GPRs and XMMs are already in host registers
+      constexpr size_t StaticBegin = offsetof(FEXCore::Core::CPUState, gregs[0]);
+      constexpr size_t StaticEnd = offsetof(FEXCore::Core::CPUState, xmm[16][0]);
+      if (StaticRegisterAllocation && Op->Offset >= StaticBegin && Op->Offset < StaticEnd) {
+        return false;
+      }
+
+      return !Overlaps(Op->Offset, IROp->Size);
+    }
+    case OP_LOADFLAG:
+      return !Overlaps(FlagOffset(IROp->C<IROp_LoadFlag>()->Flag), 1);
+
+    // Results depend on state that isn't an argument
+    case OP_LOADCONTEXTINDEXED:
+    case OP_LOADREGISTER:
+    case OP_FILLREGISTER:
+    case OP_LOADMEM:
+    case OP_LOADMEMTSO:
+    case OP_PROCESSORID:
+    case OP_RDRAND:
+    case OP_CPUID:
+    case OP_CYCLECOUNTER:
+    // Trap on a zero divisor in the x86-64 JIT and the interpreter, the loop might only run them conditionally
+    case OP_DIV:
+    case OP_UDIV:
+    case OP_REM:
+    case OP_UREM:
+    case OP_LDIV:
+    case OP_LUDIV:
+    case OP_LREM:
+    case OP_LUREM:
+    // Consumed by the flag fusion in the backend
+    case OP_HOSTNZCV:
+    case OP_GETHOSTFLAG:
+    // Structural ops
+    case OP_PHI:
+    case OP_PHIVALUE:
+    case OP_MOV:
+    case OP_CODEBLOCK:
+    case OP_IRHEADER:
+      return false;
+    default:
+      break;
+  }
+
+  // x87 ops depend on the guest control word
+  if (DependsOnFCW(IROp->Op)) {
+    return false;
+  }
+
+  // Floating point ops depend on the rounding mode, loops that change it are never hoisted
+  return !HasSideEffects(IROp->Op);
+}
+
+OrderedNode *LoopInvariantCodeMotion::CopyToPreheader(IREmitter *IREmit, OrderedNode *Node) {
+  auto CurrentIR = IREmit->ViewIR();
+  auto IROp = CurrentIR.GetOp<IROp_Header>(Node);
+
+  IREmit->SetWriteCursor(CurrentIR.GetNode(PreheaderExit->Header.Previous));
+
+  switch (IROp->Op) {
+    case OP_CONSTANT: {
+      auto NewNode = IREmit->_Constant(IROp->C<IROp_Constant>()->Constant);
+      NewNode.first->Header.Size = IROp->Size;
+      return NewNode;
+    }
+    case OP_INLINECONSTANT:
+      return IREmit->_InlineConstant(IROp->C<IROp_InlineConstant>()->Constant);
+    case OP_ENTRYPOINTOFFSET:
+      return IREmit->_EntrypointOffset(IROp->C<IROp_EntrypointOffset>()->Offset, IROp->Size);
+    case OP_INLINEENTRYPOINTOFFSET:
+      return IREmit->_InlineEntrypointOffset(IROp->C<IROp_InlineEntrypointOffset>()->Offset, IROp->Size);
+    default:
+      LOGMAN_MSG_A_FMT("Can't copy {}", GetName(IROp->Op));
+      return nullptr;
+  }
+}
+
+/**
+ * @brief Turns (Variant + Invariant1) + Invariant2 in to Variant + (Invariant1 + Invariant2)
+ *
+ * Address calculations add the displacement and the segment base on top of the registers that change every iteration.
+ * Regrouping the adds lets the invariant half move to the preheader, saving an add per iteration.
+ * Adds of the same size wrap the same way in either order.
+ */
+bool LoopInvariantCodeMotion::ReassociateInvariants(IREmitter *IREmit, OrderedNode *CodeNode) {
+  auto CurrentIR = IREmit->ViewIR();
+  auto IROp = CurrentIR.GetOp<IROp_Header>(CodeNode);
+
+  if (IROp->Op != OP_ADD) {
+    return false;
+  }
+
+  auto IsInvariant = [&](OrderedNode *Node) {
+    return !LoopNodes.contains(Node) || IsRematerializable(CurrentIR.GetOp<IROp_Header>(Node)->Op);
+  };
+
+  // Constants inside of the loop get a copy in the preheader
+  auto GetPreheaderValue = [&](OrderedNode *Node) {
+    return LoopNodes.contains(Node) ? CopyToPreheader(IREmit, Node) : Node;
+  };
+
+  for (uint8_t InnerIndex = 0; InnerIndex < 2; ++InnerIndex) {
+    auto Inner = CurrentIR.GetNode(IROp->Args[InnerIndex]);
+    auto Outer = CurrentIR.GetNode(IROp->Args[InnerIndex ^ 1]);
+    auto InnerOp = CurrentIR.GetOp<IROp_Header>(Inner);
+
+    if (InnerOp->Op != OP_ADD ||
+        InnerOp->Size != IROp->Size ||
+        Inner->GetUses() != 1 ||
+        !LoopNodes.contains(Inner) ||
+        !IsInvariant(Outer)) {
+      continue;
+    }
+
+    for (uint8_t VariantIndex = 0; VariantIndex < 2; ++VariantIndex) {
+      auto Variant = CurrentIR.GetNode(InnerOp->Args[VariantIndex]);
+      auto Invariant = CurrentIR.GetNode(InnerOp->Args[VariantIndex ^ 1]);
+
+      if (IsInvariant(Variant) || !IsInvariant(Invariant)) {
+        continue;
+      }
+
+      // Inline constants can only be the second source
+      const bool InvariantInline = IREmit->IsValueInlineConstant(InnerOp->Args[VariantIndex ^ 1]);
+      const bool OuterInline = IREmit->IsValueInlineConstant(IROp->Args[InnerIndex ^ 1]);
+      if (InvariantInline && OuterInline) {
+        continue;
+      }
+
+      auto Src1 = GetPreheaderValue(InvariantInline ? Outer : Invariant);
+      auto Src2 = GetPreheaderValue(InvariantInline ? Invariant : Outer);
+
+      IREmit->SetWriteCursor(CurrentIR.GetNode(PreheaderExit->Header.Previous));
+      auto Sum = IREmit->_Add(Src1, Src2);
+      Sum.first->Header.Size = IROp->Size;
+
+      IREmit->ReplaceNodeArgument(CodeNode, 0, Variant);
+      IREmit->ReplaceNodeArgument(CodeNode, 1, Sum);
+      IREmit->Remove(Inner);
+      LoopNodes.erase(Inner);
+
+      // Inline constants have side effects as far as DCE is concerned
+      for (auto Unused : {Invariant, Outer}) {
+        if (LoopNodes.contains(Unused) && Unused->GetUses() == 0) {
+          IREmit->Remove(Unused);
+          LoopNodes.erase(Unused);
+        }
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool LoopInvariantCodeMotion::HoistLoop(IREmitter *IREmit, Loop const &CurrentLoop) {
+  auto CurrentIR = IREmit->ViewIR();
+
+  LoopNodes.clear();
+  ContextWrites.clear();
+
+  // Gather everything first, the block lists change while hoisting
+  std::vector<OrderedNode*> LoopCode;
+  for (auto Block : CurrentLoop.Blocks) {
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(Blocks[Block].Node)) {
+      if (HasSideEffects(IROp->Op) && !IsLoopLocalSideEffect(IROp->Op)) {
+        // Syscalls, thunks and the like can change anything
+        return false;
+      }
+
+      switch (IROp->Op) {
+        case OP_STORECONTEXT:
+          ContextWrites.push_back({IROp->C<IROp_StoreContext>()->Offset, IROp->Size});
+          break;
+        case OP_STOREFLAG:
+          ContextWrites.push_back({FlagOffset(IROp->C<IROp_StoreFlag>()->Flag), 1});
+          break;
+        case OP_INVALIDATEFLAGS: {
+          const uint64_t Flags = IROp->C<IROp_InvalidateFlags>()->Flags;
+          for (uint32_t Flag = 0; Flag < 64; ++Flag) {
+            if (Flags & (1ULL << Flag)) {
+              ContextWrites.push_back({FlagOffset(Flag), 1});
+            }
+          }
+          break;
+        }
+        case OP_SETROUNDINGMODE:
+          // Changes the results of floating point ops
+          return false;
+        default:
+          break;
+      }
+
+      LoopNodes.insert(CodeNode);
+      LoopCode.push_back(CodeNode);
+    }
+  }
+
+  auto PreheaderBlock = CurrentIR.GetOp<IROp_CodeBlock>(Blocks[CurrentLoop.Preheader].Node);
+  PreheaderExit = CurrentIR.GetNode(CurrentIR.GetNode(PreheaderBlock->Last)->Header.Previous);
+
+  bool Changed = false;
+
+  for (auto CodeNode : LoopCode) {
+    auto IROp = CurrentIR.GetOp<IROp_Header>(CodeNode);
+    if (IsRematerializable(IROp->Op) || !CanHoist(IROp)) {
+      continue;
+    }
+
+    const uint8_t NumArgs = GetArgs(IROp->Op);
+    bool Invariant = true;
+    for (uint8_t i = 0; i < NumArgs && Invariant; ++i) {
+      auto Arg = CurrentIR.GetNode(IROp->Args[i]);
+      Invariant = !LoopNodes.contains(Arg) || IsRematerializable(CurrentIR.GetOp<IROp_Header>(Arg)->Op);
+    }
+
+    if (!Invariant) {
+      continue;
+    }
+
+    // Constants used from inside of the loop move with it
+    for (uint8_t i = 0; i < NumArgs; ++i) {
+      auto Arg = CurrentIR.GetNode(IROp->Args[i]);
+      if (!LoopNodes.contains(Arg)) {
+        continue;
+      }
+
+      if (Arg->GetUses() == 1) {
+        IREmit->MoveBefore(Arg, PreheaderExit);
+        LoopNodes.erase(Arg);
+      }
+      else {
+        IREmit->ReplaceNodeArgument(CodeNode, i, CopyToPreheader(IREmit, Arg));
+      }
+    }
+
+    IREmit->MoveBefore(CodeNode, PreheaderExit);
+    LoopNodes.erase(CodeNode);
+    Changed = true;
+  }
+
+  for (auto CodeNode : LoopCode) {
+    if (LoopNodes.contains(CodeNode)) {
+      Changed |= ReassociateInvariants(IREmit, CodeNode);
+    }
+  }
+
+  return Changed;
+}
+
+/**
+ * @brief Hoists values that are the same on every iteration of a loop in to the loop's preheader
+ *
+ * Multiblock can capture whole guest loops in one IR. The loops are found from the dominator tree, see FindLoops.
+ * Inside of a loop, a value is invariant when all of its arguments are defined outside of the loop, or are invariant themselves.
+ * - Pure ops are hoisted once their arguments are
+ * - Context and flag loads are hoisted if nothing in the loop writes any byte of them
+ * - Constants are only hoisted along with a user, by themselves they are cheaper to recreate than to keep in a register
+ * - Loops with syscalls, thunks, rounding mode changes or any other op that can change unknown state are left alone
+ *
+ * Guest induction variables live in the context between iterations, since nothing in the RA or the backends handles phis.
+ * The remaining per iteration address math is improved by regrouping adds so their invariant parts can be hoisted.
+ *
+ * Hoisted values become cross block live ranges, the RA spills those per block when it runs out of registers.
+ */
+bool LoopInvariantCodeMotion::Run(IREmitter *IREmit) {
+  auto CurrentIR = IREmit->ViewIR();
+
+  Blocks.clear();
+  Loops.clear();
+
+  BuildControlFlowGraph(CurrentIR);
+  FindLoops();
+
+  bool Changed = false;
+  for (auto const &CurrentLoop : Loops) {
+    Changed |= HoistLoop(IREmit, CurrentLoop);
+  }
+
+  return Changed;
+}
+
+std::unique_ptr<FEXCore::IR::Pass> CreateLoopInvariantCodeMotion(bool StaticRegisterAllocation) {
+  return std::make_unique<LoopInvariantCodeMotion>(StaticRegisterAllocation);
+}
+
+}
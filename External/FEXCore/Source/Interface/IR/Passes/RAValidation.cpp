@@ -100,12 +100,11 @@ struct RegState {
     Spills[SpillSlot] = ssa;
   }
 
-  // Consume (and return) the SSA id currently in a spill slot
-  IR::NodeID Unspill(uint32_t SpillSlot) {
-    if (Spills.contains(SpillSlot)) {
-      const auto Value = Spills[SpillSlot];
-      Spills.erase(SpillSlot);
-      return Value;
+  // Return the SSA id currently in a spill slot
+  // The slot keeps its value, values spilled across blocks are filled once per block that uses them
+  IR::NodeID Unspill(uint32_t SpillSlot) const {
+    if (auto it = Spills.find(SpillSlot); it != Spills.end()) {
+      return it->second;
     }
     return UninitializedValue;
   }
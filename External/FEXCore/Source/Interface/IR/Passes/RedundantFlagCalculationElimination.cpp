@@ -1,17 +1,21 @@
 /*
 $info$
 tags: ir|opts
-desc: This is not used right now, possibly broken
+desc: Cross block flag liveness, removes flag stores that can never be observed
 $end_info$
 */
 
+#include <FEXCore/Core/CoreState.h>
 #include <FEXCore/IR/IR.h>
 #include <FEXCore/IR/IREmitter.h>
 #include <FEXCore/IR/IntrusiveIRList.h>
 #include "Interface/IR/PassManager.h"
 
-#include <array>
 #include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace FEXCore::IR {
 
@@ -20,45 +24,195 @@ public:
   bool Run(IREmitter *IREmit) override;
 };
 
+namespace {
+  constexpr size_t NumFlags = sizeof(FEXCore::Core::CPUState::flags);
+  static_assert(NumFlags <= 64, "Flag liveness is tracked in a 64-bit mask");
+
+  constexpr uint64_t AllFlags = NumFlags == 64 ? ~0ULL : ((1ULL << NumFlags) - 1);
+
+  struct FlagLiveness {
+    // Flags read before this block writes them
+    uint64_t Uses{};
+    // Flags this block overwrites before reading them
+    uint64_t Defs{};
+    uint64_t LiveIn{};
+    uint64_t LiveOut{};
+    // Successors inside of this IR, null if the block leaves it
+    OrderedNode *Successors[2]{};
+    bool LeavesIR{};
+  };
+
+  bool OverlapsFlags(uint32_t Offset, uint8_t Size) {
+    constexpr uint32_t Begin = offsetof(FEXCore::Core::CPUState, flags[0]);
+    constexpr uint32_t End = Begin + NumFlags;
+    return Offset < End && (Offset + Size) > Begin;
+  }
+
+  // Returns the set of flags that the op can observe.
+  // Anything that can leave the block, fault or hand state to something else sees every flag.
+  uint64_t FlagsObserved(IROp_Header const *IROp) {
+    switch (IROp->Op) {
+      case OP_LOADFLAG:
+        return 1ULL << IROp->C<IROp_LoadFlag>()->Flag;
+
+      // Can fault, the signal frame exposes the flags
+      case OP_LOADMEM:
+      case OP_LOADMEMTSO:
+      // #DE on divide by zero or quotient overflow
+      case OP_DIV:
+      case OP_UDIV:
+      case OP_REM:
+      case OP_UREM:
+      case OP_LDIV:
+      case OP_LUDIV:
+      case OP_LREM:
+      case OP_LUREM:
+      // We can't track through these
+      case OP_LOADCONTEXTINDEXED:
+      case OP_STORECONTEXTINDEXED:
+        return AllFlags;
+
+      case OP_LOADCONTEXT:
+        return OverlapsFlags(IROp->C<IROp_LoadContext>()->Offset, IROp->Size) ? AllFlags : 0;
+      case OP_STORECONTEXT:
+        return OverlapsFlags(IROp->C<IROp_StoreContext>()->Offset, IROp->Size) ? AllFlags : 0;
+
+      // Side effects that stay inside of the block and can't fault
+      case OP_DUMMY:
+      case OP_BEGINBLOCK:
+      case OP_ENDBLOCK:
+      case OP_STOREFLAG:
+      case OP_INVALIDATEFLAGS:
+      case OP_JUMP:
+      case OP_CONDJUMP:
+      case OP_STOREREGISTER:
+      case OP_SPILLREGISTER:
+      case OP_SETROUNDINGMODE:
+      case OP_F80LOADFCW:
+      case OP_FENCE:
+      case OP_PRINT:
+      case OP_INLINECONSTANT:
+      case OP_INLINEENTRYPOINTOFFSET:
+        return 0;
+
+      default:
+        // Block exits, syscalls, thunks, memory stores and atomics
+        return IR::HasSideEffects(IROp->Op) ? AllFlags : 0;
+    }
+  }
+
+  // Returns the set of flags that the op fully overwrites
+  uint64_t FlagsWritten(IROp_Header const *IROp) {
+    if (IROp->Op == OP_STOREFLAG) {
+      return 1ULL << IROp->C<IROp_StoreFlag>()->Flag;
+    }
+    else if (IROp->Op == OP_INVALIDATEFLAGS) {
+      // Undefined flags don't need to hold the previous value
+      return IROp->C<IROp_InvalidateFlags>()->Flags & AllFlags;
+    }
+
+    return 0;
+  }
+}
+
 /**
- * @brief (UNSAFE) This pass removes flag calculations that will otherwise be unused INSIDE of that block
+ * @brief This pass removes flag stores that no later code can observe, across blocks
  *
- * Compilers don't really do any form of cross-block flag allocation like they do RA with GPRs.
- * This ends up with them recalculating flags across blocks regardless of if it is actually possible to reuse the flags.
- * This is an additional burden in x86 that most instructions change flags when called, so it is easier to recalculate anyway.
+ * The OpcodeDispatcher defers flag generation within an instruction stream, but has to materialize the flags with StoreFlag
+ * whenever it leaves a block or an instruction only overwrites some of the flags.
+ * Those stores are usually overwritten by the next block before anything reads them.
  *
- * This is unsafe since handwritten code can easily break this assumption.
- * This may be more interesting with full function level recompilation since flags definitely won't be used across function boundaries.
+ * This is a standard backwards liveness dataflow over the multiblock CFG, with one bit per entry in CPUState::flags.
+ * To stay correct for handwritten code, anything that can leave the IR or expose the flags to something else is a use of every flag:
+ *   - Blocks that don't end in a Jump or CondJump to another block in this IR (ExitFunction, Break, etc)
+ *   - Syscalls, thunks and any other op with side effects that isn't known to be local
+ *   - Potential fault points, memory loads/stores and atomics, since a signal handler can read the flags from the signal frame
  *
+ * Once the flag store is gone, DCE cleans up the calculation feeding it.
  */
 bool DeadFlagCalculationEliminination::Run(IREmitter *IREmit) {
-  std::array<OrderedNode*, 32> LastValidFlagStores{};
-
   bool Changed = false;
   auto CurrentIR = IREmit->ViewIR();
 
-  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+  std::unordered_map<OrderedNode*, FlagLiveness> BlockInfo;
+  std::vector<OrderedNode*> Blocks;
+
+  // Pass 1
+  // Compute the flags each block reads before writing, and the flags it overwrites before reading
+  for (auto [BlockNode, BlockIROp] : CurrentIR.GetBlocks()) {
+    auto &Info = BlockInfo[BlockNode];
+    Blocks.push_back(BlockNode);
+
+    auto CodeBlock = BlockIROp->C<IROp_CodeBlock>();
+    auto LastOp = CurrentIR.GetNode(CurrentIR.GetNode(CodeBlock->Last)->Header.Previous)->Op(CurrentIR.GetData());
+
+    if (LastOp->Op == OP_JUMP) {
+      Info.Successors[0] = CurrentIR.GetNode(LastOp->C<IROp_Jump>()->TargetBlock);
+    }
+    else if (LastOp->Op == OP_CONDJUMP) {
+      auto Op = LastOp->C<IROp_CondJump>();
+      Info.Successors[0] = CurrentIR.GetNode(Op->TrueBlock);
+      Info.Successors[1] = CurrentIR.GetNode(Op->FalseBlock);
+    }
+    else {
+      Info.LeavesIR = true;
+    }
+
     for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
-      if (IROp->Op == OP_STOREFLAG) {
-        auto Op = IROp->CW<IR::IROp_StoreFlag>();
-        // Set this node as the last one valid for this flag
-        LastValidFlagStores[Op->Flag] = CodeNode;
+      const uint64_t Observed = FlagsObserved(IROp);
+      Info.Uses |= Observed & ~Info.Defs;
+      Info.Defs |= FlagsWritten(IROp) & ~Info.Uses;
+    }
+  }
+
+  // Pass 2
+  // Iterate live-in/live-out to a fixed point, blocks are visited last to first so this converges quickly
+  bool Updated = true;
+  while (Updated) {
+    Updated = false;
+
+    for (auto it = Blocks.rbegin(); it != Blocks.rend(); ++it) {
+      auto &Info = BlockInfo[*it];
+
+      uint64_t LiveOut = Info.LeavesIR ? AllFlags : 0;
+      for (auto Successor : Info.Successors) {
+        if (Successor) {
+          LiveOut |= BlockInfo[Successor].LiveIn;
+        }
       }
-      else if (IROp->Op == OP_LOADFLAG) {
-        auto Op = IROp->CW<IR::IROp_LoadFlag>();
-        LastValidFlagStores[Op->Flag] = nullptr;
+
+      const uint64_t LiveIn = Info.Uses | (LiveOut & ~Info.Defs);
+      if (LiveOut != Info.LiveOut || LiveIn != Info.LiveIn) {
+        Info.LiveOut = LiveOut;
+        Info.LiveIn = LiveIn;
+        Updated = true;
       }
     }
+  }
+
+  // Pass 3
+  // Walk each block backwards from its live-out set and remove stores to dead flags
+  std::vector<OrderedNode*> BlockCode;
+  for (auto BlockNode : Blocks) {
+    uint64_t Live = BlockInfo[BlockNode].LiveOut;
+
+    BlockCode.clear();
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+      BlockCode.push_back(CodeNode);
+    }
+
+    for (auto it = BlockCode.rbegin(); it != BlockCode.rend(); ++it) {
+      auto IROp = (*it)->Op(CurrentIR.GetData());
 
-    // If any flags are stored but not loaded by the end of the block, then erase them
-    for (auto &Flag : LastValidFlagStores) {
-      if (Flag != nullptr) {
-        IREmit->Remove(Flag);
+      const uint64_t Written = FlagsWritten(IROp);
+      if (IROp->Op == OP_STOREFLAG && !(Live & Written)) {
+        IREmit->Remove(*it);
         Changed = true;
       }
-    }
 
-    LastValidFlagStores.fill(nullptr);
+      Live &= ~Written;
+      Live |= FlagsObserved(IROp);
+    }
   }
 
   return Changed;
@@ -37,7 +37,7 @@ namespace {
   constexpr uint32_t INVALID_REG = FEXCore::IR::InvalidReg;
   constexpr uint32_t INVALID_CLASS = FEXCore::IR::InvalidClass.Val;
 
-  constexpr uint32_t DEFAULT_INTERFERENCE_LIST_COUNT = 122;
+  constexpr uint32_t DEFAULT_INTERFERENCE_LIST_COUNT = 126;
   constexpr uint32_t DEFAULT_INTERFERENCE_SPAN_COUNT = 30;
   constexpr uint32_t DEFAULT_NODE_COUNT = 8192;
 
@@ -52,18 +52,16 @@ namespace {
   };
 
   struct RegisterNode {
-    struct VolatileHeader {
-      IR::NodeID BlockID{UINT32_MAX};
-      uint32_t SpillSlot{UINT32_MAX};
-      RegisterNode *PhiPartner{nullptr};
-    };
-
-    VolatileHeader Head;
-    FEXCore::BucketList<DEFAULT_INTERFERENCE_LIST_COUNT, IR::NodeID> Interferences;
+    IR::NodeID BlockID{UINT32_MAX};
+    uint32_t SpillSlot{UINT32_MAX};
+    RegisterNode *PhiPartner{nullptr};
   };
 
-  static_assert(sizeof(RegisterNode) == 128 * 4);
-  constexpr size_t REGISTER_NODES_PER_PAGE = FHU::FEX_PAGE_SIZE / sizeof(RegisterNode);
+  // Interferences are kept apart from the node so the linear scan allocator never has to allocate them
+  using InterferenceList = FEXCore::BucketList<DEFAULT_INTERFERENCE_LIST_COUNT, IR::NodeID>;
+
+  static_assert(sizeof(InterferenceList) == 128 * 4);
+  constexpr size_t REGISTER_NODES_PER_PAGE = FHU::FEX_PAGE_SIZE / sizeof(InterferenceList);
 
   struct RegisterSet {
     std::vector<RegisterClass> Classes;
@@ -92,15 +90,17 @@ namespace {
     std::unique_ptr<IR::RegisterAllocationData, IR::RegisterAllocationDataDeleter> AllocData;
     RegisterSet Set;
     std::vector<RegisterNode> Nodes{};
+    // Only used by the graph allocator
+    std::vector<InterferenceList> Interferences{};
     uint32_t NodeCount{};
     std::vector<SpillStackUnit> SpillStack;
     std::unordered_map<IR::NodeID, std::unordered_set<IR::NodeID>> BlockPredecessors;
     std::unordered_map<IR::NodeID, std::unordered_set<IR::NodeID>> VisitedNodePredecessors;
   };
 
-  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount);
+  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount, bool LinearScan);
 
-  RegisterGraph *AllocateRegisterGraph(uint32_t ClassCount) {
+  RegisterGraph *AllocateRegisterGraph(uint32_t ClassCount, bool LinearScan) {
     RegisterGraph *Graph = new RegisterGraph{};
 
     // Allocate the register set
@@ -108,7 +108,7 @@ namespace {
     Graph->Set.Classes.resize(ClassCount);
 
     // Allocate default nodes
-    ResetRegisterGraph(Graph, DEFAULT_NODE_COUNT);
+    ResetRegisterGraph(Graph, DEFAULT_NODE_COUNT, LinearScan);
     return Graph;
   }
 
@@ -144,14 +144,19 @@ namespace {
     delete Graph;
   }
 
-  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount) {
+  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount, bool LinearScan) {
     NodeCount = FEXCore::AlignUp(NodeCount, REGISTER_NODES_PER_PAGE);
 
-    // Clear to free the Bucketlists which have unique_ptrs
-    // Resize to our correct size
     Graph->Nodes.clear();
     Graph->Nodes.resize(NodeCount);
 
+    // Clear to free the Bucketlists which have unique_ptrs
+    // Resize to our correct size
+    Graph->Interferences.clear();
+    if (!LinearScan) {
+      Graph->Interferences.resize(NodeCount);
+    }
+
     Graph->VisitedNodePredecessors.clear();
     Graph->AllocData.reset((FEXCore::IR::RegisterAllocationData*)FEXCore::Allocator::malloc(FEXCore::IR::RegisterAllocationData::Size(NodeCount)));
     memset(&Graph->AllocData->Map[0], PhysicalRegister::Invalid().Raw, NodeCount);
@@ -165,7 +170,7 @@ namespace {
   }
 
   void SetNodePartner(RegisterGraph *Graph, IR::NodeID Node, IR::NodeID Partner) {
-    Graph->Nodes[Node.Value].Head.PhiPartner = &Graph->Nodes[Partner.Value];
+    Graph->Nodes[Node.Value].PhiPartner = &Graph->Nodes[Partner.Value];
   }
 
 
@@ -201,6 +206,14 @@ namespace {
   }
   #endif
 
+  // GPR pairs are allocated from the GPRs, so they interfere with each other
+  uint32_t GetInterferenceClass(PhysicalRegister PhyReg) {
+    if (PhyReg.Class == IR::GPRPairClass.Val)
+      return IR::GPRClass.Val;
+    else
+      return (uint32_t)PhyReg.Class;
+  }
+
   FEXCore::IR::RegisterClassType GetRegClassFromNode(FEXCore::IR::IRListView *IR, FEXCore::IR::IROp_Header *IROp) {
     using namespace FEXCore;
 
@@ -270,7 +283,7 @@ namespace {
 
   class ConstrainedRAPass final : public RegisterAllocationPass {
     public:
-      ConstrainedRAPass(FEXCore::IR::Pass* _CompactionPass, bool OptimizeSRA);
+      ConstrainedRAPass(FEXCore::IR::Pass* _CompactionPass, bool OptimizeSRA, bool LinearScan);
       ~ConstrainedRAPass();
       bool Run(IREmitter *IREmit) override;
 
@@ -296,9 +309,17 @@ namespace {
       RegisterGraph *Graph;
       FEXCore::IR::Pass* CompactionPass;
       bool OptimizeSRA;
+      bool LinearScan;
 
       std::vector<LiveRange> LiveRanges;
 
+      // Linear scan state
+      // Intervals sorted by their start, and the ones that are live at the current start
+      std::vector<IR::NodeID> Intervals;
+      std::vector<IR::NodeID> ActiveIntervals;
+      // Values holding a register at the point where linear scan failed
+      InterferenceList SpillInterferences;
+
       std::unordered_map<IR::NodeID, BlockInterferences> LocalBlockInterferences;
       BlockInterferences GlobalBlockInterferences;
 
@@ -316,6 +337,7 @@ namespace {
       }
 
       void SpillOne(FEXCore::IR::IREmitter *IREmit);
+      void SpillGlobal(FEXCore::IR::IREmitter *IREmit, IR::NodeID Node);
 
       void CalculateLiveRange(FEXCore::IR::IRListView *IR);
       void OptimizeStaticRegisters(FEXCore::IR::IRListView *IR);
@@ -323,6 +345,7 @@ namespace {
       void CalculateBlockNodeInterference(FEXCore::IR::IRListView *IR);
       void CalculateNodeInterference(FEXCore::IR::IRListView *IR);
       void AllocateVirtualRegisters();
+      void AllocateVirtualRegistersLinear();
       void CalculatePredecessors(FEXCore::IR::IRListView *IR);
       void RecursiveLiveRangeExpansion(FEXCore::IR::IRListView *IR,
                                        IR::NodeID Node, IR::NodeID DefiningBlockID,
@@ -334,7 +357,7 @@ namespace {
       FEXCore::IR::AllNodesIterator FindLastUseBefore(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End);
 
       std::optional<IR::NodeID> FindNodeToSpill(IREmitter *IREmit,
-                                                RegisterNode *RegisterNode,
+                                                InterferenceList const &Interferences,
                                                 IR::NodeID CurrentLocation,
                                                 LiveRange const *OpLiveRange,
                                                 int32_t RematCost = -1);
@@ -343,8 +366,8 @@ namespace {
       bool RunAllocateVirtualRegisters(IREmitter *IREmit);
   };
 
-  ConstrainedRAPass::ConstrainedRAPass(FEXCore::IR::Pass* _CompactionPass, bool _OptimizeSRA)
-    : CompactionPass {_CompactionPass}, OptimizeSRA(_OptimizeSRA) {
+  ConstrainedRAPass::ConstrainedRAPass(FEXCore::IR::Pass* _CompactionPass, bool _OptimizeSRA, bool _LinearScan)
+    : CompactionPass {_CompactionPass}, OptimizeSRA(_OptimizeSRA), LinearScan(_LinearScan) {
   }
 
   ConstrainedRAPass::~ConstrainedRAPass() {
@@ -355,7 +378,7 @@ namespace {
     LOGMAN_THROW_A_FMT(RegisterCount <= INVALID_REG, "Up to {} regs supported", INVALID_REG);
     LOGMAN_THROW_A_FMT(ClassCount <= INVALID_CLASS, "Up to {} classes supported", INVALID_CLASS);
 
-    Graph = AllocateRegisterGraph(ClassCount);
+    Graph = AllocateRegisterGraph(ClassCount, LinearScan);
 
     // Add identity conflicts
     for (uint32_t Class = 0; Class < INVALID_CLASS; Class++) {
@@ -467,7 +490,7 @@ namespace {
         NodeLiveRange.RematCost = CalculateRematCost(IROp->Op);
 
         // Set this node's block ID
-        Graph->Nodes[Node.Value].Head.BlockID = BlockNodeID;
+        Graph->Nodes[Node.Value].BlockID = BlockNodeID;
 
         // FillRegister's SSA arg is only there for verification, and we don't want it
         // to impact the live range.
@@ -497,7 +520,7 @@ namespace {
           LOGMAN_THROW_A_FMT(ArgNodeLiveRange.Begin.Value != UINT32_MAX,
                              "%ssa{} used by %ssa{} before defined?", ArgNode, Node);
 
-          const auto ArgNodeBlockID = Graph->Nodes[ArgNode.Value].Head.BlockID;
+          const auto ArgNodeBlockID = Graph->Nodes[ArgNode.Value].BlockID;
           if (ArgNodeBlockID == BlockNodeID) {
             // Set the node end to be at least here
             ArgNodeLiveRange.End = Node;
@@ -508,8 +531,7 @@ namespace {
             ArgNodeLiveRange.Begin = std::min(ArgNodeLiveRange.Begin, Node);
             ArgNodeLiveRange.End = std::max(ArgNodeLiveRange.End, Node);
 
-            // Can't spill this range, it is MB
-            ArgNodeLiveRange.RematCost = -1;
+            // The linear spill heuristics don't apply to this range, SpillGlobal fills it per block instead
 
             // Include any blocks this value passes through in the live range
             RecursiveLiveRangeExpansion(IR, ArgNode, ArgNodeBlockID, &ArgNodeLiveRange,
@@ -873,21 +895,13 @@ namespace {
 
   void ConstrainedRAPass::CalculateNodeInterference(FEXCore::IR::IRListView *IR) {
     const auto AddInterference = [this](IR::NodeID Node1, IR::NodeID Node2) {
-      RegisterNode *Node = &Graph->Nodes[Node1.Value];
-      Node->Interferences.Append(Node2);
+      Graph->Interferences[Node1.Value].Append(Node2);
     };
 
     const uint32_t NodeCount = IR->GetSSACount();
 
     // Now that we have all the live ranges calculated we need to add them to our interference graph
 
-    const auto GetClass = [](PhysicalRegister PhyReg) {
-      if (PhyReg.Class == IR::GPRPairClass.Val)
-        return IR::GPRClass.Val;
-      else
-        return (uint32_t)PhyReg.Class;
-    };
-
     // SpanStart/SpanEnd assume SSA id will fit in 24bits
     LOGMAN_THROW_A_FMT(NodeCount <= 0xff'ffff, "Block too large for Spans");
 
@@ -899,7 +913,7 @@ namespace {
       if (NodeLiveRange.Begin.Value != UINT32_MAX) {
         LOGMAN_THROW_A_FMT(NodeLiveRange.Begin < NodeLiveRange.End , "Span must Begin before Ending");
 
-        const auto Class = GetClass(Graph->AllocData->Map[i]);
+        const auto Class = GetInterferenceClass(Graph->AllocData->Map[i]);
         SpanStart[NodeLiveRange.Begin.Value].Append(InfoMake(i, Class));
         SpanEnd[NodeLiveRange.End.Value]    .Append(InfoMake(i, Class));
       }
@@ -943,7 +957,7 @@ namespace {
       auto RegAndClass = PhysicalRegister::Invalid();
       RegisterClass *RAClass = &Graph->Set.Classes[RegClass];
 
-      if (CurrentNode->Head.PhiPartner) {
+      if (CurrentNode->PhiPartner) {
         LOGMAN_MSG_A_FMT("Phi nodes not supported");
         #if 0
         // In the case that we have a list of nodes that need the same register allocated we need to do something special
@@ -983,7 +997,7 @@ namespace {
           RegAndClass = LiveRange->PrefferedRegister;
         } else {
           uint32_t RegisterConflicts = 0;
-          CurrentNode->Interferences.Iterate([&](const IR::NodeID InterferenceNode) {
+          Graph->Interferences[i].Iterate([&](const IR::NodeID InterferenceNode) {
             RegisterConflicts |= GetConflicts(Graph, Graph->AllocData->Map[InterferenceNode.Value], {RegClass});
           });
 
@@ -1011,6 +1025,87 @@ namespace {
     }
   }
 
+  /**
+   * @brief Linear scan allocation over the live intervals
+   *
+   * Intervals are visited in order of their start, a value can only conflict with the values that are still live at that point.
+   * This gives the same assignment as the graph allocator for block local values without building the interference graph.
+   * On failure the values holding a register at the failing start become the spill candidates.
+   */
+  void ConstrainedRAPass::AllocateVirtualRegistersLinear() {
+    Intervals.clear();
+    ActiveIntervals.clear();
+
+    for (uint32_t i = 0; i < LiveRanges.size(); ++i) {
+      if (Graph->AllocData->Map[i] == PhysicalRegister::Invalid() ||
+          LiveRanges[i].Begin.Value == UINT32_MAX) {
+        continue;
+      }
+
+      Intervals.emplace_back(i);
+    }
+
+    // Ids are already in program order, only cross block ranges can start earlier than their definition
+    std::stable_sort(Intervals.begin(), Intervals.end(), [this](IR::NodeID Lhs, IR::NodeID Rhs) {
+      return LiveRanges[Lhs.Value].Begin < LiveRanges[Rhs.Value].Begin;
+    });
+
+    for (auto Node : Intervals) {
+      const auto &NodeLiveRange = LiveRanges[Node.Value];
+      auto &CurrentRegAndClass = Graph->AllocData->Map[Node.Value];
+
+      // Expire the intervals that ended before this one starts
+      std::erase_if(ActiveIntervals, [&](IR::NodeID Active) {
+        return LiveRanges[Active.Value].End <= NodeLiveRange.Begin;
+      });
+
+      LOGMAN_THROW_A_FMT(Graph->Nodes[Node.Value].PhiPartner == nullptr, "Phi nodes not supported");
+
+      const FEXCore::IR::RegisterClassType RegClass = FEXCore::IR::RegisterClassType{CurrentRegAndClass.Class};
+      const auto InterferenceClass = GetInterferenceClass(CurrentRegAndClass);
+      auto RegAndClass = PhysicalRegister::Invalid();
+
+      if (!NodeLiveRange.PrefferedRegister.IsInvalid()) {
+        RegAndClass = NodeLiveRange.PrefferedRegister;
+      } else {
+        uint32_t RegisterConflicts = 0;
+        for (auto Active : ActiveIntervals) {
+          const auto ActiveRegAndClass = Graph->AllocData->Map[Active.Value];
+          if (GetInterferenceClass(ActiveRegAndClass) == InterferenceClass) {
+            RegisterConflicts |= GetConflicts(Graph, ActiveRegAndClass, RegClass);
+          }
+        }
+
+        RegisterConflicts = (~RegisterConflicts) & Graph->Set.Classes[RegClass].CountMask;
+
+        int Reg = ffs(RegisterConflicts);
+        if (Reg != 0) {
+          RegAndClass = PhysicalRegister(RegClass, Reg-1);
+        }
+      }
+
+      // If we failed to find a virtual register then use INVALID_REG and mark allocation as failed
+      if (RegAndClass.IsInvalid()) {
+        CurrentRegAndClass = IR::PhysicalRegister(RegClass, INVALID_REG);
+        HadFullRA = false;
+        SpillPointId = Node;
+
+        SpillInterferences.Clear();
+        for (auto Active : ActiveIntervals) {
+          if (GetInterferenceClass(Graph->AllocData->Map[Active.Value]) == InterferenceClass) {
+            SpillInterferences.Append(Active);
+          }
+        }
+
+        // Must spill and restart
+        return;
+      }
+
+      CurrentRegAndClass = RegAndClass;
+      ActiveIntervals.emplace_back(Node);
+    }
+  }
+
   FEXCore::IR::AllNodesIterator ConstrainedRAPass::FindFirstUse(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End) {
     using namespace FEXCore::IR;
     const auto SearchID = IREmit->ViewIR().GetID(Node);
@@ -1070,7 +1165,7 @@ namespace {
   }
 
   std::optional<IR::NodeID> ConstrainedRAPass::FindNodeToSpill(IREmitter *IREmit,
-                                                               RegisterNode *RegisterNode,
+                                                               InterferenceList const &Interferences,
                                                                IR::NodeID CurrentLocation,
                                                                LiveRange const *OpLiveRange,
                                                                int32_t RematCost) {
@@ -1087,9 +1182,10 @@ namespace {
     // Couldn't find register to spill
     // Be more aggressive
     if (InterferenceIdToSpill.IsInvalid()) {
-      RegisterNode->Interferences.Iterate([&](IR::NodeID InterferenceNode) {
+      Interferences.Iterate([&](IR::NodeID InterferenceNode) {
         auto *InterferenceLiveRange = &LiveRanges[InterferenceNode.Value];
         if (InterferenceLiveRange->RematCost == -1 ||
+            InterferenceLiveRange->Global ||
             (RematCost != -1 && InterferenceLiveRange->RematCost != RematCost)) {
           return;
         }
@@ -1163,9 +1259,10 @@ namespace {
 
 
     if (InterferenceIdToSpill.IsInvalid()) {
-      RegisterNode->Interferences.Iterate([&](IR::NodeID InterferenceNode) {
+      Interferences.Iterate([&](IR::NodeID InterferenceNode) {
         auto *InterferenceLiveRange = &LiveRanges[InterferenceNode.Value];
         if (InterferenceLiveRange->RematCost == -1 ||
+            InterferenceLiveRange->Global ||
             (RematCost != -1 && InterferenceLiveRange->RematCost != RematCost)) {
           return;
         }
@@ -1266,6 +1363,24 @@ namespace {
       return std::nullopt;
     }
 
+    // Heuristics only look at block local ranges, a range that lives across blocks is the next best thing to spill.
+    // Pick the longest one, it frees the register over the most code.
+    if (InterferenceIdToSpill.IsInvalid()) {
+      uint32_t LongestRange = 0;
+      Interferences.Iterate([&](IR::NodeID InterferenceNode) {
+        const auto *InterferenceLiveRange = &LiveRanges[InterferenceNode.Value];
+        if (!InterferenceLiveRange->Global) {
+          return;
+        }
+
+        const auto Length = InterferenceLiveRange->End.Value - InterferenceLiveRange->Begin.Value;
+        if (Length >= LongestRange) {
+          InterferenceIdToSpill = InterferenceNode;
+          LongestRange = Length;
+        }
+      });
+    }
+
     // Heuristics failed to spill ?
     if (InterferenceIdToSpill.IsInvalid()) {
       // Panic spill: Spill any value not used by the current op
@@ -1284,9 +1399,10 @@ namespace {
       }
 
 
-      RegisterNode->Interferences.Find([&](IR::NodeID InterferenceNode) {
+      Interferences.Find([&](IR::NodeID InterferenceNode) {
           auto *InterferenceLiveRange = &LiveRanges[InterferenceNode.Value];
           if (InterferenceLiveRange->RematCost == -1 ||
+              InterferenceLiveRange->Global ||
               (RematCost != -1 && InterferenceLiveRange->RematCost != RematCost)) {
             return false;
           }
@@ -1306,7 +1422,7 @@ namespace {
                         CurrentLocation, -1,
                         OpLiveRange->Begin, OpLiveRange->End);
 
-      RegisterNode->Interferences.Iterate([&](IR::NodeID InterferenceNode) {
+      Interferences.Iterate([&](IR::NodeID InterferenceNode) {
         auto *InterferenceLiveRange = &LiveRanges[InterferenceNode.Value];
 
         LogMan::Msg::DFmt("\tInt{}: %ssa{} Remat: {} [{}, {})", j++, InterferenceNode, InterferenceLiveRange->RematCost, InterferenceLiveRange->Begin, InterferenceLiveRange->End);
@@ -1329,7 +1445,7 @@ namespace {
             SpillUnit.SpillRange.Begin <= NodeLiveRange.End) {
           SpillUnit.SpillRange.Begin = std::min(SpillUnit.SpillRange.Begin, NodeLiveRange.Begin);
           SpillUnit.SpillRange.End = std::max(SpillUnit.SpillRange.End, NodeLiveRange.End);
-          CurrentNode.Head.SpillSlot = i;
+          CurrentNode.SpillSlot = i;
           return i;
         }
       }
@@ -1339,9 +1455,9 @@ namespace {
     auto StackItem = Graph->SpillStack.emplace_back(SpillStackUnit{Node, RegisterClass});
     StackItem.SpillRange.Begin = NodeLiveRange.Begin;
     StackItem.SpillRange.End = NodeLiveRange.End;
-    CurrentNode.Head.SpillSlot = SpillSlotCount;
+    CurrentNode.SpillSlot = SpillSlotCount;
     SpillSlotCount++;
-    return CurrentNode.Head.SpillSlot;
+    return CurrentNode.SpillSlot;
   }
 
   void ConstrainedRAPass::SpillOne(FEXCore::IR::IREmitter *IREmit) {
@@ -1354,7 +1470,7 @@ namespace {
     LOGMAN_THROW_A_FMT(IROp->HasDest, "Can't spill with no dest");
 
     const auto Node = IR.GetID(CodeNode);
-    RegisterNode *CurrentNode = &Graph->Nodes[Node.Value];
+    auto const &Interferences = LinearScan ? SpillInterferences : Graph->Interferences[Node.Value];
     auto &CurrentRegAndClass = Graph->AllocData->Map[Node.Value];
     LiveRange *OpLiveRange = &LiveRanges[Node.Value];
 
@@ -1367,7 +1483,7 @@ namespace {
       bool Spilled = false;
 
       // First let's just check for constants that we can just rematerialize instead of spilling
-      if (const auto InterferenceNode = FindNodeToSpill(IREmit, CurrentNode, Node, OpLiveRange, 1)) {
+      if (const auto InterferenceNode = FindNodeToSpill(IREmit, Interferences, Node, OpLiveRange, 1)) {
         // We want to end the live range of this value here and continue it on first use
         auto [ConstantNode, _] = IR.at(*InterferenceNode)();
         auto ConstantIROp = IR.GetOp<IR::IROp_Constant>(ConstantNode);
@@ -1392,7 +1508,11 @@ namespace {
 
       // If we didn't remat a constant then we need to do some real spilling
       if (!Spilled) {
-        if (const auto InterferenceNode = FindNodeToSpill(IREmit, CurrentNode, Node, OpLiveRange)) {
+        const auto InterferenceNode = FindNodeToSpill(IREmit, Interferences, Node, OpLiveRange);
+        if (InterferenceNode && LiveRanges[InterferenceNode->Value].Global) {
+          SpillGlobal(IREmit, *InterferenceNode);
+        }
+        else if (InterferenceNode) {
           const auto InterferenceRegClass = IR::RegisterClassType{Graph->AllocData->Map[InterferenceNode->Value].Class};
           const uint32_t SpillSlot = FindSpillSlot(*InterferenceNode, InterferenceRegClass);
 
@@ -1401,7 +1521,7 @@ namespace {
           LOGMAN_THROW_A_FMT(SpillSlot != UINT32_MAX, "Interference Node doesn't have a spill slot!");
           //LOGMAN_THROW_A_FMT(InterferenceRegisterNode->Head.RegAndClass.Reg != INVALID_REG, "Interference node never assigned a register?");
           LOGMAN_THROW_A_FMT(InterferenceRegClass != UINT32_MAX, "Interference node never assigned a register class?");
-          LOGMAN_THROW_A_FMT(InterferenceRegisterNode->Head.PhiPartner == nullptr, "We don't support spilling PHI nodes currently");
+          LOGMAN_THROW_A_FMT(InterferenceRegisterNode->PhiPartner == nullptr, "We don't support spilling PHI nodes currently");
 #endif
 
           // This is the op that we need to dump
@@ -1459,6 +1579,68 @@ namespace {
     }
   }
 
+  void ConstrainedRAPass::SpillGlobal(FEXCore::IR::IREmitter *IREmit, IR::NodeID Node) {
+    using namespace FEXCore;
+
+    auto IR = IREmit->ViewIR();
+    auto [DefNode, DefIROp] = IR.at(Node)();
+    const auto DefBlockID = Graph->Nodes[Node.Value].BlockID;
+    const auto RegClass = IR::RegisterClassType{Graph->AllocData->Map[Node.Value].Class};
+
+    // Constants are cheaper to recreate than to fill
+    const bool IsConstant = DefIROp->Op == OP_CONSTANT;
+    const uint64_t Constant = IsConstant ? DefIROp->C<IR::IROp_Constant>()->Constant : 0;
+    const uint32_t SpillSlot = IsConstant ? UINT32_MAX : FindSpillSlot(Node, RegClass);
+
+    // The definition dominates every use, so spilling right after it is valid for every path through the CFG
+    if (!IsConstant) {
+      IREmit->SetWriteCursor(DefNode);
+      auto SpillOp = IREmit->_SpillRegister(DefNode, SpillSlot, RegClass);
+      SpillOp.first->Header.Size = DefIROp->Size;
+      SpillOp.first->Header.ElementSize = DefIROp->ElementSize;
+    }
+
+    // Every other block that uses the value gets its own fill before the first use.
+    // This leaves the definition and all of the fills as block local ranges.
+    for (auto [BlockNode, BlockHeader] : IR.GetBlocks()) {
+      if (IR.GetID(BlockNode) == DefBlockID) {
+        continue;
+      }
+
+      auto BlockIROp = BlockHeader->C<IR::IROp_CodeBlock>();
+      auto BlockEnd = IREmit->GetIterator(BlockIROp->Last);
+
+      for (auto [CodeNode, IROp] : IR.GetCode(BlockNode)) {
+        bool Uses = false;
+        const uint8_t NumArgs = IR::GetArgs(IROp->Op);
+        for (uint8_t i = 0; i < NumArgs; ++i) {
+          Uses |= IROp->Args[i].ID() == Node;
+        }
+
+        // FillRegister only references the original value for validation
+        if (!Uses || IROp->Op == OP_FILLREGISTER) {
+          continue;
+        }
+
+        IREmit->SetWriteCursor(IR.GetNode(CodeNode->Header.Previous));
+
+        IR::OrderedNode *Filled{};
+        if (IsConstant) {
+          Filled = IREmit->_Constant(Constant);
+        }
+        else {
+          auto FillOp = IREmit->_FillRegister(DefNode, SpillSlot, RegClass);
+          FillOp.first->Header.Size = DefIROp->Size;
+          FillOp.first->Header.ElementSize = DefIROp->ElementSize;
+          Filled = FillOp;
+        }
+
+        IREmit->ReplaceAllUsesWithRange(DefNode, Filled, IREmit->GetIterator(IREmit->WrapNode(CodeNode)), BlockEnd);
+        break;
+      }
+    }
+  }
+
   bool ConstrainedRAPass::RunAllocateVirtualRegisters(FEXCore::IR::IREmitter *IREmit) {
     using namespace FEXCore;
     bool Changed = false;
@@ -1470,22 +1652,28 @@ namespace {
 
     uint32_t SSACount = IR.GetSSACount();
 
-    ResetRegisterGraph(Graph, SSACount);
+    ResetRegisterGraph(Graph, SSACount, LinearScan);
     FindNodeClasses(Graph, &IR);
     CalculateLiveRange(&IR);
     if (OptimizeSRA)
       OptimizeStaticRegisters(&IR);
 
-    // Linear forward scan based interference calculation is faster for smaller blocks
-    // Smarter block based interference calculation is faster for larger blocks
-    /*if (SSACount >= 2048) {
-      CalculateBlockInterferences(&IR);
-      CalculateBlockNodeInterference(&IR);
+    if (LinearScan) {
+      // Allocates straight from the live intervals, no interference graph
+      AllocateVirtualRegistersLinear();
     }
-    else*/ {
-      CalculateNodeInterference(&IR);
+    else {
+      // Linear forward scan based interference calculation is faster for smaller blocks
+      // Smarter block based interference calculation is faster for larger blocks
+      /*if (SSACount >= 2048) {
+        CalculateBlockInterferences(&IR);
+        CalculateBlockNodeInterference(&IR);
+      }
+      else*/ {
+        CalculateNodeInterference(&IR);
+      }
+      AllocateVirtualRegisters();
     }
-    AllocateVirtualRegisters();
 
     return Changed;
   }
@@ -1540,7 +1728,7 @@ namespace {
     return Changed;
   }
 
-  std::unique_ptr<FEXCore::IR::RegisterAllocationPass> CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA) {
-    return std::make_unique<ConstrainedRAPass>(CompactionPass, OptimizeSRA);
+  std::unique_ptr<FEXCore::IR::RegisterAllocationPass> CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA, bool LinearScan) {
+    return std::make_unique<ConstrainedRAPass>(CompactionPass, OptimizeSRA, LinearScan);
   }
 }
@@ -19,7 +19,12 @@ namespace FEXCore::IR {
 
 class SyscallOptimization final : public FEXCore::IR::Pass {
 public:
+  explicit SyscallOptimization(bool InlineConstants)
+    : InlineConstants {InlineConstants} {}
   bool Run(IREmitter *IREmit) override;
+
+private:
+  bool InlineConstants;
 };
 
 bool SyscallOptimization::Run(IREmitter *IREmit) {
@@ -40,14 +45,12 @@ bool SyscallOptimization::Run(IREmitter *IREmit) {
         // Update the syscall flags
         Op->Flags = SyscallFlags;
 
-        // XXX: Once we have the ability to do real function calls then we can call directly in to the syscall handler
         if (SyscallDef.NumArgs < FEXCore::HLE::SyscallArguments::MAX_ARGS) {
           // If the number of args are less than what the IR op supports then we can remove arg usage
           // We need +1 since we are still passing in syscall number here
           for (uint8_t Arg = (SyscallDef.NumArgs + 1); Arg < FEXCore::HLE::SyscallArguments::MAX_ARGS; ++Arg) {
             IREmit->ReplaceNodeArgument(CodeNode, Arg, IREmit->Invalid());
           }
-#ifdef _M_ARM_64
           // Replace syscall with inline passthrough syscall if we can
           if (SyscallDef.HostSyscallNumber != -1) {
             IREmit->SetWriteCursor(CodeNode);
@@ -68,7 +71,11 @@ bool SyscallOptimization::Run(IREmitter *IREmit) {
             // We must remove here since DCE can't remove a IROp with sideeffects
             IREmit->Remove(CodeNode);
           }
-#endif
+          else if (InlineConstants) {
+            // Lets the JIT look up the handler and call it directly with the arguments in registers
+            IREmit->SetWriteCursor(CurrentIR.GetNode(Op->SyscallID));
+            IREmit->ReplaceNodeArgument(CodeNode, 0, IREmit->_InlineConstant(Constant));
+          }
         }
 
         Changed = true;
@@ -79,8 +86,8 @@ bool SyscallOptimization::Run(IREmitter *IREmit) {
   return Changed;
 }
 
-std::unique_ptr<FEXCore::IR::Pass> CreateSyscallOptimization() {
-  return std::make_unique<SyscallOptimization>();
+std::unique_ptr<FEXCore::IR::Pass> CreateSyscallOptimization(bool InlineConstants) {
+  return std::make_unique<SyscallOptimization>(InlineConstants);
 }
 
 }
@@ -0,0 +1,355 @@
+/*
+$info$
+tags: ir|opts
+desc: Global value numbering, removes redundant pure ops across the dominator tree
+$end_info$
+*/
+
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <cstring>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace FEXCore::IR {
+
+class ValueNumbering final : public FEXCore::IR::Pass {
+public:
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  struct BlockInfo {
+    OrderedNode *Node;
+    std::vector<uint32_t> Successors;
+    std::vector<uint32_t> Predecessors;
+    std::vector<uint32_t> DominatorChildren;
+    uint32_t RPONumber {~0U};
+    uint32_t IDom {~0U};
+  };
+
+  struct Leader {
+    OrderedNode *Node;
+    uint32_t Block;
+  };
+
+  bool CanNumber(IROp_Header const *IROp) const;
+  uint64_t HashOp(IROp_Header const *IROp) const;
+  bool IsEqual(IROp_Header const *LHS, IROp_Header const *RHS) const;
+  uint32_t GetNumber(NodeID ID) const;
+
+  void BuildDominatorTree(IRListView const &CurrentIR);
+
+  std::vector<BlockInfo> Blocks;
+  std::unordered_map<uint32_t, uint32_t> ValueNumbers;
+  bool HasRoundingModeChange{};
+};
+
+// Cheap to recreate in every block, never worth a global live range
+static bool IsRematerializable(IROps Op) {
+  switch (Op) {
+    case OP_CONSTANT:
+    case OP_INLINECONSTANT:
+    case OP_INLINEENTRYPOINTOFFSET:
+    case OP_ENTRYPOINTOFFSET:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ValueNumbering::CanNumber(IROp_Header const *IROp) const {
+  if (!IROp->HasDest || HasSideEffects(IROp->Op)) {
+    return false;
+  }
+
+  switch (IROp->Op) {
+    // Results depend on state that isn't an argument
+    case OP_LOADCONTEXT:
+    case OP_LOADCONTEXTINDEXED:
+    case OP_LOADREGISTER:
+    case OP_FILLREGISTER:
+    case OP_LOADFLAG:
+    case OP_LOADMEM:
+    case OP_LOADMEMTSO:
+    case OP_PROCESSORID:
+    case OP_GETROUNDINGMODE:
+    case OP_RDRAND:
+    case OP_CPUID:
+    case OP_CYCLECOUNTER:
+    // Structural ops
+    case OP_PHI:
+    case OP_PHIVALUE:
+    case OP_MOV:
+    case OP_CODEBLOCK:
+    case OP_IRHEADER:
+      return false;
+    default:
+      break;
+  }
+
+  // x87 ops depend on the guest control word
+  if (DependsOnFCW(IROp->Op)) {
+    return false;
+  }
+
+  // Floating point results depend on the current rounding mode
+  if (HasRoundingModeChange &&
+      (GetRegClass(IROp->Op) == FPRClass || IROp->Op == OP_FLOAT_TOGPR_S)) {
+    return false;
+  }
+
+  return true;
+}
+
+uint32_t ValueNumbering::GetNumber(NodeID ID) const {
+  auto it = ValueNumbers.find(ID.Value);
+  return it == ValueNumbers.end() ? ID.Value : it->second;
+}
+
+uint64_t ValueNumbering::HashOp(IROp_Header const *IROp) const {
+  // FNV-1a over the header, the argument value numbers and the remaining op data
+  uint64_t Hash = 0xcbf29ce484222325ULL;
+  auto Mix = [&Hash](void const *Data, size_t Size) {
+    auto Bytes = reinterpret_cast<uint8_t const*>(Data);
+    for (size_t i = 0; i < Size; ++i) {
+      Hash ^= Bytes[i];
+      Hash *= 0x100000001b3ULL;
+    }
+  };
+
+  Mix(IROp, sizeof(IROp_Header));
+
+  const uint8_t NumArgs = GetArgs(IROp->Op);
+  for (uint8_t i = 0; i < NumArgs; ++i) {
+    uint32_t Number = GetNumber(IROp->Args[i].ID());
+    Mix(&Number, sizeof(Number));
+  }
+
+  const size_t DataBegin = sizeof(IROp_Header) + NumArgs * sizeof(OrderedNodeWrapper);
+  Mix(reinterpret_cast<uint8_t const*>(IROp) + DataBegin, GetSize(IROp->Op) - DataBegin);
+
+  return Hash;
+}
+
+bool ValueNumbering::IsEqual(IROp_Header const *LHS, IROp_Header const *RHS) const {
+  if (memcmp(LHS, RHS, sizeof(IROp_Header)) != 0) {
+    return false;
+  }
+
+  const uint8_t NumArgs = GetArgs(LHS->Op);
+  for (uint8_t i = 0; i < NumArgs; ++i) {
+    if (GetNumber(LHS->Args[i].ID()) != GetNumber(RHS->Args[i].ID())) {
+      return false;
+    }
+  }
+
+  const size_t DataBegin = sizeof(IROp_Header) + NumArgs * sizeof(OrderedNodeWrapper);
+  return memcmp(reinterpret_cast<uint8_t const*>(LHS) + DataBegin,
+                reinterpret_cast<uint8_t const*>(RHS) + DataBegin,
+                GetSize(LHS->Op) - DataBegin) == 0;
+}
+
+void ValueNumbering::BuildDominatorTree(IRListView const &CurrentIR) {
+  std::unordered_map<uint32_t, uint32_t> BlockIndex;
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    BlockIndex[CurrentIR.GetID(BlockNode).Value] = Blocks.size();
+    Blocks.push_back({BlockNode});
+  }
+
+  for (auto &Block : Blocks) {
+    const uint32_t Index = &Block - &Blocks[0];
+    auto AddEdge = [&](OrderedNodeWrapper Target) {
+      const uint32_t TargetIndex = BlockIndex.at(Target.ID().Value);
+      Block.Successors.push_back(TargetIndex);
+      Blocks[TargetIndex].Predecessors.push_back(Index);
+    };
+
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(Block.Node)) {
+      if (IROp->Op == OP_JUMP) {
+        AddEdge(IROp->C<IROp_Jump>()->TargetBlock);
+      }
+      else if (IROp->Op == OP_CONDJUMP) {
+        auto Op = IROp->C<IROp_CondJump>();
+        AddEdge(Op->TrueBlock);
+        AddEdge(Op->FalseBlock);
+      }
+      else if (IROp->Op == OP_SETROUNDINGMODE) {
+        HasRoundingModeChange = true;
+      }
+    }
+  }
+
+  // Reverse post order from the entry block
+  std::vector<uint32_t> PostOrder;
+  {
+    std::vector<std::pair<uint32_t, size_t>> Stack;
+    std::vector<bool> Visited(Blocks.size());
+    Stack.emplace_back(0, 0);
+    Visited[0] = true;
+    while (!Stack.empty()) {
+      auto &[Index, NextSuccessor] = Stack.back();
+      if (NextSuccessor < Blocks[Index].Successors.size()) {
+        const uint32_t Successor = Blocks[Index].Successors[NextSuccessor++];
+        if (!Visited[Successor]) {
+          Visited[Successor] = true;
+          Stack.emplace_back(Successor, 0);
+        }
+      }
+      else {
+        PostOrder.push_back(Index);
+        Stack.pop_back();
+      }
+    }
+  }
+
+  std::vector<uint32_t> RPO(PostOrder.rbegin(), PostOrder.rend());
+  for (size_t i = 0; i < RPO.size(); ++i) {
+    Blocks[RPO[i]].RPONumber = i;
+  }
+
+  // Cooper, Harvey and Kennedy's iterative dominator algorithm
+  auto Intersect = [this](uint32_t A, uint32_t B) {
+    while (A != B) {
+      while (Blocks[A].RPONumber > Blocks[B].RPONumber) {
+        A = Blocks[A].IDom;
+      }
+      while (Blocks[B].RPONumber > Blocks[A].RPONumber) {
+        B = Blocks[B].IDom;
+      }
+    }
+    return A;
+  };
+
+  Blocks[0].IDom = 0;
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (size_t i = 1; i < RPO.size(); ++i) {
+      auto &Block = Blocks[RPO[i]];
+      uint32_t NewIDom = ~0U;
+      for (auto Pred : Block.Predecessors) {
+        if (Blocks[Pred].IDom == ~0U) {
+          // Not processed yet, or unreachable
+          continue;
+        }
+        NewIDom = NewIDom == ~0U ? Pred : Intersect(Pred, NewIDom);
+      }
+
+      if (Block.IDom != NewIDom) {
+        Block.IDom = NewIDom;
+        Changed = true;
+      }
+    }
+  }
+
+  for (size_t i = 1; i < RPO.size(); ++i) {
+    Blocks[Blocks[RPO[i]].IDom].DominatorChildren.push_back(RPO[i]);
+  }
+}
+
+bool ValueNumbering::Run(IREmitter *IREmit) {
+  auto CurrentIR = IREmit->ViewIR();
+
+  Blocks.clear();
+  ValueNumbers.clear();
+  HasRoundingModeChange = false;
+
+  BuildDominatorTree(CurrentIR);
+
+  // Scoped table of available values, the most recent leader for a hash is at the back
+  std::unordered_map<uint64_t, std::vector<Leader>> Available;
+  std::vector<uint64_t> ScopeLog;
+  std::vector<std::pair<OrderedNode*, OrderedNode*>> Replacements;
+
+  // Walk the dominator tree so every available value dominates the ops checked against it
+  struct Visit {
+    uint32_t Block;
+    size_t ScopeBegin;
+    size_t NextChild;
+  };
+  std::vector<Visit> Stack;
+  Stack.push_back({0, 0, 0});
+
+  bool Entered = false;
+  while (!Stack.empty()) {
+    auto &Current = Stack.back();
+
+    if (!Entered) {
+      Current.ScopeBegin = ScopeLog.size();
+      const uint32_t BlockIndex = Current.Block;
+
+      for (auto [CodeNode, IROp] : CurrentIR.GetCode(Blocks[BlockIndex].Node)) {
+        if (!CanNumber(IROp)) {
+          continue;
+        }
+
+        const auto ID = CurrentIR.GetID(CodeNode);
+        const uint64_t Hash = HashOp(IROp);
+        auto &Leaders = Available[Hash];
+
+        Leader const *Match = nullptr;
+        for (auto it = Leaders.rbegin(); it != Leaders.rend(); ++it) {
+          if (IsEqual(CurrentIR.GetOp<IROp_Header>(it->Node), IROp)) {
+            Match = &*it;
+            break;
+          }
+        }
+
+        if (Match) {
+          // Either way this op computes the same value as the leader
+          ValueNumbers[ID.Value] = GetNumber(CurrentIR.GetID(Match->Node));
+
+          // Reused values become global live ranges, the RA spills those per block if it runs out of registers
+          if (Match->Block == BlockIndex || !IsRematerializable(IROp->Op)) {
+            Replacements.emplace_back(CodeNode, Match->Node);
+            continue;
+          }
+        }
+
+        // This op is the closest available value for the rest of this dominator subtree
+        Leaders.push_back({CodeNode, BlockIndex});
+        ScopeLog.push_back(Hash);
+      }
+
+      Entered = true;
+    }
+
+    if (Current.NextChild < Blocks[Current.Block].DominatorChildren.size()) {
+      const uint32_t Child = Blocks[Current.Block].DominatorChildren[Current.NextChild++];
+      Stack.push_back({Child, 0, 0});
+      Entered = false;
+      continue;
+    }
+
+    // Leaving the subtree, values defined in this block no longer dominate
+    while (ScopeLog.size() > Current.ScopeBegin) {
+      Available[ScopeLog.back()].pop_back();
+      ScopeLog.pop_back();
+    }
+    Stack.pop_back();
+  }
+
+  for (auto [Node, Leader] : Replacements) {
+    IREmit->ReplaceAllUsesWithRange(Node, Leader, CurrentIR.GetAllCode().begin(), CurrentIR.GetAllCode().end());
+    IREmit->Remove(Node);
+  }
+
+  return !Replacements.empty();
+}
+
+std::unique_ptr<FEXCore::IR::Pass> CreateValueNumbering() {
+  return std::make_unique<ValueNumbering>();
+}
+
+}
@@ -0,0 +1,275 @@
+/*
+$info$
+tags: ir|opts
+desc: Fuses the vector IR chains that common SSE idioms translate to in to single vector ops
+$end_info$
+*/
+
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+
+#include <array>
+#include <memory>
+#include <stdint.h>
+
+namespace FEXCore::IR {
+
+class VectorOpFusion final : public FEXCore::IR::Pass {
+public:
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  OrderedNode *FoldSameSources(IREmitter *IREmit, IROp_Header const *IROp);
+  OrderedNode *FoldZeroExtendingZip(IREmitter *IREmit, IROp_Header const *IROp);
+  OrderedNode *FoldInsertChain(IREmitter *IREmit, IROp_Header const *IROp);
+  OrderedNode *FoldAbsoluteDifference(IREmitter *IREmit, IROp_Header const *IROp);
+
+  bool IsZeroVector(IREmitter *IREmit, OrderedNodeWrapper Arg) const;
+};
+
+bool VectorOpFusion::IsZeroVector(IREmitter *IREmit, OrderedNodeWrapper Arg) const {
+  auto IROp = IREmit->GetOpHeader(Arg);
+
+  switch (IROp->Op) {
+    case OP_VECTORZERO:
+      return true;
+    case OP_VECTORIMM:
+      return IROp->C<IROp_VectorImm>()->Immediate == 0;
+    // pxor reg, reg ahead of the fusion running over it
+    case OP_VXOR:
+    case OP_VSUB:
+      return IROp->Args[0] == IROp->Args[1];
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Integer ops where both sources are the same register
+ *
+ * `pxor xmm0, xmm0`, `psubb xmm0, xmm0` and `pcmpeqd xmm0, xmm0` are how x86 code materializes all zeroes and all ones.
+ * Without this they depend on the previous value of the register and cost a real op.
+ */
+OrderedNode *VectorOpFusion::FoldSameSources(IREmitter *IREmit, IROp_Header const *IROp) {
+  if (IROp->Args[0] != IROp->Args[1]) {
+    return nullptr;
+  }
+
+  switch (IROp->Op) {
+    case OP_VXOR:
+    case OP_VSUB:
+    case OP_VUQSUB:
+    case OP_VSQSUB:
+    case OP_VBIC:
+    case OP_VCMPGT:
+      return IREmit->_VectorZero(IROp->Size);
+    case OP_VCMPEQ:
+      return IREmit->_VectorImm(IROp->Size, 1, 0xFF);
+    case OP_VAND:
+    case OP_VOR:
+    case OP_VUMIN:
+    case OP_VUMAX:
+    case OP_VSMIN:
+    case OP_VSMAX:
+      // A narrower op would also clear the upper bits of its source
+      if (IREmit->GetOpHeader(IROp->Args[0])->Size != IROp->Size) {
+        return nullptr;
+      }
+      return IREmit->UnwrapNode(IROp->Args[0]);
+    default:
+      return nullptr;
+  }
+}
+
+/**
+ * @brief punpckl/punpckh against a zero register is a zero extend of the low or high half
+ *
+ * MMX sized unpacks are left alone, the extends write a full 128-bit register.
+ */
+OrderedNode *VectorOpFusion::FoldZeroExtendingZip(IREmitter *IREmit, IROp_Header const *IROp) {
+  if (IROp->Size != 16 || IROp->ElementSize == 8 || !IsZeroVector(IREmit, IROp->Args[1])) {
+    return nullptr;
+  }
+
+  auto Source = IREmit->UnwrapNode(IROp->Args[0]);
+  if (IROp->Op == OP_VZIP) {
+    return IREmit->_VUXTL(IROp->Size, IROp->ElementSize, Source);
+  }
+  else {
+    return IREmit->_VUXTL2(IROp->Size, IROp->ElementSize, Source);
+  }
+}
+
+/**
+ * @brief Looks at the chain of element inserts a shuffle like pshufd translates to
+ *
+ * - An insert of an element in to a vector that already holds that same element does nothing
+ * - Inserts that cover every element with the same source element are a broadcast
+ */
+OrderedNode *VectorOpFusion::FoldInsertChain(IREmitter *IREmit, IROp_Header const *IROp) {
+  auto Op = IROp->C<IROp_VInsElement>();
+
+  auto IsSameShape = [IROp](IROp_Header const *Other) {
+    return Other->Op == OP_VINSELEMENT &&
+      Other->Size == IROp->Size &&
+      Other->ElementSize == IROp->ElementSize;
+  };
+
+  // Find what the destination vector holds in the element being written
+  if (Op->DestIdx == Op->SrcIdx) {
+    auto Base = Op->DestVector;
+    auto BaseOp = IREmit->GetOpHeader(Base);
+    while (IsSameShape(BaseOp) && BaseOp->C<IROp_VInsElement>()->DestIdx != Op->DestIdx) {
+      Base = BaseOp->C<IROp_VInsElement>()->DestVector;
+      BaseOp = IREmit->GetOpHeader(Base);
+    }
+
+    const bool AlreadyHeld = Base == Op->SrcVector ||
+      (IsSameShape(BaseOp) &&
+       BaseOp->C<IROp_VInsElement>()->SrcVector == Op->SrcVector &&
+       BaseOp->C<IROp_VInsElement>()->SrcIdx == Op->SrcIdx);
+
+    if (AlreadyHeld) {
+      return IREmit->UnwrapNode(Op->DestVector);
+    }
+  }
+
+  // Walk back from the last insert, the most recent write of each element is the one that counts
+  // Broadcasts always write a full register, MMX sized shuffles are left alone
+  if (IROp->Size != 16) {
+    return nullptr;
+  }
+
+  const uint8_t NumElements = IROp->Size / IROp->ElementSize;
+  std::array<bool, 16> Written{};
+  uint8_t NumWritten{};
+
+  auto Current = IROp;
+  while (NumWritten != NumElements) {
+    auto CurrentOp = Current->C<IROp_VInsElement>();
+    if (CurrentOp->SrcVector != Op->SrcVector || CurrentOp->SrcIdx != Op->SrcIdx) {
+      if (!Written[CurrentOp->DestIdx]) {
+        // An element that survives to the end comes from somewhere else
+        return nullptr;
+      }
+    }
+    else if (!Written[CurrentOp->DestIdx]) {
+      Written[CurrentOp->DestIdx] = true;
+      ++NumWritten;
+    }
+
+    if (NumWritten == NumElements) {
+      break;
+    }
+
+    Current = IREmit->GetOpHeader(CurrentOp->DestVector);
+    if (!IsSameShape(Current)) {
+      return nullptr;
+    }
+  }
+
+  return IREmit->_VDupElement(IROp->Size, IROp->ElementSize, IREmit->UnwrapNode(Op->SrcVector), Op->SrcIdx);
+}
+
+/**
+ * @brief abs(zext(a) - zext(b)) is an unsigned absolute difference long
+ *
+ * This is the inner part of psadbw and of sum of absolute difference loops written with unpacks.
+ * Zero extended sources can't overflow the wider signed subtract, so the results match.
+ */
+OrderedNode *VectorOpFusion::FoldAbsoluteDifference(IREmitter *IREmit, IROp_Header const *IROp) {
+  // Only halfword and word results are lowered by every backend
+  if (IROp->Size != 16 || (IROp->ElementSize != 2 && IROp->ElementSize != 4)) {
+    return nullptr;
+  }
+
+  auto SubOp = IREmit->GetOpHeader(IROp->Args[0]);
+  if (SubOp->Op != OP_VSUB || SubOp->Size != IROp->Size || SubOp->ElementSize != IROp->ElementSize) {
+    return nullptr;
+  }
+
+  auto IsLowExtend = [IROp](IROp_Header const *ExtendOp) {
+    return ExtendOp->Op == OP_VUXTL && ExtendOp->Size == IROp->Size && ExtendOp->ElementSize == IROp->ElementSize;
+  };
+
+  auto Src1 = IREmit->GetOpHeader(SubOp->Args[0]);
+  auto Src2 = IREmit->GetOpHeader(SubOp->Args[1]);
+  if (!IsLowExtend(Src1) || !IsLowExtend(Src2)) {
+    return nullptr;
+  }
+
+  return IREmit->_VUABDL(IROp->Size, IROp->ElementSize >> 1,
+    IREmit->UnwrapNode(Src1->Args[0]), IREmit->UnwrapNode(Src2->Args[0]));
+}
+
+/**
+ * @brief Peephole fusion of vector IR
+ *
+ * The OpcodeDispatcher translates every SSE instruction on its own, so idioms that span instructions, or that use one
+ * instruction for something simpler, turn in to longer IR than the host needs:
+ * - Zeroing and all ones idioms become VectorZero and VectorImm
+ * - punpck against zero becomes VUXTL/VUXTL2
+ * - pshufd broadcasts become VDupElement, identity elements of a shuffle are dropped
+ * - The extend, subtract and absolute of psadbw becomes VUABDL
+ *
+ * Fused ops are emitted after the op they replace, the old chains are left for DCE.
+ */
+bool VectorOpFusion::Run(IREmitter *IREmit) {
+  bool Changed = false;
+  auto CurrentIR = IREmit->ViewIR();
+  auto OriginalWriteCursor = IREmit->GetWriteCursor();
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+      IREmit->SetWriteCursor(CodeNode);
+
+      OrderedNode *Replacement{};
+      switch (IROp->Op) {
+        case OP_VXOR:
+        case OP_VSUB:
+        case OP_VUQSUB:
+        case OP_VSQSUB:
+        case OP_VBIC:
+        case OP_VCMPGT:
+        case OP_VCMPEQ:
+        case OP_VAND:
+        case OP_VOR:
+        case OP_VUMIN:
+        case OP_VUMAX:
+        case OP_VSMIN:
+        case OP_VSMAX:
+          Replacement = FoldSameSources(IREmit, IROp);
+          break;
+        case OP_VZIP:
+        case OP_VZIP2:
+          Replacement = FoldZeroExtendingZip(IREmit, IROp);
+          break;
+        case OP_VINSELEMENT:
+          Replacement = FoldInsertChain(IREmit, IROp);
+          break;
+        case OP_VABS:
+          Replacement = FoldAbsoluteDifference(IREmit, IROp);
+          break;
+        default:
+          break;
+      }
+
+      if (Replacement) {
+        IREmit->ReplaceAllUsesWith(CodeNode, Replacement);
+        Changed = true;
+      }
+    }
+  }
+
+  IREmit->SetWriteCursor(OriginalWriteCursor);
+  return Changed;
+}
+
+std::unique_ptr<FEXCore::IR::Pass> CreateVectorOpFusion() {
+  return std::make_unique<VectorOpFusion>();
+}
+
+}
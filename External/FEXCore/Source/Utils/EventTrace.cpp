@@ -0,0 +1,226 @@
+/*
+$info$
+tags: glue|event-trace
+desc: Per-thread binary rings of syscalls, compiles, SMC invalidations and signals
+$end_info$
+*/
+
+#include <FEXCore/Utils/Allocator.h>
+#include <FEXCore/Utils/EventTrace.h>
+#include <FEXHeaderUtils/Syscalls.h>
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <sys/mman.h>
+#include <time.h>
+#include <vector>
+
+namespace FEXCore::EventTrace {
+  namespace Internal {
+    std::atomic_bool Enabled{false};
+  }
+
+  namespace {
+    constexpr size_t RING_SIZE = 1024;
+    constexpr size_t FLUSH_SIZE = RING_SIZE / 2;
+
+    struct ThreadRing {
+      uint32_t TID;
+      // Total number of slots reserved and handed to the flush handler, the ring index is these modulo RING_SIZE
+      std::atomic<uint64_t> Head;
+      std::atomic<uint64_t> Flushed;
+      // Held by whoever flushes, the owning thread or Shutdown
+      std::atomic_bool FlushLock;
+      // Slot number + 1 once the slot's record is fully written.
+      // A signal can interrupt a write after its slot got reserved, flushing stops at the first slot that isn't done.
+      std::atomic<uint64_t> Committed[RING_SIZE];
+      Record Records[RING_SIZE];
+    };
+
+    std::atomic<FlushHandlerType> FlushHandler{};
+
+    // Guards Rings, only taken when a thread registers or leaves and on shutdown
+    std::mutex RingsMutex;
+    std::vector<ThreadRing*> Rings;
+
+    // Hands every committed record to the flush handler, the caller holds FlushLock
+    void FlushCommitted(ThreadRing *Ring) {
+      auto Handler = FlushHandler.load(std::memory_order_acquire);
+      const uint64_t Head = Ring->Head.load(std::memory_order_acquire);
+      uint64_t Flushed = Ring->Flushed.load(std::memory_order_relaxed);
+
+      while (Flushed < Head) {
+        const size_t Index = Flushed % RING_SIZE;
+        const size_t MaxCount = std::min<uint64_t>(Head - Flushed, RING_SIZE - Index);
+
+        size_t Count{};
+        while (Count < MaxCount &&
+               Ring->Committed[Index + Count].load(std::memory_order_acquire) == Flushed + Count + 1) {
+          ++Count;
+        }
+
+        if (Count == 0) {
+          break;
+        }
+
+        if (Handler) {
+          Handler(&Ring->Records[Index], Count * sizeof(Record));
+        }
+        Flushed += Count;
+        // Frees the slots up for writers
+        Ring->Flushed.store(Flushed, std::memory_order_release);
+      }
+    }
+
+    bool TryFlush(ThreadRing *Ring) {
+      if (Ring->FlushLock.exchange(true, std::memory_order_acquire)) {
+        return false;
+      }
+
+      FlushCommitted(Ring);
+      Ring->FlushLock.store(false, std::memory_order_release);
+      return true;
+    }
+
+    void Flush(ThreadRing *Ring) {
+      // Anyone else holding the lock is another thread in the middle of a single flush
+      while (!TryFlush(Ring));
+    }
+
+    // Rings are mmapped, so they can be allocated while the thread's malloc arena is in an unknown state
+    ThreadRing *AllocateRing() {
+      void *Ptr = FEXCore::Allocator::mmap(nullptr, sizeof(ThreadRing), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (Ptr == MAP_FAILED) {
+        return nullptr;
+      }
+
+      auto Ring = new (Ptr) ThreadRing{};
+      Ring->TID = FHU::Syscalls::gettid();
+
+      std::lock_guard lk(RingsMutex);
+      Rings.emplace_back(Ring);
+      return Ring;
+    }
+
+    void FreeRing(ThreadRing *Ring) {
+      {
+        std::lock_guard lk(RingsMutex);
+        auto It = std::find(Rings.begin(), Rings.end(), Ring);
+        if (It == Rings.end()) {
+          // Shutdown already took care of it
+          return;
+        }
+        Rings.erase(It);
+      }
+
+      Flush(Ring);
+      FEXCore::Allocator::munmap(Ring, sizeof(ThreadRing));
+    }
+
+    struct ThreadData {
+      // Written once before the thread can record anything from a signal handler
+      std::atomic<ThreadRing*> Ring{};
+
+      ~ThreadData() {
+        if (auto Ring = this->Ring.exchange(nullptr)) {
+          FreeRing(Ring);
+        }
+      }
+    };
+
+    thread_local ThreadData LocalData{};
+
+    // Only touches the ring with atomics, so this is fine in any context
+    bool TryRecord(ThreadRing *Ring, Record const &Event) {
+      // Reserve a slot, unless that would overwrite records that haven't been flushed yet
+      uint64_t Slot = Ring->Head.load(std::memory_order_relaxed);
+      do {
+        if (Slot - Ring->Flushed.load(std::memory_order_acquire) >= RING_SIZE) {
+          return false;
+        }
+      } while (!Ring->Head.compare_exchange_weak(Slot, Slot + 1, std::memory_order_relaxed));
+
+      auto &Entry = Ring->Records[Slot % RING_SIZE];
+      Entry = Event;
+      Entry.TID = Ring->TID;
+      Ring->Committed[Slot % RING_SIZE].store(Slot + 1, std::memory_order_release);
+      return true;
+    }
+  }
+
+  void Enable(FlushHandlerType Handler) {
+    FlushHandler.store(Handler, std::memory_order_release);
+    Internal::Enabled.store(true, std::memory_order_release);
+  }
+
+  void Shutdown() {
+    Internal::Enabled.store(false, std::memory_order_release);
+
+    std::lock_guard lk(RingsMutex);
+    for (auto Ring : Rings) {
+      // Other threads might still be recording, only what they finished writing goes out
+      Flush(Ring);
+    }
+
+    // Rings stay mapped, threads that are still alive might be in the middle of recording
+    Rings.clear();
+    FlushHandler.store(nullptr, std::memory_order_release);
+  }
+
+  uint64_t Now() {
+    struct timespec Time{};
+    clock_gettime(CLOCK_MONOTONIC, &Time);
+    return Time.tv_sec * 1'000'000'000ULL + Time.tv_nsec;
+  }
+
+  void RegisterThread() {
+    if (!LocalData.Ring.load(std::memory_order_relaxed)) {
+      LocalData.Ring.store(AllocateRing(), std::memory_order_release);
+    }
+  }
+
+  void Add(Record const &Event) {
+    RegisterThread();
+    auto Ring = LocalData.Ring.load(std::memory_order_relaxed);
+    if (!Ring) {
+      return;
+    }
+
+    if (!TryRecord(Ring, Event)) {
+      // Full of records from signal handlers, make room and try again
+      TryFlush(Ring);
+      TryRecord(Ring, Event);
+    }
+
+    if (Ring->Head.load(std::memory_order_relaxed) - Ring->Flushed.load(std::memory_order_relaxed) >= FLUSH_SIZE) {
+      TryFlush(Ring);
+    }
+  }
+
+  void AddFromSignal(Record const &Event) {
+    // Allocating or flushing could deadlock on whatever the interrupted code holds
+    if (auto Ring = LocalData.Ring.load(std::memory_order_acquire)) {
+      TryRecord(Ring, Event);
+    }
+  }
+
+  void LockBeforeFork() {
+    if (auto Ring = LocalData.Ring.load(std::memory_order_relaxed)) {
+      Flush(Ring);
+    }
+    RingsMutex.lock();
+  }
+
+  void UnlockAfterFork(bool Child) {
+    if (Child) {
+      // The other threads don't exist in the child, whatever they hold belongs to the parent
+      Rings.clear();
+      if (auto Ring = LocalData.Ring.load(std::memory_order_relaxed)) {
+        Rings.emplace_back(Ring);
+        Ring->TID = FHU::Syscalls::gettid();
+      }
+    }
+    RingsMutex.unlock();
+  }
+}
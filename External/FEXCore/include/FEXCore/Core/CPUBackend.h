@@ -103,6 +103,14 @@ class LLVMCore;
     }
 
     virtual void ClearCache() {}
+
+    /**
+     * @brief Can this backend be handed to a new guest thread once its thread exits
+     *
+     * Not the case while a guest signal handler frame is still live on the exiting thread
+     */
+    virtual bool CanBeReused() const { return false; }
+
     virtual bool IsAddressInJITCode(uint64_t Address, bool IncludeDispatcher = true) const { return false; }
 
     /**
@@ -117,12 +125,20 @@ class LLVMCore;
      */
     virtual void ClearRelocations() {}
 
+    /**
+     * @brief Sets how many times blocks compiled from now on run before they request a recompile at a higher tier
+     *
+     * Only backends that support tiered compilation use this, 0 compiles blocks that never tier up
+     */
+    void SetTierUpThreshold(uint32_t Threshold) { TierUpThreshold = Threshold; }
+
     using AsmDispatch = FEX_NAKED void(*)(FEXCore::Core::CpuStateFrame *Frame);
     using JITCallback = FEX_NAKED void(*)(FEXCore::Core::CpuStateFrame *Frame, uint64_t RIP);
 
     JITCallback CallbackPtr{};
   protected:
     AsmDispatch DispatchPtr{};
+    uint32_t TierUpThreshold{};
   };
 
 }
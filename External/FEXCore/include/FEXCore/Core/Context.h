@@ -8,6 +8,7 @@
 #include <FEXCore/Utils/CompilerDefs.h>
 
 #include <istream>
+#include <map>
 #include <ostream>
 #include <memory>
 #include <set>
@@ -33,6 +34,7 @@ namespace FEXCore::HLE {
 
 namespace FEXCore::IR {
   struct AOTIRCacheEntry;
+  struct SHA256Sum;
 }
 
 namespace FEXCore::Context {
@@ -243,6 +245,15 @@ namespace FEXCore::Context {
   FEX_DEFAULT_VISIBILITY FEXCore::IR::AOTIRCacheEntry *LoadAOTIRCacheEntry(FEXCore::Context::Context *CTX, const std::string& Name);
   FEX_DEFAULT_VISIBILITY void UnloadAOTIRCacheEntry(FEXCore::Context::Context *CTX, FEXCore::IR::AOTIRCacheEntry *Entry);
 
+  /**
+   * @brief Tells the code object cache that an executable file backed region was mapped
+   *
+   * Code compiled from inside of the region can then be serialized to and loaded from the object cache.
+   * Does nothing if the code object cache is disabled.
+   */
+  FEX_DEFAULT_VISIBILITY void AddNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Size, uintptr_t Offset, const std::string &Filename);
+  FEX_DEFAULT_VISIBILITY void RemoveNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Size);
+
   FEX_DEFAULT_VISIBILITY void SetAOTIRLoader(FEXCore::Context::Context *CTX, std::function<int(const std::string&)> CacheReader);
   FEX_DEFAULT_VISIBILITY void SetAOTIRWriter(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::ofstream>(const std::string&)> CacheWriter);
   FEX_DEFAULT_VISIBILITY void SetAOTIRRenamer(FEXCore::Context::Context *CTX, std::function<void(const std::string&)> CacheRenamer);
@@ -251,5 +262,20 @@ namespace FEXCore::Context {
   FEX_DEFAULT_VISIBILITY void WriteFilesWithCode(FEXCore::Context::Context *CTX, std::function<void(const std::string& fileid, const std::string& filename)> Writer);
   FEX_DEFAULT_VISIBILITY void InvalidateGuestCodeRange(FEXCore::Context::Context *CTX, uint64_t Start, uint64_t Length);
 
-  FEX_DEFAULT_VISIBILITY void ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress);
+  /**
+   * @brief Registers a host function that guest code reaches through the thunk instruction
+   *
+   * The function gets the guest's RDI, which points to the packed arguments and return value.
+   * Must be called after InitCore.
+   */
+  FEX_DEFAULT_VISIBILITY void RegisterHostThunk(FEXCore::Context::Context *CTX, FEXCore::IR::SHA256Sum const &Sum, void (*Function)(void *ArgsRV));
+
+  /**
+   * @brief Sets up a thread for compiling ahead of time
+   *
+   * @param ExternalBranches Collects branch targets that leave the compiled regions
+   * @param SectionMaxAddress End of the executable section being compiled
+   * @param FunctionRanges Optional function start to end map from the ELF symbols, each function compiles as one region
+   */
+  FEX_DEFAULT_VISIBILITY void ConfigureAOTGen(FEXCore::Core::InternalThreadState *Thread, std::set<uint64_t> *ExternalBranches, uint64_t SectionMaxAddress, std::map<uint64_t, uint64_t> const *FunctionRanges = nullptr);
 }
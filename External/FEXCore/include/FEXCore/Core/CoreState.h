@@ -3,6 +3,7 @@
 #include <FEXCore/HLE/Linux/ThreadManagement.h>
 #include <FEXCore/Utils/CompilerDefs.h>
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <stdint.h>
@@ -123,6 +124,8 @@ namespace FEXCore::Core {
       uint64_t OverflowExceptionHandler{};
       uint64_t SignalReturnHandler{};
       uint64_t L1Pointer{};
+      uint64_t IndirectBranchLinker{};
+      uint64_t TierUpLinker{};
       uint64_t LUDIVHandler{};
       uint64_t LDIVHandler{};
       uint64_t LUREMHandler{};
@@ -156,10 +159,21 @@ namespace FEXCore::Core {
       uint64_t OverflowExceptionHandler{};
       uint64_t SignalReturnHandler{};
       uint64_t L1Pointer{};
+      uint64_t IndirectBranchLinker{};
+      uint64_t TierUpLinker{};
       /**  @} */
     } X86;
   };
 
+  struct ReturnStackEntry {
+    uint64_t GuestRIP;
+    // Linkable exit to GuestRIP inside of the calling block, zero when the entry is empty
+    uint64_t HostCode;
+  };
+
+  // Needs to be a power of two, the JITs mask the index with this
+  constexpr size_t RETURN_STACK_SIZE = 16;
+
   // Each guest JIT frame has one of these
   struct CpuStateFrame {
     CPUState State;
@@ -183,12 +197,24 @@ namespace FEXCore::Core {
 
     // Pointers that the JIT needs to load to remove relocations
     JITPointers Pointers;
+
+    /**
+     * @brief Shadow stack of guest return addresses, pushed by CALL and popped by RET
+     *
+     * This is only a prediction. RET verifies the guest RIP before using an entry and does a normal lookup otherwise.
+     * The JIT resets it whenever host code that entries could point to goes away.
+     */
+    std::array<ReturnStackEntry, RETURN_STACK_SIZE> ReturnStack{};
+    uint64_t ReturnStackIndex{};
   };
   static_assert(offsetof(CpuStateFrame, State) == 0, "CPUState must be first member in CpuStateFrame");
   static_assert(offsetof(CpuStateFrame, State.rip) == 0, "rip must be zero offset in CpuStateFrame");
   static_assert(offsetof(CpuStateFrame, Pointers) % 8 == 0, "JITPointers need to be aligned to 8 bytes");
   static_assert(offsetof(CpuStateFrame, Pointers) + sizeof(CpuStateFrame::Pointers) <= 32760, "JITPointers maximum pointer needs to be less than architecture maximum 32768");
 
+  static_assert(offsetof(CpuStateFrame, ReturnStack) < 4096, "ReturnStack needs to be reachable with an add immediate");
+  static_assert((RETURN_STACK_SIZE & (RETURN_STACK_SIZE - 1)) == 0, "RETURN_STACK_SIZE needs to be a power of two");
+
   static_assert(std::is_standard_layout<CpuStateFrame>::value, "This needs to be standard layout");
 
   FEX_DEFAULT_VISIBILITY std::string_view const& GetFlagName(unsigned Flag);
@@ -8,6 +8,7 @@
 #include <FEXCore/Utils/InterruptableConditionVariable.h>
 #include <FEXCore/Utils/Threads.h>
 
+#include <set>
 #include <unordered_map>
 #include <shared_mutex>
 
@@ -104,6 +105,8 @@ namespace FEXCore::Core {
     int StatusCode{};
     FEXCore::Context::ExitReason ExitReason {FEXCore::Context::ExitReason::EXIT_WAITING};
     std::shared_ptr<FEXCore::CompileService> CompileService;
+    // Direct branch targets leaving the last decoded block, handed to the CompileService
+    std::set<uint64_t> CompileAheadTargets;
 
     std::shared_mutex ObjectCacheRefCounter{};
     bool DestroyedByParent{false};  // Should the parent destroy this thread, or it destory itself
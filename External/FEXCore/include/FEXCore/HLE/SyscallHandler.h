@@ -38,6 +38,10 @@ namespace FEXCore::HLE {
     bool HasReturn;
 
     int32_t HostSyscallNumber;
+
+    // If set, the JIT may call this directly as `uint64_t(CpuStateFrame*, uint64_t...)` with NumArgs arguments
+    // instead of going through HandleSyscall
+    void *DirectHandler{};
   };
 
   enum class SyscallOSABI {
@@ -239,6 +239,12 @@ friend class FEXCore::IR::PassManager;
 
   void Remove(OrderedNode *Node);
 
+  // Moves the node in front of Before, which can be in a different block
+  void MoveBefore(OrderedNode *Node, OrderedNode *Before) {
+    Node->Unlink(DualListData.ListBegin());
+    Before->prepend(DualListData.ListBegin(), Node);
+  }
+
   void SetPackedRFLAG(bool Lower8, OrderedNode *Src);
   OrderedNode *GetPackedRFLAG(bool Lower8);
 
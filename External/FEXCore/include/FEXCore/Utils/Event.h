@@ -61,6 +61,13 @@ public:
     return DidSignal;
   }
 
+  /**
+   * @brief Drops a signal that nobody waited on
+   */
+  void Reset() {
+    FlagObject.TestAndClear();
+  }
+
 private:
   Flag FlagObject;
   std::mutex MutexObject;
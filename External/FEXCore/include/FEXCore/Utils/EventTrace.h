@@ -0,0 +1,112 @@
+#pragma once
+
+#include <FEXCore/Utils/CompilerDefs.h>
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace FEXCore::EventTrace {
+  // "FEXTRACE"
+  constexpr uint64_t FILE_MAGIC = 0x4543'4152'5458'4546ULL;
+  constexpr uint32_t FILE_VERSION = 1;
+
+  enum class EventType : uint16_t {
+    // Number = syscall number, Args = arguments, Result = return value
+    SYSCALL,
+    // Args[0] = guest RIP, Args[1] = host code, Args[2] = guest code start, Args[3] = guest code length
+    BLOCK_COMPILE,
+    // Args[0] = start, Args[1] = length
+    SMC_INVALIDATE,
+    // Number = signal, Args[0] = si_code, Args[1] = guest handler, Args[2] = guest sa_flags
+    SIGNAL,
+  };
+
+  /**
+   * @brief Written once at the start of a trace, records follow until the end of the stream
+   */
+  struct FileHeader {
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t RecordSize;
+    uint32_t PID;
+    uint32_t Is64Bit;
+  };
+  static_assert(sizeof(FileHeader) == 24, "Trace files are shared between builds");
+
+  struct Record {
+    // CLOCK_MONOTONIC at the start of the event, in nanoseconds
+    uint64_t Timestamp;
+    // Nanoseconds the event took, zero for events that don't take time
+    uint32_t Duration;
+    uint32_t TID;
+    EventType Type;
+    uint16_t Pad;
+    uint32_t Number;
+    uint64_t Result;
+    uint64_t Args[6];
+  };
+  static_assert(sizeof(Record) == 80, "Trace files are shared between builds");
+
+  /**
+   * @brief Receives full chunks of records
+   *
+   * Called from the thread that filled the chunk, possibly from many threads at once.
+   */
+  using FlushHandlerType = void(*)(void const *Data, size_t Size);
+
+  namespace Internal {
+    FEX_DEFAULT_VISIBILITY extern std::atomic_bool Enabled;
+  }
+
+  /**
+   * @brief Checked before recording anything, this is the whole cost of tracing when it is disabled
+   */
+  static inline bool IsEnabled() {
+    return Internal::Enabled.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Starts recording, Handler receives the records
+   *
+   * Anything that decides at compile time whether to skip the recording paths needs this to happen first.
+   */
+  FEX_DEFAULT_VISIBILITY void Enable(FlushHandlerType Handler);
+
+  /**
+   * @brief Stops recording and hands what every thread still holds to the flush handler
+   */
+  FEX_DEFAULT_VISIBILITY void Shutdown();
+
+  FEX_DEFAULT_VISIBILITY uint64_t Now();
+
+  /**
+   * @brief Gives the calling thread its ring up front so AddFromSignal has somewhere to record to
+   */
+  FEX_DEFAULT_VISIBILITY void RegisterThread();
+
+  /**
+   * @brief Adds a record to the calling thread's ring, TID is filled in
+   *
+   * Allocates the ring on first use and flushes it once half of it is full, so this must not be called from signal handlers.
+   */
+  FEX_DEFAULT_VISIBILITY void Add(Record const &Event);
+
+  /**
+   * @brief Adds a record from code that might run in a signal handler
+   *
+   * Never allocates or flushes, the record is dropped if the thread has no ring or it is full.
+   * The next Add on the thread flushes it.
+   */
+  FEX_DEFAULT_VISIBILITY void AddFromSignal(Record const &Event);
+
+  /**
+   * @brief Flushes the calling thread and blocks other threads from registering a ring
+   */
+  FEX_DEFAULT_VISIBILITY void LockBeforeFork();
+
+  /**
+   * @brief Releases LockBeforeFork, the child also drops the rings of the threads it didn't inherit
+   */
+  FEX_DEFAULT_VISIBILITY void UnlockAfterFork(bool Child);
+}
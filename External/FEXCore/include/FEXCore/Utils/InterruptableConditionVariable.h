@@ -63,6 +63,11 @@ namespace FEXCore {
         DoNotify(INT_MAX);
       }
 
+      // Drops a signal that nobody waited on, there must not be any waiters
+      void Reset() {
+        Mutex.store(UNSIGNALED);
+      }
+
     private:
       std::atomic<uint32_t> Mutex{};
       constexpr static uint32_t SIGNALED = 1;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief constexpr SHA-256 so thunk IDs can be derived from their names at compile time
+ *
+ * Only meant for short messages, it isn't fast.
+ */
+namespace FEX::SHA256 {
+  using Digest = std::array<uint8_t, 32>;
+
+  namespace Detail {
+    constexpr std::array<uint32_t, 64> RoundConstants = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    constexpr void Compress(std::array<uint32_t, 8> &State, std::array<uint8_t, 64> const &Block) {
+      std::array<uint32_t, 64> W{};
+      for (size_t i = 0; i < 16; ++i) {
+        W[i] = (uint32_t{Block[i * 4]} << 24) | (uint32_t{Block[i * 4 + 1]} << 16) |
+               (uint32_t{Block[i * 4 + 2]} << 8) | uint32_t{Block[i * 4 + 3]};
+      }
+
+      for (size_t i = 16; i < 64; ++i) {
+        const uint32_t S0 = std::rotr(W[i - 15], 7) ^ std::rotr(W[i - 15], 18) ^ (W[i - 15] >> 3);
+        const uint32_t S1 = std::rotr(W[i - 2], 17) ^ std::rotr(W[i - 2], 19) ^ (W[i - 2] >> 10);
+        W[i] = W[i - 16] + S0 + W[i - 7] + S1;
+      }
+
+      auto [a, b, c, d, e, f, g, h] = State;
+      for (size_t i = 0; i < 64; ++i) {
+        const uint32_t S1 = std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25);
+        const uint32_t Choose = (e & f) ^ (~e & g);
+        const uint32_t Temp1 = h + S1 + Choose + RoundConstants[i] + W[i];
+        const uint32_t S0 = std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22);
+        const uint32_t Majority = (a & b) ^ (a & c) ^ (b & c);
+        const uint32_t Temp2 = S0 + Majority;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + Temp1;
+        d = c;
+        c = b;
+        b = a;
+        a = Temp1 + Temp2;
+      }
+
+      State[0] += a;
+      State[1] += b;
+      State[2] += c;
+      State[3] += d;
+      State[4] += e;
+      State[5] += f;
+      State[6] += g;
+      State[7] += h;
+    }
+  }
+
+  constexpr Digest Hash(std::string_view Message) {
+    std::array<uint32_t, 8> State = {
+      0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    std::array<uint8_t, 64> Block{};
+    size_t Used{};
+    auto Push = [&](uint8_t Byte) {
+      Block[Used++] = Byte;
+      if (Used == Block.size()) {
+        Detail::Compress(State, Block);
+        Used = 0;
+      }
+    };
+
+    for (char c : Message) {
+      Push(static_cast<uint8_t>(c));
+    }
+
+    // Padding, then the message length in bits as big endian
+    const uint64_t BitLength = uint64_t{Message.size()} * 8;
+    Push(0x80);
+    while (Used != 56) {
+      Push(0);
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      Push(static_cast<uint8_t>(BitLength >> ((7 - i) * 8)));
+    }
+
+    Digest Result{};
+    for (size_t i = 0; i < Result.size(); ++i) {
+      Result[i] = static_cast<uint8_t>(State[i / 4] >> ((3 - i % 4) * 8));
+    }
+    return Result;
+  }
+}
@@ -5,6 +5,7 @@
 #include <FEXHeaderUtils/Syscalls.h>
 
 #include <atomic>
+#include <mutex>
 #include <byteswap.h>
 #include <fcntl.h>
 #include <netdb.h>
@@ -14,8 +15,10 @@
 #include <string>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <unordered_map>
 #include <vector>
 
 // For older build environments
@@ -27,6 +30,7 @@ namespace FEX::SocketLogging {
     enum class PacketTypes : uint32_t {
       TYPE_MSG,
       TYPE_ACK,
+      TYPE_TRACE,
     };
 
     struct PacketHeader {
@@ -44,7 +48,15 @@ namespace FEX::SocketLogging {
       char Msg[0];
     };
 
+    struct PacketTrace {
+      PacketHeader Header{};
+      uint32_t Size{};
+      uint32_t Pad{};
+      uint8_t Data[0];
+    };
+
     static_assert(sizeof(PacketHeader) == 24, "Wrong size");
+    static_assert(sizeof(PacketTrace) == 32, "Wrong size");
 
     static PacketHeader FillHeader(Common::PacketTypes Type) {
       struct timespec Time{};
@@ -122,12 +134,57 @@ namespace FEX::SocketLogging {
       Client->AssertHandler(Message);
     }
 
-    bool ConnectToClient(const std::string &Remote) {
+    // Trace data goes over its own connection with plain write(2), nothing here allocates or touches the log stream
+    static int TraceSocket{-1};
+    // Trace data is flushed from any thread, packets must not interleave
+    static std::mutex TraceMutex;
+
+    void TraceHandler(void const *Data, size_t Size) {
+      Common::PacketTrace Trace {
+        .Header = Common::FillHeader(Common::PacketTypes::TYPE_TRACE),
+        .Size = static_cast<uint32_t>(Size),
+      };
+
+      struct iovec Vecs[2] = {
+        { &Trace, sizeof(Trace) },
+        { const_cast<void*>(Data), Size },
+      };
+      struct iovec *Vec = Vecs;
+      size_t VecCount = 2;
+
+      std::lock_guard lk(TraceMutex);
+      while (TraceSocket != -1 && VecCount) {
+        ssize_t Written = writev(TraceSocket, Vec, VecCount);
+        if (Written == -1) {
+          if (errno == EINTR) {
+            continue;
+          }
+          // The server went away, drop the rest of the trace
+          close(TraceSocket);
+          TraceSocket = -1;
+          break;
+        }
+
+        // Skip over whatever made it out, partial writes can end anywhere
+        size_t Remaining = Written;
+        while (VecCount && Remaining >= Vec->iov_len) {
+          Remaining -= Vec->iov_len;
+          ++Vec;
+          --VecCount;
+        }
+        if (VecCount) {
+          Vec->iov_base = reinterpret_cast<uint8_t*>(Vec->iov_base) + Remaining;
+          Vec->iov_len -= Remaining;
+        }
+      }
+    }
+
+    static int OpenSocket(const std::string &Remote) {
       // Time to open up the actual socket and send the FD over to the daemon
       // Create the initial unix socket
       int socket_fd = socket(AF_INET, SOCK_STREAM, 0);
       if (socket_fd == -1) {
-        return false;
+        return -1;
       }
 
       // XXX: Not parsing Remote atm
@@ -144,7 +201,8 @@ namespace FEX::SocketLogging {
 
       if ((Entry = gethostbyname(Host.c_str())) == nullptr) {
         perror("gethostbyname");
-        return false;
+        close(socket_fd);
+        return -1;
       }
 
       struct sockaddr_in addr{};
@@ -154,12 +212,26 @@ namespace FEX::SocketLogging {
 
       if (connect(socket_fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
         close(socket_fd);
+        return -1;
+      }
+
+      return socket_fd;
+    }
+
+    bool ConnectToClient(const std::string &Remote) {
+      int socket_fd = OpenSocket(Remote);
+      if (socket_fd == -1) {
         return false;
       }
 
       Client = std::make_unique<ClientConnector>(socket_fd);
       return true;
     }
+
+    bool ConnectTrace(const std::string &Remote) {
+      TraceSocket = OpenSocket(Remote);
+      return TraceSocket != -1;
+    }
   }
 
   namespace Server {
@@ -230,6 +302,7 @@ namespace FEX::SocketLogging {
                       // Error or hangup, close the socket and erase it from our list
                       Erase = true;
                       close(Event.fd);
+                      PendingData.erase(Event.fd);
                       ClosedHandler(Event.fd);
                     }
                   }
@@ -270,6 +343,8 @@ namespace FEX::SocketLogging {
         std::atomic_bool ShuttingDown{};
         int ListenSocket{-1};
         std::vector<struct pollfd> PollFDs{};
+        // Packets that haven't fully arrived yet, trace packets are larger than a single read
+        std::unordered_map<int, std::vector<uint8_t>> PendingData{};
 
         void OpenListenSocket(std::string_view Socket) {
           struct addrinfo Hints{};
@@ -311,8 +386,9 @@ namespace FEX::SocketLogging {
         }
 
         void HandleSocketData(int Socket) {
-          std::vector<uint8_t> Data(1500);
-          size_t CurrentRead{};
+          auto &Data = PendingData[Socket];
+          size_t CurrentRead = Data.size();
+          Data.resize(CurrentRead + 1500);
           while (true) {
             int Read = read(Socket, &Data.at(CurrentRead), Data.size() - CurrentRead);
             if (Read > 0) {
@@ -336,11 +412,18 @@ namespace FEX::SocketLogging {
             }
           }
 
+          Data.resize(CurrentRead);
+
           size_t CurrentOffset{};
-          while (CurrentOffset < CurrentRead) {
+          while (CurrentRead - CurrentOffset >= sizeof(Common::PacketHeader)) {
+            const size_t Remaining = CurrentRead - CurrentOffset;
             Common::PacketHeader *Header = reinterpret_cast<Common::PacketHeader*>(&Data[CurrentOffset]);
             if (Header->PacketType == Common::PacketTypes::TYPE_MSG) {
               Common::PacketMsg *Msg = reinterpret_cast<Common::PacketMsg*>(&Data[CurrentOffset]);
+              if (Remaining < sizeof(Common::PacketMsg) ||
+                  !memchr(Msg->Msg, 0, Remaining - sizeof(Common::PacketMsg))) {
+                break;
+              }
 
               MsgHandler(Socket, Msg->Header.Timestamp, Msg->Header.PID, Msg->Header.TID, Msg->Level, Msg->Msg);
               CurrentOffset += sizeof(Common::PacketMsg) + strlen(Msg->Msg) + 1;
@@ -351,10 +434,22 @@ namespace FEX::SocketLogging {
               write(Socket, &Ack, sizeof(Ack));
               CurrentOffset += sizeof(Ack);
             }
+            else if (Header->PacketType == Common::PacketTypes::TYPE_TRACE) {
+              Common::PacketTrace *Trace = reinterpret_cast<Common::PacketTrace*>(&Data[CurrentOffset]);
+              if (Remaining < sizeof(Common::PacketTrace) ||
+                  Remaining - sizeof(Common::PacketTrace) < Trace->Size) {
+                break;
+              }
+
+              TraceHandler(Socket, Trace->Header.PID, Trace->Data, Trace->Size);
+              CurrentOffset += sizeof(Common::PacketTrace) + Trace->Size;
+            }
             else {
               CurrentOffset = CurrentRead;
             }
           }
+
+          Data.erase(Data.begin(), Data.begin() + CurrentOffset);
         }
     };
 
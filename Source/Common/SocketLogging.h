@@ -14,6 +14,11 @@ namespace FEX::SocketLogging {
     void AssertHandler(char const *Message);
 
     bool ConnectToClient(const std::string &Remote);
+
+    // Opens a separate connection that only carries trace packets
+    bool ConnectTrace(const std::string &Remote);
+    // Sends raw trace data over the trace connection, matches FEXCore::EventTrace::FlushHandlerType
+    void TraceHandler(void const *Data, size_t Size);
   }
 
   // Server side
@@ -22,6 +27,7 @@ namespace FEX::SocketLogging {
       public:
         using MsgHandlerType = std::function<void(int FD, uint64_t Timestamp, uint32_t PID, uint32_t TID, uint32_t Level, const char* Msg)>;
         using FDClosedHandlerType = std::function<void(int FD)>;
+        using TraceHandlerType = std::function<void(int FD, uint32_t PID, void const *Data, size_t Size)>;
 
         void SetMsgHandler(MsgHandlerType Handler) {
           MsgHandler = std::move(Handler);
@@ -31,6 +37,10 @@ namespace FEX::SocketLogging {
           ClosedHandler = std::move(Handler);
         }
 
+        void SetTraceHandler(TraceHandlerType Handler) {
+          TraceHandler = std::move(Handler);
+        }
+
         void WaitForShutdown() {
           ShutdownEvent.Wait();
         }
@@ -43,8 +53,12 @@ namespace FEX::SocketLogging {
         static void DefaultFDClosedHandler(int) {
         }
 
+        static void DefaultTraceHandler(int, uint32_t, void const*, size_t) {
+        }
+
         MsgHandlerType MsgHandler {DefaultMsgHandler};
         FDClosedHandlerType ClosedHandler {DefaultFDClosedHandler};
+        TraceHandlerType TraceHandler {DefaultTraceHandler};
         Event ShutdownEvent{};
     };
     std::unique_ptr<ServerListener> StartListening(std::string_view Socket);
@@ -5,7 +5,10 @@
 #include <FEXCore/Utils/LogManager.h>
 #include <FEXHeaderUtils/Syscalls.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <elf.h>
+#include <map>
 #include <set>
 #include <sys/resource.h>
 #include <sys/sysinfo.h>
@@ -13,13 +16,16 @@
 #include <queue>
 
 namespace FEX::AOT {
-void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection &Section) {
+void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection &Section, bool FunctionRegions) {
   // Make sure this section is executable and big enough
   if (!Section.Executable || Section.Size < 16)
     return;
 
   std::set<uintptr_t> InitialBranchTargets;
 
+  // Function start to end, used to compile each function as one region
+  std::map<uint64_t, uint64_t> FunctionRanges;
+
   // Load the ELF again with symbol parsing this time
   ELFLoader::ELFContainer container{Section.Filename, "", true};
 
@@ -32,9 +38,19 @@ void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection
     }
 
     InitialBranchTargets.insert(Destination);
+
+    if (FunctionRegions && sym->Type == STT_FUNC && sym->Size) {
+      auto End = std::min<uint64_t>(Destination + sym->Size, Section.Base + Section.Size);
+      // Aliases share a start, keep the largest
+      auto &FunctionEnd = FunctionRanges[Destination];
+      FunctionEnd = std::max(FunctionEnd, End);
+    }
   });
 
   LogMan::Msg::IFmt("Symbol seed: {}", InitialBranchTargets.size());
+  if (FunctionRegions) {
+    LogMan::Msg::IFmt("Function regions: {}", FunctionRanges.size());
+  }
 
   // Add unwind entries to the branch target list
   container.AddUnwindEntries([&](uintptr_t Entry) {
@@ -96,7 +112,7 @@ void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection
   std::vector<std::thread> ThreadPool;
 
   for (int i = 0; i < get_nprocs_conf(); i++) {
-    std::thread thd([&BranchTargets, CTX, &counter, &Compiled, &Section, &QueueMutex, SectionMaxAddress]() {
+    std::thread thd([&BranchTargets, CTX, &counter, &Compiled, &Section, &QueueMutex, &FunctionRanges, FunctionRegions, SectionMaxAddress]() {
       // Set the priority of the thread so it doesn't overwhelm the system when running in the background
       setpriority(PRIO_PROCESS, FHU::Syscalls::gettid(), 19);
 
@@ -104,7 +120,7 @@ void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection
       FEXCore::Core::CPUState state;
       auto Thread = FEXCore::Context::CreateThread(CTX, &state, FHU::Syscalls::gettid());
       std::set<uint64_t> ExternalBranchesLocal;
-      FEXCore::Context::ConfigureAOTGen(Thread, &ExternalBranchesLocal, SectionMaxAddress);
+      FEXCore::Context::ConfigureAOTGen(Thread, &ExternalBranchesLocal, SectionMaxAddress, FunctionRegions ? &FunctionRanges : nullptr);
 
 
       for (;;) {
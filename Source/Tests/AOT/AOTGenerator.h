@@ -3,5 +3,5 @@
 #include "ELFCodeLoader2.h"
 
 namespace FEX::AOT {
-  void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection &Section);
+  void AOTGenSection(FEXCore::Context::Context *CTX, ELFCodeLoader2::LoadedSection &Section, bool FunctionRegions);
 }
@@ -3,6 +3,7 @@
 
 #include "Common/Config.h"
 #include "Tests/LinuxSyscalls/Syscalls.h"
+#include "Tests/LinuxSyscalls/VDSO.h"
 #include "Linux/Utils/ELFParser.h"
 #include "Linux/Utils/ELFSymbolDatabase.h"
 
@@ -404,6 +405,9 @@ class ELFCodeLoader2 final : public FEXCore::CodeLoader {
 
     // All done
 
+    // Map the vDSO, without it the guest falls back to syscalls for the time functions
+    const uint64_t VDSOBase = FEX::HLE::VDSO::MapImage(Mapper, Is64BitMode());
+
     // Setup AuxVars
     AuxVariables.emplace_back(auxv_t{11, getauxval(AT_UID)}); // AT_UID
     AuxVariables.emplace_back(auxv_t{12, getauxval(AT_EUID)}); // AT_EUID
@@ -425,16 +429,20 @@ class ELFCodeLoader2 final : public FEXCore::CodeLoader {
       // On x86 only allows userspace to check for monitor and fs/gs base writing in CPL3
       //AuxVariables.emplace_back(auxv_t{26, 0}); // AT_HWCAP2
 
-      // we don't support vsyscall or vDSO so we don't set those
+      // we don't support vsyscall so we don't set that
       //AuxVariables.emplace_back(auxv_t{32, 0}); // AT_SYSINFO - Entry point to syscall
-      //AuxVariables.emplace_back(auxv_t{33, 0}); // AT_SYSINFO_EHDR - Address of the start of VDSO
+      if (VDSOBase) {
+        AuxVariables.emplace_back(auxv_t{33, VDSOBase}); // AT_SYSINFO_EHDR - Address of the start of VDSO
+      }
     }
     else {
       AuxVariables.emplace_back(auxv_t{4, 0x20}); // AT_PHENT
 
-      // we don't support vsyscall or vDSO so we don't set those
+      // we don't support vsyscall so we don't set that
       //AuxVariables.emplace_back(auxv_t{32, 0}); // AT_SYSINFO - Entry point to syscall
-      //AuxVariables.emplace_back(auxv_t{33, 0}); // AT_SYSINFO_EHDR - Address of the start of VDSO
+      if (VDSOBase) {
+        AuxVariables.emplace_back(auxv_t{33, VDSOBase}); // AT_SYSINFO_EHDR - Address of the start of VDSO
+      }
     }
     AuxVariables.emplace_back(auxv_t{3, MainElfBase + MainElf.ehdr.e_phoff}); // Program header
     AuxVariables.emplace_back(auxv_t{7, InterpeterElfBase}); // AT_BASE - Interpreter address
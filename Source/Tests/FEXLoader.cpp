@@ -15,12 +15,14 @@ $end_info$
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
 #include "Tests/LinuxSyscalls/x64/Syscalls.h"
 #include "Tests/LinuxSyscalls/SignalDelegator.h"
+#include "Tests/LinuxSyscalls/VDSO.h"
 #include "Linux/Utils/ELFContainer.h"
 
 #include <FEXCore/Config/Config.h>
 #include <FEXCore/Core/Context.h>
 #include <FEXCore/Core/CoreState.h>
 #include <FEXCore/Utils/Allocator.h>
+#include <FEXCore/Utils/EventTrace.h>
 #include <FEXCore/Utils/LogManager.h>
 #include <FEXCore/Utils/Telemetry.h>
 #include <FEXCore/Utils/Threads.h>
@@ -108,6 +110,45 @@ void AssertHandler(char const *Message) {
   fsync(OutputFD);
 }
 
+static int TraceFD {-1};
+
+void TraceHandler(void const *Data, size_t Size) {
+  write(TraceFD, Data, Size);
+}
+
+// Needs to happen before anything compiles, the syscall handler only allows inline syscalls while tracing is off
+void SetupEventTrace(std::string const &Target, std::string const &Socket, bool Is64Bit) {
+  const FEXCore::EventTrace::FileHeader Header {
+    .Magic = FEXCore::EventTrace::FILE_MAGIC,
+    .Version = FEXCore::EventTrace::FILE_VERSION,
+    .RecordSize = sizeof(FEXCore::EventTrace::Record),
+    .PID = static_cast<uint32_t>(::getpid()),
+    .Is64Bit = Is64Bit,
+  };
+
+  if (Target == "server") {
+    if (Socket.empty() || !FEX::SocketLogging::Client::ConnectTrace(Socket)) {
+      LogMan::Msg::EFmt("EventTrace: Couldn't connect to the log server at '{}'", Socket);
+      return;
+    }
+
+    FEX::SocketLogging::Client::TraceHandler(&Header, sizeof(Header));
+    FEXCore::EventTrace::Enable(FEX::SocketLogging::Client::TraceHandler);
+  }
+  else {
+    // Every process that runs under FEX gets its own file
+    const auto Filename = fmt::format("{}.{}", Target, Header.PID);
+    TraceFD = open(Filename.c_str(), O_CREAT | O_CLOEXEC | O_WRONLY | O_TRUNC, 0644);
+    if (TraceFD == -1) {
+      LogMan::Msg::EFmt("EventTrace: Couldn't open '{}'", Filename);
+      return;
+    }
+
+    write(TraceFD, &Header, sizeof(Header));
+    FEXCore::EventTrace::Enable(TraceHandler);
+  }
+}
+
 } // Anonymous namespace
 
 void InterpreterHandler(std::string *Filename, std::string const &RootFS, std::vector<std::string> *args) {
@@ -231,9 +272,11 @@ int main(int argc, char **argv, char **const envp) {
   FEX_CONFIG_OPT(SilentLog, SILENTLOG);
   FEX_CONFIG_OPT(AOTIRCapture, AOTIRCAPTURE);
   FEX_CONFIG_OPT(AOTIRGenerate, AOTIRGENERATE);
+  FEX_CONFIG_OPT(AOTIRFunctionRegions, AOTIRFUNCTIONREGIONS);
   FEX_CONFIG_OPT(AOTIRLoad, AOTIRLOAD);
   FEX_CONFIG_OPT(OutputLog, OUTPUTLOG);
   FEX_CONFIG_OPT(OutputSocket, OUTPUTSOCKET);
+  FEX_CONFIG_OPT(EventTrace, EVENTTRACE);
   FEX_CONFIG_OPT(LDPath, ROOTFS);
   FEX_CONFIG_OPT(Environment, ENV);
   FEX_CONFIG_OPT(HostEnvironment, HOSTENV);
@@ -322,6 +365,10 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::Set(FEXCore::Config::CONFIG_APP_FILENAME, std::filesystem::canonical(Program).string());
   FEXCore::Config::Set(FEXCore::Config::CONFIG_IS64BIT_MODE, Loader.Is64BitMode() ? "1" : "0");
 
+  if (!EventTrace().empty()) {
+    SetupEventTrace(EventTrace(), OutputSocket(), Loader.Is64BitMode());
+  }
+
   std::unique_ptr<FEX::HLE::MemAllocator> Allocator;
   FEXCore::Allocator::PtrCache *Base48Bit{};
 
@@ -395,6 +442,7 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Context::SetSignalDelegator(CTX, SignalDelegation.get());
   FEXCore::Context::SetSyscallHandler(CTX, SyscallHandler.get());
   FEXCore::Context::InitCore(CTX, &Loader);
+  FEX::HLE::VDSO::RegisterThunks(CTX, Loader.Is64BitMode());
 
   FEXCore::Context::ExitReason ShutdownReason = FEXCore::Context::ExitReason::EXIT_SHUTDOWN;
 
@@ -442,7 +490,7 @@ int main(int argc, char **argv, char **const envp) {
 
   if (AOTIRGenerate()) {
     for(auto &Section: Loader.Sections) {
-      FEX::AOT::AOTGenSection(CTX, Section);
+      FEX::AOT::AOTGenSection(CTX, Section, AOTIRFunctionRegions());
     }
   } else {
     FEXCore::Context::RunUntilExit(CTX);
@@ -465,6 +513,11 @@ int main(int argc, char **argv, char **const envp) {
     LogMan::Msg::IFmt("AOTIR Cache Stored");
   }
 
+  FEXCore::EventTrace::Shutdown();
+  if (TraceFD != -1) {
+    close(TraceFD);
+  }
+
   auto ProgramStatus = FEXCore::Context::GetProgramStatus(CTX);
 
   SyscallHandler.reset();
@@ -14,6 +14,7 @@ $end_info$
 #include <FEXCore/Core/X86Enums.h>
 #include <FEXCore/HLE/Linux/ThreadManagement.h>
 #include <FEXCore/Utils/Allocator.h>
+#include <FEXCore/Utils/EventTrace.h>
 #include <FEXCore/Utils/LogManager.h>
 #include <FEXHeaderUtils/Syscalls.h>
 
@@ -93,6 +94,19 @@ namespace FEX::HLE {
     // Remove the pending signal
     ThreadData.PendingSignals &= ~(1ULL << (Signal - 1));
 
+    if (FEXCore::EventTrace::IsEnabled()) {
+      FEXCore::EventTrace::AddFromSignal({
+        .Timestamp = FEXCore::EventTrace::Now(),
+        .Type = FEXCore::EventTrace::EventType::SIGNAL,
+        .Number = static_cast<uint32_t>(Signal),
+        .Args = {
+          static_cast<uint64_t>(static_cast<siginfo_t*>(Info)->si_code),
+          reinterpret_cast<uint64_t>(Handler.GuestAction.sigaction_handler.handler),
+          Handler.GuestAction.sa_flags,
+        },
+      });
+    }
+
     // We have an emulation thread pointer, we can now modify its state
     if (Handler.GuestAction.sigaction_handler.handler == SIG_DFL) {
       if (Handler.DefaultBehaviour == DEFAULT_TERM ||
@@ -23,6 +23,7 @@ $end_info$
 #include <FEXCore/HLE/SyscallHandler.h>
 #include <FEXCore/Utils/Allocator.h>
 #include <FEXCore/Utils/CompilerDefs.h>
+#include <FEXCore/Utils/EventTrace.h>
 #include <FEXCore/Utils/LogManager.h>
 #include <FEXCore/Utils/MathUtils.h>
 #include <FEXCore/Utils/Threads.h>
@@ -630,6 +631,9 @@ uint64_t SyscallHandler::HandleSyscall(FEXCore::Core::CpuStateFrame *Frame, FEXC
   }
 
   auto &Def = Definitions[Args->Argument[0]];
+  const bool Trace = FEXCore::EventTrace::IsEnabled();
+  const uint64_t TraceStart = Trace ? FEXCore::EventTrace::Now() : 0;
+
   uint64_t Result{};
   switch (Def.NumArgs) {
   case 0: Result = std::invoke(Def.Ptr0, Frame); break;
@@ -640,7 +644,7 @@ uint64_t SyscallHandler::HandleSyscall(FEXCore::Core::CpuStateFrame *Frame, FEXC
   case 5: Result = std::invoke(Def.Ptr5, Frame, Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Args->Argument[5]); break;
   case 6: Result = std::invoke(Def.Ptr6, Frame, Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Args->Argument[5], Args->Argument[6]); break;
   // for missing syscalls
-  case 255: return std::invoke(Def.Ptr1, Frame, Args->Argument[0]);
+  case 255: Result = std::invoke(Def.Ptr1, Frame, Args->Argument[0]); break;
   default:
     LOGMAN_MSG_A_FMT("Unhandled syscall: {}", Args->Argument[0]);
     return -1;
@@ -649,6 +653,17 @@ uint64_t SyscallHandler::HandleSyscall(FEXCore::Core::CpuStateFrame *Frame, FEXC
 #ifdef DEBUG_STRACE
   Strace(Args, Result);
 #endif
+
+  if (Trace) {
+    FEXCore::EventTrace::Add({
+      .Timestamp = TraceStart,
+      .Duration = static_cast<uint32_t>(FEXCore::EventTrace::Now() - TraceStart),
+      .Type = FEXCore::EventTrace::EventType::SYSCALL,
+      .Number = static_cast<uint32_t>(Args->Argument[0]),
+      .Result = Result,
+      .Args = {Args->Argument[1], Args->Argument[2], Args->Argument[3], Args->Argument[4], Args->Argument[5], Args->Argument[6]},
+    });
+  }
   return Result;
 }
 
@@ -14,6 +14,7 @@ $end_info$
 #include <FEXCore/HLE/SyscallHandler.h>
 #include <FEXCore/IR/IR.h>
 #include <FEXCore/Utils/CompilerDefs.h>
+#include <FEXCore/Utils/EventTrace.h>
 
 #include <mutex>
 #include <shared_mutex>
@@ -124,7 +125,18 @@ public:
 
   FEXCore::HLE::SyscallABI GetSyscallABI(uint64_t Syscall) override {
     auto &Def = Definitions.at(Syscall);
-    return {Def.NumArgs, true, Def.HostSyscallNumber};
+    if (FEXCore::EventTrace::IsEnabled()) {
+      // Inline and direct calls would skip the trace in HandleSyscall
+      return {Def.NumArgs, true, -1, nullptr};
+    }
+#ifdef DEBUG_STRACE
+    // Direct calls would skip the trace in HandleSyscall
+    void *DirectHandler = nullptr;
+#else
+    // Missing syscalls take the syscall number instead of their arguments
+    void *DirectHandler = Def.NumArgs < FEXCore::HLE::SyscallArguments::MAX_ARGS ? Def.Ptr : nullptr;
+#endif
+    return {Def.NumArgs, true, Def.HostSyscallNumber, DirectHandler};
   }
 
   FEXCore::IR::SyscallFlags  GetSyscallFlags(uint64_t Syscall) const override {
@@ -146,6 +158,7 @@ public:
   FEX_CONFIG_OPT(ThreadsConfig, THREADS);
   FEX_CONFIG_OPT(Is64BitMode, IS64BIT_MODE);
   FEX_CONFIG_OPT(SMCChecks, SMCCHECKS);
+  FEX_CONFIG_OPT(CacheObjectCodeCompilation, CACHEOBJECTCODECOMPILATION);
 
   uint32_t GetHostKernelVersion() const { return HostKernelVersion; }
   uint32_t GetGuestKernelVersion() const { return GuestKernelVersion; }
@@ -16,6 +16,7 @@ $end_info$
 #include <FEXCore/Core/X86Enums.h>
 #include <FEXCore/Debug/InternalThreadState.h>
 #include <FEXCore/IR/IR.h>
+#include <FEXCore/Utils/EventTrace.h>
 
 #include <FEXHeaderUtils/Syscalls.h>
 
@@ -180,6 +181,7 @@ namespace FEX::HLE {
   uint64_t ForkGuest(FEXCore::Core::InternalThreadState *Thread, FEXCore::Core::CpuStateFrame *Frame, uint32_t flags, void *stack, pid_t *parent_tid, pid_t *child_tid, void *tls) {
     // Just before we fork, we lock all syscall mutexes so that both processes will end up with a locked mutex
     FEX::HLE::_SyscallHandler->LockBeforeFork();
+    FEXCore::EventTrace::LockBeforeFork();
     
     pid_t Result{};
     if (flags & CLONE_VFORK) {
@@ -192,6 +194,7 @@ namespace FEX::HLE {
     }
 
     // Unlock the mutexes on both sides of the fork
+    FEXCore::EventTrace::UnlockAfterFork(Result == 0);
     FEX::HLE::_SyscallHandler->UnlockAfterFork();
 
     if (Result == 0) {
@@ -221,6 +221,11 @@ void SyscallHandler::TrackMmap(uintptr_t Base, uintptr_t Size, int Prot, int Fla
   if (SMCChecks != FEXCore::Config::CONFIG_SMC_NONE) {
     FEXCore::Context::InvalidateGuestCodeRange(CTX, (uintptr_t)Base, Size);
   }
+
+  if (CacheObjectCodeCompilation() != FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE &&
+      !(Flags & MAP_ANONYMOUS) && (Prot & PROT_EXEC)) {
+    FEXCore::Context::AddNamedRegion(CTX, Base, Size, Offset, get_fdpath(fd));
+  }
 }
 
 void SyscallHandler::TrackMunmap(uintptr_t Base, uintptr_t Size) {
@@ -235,6 +240,10 @@ void SyscallHandler::TrackMunmap(uintptr_t Base, uintptr_t Size) {
   if (SMCChecks != FEXCore::Config::CONFIG_SMC_NONE) {
     FEXCore::Context::InvalidateGuestCodeRange(CTX, (uintptr_t)Base, Size);
   }
+
+  if (CacheObjectCodeCompilation() != FEXCore::Config::ConfigObjectCodeHandler::CONFIG_NONE) {
+    FEXCore::Context::RemoveNamedRegion(CTX, Base, Size);
+  }
 }
 
 void SyscallHandler::TrackMprotect(uintptr_t Base, uintptr_t Size, int Prot) {
@@ -0,0 +1,523 @@
+/*
+$info$
+tags: LinuxSyscalls|common
+desc: Synthesizes the guest vDSO, time queries become a thunk call instead of a syscall
+$end_info$
+*/
+
+#include "Common/SHA256.h"
+#include "Tests/LinuxSyscalls/Syscalls.h"
+#include "Tests/LinuxSyscalls/VDSO.h"
+#include "Tests/LinuxSyscalls/x32/Types.h"
+
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/Utils/LogManager.h>
+#include <FEXHeaderUtils/Syscalls.h>
+
+#include <array>
+#include <cstring>
+#include <elf.h>
+#include <errno.h>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace FEX::HLE::VDSO {
+namespace {
+  // Arguments are packed by the guest side stub, same as the other thunks
+  struct VDSOArgs {
+    uint64_t Arg0;
+    uint64_t Arg1;
+    uint64_t rv;
+  };
+
+  struct VDSOArgs32 {
+    uint32_t Arg0;
+    uint32_t Arg1;
+    uint32_t rv;
+  };
+
+  uint64_t ResultOrErrno(int Result) {
+    return Result == -1 ? -errno : Result;
+  }
+
+  uint32_t GetCPU(uint32_t *cpu, uint32_t *node) {
+    uint32_t LocalCPU{};
+    uint32_t LocalNode{};
+    int Result = FHU::Syscalls::getcpu(cpu ? &LocalCPU : nullptr, node ? &LocalNode : nullptr);
+    if (Result == 0) {
+      // Matches the getcpu syscall, which only reports the emulated cores
+      if (cpu) {
+        *cpu = LocalCPU % FEX::HLE::_SyscallHandler->ThreadsConfig();
+      }
+
+      if (node) {
+        *node = 0;
+      }
+    }
+    return ResultOrErrno(Result);
+  }
+
+  // Host side of the 64-bit functions, the structures match the host's
+  void ClockGettime(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs*>(ArgsRV);
+    auto tp = reinterpret_cast<struct timespec*>(Args->Arg1);
+    // The syscall faults on a null pointer, the host libc would crash instead
+    if (!tp) {
+      Args->rv = -EFAULT;
+      return;
+    }
+    Args->rv = ResultOrErrno(::clock_gettime(Args->Arg0, tp));
+  }
+
+  void GetTimeOfDay(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs*>(ArgsRV);
+    Args->rv = ResultOrErrno(::gettimeofday(reinterpret_cast<struct timeval*>(Args->Arg0), reinterpret_cast<struct timezone*>(Args->Arg1)));
+  }
+
+  void Time(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs*>(ArgsRV);
+    Args->rv = ::time(reinterpret_cast<time_t*>(Args->Arg0));
+  }
+
+  void GetCPU64(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs*>(ArgsRV);
+    Args->rv = (int32_t)GetCPU(reinterpret_cast<uint32_t*>(Args->Arg0), reinterpret_cast<uint32_t*>(Args->Arg1));
+  }
+
+  // Host side of the 32-bit functions
+  void ClockGettime32(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs32*>(ArgsRV);
+    auto tp = reinterpret_cast<FEX::HLE::x32::timespec32*>(Args->Arg1);
+
+    if (!tp) {
+      Args->rv = -EFAULT;
+      return;
+    }
+
+    struct timespec tp64{};
+    int Result = ::clock_gettime(Args->Arg0, &tp64);
+    if (Result == 0) {
+      *tp = tp64;
+    }
+    Args->rv = ResultOrErrno(Result);
+  }
+
+  void ClockGettime64_32(void *ArgsRV) {
+    // 32-bit __kernel_timespec has the same layout as the host timespec
+    auto Args = reinterpret_cast<VDSOArgs32*>(ArgsRV);
+    auto tp = reinterpret_cast<struct timespec*>(Args->Arg1);
+    if (!tp) {
+      Args->rv = -EFAULT;
+      return;
+    }
+    Args->rv = ResultOrErrno(::clock_gettime(Args->Arg0, tp));
+  }
+
+  void GetTimeOfDay32(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs32*>(ArgsRV);
+    auto tv = reinterpret_cast<FEX::HLE::x32::timeval32*>(Args->Arg0);
+    // timezone is two ints on both
+    auto tz = reinterpret_cast<struct timezone*>(Args->Arg1);
+
+    struct timeval tv64{};
+    int Result = ::gettimeofday(tv ? &tv64 : nullptr, tz);
+    if (Result == 0 && tv) {
+      *tv = tv64;
+    }
+    Args->rv = ResultOrErrno(Result);
+  }
+
+  void Time32(void *ArgsRV) {
+    auto Args = reinterpret_cast<VDSOArgs32*>(ArgsRV);
+    auto tloc = reinterpret_cast<FEX::HLE::x32::old_time32_t*>(Args->Arg0);
+
+    // On 32-bit this truncates
+    auto Result = (FEX::HLE::x32::old_time32_t)::time(nullptr);
+    if (tloc) {
+      *tloc = Result;
+    }
+    Args->rv = Result;
+  }
+
+  struct VDSOFunction {
+    // Exported names, the first is the __vdso_ prefixed one
+    std::array<std::string_view, 2> Names;
+    // sha256 of the thunk name
+    FEXCore::IR::SHA256Sum Sum;
+    void (*Host)(void *ArgsRV);
+  };
+
+  constexpr FEXCore::IR::SHA256Sum ThunkSum(std::string_view Name) {
+    const auto Digest = FEX::SHA256::Hash(Name);
+
+    FEXCore::IR::SHA256Sum Sum{};
+    for (size_t i = 0; i < Digest.size(); ++i) {
+      Sum.data[i] = Digest[i];
+    }
+    return Sum;
+  }
+
+  constexpr std::array<VDSOFunction, 4> Functions64 = {{
+    {
+      {"__vdso_clock_gettime", "clock_gettime"},
+      ThunkSum("fex:vdso_clock_gettime"),
+      &ClockGettime,
+    },
+    {
+      {"__vdso_gettimeofday", "gettimeofday"},
+      ThunkSum("fex:vdso_gettimeofday"),
+      &GetTimeOfDay,
+    },
+    {
+      {"__vdso_time", "time"},
+      ThunkSum("fex:vdso_time"),
+      &Time,
+    },
+    {
+      {"__vdso_getcpu", "getcpu"},
+      ThunkSum("fex:vdso_getcpu"),
+      &GetCPU64,
+    },
+  }};
+
+  constexpr std::array<VDSOFunction, 4> Functions32 = {{
+    {
+      {"__vdso_clock_gettime", "clock_gettime"},
+      ThunkSum("fex:vdso_clock_gettime32"),
+      &ClockGettime32,
+    },
+    {
+      {"__vdso_clock_gettime64", "clock_gettime64"},
+      ThunkSum("fex:vdso_clock_gettime64_32"),
+      &ClockGettime64_32,
+    },
+    {
+      {"__vdso_gettimeofday", "gettimeofday"},
+      ThunkSum("fex:vdso_gettimeofday32"),
+      &GetTimeOfDay32,
+    },
+    {
+      {"__vdso_time", "time"},
+      ThunkSum("fex:vdso_time32"),
+      &Time32,
+    },
+  }};
+
+  // Packs RDI and RSI in to VDSOArgs on the stack and calls the thunk with a pointer to it
+  constexpr std::array<uint8_t, 31> Stub64 = {
+    0x48, 0x83, 0xEC, 0x18,       // sub rsp, 0x18
+    0x48, 0x89, 0x3C, 0x24,       // mov [rsp], rdi
+    0x48, 0x89, 0x74, 0x24, 0x08, // mov [rsp + 8], rsi
+    0x48, 0x89, 0xE7,             // mov rdi, rsp
+    0xE8, 0x0A, 0x00, 0x00, 0x00, // call Thunk
+    0x48, 0x8B, 0x44, 0x24, 0x10, // mov rax, [rsp + 0x10]
+    0x48, 0x83, 0xC4, 0x18,       // add rsp, 0x18
+    0xC3,                         // ret
+    // Thunk: 0x0F, 0x3F, sha256
+  };
+
+  // Copies the two stack arguments in to VDSOArgs32 and calls the thunk with a pointer to it.
+  // EDI is callee saved on i386.
+  constexpr std::array<uint8_t, 37> Stub32 = {
+    0x83, 0xEC, 0x0C,             // sub esp, 0xc
+    0x8B, 0x44, 0x24, 0x10,       // mov eax, [esp + 0x10]
+    0x89, 0x04, 0x24,             // mov [esp], eax
+    0x8B, 0x44, 0x24, 0x14,       // mov eax, [esp + 0x14]
+    0x89, 0x44, 0x24, 0x04,       // mov [esp + 4], eax
+    0x57,                         // push edi
+    0x8D, 0x7C, 0x24, 0x04,       // lea edi, [esp + 4]
+    0xE8, 0x09, 0x00, 0x00, 0x00, // call Thunk
+    0x5F,                         // pop edi
+    0x8B, 0x44, 0x24, 0x08,       // mov eax, [esp + 8]
+    0x83, 0xC4, 0x0C,             // add esp, 0xc
+    0xC3,                         // ret
+    // Thunk: 0x0F, 0x3F, sha256
+  };
+
+  struct ELF64 {
+    using Ehdr = Elf64_Ehdr;
+    using Phdr = Elf64_Phdr;
+    using Shdr = Elf64_Shdr;
+    using Sym = Elf64_Sym;
+    using Dyn = Elf64_Dyn;
+    static constexpr uint8_t Class = ELFCLASS64;
+    static constexpr uint16_t Machine = EM_X86_64;
+    static constexpr uint8_t SymInfo = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+    static constexpr uint8_t WeakSymInfo = ELF64_ST_INFO(STB_WEAK, STT_FUNC);
+  };
+
+  struct ELF32 {
+    using Ehdr = Elf32_Ehdr;
+    using Phdr = Elf32_Phdr;
+    using Shdr = Elf32_Shdr;
+    using Sym = Elf32_Sym;
+    using Dyn = Elf32_Dyn;
+    static constexpr uint8_t Class = ELFCLASS32;
+    static constexpr uint16_t Machine = EM_386;
+    static constexpr uint8_t SymInfo = ELF32_ST_INFO(STB_GLOBAL, STT_FUNC);
+    static constexpr uint8_t WeakSymInfo = ELF32_ST_INFO(STB_WEAK, STT_FUNC);
+  };
+
+  class ImageWriter {
+  public:
+    size_t Align(size_t Alignment) {
+      Data.resize((Data.size() + Alignment - 1) & ~(Alignment - 1));
+      return Data.size();
+    }
+
+    size_t Append(void const *Src, size_t Size) {
+      const size_t Offset = Data.size();
+      Data.resize(Offset + Size);
+      memcpy(&Data[Offset], Src, Size);
+      return Offset;
+    }
+
+    template<typename T>
+    size_t Append(T const &Value) {
+      return Append(&Value, sizeof(T));
+    }
+
+    template<typename T>
+    T *At(size_t Offset) {
+      return reinterpret_cast<T*>(&Data[Offset]);
+    }
+
+    std::vector<uint8_t> Data;
+  };
+
+  template<typename ELF, size_t StubSize>
+  std::vector<uint8_t> Generate(std::array<VDSOFunction, 4> const &Functions, std::array<uint8_t, StubSize> const &Stub) {
+    // Sections in the order they are written
+    enum {
+      SECTION_NULL,
+      SECTION_HASH,
+      SECTION_DYNSYM,
+      SECTION_DYNSTR,
+      SECTION_TEXT,
+      SECTION_DYNAMIC,
+      SECTION_SHSTRTAB,
+      SECTION_COUNT,
+    };
+
+    constexpr std::array<std::string_view, SECTION_COUNT> SectionNames = {
+      "", ".hash", ".dynsym", ".dynstr", ".text", ".dynamic", ".shstrtab",
+    };
+
+    constexpr size_t NumProgramHeaders = 2;
+    constexpr std::string_view SOName = "linux-vdso.so.1";
+
+    ImageWriter Image;
+    std::array<typename ELF::Shdr, SECTION_COUNT> Sections{};
+
+    // Headers are filled in once everything else is placed
+    Image.Append(typename ELF::Ehdr{});
+    const size_t PhdrOffset = Image.Append(std::array<typename ELF::Phdr, NumProgramHeaders>{});
+
+    // String table
+    std::string DynStr(1, '\0');
+    auto AddString = [&DynStr](std::string_view Str) -> uint32_t {
+      const uint32_t Offset = DynStr.size();
+      DynStr.append(Str);
+      DynStr.push_back('\0');
+      return Offset;
+    };
+
+    const uint32_t SONameOffset = AddString(SOName);
+
+    // Code, the stub of each function is followed by its thunk
+    std::vector<uint8_t> Text;
+    std::vector<size_t> FunctionOffsets;
+    for (auto &Function : Functions) {
+      FunctionOffsets.emplace_back(Text.size());
+      Text.insert(Text.end(), Stub.begin(), Stub.end());
+      Text.push_back(0x0F);
+      Text.push_back(0x3F);
+      Text.insert(Text.end(), std::begin(Function.Sum.data), std::end(Function.Sum.data));
+
+      // Pad with int3
+      Text.resize((Text.size() + 15) & ~15ULL, 0xCC);
+    }
+
+    // Hash table, a single bucket chaining through every symbol is enough for this few
+    const uint32_t NumSymbols = 1 + Functions.size() * 2;
+    Sections[SECTION_HASH].sh_offset = Image.Align(8);
+    Image.Append(uint32_t{1});
+    Image.Append(NumSymbols);
+    Image.Append(NumSymbols - 1);
+    Image.Append(uint32_t{0});
+    for (uint32_t i = 1; i < NumSymbols; ++i) {
+      Image.Append(i - 1);
+    }
+
+    // Symbols, text offsets are patched once .text is placed
+    Sections[SECTION_DYNSYM].sh_offset = Image.Align(8);
+    Image.Append(typename ELF::Sym{});
+    for (size_t i = 0; i < Functions.size(); ++i) {
+      for (size_t NameIndex = 0; NameIndex < Functions[i].Names.size(); ++NameIndex) {
+        typename ELF::Sym Symbol{};
+        Symbol.st_name = AddString(Functions[i].Names[NameIndex]);
+        // The unprefixed names are weak aliases, like the kernel's vDSO
+        Symbol.st_info = NameIndex == 0 ? ELF::SymInfo : ELF::WeakSymInfo;
+        Symbol.st_shndx = SECTION_TEXT;
+        Symbol.st_value = FunctionOffsets[i];
+        Symbol.st_size = Stub.size() + 2 + sizeof(FEXCore::IR::SHA256Sum);
+        Image.Append(Symbol);
+      }
+    }
+
+    Sections[SECTION_DYNSTR].sh_offset = Image.Append(DynStr.data(), DynStr.size());
+
+    Sections[SECTION_TEXT].sh_offset = Image.Align(16);
+    Image.Append(Text.data(), Text.size());
+
+    auto SymbolTable = Image.template At<typename ELF::Sym>(Sections[SECTION_DYNSYM].sh_offset);
+    for (uint32_t i = 1; i < NumSymbols; ++i) {
+      SymbolTable[i].st_value += Sections[SECTION_TEXT].sh_offset;
+    }
+
+    // The image is linked at zero, so addresses are the same as offsets
+    Sections[SECTION_DYNAMIC].sh_offset = Image.Align(8);
+    const std::array<std::pair<int64_t, uint64_t>, 7> DynamicEntries = {{
+      {DT_HASH, Sections[SECTION_HASH].sh_offset},
+      {DT_STRTAB, Sections[SECTION_DYNSTR].sh_offset},
+      {DT_SYMTAB, Sections[SECTION_DYNSYM].sh_offset},
+      {DT_STRSZ, DynStr.size()},
+      {DT_SYMENT, sizeof(typename ELF::Sym)},
+      {DT_SONAME, SONameOffset},
+      {DT_NULL, 0},
+    }};
+
+    for (auto [Tag, Value] : DynamicEntries) {
+      typename ELF::Dyn Entry{};
+      Entry.d_tag = Tag;
+      Entry.d_un.d_val = Value;
+      Image.Append(Entry);
+    }
+
+    std::string SectionStrings;
+    for (size_t i = 0; i < SectionNames.size(); ++i) {
+      Sections[i].sh_name = SectionStrings.size();
+      SectionStrings.append(SectionNames[i]);
+      SectionStrings.push_back('\0');
+    }
+    Sections[SECTION_SHSTRTAB].sh_offset = Image.Append(SectionStrings.data(), SectionStrings.size());
+
+    const size_t LoadedSize = Image.Data.size();
+
+    // Section headers
+    auto SetSection = [&](size_t Index, uint32_t Type, uint64_t Flags, uint64_t Size, uint32_t Link, uint64_t Align, uint64_t EntSize) {
+      auto &Section = Sections[Index];
+      Section.sh_type = Type;
+      Section.sh_flags = Flags;
+      Section.sh_addr = Flags & SHF_ALLOC ? Section.sh_offset : 0;
+      Section.sh_size = Size;
+      Section.sh_link = Link;
+      Section.sh_addralign = Align;
+      Section.sh_entsize = EntSize;
+    };
+
+    SetSection(SECTION_HASH, SHT_HASH, SHF_ALLOC, (2 + 1 + NumSymbols) * sizeof(uint32_t), SECTION_DYNSYM, 8, sizeof(uint32_t));
+    SetSection(SECTION_DYNSYM, SHT_DYNSYM, SHF_ALLOC, NumSymbols * sizeof(typename ELF::Sym), SECTION_DYNSTR, 8, sizeof(typename ELF::Sym));
+    // Every symbol but the null one is global or weak
+    Sections[SECTION_DYNSYM].sh_info = 1;
+    SetSection(SECTION_DYNSTR, SHT_STRTAB, SHF_ALLOC, DynStr.size(), 0, 1, 0);
+    SetSection(SECTION_TEXT, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, Text.size(), 0, 16, 0);
+    SetSection(SECTION_DYNAMIC, SHT_DYNAMIC, SHF_ALLOC, DynamicEntries.size() * sizeof(typename ELF::Dyn), SECTION_DYNSTR, 8, sizeof(typename ELF::Dyn));
+    SetSection(SECTION_SHSTRTAB, SHT_STRTAB, 0, SectionStrings.size(), 0, 1, 0);
+
+    const size_t ShdrOffset = Image.Align(8);
+    Image.Append(Sections);
+
+    // ELF header
+    auto Header = Image.template At<typename ELF::Ehdr>(0);
+    memcpy(Header->e_ident, ELFMAG, SELFMAG);
+    Header->e_ident[EI_CLASS] = ELF::Class;
+    Header->e_ident[EI_DATA] = ELFDATA2LSB;
+    Header->e_ident[EI_VERSION] = EV_CURRENT;
+    Header->e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    Header->e_type = ET_DYN;
+    Header->e_machine = ELF::Machine;
+    Header->e_version = EV_CURRENT;
+    Header->e_entry = 0;
+    Header->e_phoff = PhdrOffset;
+    Header->e_shoff = ShdrOffset;
+    Header->e_ehsize = sizeof(typename ELF::Ehdr);
+    Header->e_phentsize = sizeof(typename ELF::Phdr);
+    Header->e_phnum = NumProgramHeaders;
+    Header->e_shentsize = sizeof(typename ELF::Shdr);
+    Header->e_shnum = SECTION_COUNT;
+    Header->e_shstrndx = SECTION_SHSTRTAB;
+
+    // Program headers
+    auto ProgramHeaders = Image.template At<typename ELF::Phdr>(PhdrOffset);
+    ProgramHeaders[0].p_type = PT_LOAD;
+    ProgramHeaders[0].p_flags = PF_R | PF_X;
+    ProgramHeaders[0].p_offset = 0;
+    ProgramHeaders[0].p_vaddr = 0;
+    ProgramHeaders[0].p_paddr = 0;
+    ProgramHeaders[0].p_filesz = LoadedSize;
+    ProgramHeaders[0].p_memsz = LoadedSize;
+    ProgramHeaders[0].p_align = 0x1000;
+
+    ProgramHeaders[1].p_type = PT_DYNAMIC;
+    ProgramHeaders[1].p_flags = PF_R;
+    ProgramHeaders[1].p_offset = Sections[SECTION_DYNAMIC].sh_offset;
+    ProgramHeaders[1].p_vaddr = Sections[SECTION_DYNAMIC].sh_offset;
+    ProgramHeaders[1].p_paddr = Sections[SECTION_DYNAMIC].sh_offset;
+    ProgramHeaders[1].p_filesz = Sections[SECTION_DYNAMIC].sh_size;
+    ProgramHeaders[1].p_memsz = Sections[SECTION_DYNAMIC].sh_size;
+    ProgramHeaders[1].p_align = 8;
+
+    return std::move(Image.Data);
+  }
+}
+
+std::vector<uint8_t> GenerateImage(bool Is64Bit) {
+  if (Is64Bit) {
+    return Generate<ELF64>(Functions64, Stub64);
+  }
+  else {
+    return Generate<ELF32>(Functions32, Stub32);
+  }
+}
+
+uint64_t MapImage(const FEXCore::CodeLoader::MapperFn& Mapper, bool Is64Bit) {
+  const auto Image = GenerateImage(Is64Bit);
+  const size_t MappedSize = (Image.size() + 4095) & ~4095ULL;
+
+  // Back the mapping with a memfd so it can be mapped with its final permissions through the guest mmap
+  int FD = ::syscall(SYS_memfd_create, "[vdso]", MFD_CLOEXEC);
+  if (FD == -1) {
+    LogMan::Msg::EFmt("Couldn't create the vDSO: {}", errno);
+    return 0;
+  }
+
+  if (ftruncate(FD, MappedSize) == -1 ||
+      pwrite(FD, Image.data(), Image.size(), 0) != (ssize_t)Image.size()) {
+    LogMan::Msg::EFmt("Couldn't write the vDSO: {}", errno);
+    close(FD);
+    return 0;
+  }
+
+  void *Base = Mapper(nullptr, MappedSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, FD, 0);
+  close(FD);
+
+  if (Base == MAP_FAILED) {
+    LogMan::Msg::EFmt("Couldn't map the vDSO: {}", errno);
+    return 0;
+  }
+
+  return reinterpret_cast<uint64_t>(Base);
+}
+
+void RegisterThunks(FEXCore::Context::Context *CTX, bool Is64Bit) {
+  for (auto &Function : Is64Bit ? Functions64 : Functions32) {
+    FEXCore::Context::RegisterHostThunk(CTX, Function.Sum, Function.Host);
+  }
+}
+}
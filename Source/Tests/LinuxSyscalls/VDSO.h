@@ -0,0 +1,35 @@
+#pragma once
+
+#include <FEXCore/Core/CodeLoader.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace FEXCore::Context {
+  struct Context;
+}
+
+namespace FEX::HLE::VDSO {
+  /**
+   * @brief Builds the guest vDSO ELF image
+   *
+   * The image is linked at address zero and is position independent, it can be mapped anywhere.
+   * 64-bit exports __vdso_clock_gettime, __vdso_gettimeofday, __vdso_time and __vdso_getcpu.
+   * 32-bit exports __vdso_clock_gettime, __vdso_clock_gettime64, __vdso_gettimeofday and __vdso_time.
+   */
+  std::vector<uint8_t> GenerateImage(bool Is64Bit);
+
+  /**
+   * @brief Maps the vDSO in to guest memory
+   *
+   * @return The base of the mapping to pass through AT_SYSINFO_EHDR, or zero if mapping failed
+   */
+  uint64_t MapImage(const FEXCore::CodeLoader::MapperFn& Mapper, bool Is64Bit);
+
+  /**
+   * @brief Registers the host side of the vDSO functions
+   *
+   * Must be called after InitCore, before the guest runs.
+   */
+  void RegisterThunks(FEXCore::Context::Context *CTX, bool Is64Bit);
+}
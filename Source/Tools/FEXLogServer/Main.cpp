@@ -3,7 +3,9 @@
 
 #include "Tools/CommonGUI/IMGui.h"
 
+#include <fcntl.h>
 #include <map>
+#include <unordered_map>
 #include <unordered_set>
 #include <unistd.h>
 #include <vector>
@@ -47,6 +49,34 @@ namespace CLI {
   }
 }
 
+namespace Trace {
+  // Socket -> trace file, only touched from the listener thread
+  static std::unordered_map<int, int> Files{};
+
+  static void TraceHandler(int FD, uint32_t PID, void const *Data, size_t Size) {
+    auto it = Files.find(FD);
+    if (it == Files.end()) {
+      const auto Filename = fmt::format("FEX-{}.fextrace", PID);
+      int File = open(Filename.c_str(), O_CREAT | O_CLOEXEC | O_WRONLY | O_TRUNC, 0644);
+      if (File == -1) {
+        return;
+      }
+      it = Files.emplace(FD, File).first;
+      fmt::print(stderr, "Writing trace of {} to {}\n", PID, Filename);
+    }
+
+    write(it->second, Data, Size);
+  }
+
+  static void FDClosedHandler(int FD) {
+    auto it = Files.find(FD);
+    if (it != Files.end()) {
+      close(it->second);
+      Files.erase(it);
+    }
+  }
+}
+
 namespace GUI {
   static std::chrono::time_point<std::chrono::high_resolution_clock> GlobalTime{};
 
@@ -251,14 +281,20 @@ int main(int argc, char **argv, char **envp) {
 
   auto Listener = FEX::SocketLogging::Server::StartListening(Port);
 
+  Listener->SetTraceHandler(Trace::TraceHandler);
+
   if (!Graphical) {
     Listener->SetMsgHandler(CLI::MsgHandler);
+    Listener->SetFDClosedHandler(Trace::FDClosedHandler);
     Listener->WaitForShutdown();
     return 0;
   }
 
   Listener->SetMsgHandler(GUI::MsgHandler);
-  Listener->SetFDClosedHandler(GUI::FDClosedHandler);
+  Listener->SetFDClosedHandler([](int FD) {
+    Trace::FDClosedHandler(FD);
+    GUI::FDClosedHandler(FD);
+  });
 
   // Imgui based UI
   std::string ImGUIConfig = FEXCore::Config::GetConfigDirectory(false) + "FEXLogServer_imgui.ini";
@@ -0,0 +1,269 @@
+/*
+$info$
+tags: Bin|FEXRABench
+desc: Compares the register allocators over IR captured in AOTIR cache files
+$end_info$
+*/
+
+#include "OptionParser.h"
+
+#include "Interface/IR/AOTIR.h"
+#include "Interface/IR/Passes.h"
+#include "Interface/IR/Passes/RegisterAllocationPass.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+#include <FEXCore/IR/RegisterAllocationData.h>
+#include <FEXCore/Utils/ThreadPoolAllocator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <stdio.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+  // Matches the register file the Arm64 JIT hands to the allocator
+  constexpr uint32_t NumGPRs = 9;
+  constexpr uint32_t NumSRAGPRs = 16;
+  constexpr uint32_t NumFPRs = 12;
+  constexpr uint32_t NumSRAFPRs = 16;
+  constexpr uint32_t NumGPRPairs = 4;
+  constexpr uint32_t RegisterCount = NumGPRs + NumFPRs + NumGPRPairs;
+  constexpr uint32_t RegisterClasses = 6;
+
+  struct AllocatorResults {
+    const char *Name;
+    uint64_t TimeNS{};
+    uint64_t Spills{};
+    uint64_t Fills{};
+    uint64_t SpillSlots{};
+  };
+
+  struct CaptureFile {
+    void *FilePtr{};
+    size_t Size{};
+    FEXCore::IR::AOTIRInlineIndex *Array{};
+
+    ~CaptureFile() {
+      if (FilePtr) {
+        munmap(FilePtr, Size);
+      }
+    }
+  };
+
+  bool LoadCaptureFile(CaptureFile *File, std::string const &Filename) {
+    int fd = open(Filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+      return false;
+    }
+
+    struct stat FileInfo;
+    if (fstat(fd, &FileInfo) < 0 || FileInfo.st_size < (off_t)(sizeof(uint64_t) * 3)) {
+      close(fd);
+      return false;
+    }
+
+    File->Size = FileInfo.st_size;
+    File->FilePtr = mmap(nullptr, File->Size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (File->FilePtr == MAP_FAILED) {
+      File->FilePtr = nullptr;
+      return false;
+    }
+
+    // Layout is the cookie, the entries, the index, the index size, the module id and the module id size
+    auto Base = reinterpret_cast<uint8_t const*>(File->FilePtr);
+    uint64_t Tag, ModSize, IndexSize;
+    memcpy(&Tag, Base, sizeof(Tag));
+    if (Tag != FEXCore::IR::AOTIR_COOKIE) {
+      return false;
+    }
+
+    size_t Offset = File->Size - sizeof(ModSize);
+    memcpy(&ModSize, Base + Offset, sizeof(ModSize));
+    if (ModSize > Offset) {
+      return false;
+    }
+
+    Offset -= ModSize + sizeof(IndexSize);
+    memcpy(&IndexSize, Base + Offset, sizeof(IndexSize));
+    if (IndexSize > Offset) {
+      return false;
+    }
+
+    File->Array = (FEXCore::IR::AOTIRInlineIndex *)(Base + Offset - IndexSize);
+    return true;
+  }
+
+  // Captured IR has already been through RA, put it back to the state it was in before spilling
+  void RemoveSpills(FEXCore::IR::IREmitter *IREmit) {
+    auto CurrentIR = IREmit->ViewIR();
+
+    std::vector<FEXCore::IR::OrderedNode*> Fills;
+    std::vector<FEXCore::IR::OrderedNode*> Spills;
+    for (auto [CodeNode, IROp] : CurrentIR.GetAllCode()) {
+      if (IROp->Op == FEXCore::IR::OP_FILLREGISTER) {
+        Fills.emplace_back(CodeNode);
+      }
+      else if (IROp->Op == FEXCore::IR::OP_SPILLREGISTER) {
+        Spills.emplace_back(CodeNode);
+      }
+    }
+
+    for (auto Fill : Fills) {
+      auto Op = CurrentIR.GetOp<FEXCore::IR::IROp_FillRegister>(Fill);
+      IREmit->ReplaceAllUsesWith(Fill, CurrentIR.GetNode(Op->OriginalValue));
+    }
+
+    for (auto Spill : Spills) {
+      IREmit->Remove(Spill);
+    }
+  }
+
+  void CountSpills(FEXCore::IR::IREmitter *IREmit, AllocatorResults *Results) {
+    auto CurrentIR = IREmit->ViewIR();
+    for (auto [CodeNode, IROp] : CurrentIR.GetAllCode()) {
+      Results->Spills += IROp->Op == FEXCore::IR::OP_SPILLREGISTER;
+      Results->Fills += IROp->Op == FEXCore::IR::OP_FILLREGISTER;
+    }
+  }
+
+  std::unique_ptr<FEXCore::IR::RegisterAllocationPass> CreateAllocator(FEXCore::IR::Pass *CompactionPass, bool LinearScan) {
+    auto RAPass = FEXCore::IR::CreateRegisterAllocationPass(CompactionPass, true, LinearScan);
+
+    RAPass->AllocateRegisterSet(RegisterCount, RegisterClasses);
+    RAPass->AddRegisters(FEXCore::IR::GPRClass, NumGPRs);
+    RAPass->AddRegisters(FEXCore::IR::GPRFixedClass, NumSRAGPRs);
+    RAPass->AddRegisters(FEXCore::IR::FPRClass, NumFPRs);
+    RAPass->AddRegisters(FEXCore::IR::FPRFixedClass, NumSRAFPRs);
+    RAPass->AddRegisters(FEXCore::IR::GPRPairClass, NumGPRPairs);
+    RAPass->AddRegisters(FEXCore::IR::ComplexClass, 1);
+
+    for (uint32_t i = 0; i < NumGPRPairs; ++i) {
+      RAPass->AddRegisterConflict(FEXCore::IR::GPRClass, i * 2,     FEXCore::IR::GPRPairClass, i);
+      RAPass->AddRegisterConflict(FEXCore::IR::GPRClass, i * 2 + 1, FEXCore::IR::GPRPairClass, i);
+    }
+
+    return RAPass;
+  }
+
+  void PrintResults(AllocatorResults const &Results, AllocatorResults const &Baseline) {
+    fprintf(stdout, "%-8s %12.3f ms %10lu spills %10lu fills %10lu slots",
+      Results.Name, Results.TimeNS / 1'000'000.0, Results.Spills, Results.Fills, Results.SpillSlots);
+
+    if (&Results != &Baseline && Results.TimeNS) {
+      fprintf(stdout, "  (%.2fx faster)", (double)Baseline.TimeNS / Results.TimeNS);
+    }
+    fprintf(stdout, "\n");
+  }
+}
+
+int main(int argc, char **argv) {
+  optparse::OptionParser Parser = optparse::OptionParser()
+    .usage("%prog [options] <file.aotir>...")
+    .description("Runs the graph and linear scan register allocators over captured AOTIR and compares compile time and spilling");
+
+  Parser.add_option("-i", "--iterations")
+    .dest("iterations")
+    .type("int")
+    .set_default(1)
+    .help("Number of times to allocate each IR");
+
+  optparse::Values Options = Parser.parse_args(argc, argv);
+  auto Files = Parser.args();
+
+  if (Files.empty()) {
+    Parser.print_help();
+    return -1;
+  }
+
+  const int Iterations = std::max((int)Options.get("iterations"), 1);
+
+  FEXCore::Utils::PooledAllocatorMalloc Allocator;
+  auto CompactionPass = FEXCore::IR::CreateIRCompaction(Allocator);
+
+  AllocatorResults Results[] = {
+    { "graph" },
+    { "linear" },
+  };
+
+  std::unique_ptr<FEXCore::IR::RegisterAllocationPass> Allocators[] = {
+    CreateAllocator(CompactionPass.get(), false),
+    CreateAllocator(CompactionPass.get(), true),
+  };
+
+  uint64_t Functions{};
+  uint64_t Failed{};
+
+  for (auto &Filename : Files) {
+    CaptureFile File;
+    if (!LoadCaptureFile(&File, Filename)) {
+      fprintf(stderr, "%s: Not an AOTIR capture file\n", Filename.c_str());
+      continue;
+    }
+
+    for (uint64_t i = 0; i < File.Array->Count; ++i) {
+      auto Entry = File.Array->GetInlineEntry(File.Array->Entries[i].DataOffset);
+
+      // Round trip through the text form to get an IR we can modify
+      std::stringstream IRText;
+      FEXCore::IR::Dump(&IRText, Entry->GetIRData(), nullptr);
+      const auto Text = IRText.str();
+
+      ++Functions;
+
+      bool ParseFailed = false;
+      for (size_t Mode = 0; Mode < std::size(Allocators) && !ParseFailed; ++Mode) {
+        for (int Iteration = 0; Iteration < Iterations; ++Iteration) {
+          std::istringstream In{Text};
+          auto IREmit = FEXCore::IR::Parse(Allocator, &In);
+          if (!IREmit) {
+            ParseFailed = true;
+            break;
+          }
+
+          RemoveSpills(IREmit.get());
+          CompactionPass->Run(IREmit.get());
+
+          const auto Begin = std::chrono::high_resolution_clock::now();
+          Allocators[Mode]->Run(IREmit.get());
+          const auto End = std::chrono::high_resolution_clock::now();
+
+          Results[Mode].TimeNS += std::chrono::duration_cast<std::chrono::nanoseconds>(End - Begin).count();
+
+          // Code quality doesn't change between iterations
+          if (Iteration == 0) {
+            CountSpills(IREmit.get(), &Results[Mode]);
+            Results[Mode].SpillSlots += Allocators[Mode]->GetAllocationData()->SpillSlots();
+          }
+        }
+      }
+
+      Failed += ParseFailed;
+    }
+  }
+
+  fprintf(stdout, "%lu functions, %d iterations", Functions, Iterations);
+  if (Failed) {
+    fprintf(stdout, ", %lu failed to parse", Failed);
+  }
+  fprintf(stdout, "\n");
+
+  for (auto &Result : Results) {
+    PrintResults(Result, Results[0]);
+  }
+
+  return 0;
+}
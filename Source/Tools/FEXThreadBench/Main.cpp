@@ -0,0 +1,172 @@
+/*
+$info$
+tags: Bin|FEXThreadBench
+desc: Measures how long FEXCore takes to set up and tear down the state of a guest thread
+$end_info$
+*/
+
+#include "OptionParser.h"
+
+#include "Tests/LinuxSyscalls/SignalDelegator.h"
+
+#include <FEXCore/Config/Config.h>
+#include <FEXCore/Core/CodeLoader.h>
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Core/CoreState.h>
+#include <FEXCore/HLE/SyscallHandler.h>
+#include <FEXCore/Utils/Allocator.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <stdio.h>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+namespace {
+  void MsgHandler(LogMan::DebugLevels Level, char const *Message) {
+    if (Level <= LogMan::ERROR) {
+      fprintf(stderr, "%s\n", Message);
+    }
+  }
+
+  void AssertHandler(char const *Message) {
+    fprintf(stderr, "[ASSERT] %s\n", Message);
+  }
+
+  // Nothing runs guest code, InitCore only needs somewhere to point the parent thread at
+  class NullCodeLoader final : public FEXCore::CodeLoader {
+  public:
+    uint64_t StackSize() const override {
+      return STACK_SIZE;
+    }
+
+    uint64_t GetStackPointer() override {
+      return reinterpret_cast<uint64_t>(FEXCore::Allocator::mmap(nullptr, STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)) + STACK_SIZE;
+    }
+
+    uint64_t DefaultRIP() const override {
+      return 0;
+    }
+
+  private:
+    constexpr static uint64_t STACK_SIZE = 64 * 1024;
+  };
+
+  class NullSyscallHandler final : public FEXCore::HLE::SyscallHandler {
+  public:
+    uint64_t HandleSyscall(FEXCore::Core::CpuStateFrame *Frame, FEXCore::HLE::SyscallArguments *Args) override {
+      LOGMAN_MSG_A_FMT("Syscalls not implemented");
+      return 0;
+    }
+
+    FEXCore::HLE::SyscallABI GetSyscallABI(uint64_t Syscall) override {
+      LOGMAN_MSG_A_FMT("Syscalls not implemented");
+      return {0, false, 0 };
+    }
+
+    FEXCore::HLE::AOTIRCacheEntryLookupResult LookupAOTIRCacheEntry(uint64_t GuestAddr) override {
+      return {0, 0, FHU::ScopedSignalMaskWithSharedLock {Mutex}};
+    }
+
+  private:
+    std::shared_mutex Mutex;
+  };
+}
+
+int main(int argc, char **argv, char **const envp) {
+  optparse::OptionParser Parser = optparse::OptionParser()
+    .usage("%prog [options]")
+    .description("Creates and destroys guest thread state the way clone and exit do and reports the time per thread");
+
+  Parser.add_option("-i", "--iterations")
+    .dest("iterations")
+    .type("int")
+    .set_default(1000)
+    .help("Number of threads to create and destroy");
+
+  Parser.add_option("-b", "--burst")
+    .dest("burst")
+    .type("int")
+    .set_default(1)
+    .help("Number of threads that are alive at the same time");
+
+  Parser.add_option("-p", "--pool-size")
+    .dest("pool")
+    .type("int")
+    .set_default(-1)
+    .help("Overrides ThreadStatePoolSize, 0 measures without reuse");
+
+  optparse::Values Options = Parser.parse_args(argc, argv);
+
+  const int Iterations = std::max((int)Options.get("iterations"), 1);
+  const int Burst = std::clamp((int)Options.get("burst"), 1, Iterations);
+  const int PoolSize = (int)Options.get("pool");
+
+  LogMan::Throw::InstallHandler(AssertHandler);
+  LogMan::Msg::InstallHandler(MsgHandler);
+
+  FEXCore::Config::Initialize();
+  FEXCore::Config::AddLayer(FEXCore::Config::CreateMainLayer());
+  FEXCore::Config::AddLayer(FEXCore::Config::CreateEnvironmentLayer(envp));
+  FEXCore::Config::Load();
+
+  if (PoolSize >= 0) {
+    FEXCore::Config::EraseSet(FEXCore::Config::CONFIG_THREADSTATEPOOLSIZE, std::to_string(PoolSize));
+  }
+
+  FEXCore::Context::InitializeStaticTables();
+  auto CTX = FEXCore::Context::CreateNewContext();
+  FEXCore::Context::InitializeContext(CTX);
+
+  auto SignalDelegation = std::make_unique<FEX::HLE::SignalDelegator>();
+  FEXCore::Context::SetSignalDelegator(CTX, SignalDelegation.get());
+  FEXCore::Context::SetSyscallHandler(CTX, new NullSyscallHandler());
+
+  NullCodeLoader Loader;
+  FEXCore::Context::InitCore(CTX, &Loader);
+
+  FEXCore::Core::CPUState NewThreadState{};
+  FEXCore::Context::GetCPUState(CTX, &NewThreadState);
+
+  std::vector<FEXCore::Core::InternalThreadState*> Threads;
+  Threads.reserve(Burst);
+
+  uint64_t CreateNS{};
+  uint64_t DestroyNS{};
+  int Created{};
+
+  while (Created < Iterations) {
+    const int Count = std::min(Burst, Iterations - Created);
+
+    auto Start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < Count; ++i) {
+      Threads.emplace_back(FEXCore::Context::CreateThread(CTX, &NewThreadState, 1));
+    }
+    auto Mid = std::chrono::high_resolution_clock::now();
+    for (auto Thread : Threads) {
+      FEXCore::Context::DestroyThread(CTX, Thread);
+    }
+    auto End = std::chrono::high_resolution_clock::now();
+
+    CreateNS += std::chrono::duration_cast<std::chrono::nanoseconds>(Mid - Start).count();
+    DestroyNS += std::chrono::duration_cast<std::chrono::nanoseconds>(End - Mid).count();
+
+    Threads.clear();
+    Created += Count;
+  }
+
+  fprintf(stdout, "%d threads, %d alive at once\n", Iterations, Burst);
+  fprintf(stdout, "create  %10.3f us/thread\n", CreateNS / 1000.0 / Iterations);
+  fprintf(stdout, "destroy %10.3f us/thread\n", DestroyNS / 1000.0 / Iterations);
+  fprintf(stdout, "total   %10.3f us/thread\n", (CreateNS + DestroyNS) / 1000.0 / Iterations);
+
+  FEXCore::Context::DestroyContext(CTX);
+  FEXCore::Config::Shutdown();
+
+  return 0;
+}
@@ -0,0 +1,202 @@
+/*
+$info$
+tags: Bin|FEXTraceDump
+desc: Decodes the binary event traces written with the EventTrace option
+$end_info$
+*/
+
+#include "OptionParser.h"
+
+#include <FEXCore/Utils/EventTrace.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+namespace {
+  using FEXCore::EventTrace::EventType;
+  using FEXCore::EventTrace::Record;
+
+  const std::map<int, const char*> SyscallNames64 = {
+    #include "Tests/LinuxSyscalls/x64/SyscallsNames.inl"
+  };
+
+  const std::map<int, const char*> SyscallNames32 = {
+    #include "Tests/LinuxSyscalls/x32/SyscallsNames.inl"
+  };
+
+  struct SyscallSummary {
+    uint64_t Count{};
+    uint64_t Errors{};
+    uint64_t TotalNS{};
+  };
+
+  const char *GetSyscallName(const std::map<int, const char*> &Names, uint32_t Number) {
+    auto it = Names.find(Number);
+    return it == Names.end() ? "[unknown syscall]" : it->second;
+  }
+
+  bool LoadTrace(std::string const &Filename, FEXCore::EventTrace::FileHeader *Header, std::vector<Record> *Records) {
+    std::ifstream File(Filename, std::ios::binary);
+    if (!File.is_open()) {
+      fprintf(stderr, "%s: Couldn't open\n", Filename.c_str());
+      return false;
+    }
+
+    if (!File.read(reinterpret_cast<char*>(Header), sizeof(*Header)) ||
+        Header->Magic != FEXCore::EventTrace::FILE_MAGIC) {
+      fprintf(stderr, "%s: Not a FEX trace\n", Filename.c_str());
+      return false;
+    }
+
+    if (Header->Version != FEXCore::EventTrace::FILE_VERSION ||
+        Header->RecordSize != sizeof(Record)) {
+      fprintf(stderr, "%s: Trace version %u isn't supported\n", Filename.c_str(), Header->Version);
+      return false;
+    }
+
+    std::vector<char> Data{std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>()};
+
+    // A process that was killed can leave a partial record at the end
+    Records->resize(Data.size() / sizeof(Record));
+    memcpy(Records->data(), Data.data(), Records->size() * sizeof(Record));
+    return true;
+  }
+
+  void PrintRecord(Record const &Event, uint64_t Base, const std::map<int, const char*> &Names) {
+    fprintf(stdout, "%12.3f %7u ", (Event.Timestamp - Base) / 1000.0, Event.TID);
+
+    switch (Event.Type) {
+      case EventType::SYSCALL:
+        fprintf(stdout, "%s(0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ", 0x%" PRIx64 ") = %" PRId64 " <%u ns>\n",
+          GetSyscallName(Names, Event.Number),
+          Event.Args[0], Event.Args[1], Event.Args[2], Event.Args[3], Event.Args[4], Event.Args[5],
+          static_cast<int64_t>(Event.Result), Event.Duration);
+        break;
+      case EventType::BLOCK_COMPILE:
+        fprintf(stdout, "compile 0x%" PRIx64 " -> %p, guest [0x%" PRIx64 ", 0x%" PRIx64 ") <%u ns>\n",
+          Event.Args[0], reinterpret_cast<void*>(Event.Args[1]), Event.Args[2], Event.Args[2] + Event.Args[3], Event.Duration);
+        break;
+      case EventType::SMC_INVALIDATE:
+        fprintf(stdout, "invalidate [0x%" PRIx64 ", 0x%" PRIx64 ")\n", Event.Args[0], Event.Args[0] + Event.Args[1]);
+        break;
+      case EventType::SIGNAL:
+        fprintf(stdout, "signal %s (%u), si_code %" PRId64 ", handler 0x%" PRIx64 ", sa_flags 0x%" PRIx64 "\n",
+          strsignal(Event.Number), Event.Number, static_cast<int64_t>(Event.Args[0]), Event.Args[1], Event.Args[2]);
+        break;
+      default:
+        fprintf(stdout, "unknown event %u\n", static_cast<uint32_t>(Event.Type));
+        break;
+    }
+  }
+
+  void PrintSummary(std::vector<Record> const &Records, const std::map<int, const char*> &Names) {
+    std::map<uint32_t, SyscallSummary> Syscalls;
+    uint64_t Compiles{}, CompileNS{}, Invalidations{}, Signals{};
+
+    for (auto &Event : Records) {
+      switch (Event.Type) {
+        case EventType::SYSCALL: {
+          auto &Summary = Syscalls[Event.Number];
+          ++Summary.Count;
+          Summary.Errors += static_cast<int64_t>(Event.Result) < 0 && static_cast<int64_t>(Event.Result) >= -4095;
+          Summary.TotalNS += Event.Duration;
+          break;
+        }
+        case EventType::BLOCK_COMPILE:
+          ++Compiles;
+          CompileNS += Event.Duration;
+          break;
+        case EventType::SMC_INVALIDATE:
+          ++Invalidations;
+          break;
+        case EventType::SIGNAL:
+          ++Signals;
+          break;
+        default:
+          break;
+      }
+    }
+
+    std::vector<std::pair<uint32_t, SyscallSummary>> Sorted(Syscalls.begin(), Syscalls.end());
+    std::sort(Sorted.begin(), Sorted.end(), [](auto const &a, auto const &b) {
+      return a.second.TotalNS > b.second.TotalNS;
+    });
+
+    fprintf(stdout, "%-24s %10s %10s %14s %12s\n", "syscall", "calls", "errors", "total us", "avg ns");
+    for (auto &[Number, Summary] : Sorted) {
+      fprintf(stdout, "%-24s %10" PRIu64 " %10" PRIu64 " %14.3f %12" PRIu64 "\n",
+        GetSyscallName(Names, Number), Summary.Count, Summary.Errors, Summary.TotalNS / 1000.0, Summary.TotalNS / Summary.Count);
+    }
+
+    fprintf(stdout, "\n%" PRIu64 " block compiles, %.3f ms\n", Compiles, CompileNS / 1'000'000.0);
+    fprintf(stdout, "%" PRIu64 " SMC invalidations\n", Invalidations);
+    fprintf(stdout, "%" PRIu64 " signals\n", Signals);
+  }
+}
+
+int main(int argc, char **argv) {
+  optparse::OptionParser Parser = optparse::OptionParser()
+    .usage("%prog [options] <trace>")
+    .description("Decodes a trace written by FEX with the EventTrace option.\n"
+                 "Times are in microseconds from the first event.");
+
+  Parser.add_option("-s", "--summary")
+    .dest("summary")
+    .action("store_true")
+    .set_default(false)
+    .help("Print per-syscall counts and times instead of every event");
+
+  Parser.add_option("-t", "--tid")
+    .dest("tid")
+    .type("int")
+    .set_default(0)
+    .help("Only show events of this thread");
+
+  optparse::Values Options = Parser.parse_args(argc, argv);
+  auto Files = Parser.args();
+
+  if (Files.size() != 1) {
+    Parser.print_help();
+    return -1;
+  }
+
+  FEXCore::EventTrace::FileHeader Header{};
+  std::vector<Record> Records;
+  if (!LoadTrace(Files[0], &Header, &Records)) {
+    return -1;
+  }
+
+  const uint32_t TID = (int)Options.get("tid");
+  if (TID) {
+    std::erase_if(Records, [TID](Record const &Event) { return Event.TID != TID; });
+  }
+
+  // Threads flush their rings independently, put everything back in order
+  std::stable_sort(Records.begin(), Records.end(), [](Record const &a, Record const &b) {
+    return a.Timestamp < b.Timestamp;
+  });
+
+  auto &Names = Header.Is64Bit ? SyscallNames64 : SyscallNames32;
+
+  fprintf(stdout, "PID %u, %s, %zu events\n", Header.PID, Header.Is64Bit ? "64-bit" : "32-bit", Records.size());
+
+  if (Options.get("summary")) {
+    PrintSummary(Records, Names);
+  }
+  else {
+    const uint64_t Base = Records.empty() ? 0 : Records.front().Timestamp;
+    for (auto &Event : Records) {
+      PrintRecord(Event, Base, Names);
+    }
+  }
+
+  return 0;
+}
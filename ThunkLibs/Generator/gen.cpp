@@ -45,6 +45,9 @@ struct ThunkedFunction : FunctionParams {
     // This is implied e.g. for thunks generated for variadic functions
     bool custom_host_impl = false;
 
+    // If true, the packed arguments carry the host errno back to the guest
+    bool forwards_errno = false;
+
     std::string GetOriginalFunctionName() const {
         const std::string suffix = "_internal";
         assert(function_name.length() > suffix.size());
@@ -122,6 +125,8 @@ class ASTVisitor : public clang::RecursiveASTVisitor<ASTVisitor> {
 
         bool returns_guest_pointer = false;
 
+        bool forwards_errno = false;
+
         std::optional<clang::QualType> uniform_va_type;
 
         CallbackStrategy callback_strategy = CallbackStrategy::Default;
@@ -185,6 +190,8 @@ class ASTVisitor : public clang::RecursiveASTVisitor<ASTVisitor> {
                 ret.callback_strategy = CallbackStrategy::Guest;
             } else if (annotation == "fexgen::custom_guest_entrypoint") {
                 ret.custom_guest_entrypoint = true;
+            } else if (annotation == "fexgen::forwards_errno") {
+                ret.forwards_errno = true;
             } else {
                 throw Error(base.getSourceRange().getBegin(), "Unknown annotation");
             }
@@ -290,6 +297,7 @@ public:
         data.decl = emitted_function;
 
         data.custom_host_impl = annotations.custom_host_impl;
+        data.forwards_errno = annotations.forwards_errno;
 
         for (std::size_t param_idx = 0; param_idx < emitted_function->param_size(); ++param_idx) {
             auto* param = emitted_function->getParamDecl(param_idx);
@@ -524,7 +532,10 @@ void GenerateThunkLibsAction::EndSourceFileAction() {
             }
             if (!is_void) {
                 file << "    " << format_decl(data.return_type, "rv") << ";\n";
-            } else if (data.param_types.size() == 0) {
+            }
+            if (data.forwards_errno) {
+                file << "    int host_errno;\n";
+            } else if (is_void && data.param_types.size() == 0) {
                 // Avoid "empty struct has size 0 in C, size 1 in C++" warning
                 file << "    char force_nonempty;\n";
             }
@@ -533,6 +544,12 @@ void GenerateThunkLibsAction::EndSourceFileAction() {
                 file << "  args.a_" << idx << " = a_" << idx << ";\n";
             }
             file << "  fexthunks_" << libname << "_" << function_name << "(&args);\n";
+            if (data.forwards_errno) {
+                // Functions only ever set errno on failure, a successful call must not clear the guest's
+                file << "  if (args.host_errno) {\n";
+                file << "    errno = args.host_errno;\n";
+                file << "  }\n";
+            }
             if (!is_void) {
                 file << "  return args.rv;\n";
             }
@@ -553,7 +570,10 @@ void GenerateThunkLibsAction::EndSourceFileAction() {
             file << format_struct_members(thunk, "  ");
             if (!is_void) {
                 file << "  " << format_decl(thunk.return_type, "rv") << ";\n";
-            } else if (thunk.param_types.size() == 0) {
+            }
+            if (thunk.forwards_errno) {
+                file << "  int host_errno;\n";
+            } else if (is_void && thunk.param_types.size() == 0) {
                 // Avoid "empty struct has size 0 in C, size 1 in C++" warning
                 file << "    char force_nonempty;\n";
             }
@@ -575,6 +595,9 @@ void GenerateThunkLibsAction::EndSourceFileAction() {
             }
 
             file << "static void fexfn_unpack_" << libname << "_" << function_name << "(fexfn_packed_args_" << libname << "_" << function_name << "* args) {\n";
+            if (thunk.forwards_errno) {
+                file << "  errno = 0;\n";
+            }
             file << (is_void ? "  " : "  args->rv = ") << (thunk.custom_host_impl ? "fexfn_impl_" : "fexldr_ptr_") << libname << "_" << function_name << "(";
             {
                 auto format_param = [&](std::size_t idx) {
@@ -592,6 +615,9 @@ void GenerateThunkLibsAction::EndSourceFileAction() {
                 file << format_function_args(thunk, format_param);
             }
             file << ");\n";
+            if (thunk.forwards_errno) {
+                file << "  args->host_errno = errno;\n";
+            }
             file << "}\n";
         }
 
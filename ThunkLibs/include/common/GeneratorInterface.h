@@ -2,6 +2,8 @@ namespace fexgen {
 struct returns_guest_pointer {};
 struct custom_host_impl {};
 struct custom_guest_entrypoint {};
+// The host's errno after the call is passed back and set in the guest if it is non-zero
+struct forwards_errno {};
 
 struct generate_guest_symtable {};
 
@@ -0,0 +1,101 @@
+/*
+$info$
+tags: thunklibs|m
+desc: Guest benchmark, run it with and without the libm thunk to compare throughput and results
+$end_info$
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <immintrin.h>
+
+// libmvec doesn't ship a header for these, callers normally get them through -ftree-loop-vectorize
+extern "C" {
+__m128d _ZGVbN2v_sin(__m128d);
+__m128d _ZGVbN2v_exp(__m128d);
+__m128d _ZGVbN2v_log(__m128d);
+__m128d _ZGVbN2vv_pow(__m128d, __m128d);
+__m128 _ZGVbN4v_sinf(__m128);
+__m128 _ZGVbN4v_expf(__m128);
+}
+
+namespace {
+constexpr size_t INPUT_COUNT = 4096;
+
+double Inputs[INPUT_COUNT];
+float InputsF[INPUT_COUNT];
+
+uint64_t Now() {
+  struct timespec Time{};
+  clock_gettime(CLOCK_MONOTONIC, &Time);
+  return Time.tv_sec * 1'000'000'000ULL + Time.tv_nsec;
+}
+
+// The checksum keeps the calls from being optimized out, and differs between runs if the results do
+template<typename Fn>
+void Run(const char *Name, size_t Iterations, size_t CallsPerIteration, Fn Body) {
+  double Checksum{};
+  const uint64_t Start = Now();
+  for (size_t i = 0; i < Iterations; ++i) {
+    Checksum += Body(i % INPUT_COUNT);
+  }
+  const uint64_t End = Now();
+
+  fprintf(stdout, "%-12s %10.2f ns/call  checksum %a\n", Name,
+    static_cast<double>(End - Start) / (Iterations * CallsPerIteration), Checksum);
+}
+}
+
+int main(int argc, char **argv) {
+  const size_t Iterations = argc > 1 ? strtoull(argv[1], nullptr, 0) : 1'000'000;
+
+  // Fixed inputs spread over the ranges where the functions do real work
+  for (size_t i = 0; i < INPUT_COUNT; ++i) {
+    Inputs[i] = 0.001 + i * (20.0 / INPUT_COUNT);
+    InputsF[i] = static_cast<float>(Inputs[i]);
+  }
+
+  Run("sin", Iterations, 1, [](size_t i) { return sin(Inputs[i]); });
+  Run("cos", Iterations, 1, [](size_t i) { return cos(Inputs[i]); });
+  Run("tan", Iterations, 1, [](size_t i) { return tan(Inputs[i]); });
+  Run("exp", Iterations, 1, [](size_t i) { return exp(Inputs[i]); });
+  Run("log", Iterations, 1, [](size_t i) { return log(Inputs[i]); });
+  Run("pow", Iterations, 1, [](size_t i) { return pow(Inputs[i], 1.5); });
+  Run("atan2", Iterations, 1, [](size_t i) { return atan2(Inputs[i], 3.0); });
+  Run("sincos", Iterations, 1, [](size_t i) {
+    double s, c;
+    sincos(Inputs[i], &s, &c);
+    return s + c;
+  });
+
+  Run("sinf", Iterations, 1, [](size_t i) { return static_cast<double>(sinf(InputsF[i])); });
+  Run("expf", Iterations, 1, [](size_t i) { return static_cast<double>(expf(InputsF[i])); });
+  Run("logf", Iterations, 1, [](size_t i) { return static_cast<double>(logf(InputsF[i])); });
+  Run("powf", Iterations, 1, [](size_t i) { return static_cast<double>(powf(InputsF[i], 1.5f)); });
+
+  auto Sum2 = [](__m128d v) {
+    double Lanes[2];
+    memcpy(Lanes, &v, sizeof(Lanes));
+    return Lanes[0] + Lanes[1];
+  };
+  auto Sum4 = [](__m128 v) {
+    float Lanes[4];
+    memcpy(Lanes, &v, sizeof(Lanes));
+    return static_cast<double>(Lanes[0]) + Lanes[1] + Lanes[2] + Lanes[3];
+  };
+
+  // Per-lane times, so these compare directly with the scalar numbers above
+  Run("vsin", Iterations, 2, [&](size_t i) { return Sum2(_ZGVbN2v_sin(_mm_loadu_pd(&Inputs[i & ~1]))); });
+  Run("vexp", Iterations, 2, [&](size_t i) { return Sum2(_ZGVbN2v_exp(_mm_loadu_pd(&Inputs[i & ~1]))); });
+  Run("vlog", Iterations, 2, [&](size_t i) { return Sum2(_ZGVbN2v_log(_mm_loadu_pd(&Inputs[i & ~1]))); });
+  Run("vpow", Iterations, 2, [&](size_t i) { return Sum2(_ZGVbN2vv_pow(_mm_loadu_pd(&Inputs[i & ~1]), _mm_set1_pd(1.5))); });
+  Run("vsinf", Iterations, 4, [&](size_t i) { return Sum4(_ZGVbN4v_sinf(_mm_loadu_ps(&InputsF[i & ~3]))); });
+  Run("vexpf", Iterations, 4, [&](size_t i) { return Sum4(_ZGVbN4v_expf(_mm_loadu_ps(&InputsF[i & ~3]))); });
+
+  return 0;
+}
@@ -0,0 +1,117 @@
+/*
+$info$
+tags: thunklibs|m
+desc: Guest program that prints results, errno and raised exceptions for special inputs, diff its output with and without the libm thunk
+$end_info$
+*/
+
+#include <errno.h>
+#include <fenv.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Every line is "name type inputs... result errno exceptions", with values as raw bits in hex.
+// unittests/ThunkLibs/libm_reference.txt is this program's output on x86-64 glibc.
+
+namespace {
+const double Values[] = {
+  0.0, -0.0, 1.0, -1.0, 0.5, -0.5, 2.0, -2.0, 3.75, -7.25, 10.0, 100.0, 710.0, -745.5, 1e300, -1e300,
+  0x1p-1022, 0x1p-1074, 0x1.fffffffffffffp1023, M_PI, M_PI_2, M_E,
+  __builtin_inf(), -__builtin_inf(), __builtin_nan(""),
+};
+
+const double BinaryValues[] = {
+  0.0, -0.0, 1.0, -1.0, 0.5, -2.5, 3.0, 1e300, 0x1p-1074, __builtin_inf(), -__builtin_inf(), __builtin_nan(""),
+};
+
+const float ValuesF[] = {
+  0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -0.5f, 2.0f, -2.0f, 3.75f, -7.25f, 10.0f, 100.0f, 89.0f, -104.0f, 1e38f, -1e38f,
+  0x1p-126f, 0x1p-149f, 0x1.fffffep127f, static_cast<float>(M_PI), static_cast<float>(M_PI_2), static_cast<float>(M_E),
+  __builtin_inff(), -__builtin_inff(), __builtin_nanf(""),
+};
+
+const float BinaryValuesF[] = {
+  0.0f, -0.0f, 1.0f, -1.0f, 0.5f, -2.5f, 3.0f, 1e38f, 0x1p-149f, __builtin_inff(), -__builtin_inff(), __builtin_nanf(""),
+};
+
+uint64_t Bits(double Value) {
+  uint64_t Result;
+  memcpy(&Result, &Value, sizeof(Result));
+  return Result;
+}
+
+uint32_t Bits(float Value) {
+  uint32_t Result;
+  memcpy(&Result, &Value, sizeof(Result));
+  return Result;
+}
+
+void Print(double Value) {
+  printf(" %016llx", static_cast<unsigned long long>(Bits(Value)));
+}
+
+void Print(float Value) {
+  printf(" %08x", Bits(Value));
+}
+
+void Begin() {
+  errno = 0;
+  feclearexcept(FE_ALL_EXCEPT);
+}
+
+// Inexact is left out, it is raised by nearly everything and glibc doesn't promise anything about it
+void End() {
+  const int Errno = errno;
+  const int Raised = fetestexcept(FE_INVALID | FE_DIVBYZERO | FE_OVERFLOW | FE_UNDERFLOW);
+  printf(" %d %02x\n", Errno, Raised);
+}
+
+template<typename T>
+void Unary(const char *Name, T (*Fn)(T), const T *Inputs, size_t Count) {
+  for (size_t i = 0; i < Count; ++i) {
+    Begin();
+    const T Result = Fn(Inputs[i]);
+    printf("%s %c", Name, sizeof(T) == sizeof(double) ? 'd' : 'f');
+    Print(Inputs[i]);
+    Print(Result);
+    End();
+  }
+}
+
+template<typename T>
+void Binary(const char *Name, T (*Fn)(T, T), const T *Inputs, size_t Count) {
+  for (size_t i = 0; i < Count; ++i) {
+    for (size_t j = 0; j < Count; ++j) {
+      Begin();
+      const T Result = Fn(Inputs[i], Inputs[j]);
+      printf("%s %c", Name, sizeof(T) == sizeof(double) ? 'd' : 'f');
+      Print(Inputs[i]);
+      Print(Inputs[j]);
+      Print(Result);
+      End();
+    }
+  }
+}
+}
+
+#define UNARY(name) Unary<double>(#name, name, Values, sizeof(Values) / sizeof(Values[0]))
+#define BINARY(name) Binary<double>(#name, name, BinaryValues, sizeof(BinaryValues) / sizeof(BinaryValues[0]))
+#define UNARYF(name) Unary<float>(#name, name, ValuesF, sizeof(ValuesF) / sizeof(ValuesF[0]))
+#define BINARYF(name) Binary<float>(#name, name, BinaryValuesF, sizeof(BinaryValuesF) / sizeof(BinaryValuesF[0]))
+
+int main() {
+  UNARY(acos); UNARY(acosh); UNARY(asin); UNARY(asinh); UNARY(atan); UNARY(atanh); UNARY(cbrt); UNARY(cos);
+  UNARY(cosh); UNARY(erf); UNARY(erfc); UNARY(exp); UNARY(exp10); UNARY(exp2); UNARY(expm1); UNARY(j0);
+  UNARY(j1); UNARY(log); UNARY(log10); UNARY(log1p); UNARY(log2); UNARY(logb); UNARY(sin); UNARY(sinh);
+  UNARY(sqrt); UNARY(tan); UNARY(tanh); UNARY(tgamma); UNARY(y0); UNARY(y1);
+  BINARY(atan2); BINARY(fdim); BINARY(fmod); BINARY(hypot); BINARY(nextafter); BINARY(pow); BINARY(remainder);
+
+  UNARYF(acosf); UNARYF(acoshf); UNARYF(asinf); UNARYF(atanf); UNARYF(atanhf); UNARYF(cbrtf); UNARYF(cosf);
+  UNARYF(coshf); UNARYF(expf); UNARYF(exp2f); UNARYF(expm1f); UNARYF(logf); UNARYF(log10f); UNARYF(log1pf);
+  UNARYF(log2f); UNARYF(sinf); UNARYF(sinhf); UNARYF(sqrtf); UNARYF(tanf); UNARYF(tanhf); UNARYF(tgammaf);
+  BINARYF(atan2f); BINARYF(fmodf); BINARYF(hypotf); BINARYF(powf); BINARYF(remainderf);
+
+  return 0;
+}
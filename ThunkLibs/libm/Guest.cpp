@@ -0,0 +1,931 @@
+/*
+$info$
+tags: thunklibs|m
+desc: Replaces all of libm and libmvec, long double, fenv and classification helpers run in the guest
+$end_info$
+*/
+
+#include <errno.h>
+#include <fenv.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common/Guest.h"
+
+#include "Types.h"
+
+#include "thunks.inl"
+#include "function_packs.inl"
+#include "function_packs_public.inl"
+
+LOAD_LIB(libm)
+
+namespace {
+  // <math.h> can't be included next to the generated declarations, these are the glibc values
+  constexpr int FEX_FP_NAN = 0;
+  constexpr int FEX_FP_INFINITE = 1;
+  constexpr int FEX_FP_ZERO = 2;
+  constexpr int FEX_FP_SUBNORMAL = 3;
+  constexpr int FEX_FP_NORMAL = 4;
+  constexpr int FEX_FP_ILOGB0 = -2147483647 - 1;
+  constexpr int FEX_FP_ILOGBNAN = -2147483647 - 1;
+
+  // x87 extended precision
+  struct LongDoubleBits {
+    uint64_t Mantissa;
+    uint16_t SignExponent;
+  };
+
+  constexpr uint64_t INTEGER_BIT = 1ULL << 63;
+  constexpr uint64_t QUIET_BIT = 1ULL << 62;
+  constexpr int EXPONENT_BIAS = 16383;
+
+  LongDoubleBits ToBits(long double Value) {
+    LongDoubleBits Bits;
+    memcpy(&Bits.Mantissa, &Value, sizeof(Bits.Mantissa));
+    memcpy(&Bits.SignExponent, reinterpret_cast<char*>(&Value) + sizeof(Bits.Mantissa), sizeof(Bits.SignExponent));
+    return Bits;
+  }
+
+  long double FromBits(LongDoubleBits Bits) {
+    long double Value {};
+    memcpy(&Value, &Bits.Mantissa, sizeof(Bits.Mantissa));
+    memcpy(reinterpret_cast<char*>(&Value) + sizeof(Bits.Mantissa), &Bits.SignExponent, sizeof(Bits.SignExponent));
+    return Value;
+  }
+
+  long double PowerOfTwo(int Exponent) {
+    return FromBits({INTEGER_BIT, static_cast<uint16_t>(Exponent + EXPONENT_BIAS)});
+  }
+}
+
+extern "C" {
+// The host has no 80-bit float, these go through the double thunks like X87ReducedPrecision does.
+// Results have double precision and double range, arguments past the double range overflow or flush to zero.
+// Further down, the functions that have to give exact results are done in the guest, and exp, log, sqrt and hypot keep the long double range.
+#define LDOUBLE_1(name) long double name##l(long double a) { return name(a); }
+#define LDOUBLE_2(name) long double name##l(long double a, long double b) { return name(a, b); }
+#define COMPLEX_LDOUBLE_1(name) _Complex long double name##l(_Complex long double a) { return name((_Complex double)a); }
+
+LDOUBLE_1(acos)
+LDOUBLE_1(acosh)
+LDOUBLE_1(asin)
+LDOUBLE_1(asinh)
+LDOUBLE_1(atan)
+LDOUBLE_1(atanh)
+LDOUBLE_1(cbrt)
+LDOUBLE_1(cos)
+LDOUBLE_1(cosh)
+LDOUBLE_1(erf)
+LDOUBLE_1(erfc)
+LDOUBLE_1(expm1)
+LDOUBLE_1(j0)
+LDOUBLE_1(j1)
+LDOUBLE_1(log1p)
+LDOUBLE_1(sin)
+LDOUBLE_1(sinh)
+LDOUBLE_1(tan)
+LDOUBLE_1(tanh)
+LDOUBLE_1(tgamma)
+LDOUBLE_1(y0)
+LDOUBLE_1(y1)
+LDOUBLE_2(atan2)
+LDOUBLE_2(pow)
+
+long double fmal(long double a, long double b, long double c) { return fma(a, b, c); }
+long double jnl(int n, long double a) { return jn(n, a); }
+long double ynl(int n, long double a) { return yn(n, a); }
+long double nanl(const char *tag) { return nan(tag); }
+long double lgammal_r(long double a, int *sign) { return lgamma_r(a, sign); }
+
+void sincosl(long double a, long double *s, long double *c) {
+  double Sin, Cos;
+  sincos(a, &Sin, &Cos);
+  *s = Sin;
+  *c = Cos;
+}
+
+COMPLEX_LDOUBLE_1(cacos)
+COMPLEX_LDOUBLE_1(cacosh)
+COMPLEX_LDOUBLE_1(casin)
+COMPLEX_LDOUBLE_1(casinh)
+COMPLEX_LDOUBLE_1(catan)
+COMPLEX_LDOUBLE_1(catanh)
+COMPLEX_LDOUBLE_1(ccos)
+COMPLEX_LDOUBLE_1(ccosh)
+COMPLEX_LDOUBLE_1(cexp)
+COMPLEX_LDOUBLE_1(clog)
+COMPLEX_LDOUBLE_1(clog10)
+COMPLEX_LDOUBLE_1(cproj)
+COMPLEX_LDOUBLE_1(csin)
+COMPLEX_LDOUBLE_1(csinh)
+COMPLEX_LDOUBLE_1(csqrt)
+COMPLEX_LDOUBLE_1(ctan)
+COMPLEX_LDOUBLE_1(ctanh)
+
+_Complex long double cpowl(_Complex long double a, _Complex long double b) { return cpow((_Complex double)a, (_Complex double)b); }
+long double cabsl(_Complex long double a) { return cabs((_Complex double)a); }
+long double cargl(_Complex long double a) { return carg((_Complex double)a); }
+
+#undef LDOUBLE_1
+#undef LDOUBLE_2
+#undef COMPLEX_LDOUBLE_1
+
+// Exact long double functions
+long double fabsl(long double a) { return __builtin_fabsl(a); }
+long double copysignl(long double a, long double b) { return __builtin_copysignl(a, b); }
+
+long double frexpl(long double a, int *e) {
+  auto Bits = ToBits(a);
+  int Exponent = Bits.SignExponent & 0x7fff;
+
+  *e = 0;
+  if (Exponent == 0x7fff || Bits.Mantissa == 0) {
+    // Infinity, NaN or zero
+    return a;
+  }
+
+  if (Exponent == 0) {
+    // Denormal, normalize it first
+    const int Shift = __builtin_clzll(Bits.Mantissa);
+    Bits.Mantissa <<= Shift;
+    Exponent = 1 - Shift;
+  }
+
+  *e = Exponent - (EXPONENT_BIAS - 1);
+  Bits.SignExponent = (Bits.SignExponent & 0x8000) | (EXPONENT_BIAS - 1);
+  return FromBits(Bits);
+}
+
+long double scalbnl(long double a, int n) {
+  constexpr int MAX_EXPONENT = EXPONENT_BIAS;
+  constexpr int MIN_EXPONENT = 1 - EXPONENT_BIAS;
+
+  if (a == 0 || !__builtin_isfinite(a)) {
+    return a;
+  }
+
+  int Exponent;
+  frexpl(a, &Exponent);
+  --Exponent;
+
+  // Bring the value to [1, 2) first, that is exact and leaves a single rounding multiply at the end
+  a *= PowerOfTwo(-Exponent / 2);
+  a *= PowerOfTwo(-Exponent - (-Exponent / 2));
+
+  // Past these the result has left the range either way, clamping keeps the sum from overflowing
+  n = n > 65536 ? 65536 : n < -65536 ? -65536 : n;
+  const int Target = Exponent + n;
+
+  if (Target > MAX_EXPONENT) {
+    return a * PowerOfTwo(MAX_EXPONENT) * 2.0L;
+  }
+  if (Target < MIN_EXPONENT) {
+    const int Remaining = Target - MIN_EXPONENT;
+    return a * PowerOfTwo(MIN_EXPONENT) * PowerOfTwo(Remaining < -128 ? -128 : Remaining);
+  }
+  return a * PowerOfTwo(Target);
+}
+
+long double ldexpl(long double a, int n) { return scalbnl(a, n); }
+
+long double scalblnl(long double a, long n) {
+  return scalbnl(a, n > 65536 ? 65536 : n < -65536 ? -65536 : static_cast<int>(n));
+}
+
+int ilogbl(long double a) {
+  if (a != a) {
+    return FEX_FP_ILOGBNAN;
+  }
+  if (a == 0) {
+    return FEX_FP_ILOGB0;
+  }
+  if (__builtin_isinf(a)) {
+    return 2147483647;
+  }
+
+  int Exponent;
+  frexpl(a, &Exponent);
+  return Exponent - 1;
+}
+
+long double logbl(long double a) {
+  if (a != a) {
+    return a + a;
+  }
+  if (a == 0) {
+    return -1.0L / __builtin_fabsl(a);
+  }
+  if (__builtin_isinf(a)) {
+    return __builtin_fabsl(a);
+  }
+
+  int Exponent;
+  frexpl(a, &Exponent);
+  return Exponent - 1;
+}
+
+long double truncl(long double a) {
+  // Everything at or above 2^63 is an integer already, below that int64_t holds it exactly
+  if (!(__builtin_fabsl(a) < 0x1p63L)) {
+    return a;
+  }
+  return __builtin_copysignl(static_cast<long double>(static_cast<int64_t>(a)), a);
+}
+
+long double floorl(long double a) {
+  const long double Int = truncl(a);
+  return Int > a ? Int - 1 : Int;
+}
+
+long double ceill(long double a) {
+  const long double Int = truncl(a);
+  return Int < a ? Int + 1 : Int;
+}
+
+long double roundl(long double a) {
+  const long double Int = truncl(a);
+  return __builtin_fabsl(a - Int) >= 0.5L ? Int + __builtin_copysignl(1.0L, a) : Int;
+}
+
+long double rintl(long double a) {
+  if (!(__builtin_fabsl(a) < 0x1p63L)) {
+    return a;
+  }
+
+  // With 64 bits of mantissa this rounds away the fraction in the current rounding mode
+  volatile long double Offset = __builtin_copysignl(0x1p63L, a);
+  return __builtin_copysignl((a + Offset) - Offset, a);
+}
+
+long double nearbyintl(long double a) { return rintl(a); }
+long lrintl(long double a) { return static_cast<long>(rintl(a)); }
+long long llrintl(long double a) { return static_cast<long long>(rintl(a)); }
+long lroundl(long double a) { return static_cast<long>(roundl(a)); }
+long long llroundl(long double a) { return static_cast<long long>(roundl(a)); }
+
+long double modfl(long double a, long double *Int) {
+  *Int = truncl(a);
+  if (__builtin_isinf(a)) {
+    return __builtin_copysignl(0.0L, a);
+  }
+  return __builtin_copysignl(a - *Int, a);
+}
+
+namespace {
+  // |a| is Mantissa * 2^Exponent with the top bit of Mantissa set, a has to be finite and non-zero
+  struct UnpackedLongDouble {
+    uint64_t Mantissa;
+    int Exponent;
+  };
+
+  UnpackedLongDouble Unpack(long double a) {
+    auto Bits = ToBits(a);
+    int Exponent = Bits.SignExponent & 0x7fff;
+    if (Exponent == 0) {
+      const int Shift = __builtin_clzll(Bits.Mantissa);
+      Bits.Mantissa <<= Shift;
+      Exponent = 1 - Shift;
+    }
+    return {Bits.Mantissa, Exponent - EXPONENT_BIAS - 63};
+  }
+
+  int BiasedExponent(long double a) {
+    return ToBits(a).SignExponent & 0x7fff;
+  }
+}
+
+long double fmodl(long double a, long double b) {
+  if (a != a || b != b) {
+    return a + b;
+  }
+  if (__builtin_isinf(a) || b == 0) {
+    errno = EDOM;
+    return (a * b) / (a * b);
+  }
+  if (__builtin_isinf(b) || __builtin_fabsl(a) < __builtin_fabsl(b)) {
+    return a;
+  }
+
+  // Long division of the mantissas where only the remainder is kept, the same as fprem
+  const auto A = Unpack(a);
+  const auto B = Unpack(b);
+  unsigned __int128 Remainder = A.Mantissa % B.Mantissa;
+  for (int Shift = A.Exponent - B.Exponent; Shift > 0;) {
+    const int Step = Shift > 64 ? 64 : Shift;
+    Remainder = (Remainder << Step) % B.Mantissa;
+    Shift -= Step;
+  }
+
+  // The remainder is a multiple of the smaller ulp of a and b and smaller than b, so it is representable
+  return __builtin_copysignl(scalbnl(static_cast<long double>(static_cast<uint64_t>(Remainder)), B.Exponent), a);
+}
+
+long double remquol(long double a, long double b, int *quo) {
+  *quo = 0;
+  if (a != a || b != b) {
+    return a + b;
+  }
+  if (__builtin_isinf(a) || b == 0) {
+    return (a * b) / (a * b);
+  }
+
+  // Same steps as glibc, every subtraction below is exact
+  const bool NegativeQuotient = __builtin_signbit(a) != __builtin_signbit(b);
+  const bool NegativeA = __builtin_signbit(a);
+  const int ExponentB = BiasedExponent(b);
+
+  // Leaves the three low quotient bits to be worked out
+  if (ExponentB <= 0x7ffb) {
+    a = fmodl(a, 8 * b);
+  }
+
+  if (a == b) {
+    *quo = NegativeQuotient ? -1 : 1;
+    return 0.0L * a;
+  }
+
+  a = __builtin_fabsl(a);
+  b = __builtin_fabsl(b);
+  int Quotient = 0;
+
+  if (ExponentB <= 0x7ffc && a >= 4 * b) {
+    a -= 4 * b;
+    Quotient += 4;
+  }
+  if (ExponentB <= 0x7ffd && a >= 2 * b) {
+    a -= 2 * b;
+    Quotient += 2;
+  }
+
+  if (ExponentB < 2) {
+    // Halving b could round
+    if (a + a > b) {
+      a -= b;
+      ++Quotient;
+      if (a + a >= b) {
+        a -= b;
+        ++Quotient;
+      }
+    }
+  }
+  else {
+    const long double HalfB = 0.5L * b;
+    if (a > HalfB) {
+      a -= b;
+      ++Quotient;
+      if (a >= HalfB) {
+        a -= b;
+        ++Quotient;
+      }
+    }
+  }
+
+  *quo = NegativeQuotient ? -Quotient : Quotient;
+  return NegativeA ? -a : a;
+}
+
+long double remainderl(long double a, long double b) {
+  if ((b == 0 && a == a) || (__builtin_isinf(a) && b == b)) {
+    errno = EDOM;
+  }
+
+  int Quotient;
+  return remquol(a, b, &Quotient);
+}
+
+long double sqrtl(long double a) {
+  if (a < 0) {
+    errno = EDOM;
+  }
+
+  // fsqrt is correctly rounded, __builtin_sqrtl would call back in to sqrtl to set errno
+  __asm__("fsqrt" : "+t"(a));
+  return a;
+}
+
+// These split off a power of two so the double thunks only see values in the double range.
+// The results keep the long double range but still only have double precision.
+namespace {
+  constexpr long double DOUBLE_MAX = 0x1.fffffffffffffp1023L;
+  constexpr long double DOUBLE_MIN_NORMAL = 0x1p-1022L;
+
+  constexpr long double LN2 = 0x1.62e42fefa39ef358p-1L;
+  constexpr long double LOG10_2 = 0x1.34413509f79fef32p-2L;
+  // Split so that multiplying the high half by the integer part of the exponent is exact
+  constexpr long double LN2_HI = 0x1.62e42fefa39ep-1L;
+  constexpr long double LN2_LO = 0x1.e6af278ece600fccp-50L;
+  constexpr long double LOG10_2_HI = 0x1.34413509f7ap-2L;
+  constexpr long double LOG10_2_LO = -0x1.0cee0ed4ca7e906ep-54L;
+
+  bool OutsideDoubleRange(long double a) {
+    const long double Abs = __builtin_fabsl(a);
+    return __builtin_isfinite(a) && (Abs > DOUBLE_MAX || (Abs != 0 && Abs < DOUBLE_MIN_NORMAL));
+  }
+
+  // Result * 2^Exponent, reports overflow and underflow like the double functions do
+  long double ScaleResult(double Result, long double Exponent) {
+    const long double Scaled = scalbnl(Result, static_cast<int>(Exponent));
+    if (__builtin_isinf(Scaled) || Scaled == 0) {
+      errno = ERANGE;
+    }
+    return Scaled;
+  }
+}
+
+long double expl(long double a) {
+  if ((a > 709.0L && a < 11400.0L) || (a < -708.0L && a > -11400.0L)) {
+    const long double Exponent = rintl(a / LN2);
+    const long double Reduced = (a - Exponent * LN2_HI) - Exponent * LN2_LO;
+    return ScaleResult(exp(static_cast<double>(Reduced)), Exponent);
+  }
+  return exp(a);
+}
+
+long double exp2l(long double a) {
+  if ((a > 1023.0L && a < 16500.0L) || (a < -1022.0L && a > -16500.0L)) {
+    const long double Exponent = rintl(a);
+    return ScaleResult(exp2(static_cast<double>(a - Exponent)), Exponent);
+  }
+  return exp2(a);
+}
+
+long double exp10l(long double a) {
+  if ((a > 307.0L && a < 5000.0L) || (a < -307.0L && a > -5000.0L)) {
+    const long double Exponent = rintl(a / LOG10_2);
+    const long double Reduced = (a - Exponent * LOG10_2_HI) - Exponent * LOG10_2_LO;
+    return ScaleResult(exp10(static_cast<double>(Reduced)), Exponent);
+  }
+  return exp10(a);
+}
+
+#define LDOUBLE_LOG(name, scale) \
+  long double name##l(long double a) { \
+    if (a < 0) { \
+      /* Negative values past the double range would otherwise turn in to -0 */ \
+      return name(-1.0); \
+    } \
+    if (OutsideDoubleRange(a)) { \
+      int Exponent; \
+      const long double Mantissa = frexpl(a, &Exponent); \
+      return name(static_cast<double>(Mantissa)) + Exponent * (scale); \
+    } \
+    return name(a); \
+  }
+
+LDOUBLE_LOG(log, LN2)
+LDOUBLE_LOG(log2, 1.0L)
+LDOUBLE_LOG(log10, LOG10_2)
+
+#undef LDOUBLE_LOG
+
+long double hypotl(long double a, long double b) {
+  if (__builtin_isinf(a) || __builtin_isinf(b)) {
+    return __builtin_infl();
+  }
+  if (!OutsideDoubleRange(a) && !OutsideDoubleRange(b)) {
+    return hypot(a, b);
+  }
+
+  // Scaling both by the same power of two is exact
+  int ExponentA = 0;
+  int ExponentB = 0;
+  frexpl(a, &ExponentA);
+  frexpl(b, &ExponentB);
+  const int Exponent = ExponentA > ExponentB ? ExponentA : ExponentB;
+  return ScaleResult(hypot(static_cast<double>(scalbnl(a, -Exponent)), static_cast<double>(scalbnl(b, -Exponent))), Exponent);
+}
+
+long double fmaxl(long double a, long double b) {
+  if (a != a) {
+    return b;
+  }
+  if (b != b) {
+    return a;
+  }
+  return a > b ? a : b;
+}
+
+long double fminl(long double a, long double b) {
+  if (a != a) {
+    return b;
+  }
+  if (b != b) {
+    return a;
+  }
+  return a < b ? a : b;
+}
+
+long double fdiml(long double a, long double b) {
+  if (a != a || b != b) {
+    return a + b;
+  }
+  return a > b ? a - b : 0.0L;
+}
+
+long double nextafterl(long double a, long double b) {
+  if (a != a || b != b) {
+    return a + b;
+  }
+  if (a == b) {
+    return b;
+  }
+
+  auto Bits = ToBits(a);
+  int Exponent = Bits.SignExponent & 0x7fff;
+
+  if (a == 0) {
+    // Smallest denormal towards b
+    return FromBits({1, static_cast<uint16_t>(b < 0 ? 0x8000 : 0)});
+  }
+
+  if ((a < b) == (a > 0)) {
+    // Away from zero
+    ++Bits.Mantissa;
+    if (Bits.Mantissa == 0) {
+      Bits.Mantissa = INTEGER_BIT;
+      ++Exponent;
+    }
+    else if (Exponent == 0 && Bits.Mantissa == INTEGER_BIT) {
+      // Denormal became normal
+      Exponent = 1;
+    }
+  }
+  else {
+    // Towards zero
+    if (Bits.Mantissa == INTEGER_BIT && Exponent > 1) {
+      Bits.Mantissa = ~0ULL;
+      --Exponent;
+    }
+    else if (Bits.Mantissa == INTEGER_BIT && Exponent == 1) {
+      Bits.Mantissa = INTEGER_BIT - 1;
+      Exponent = 0;
+    }
+    else {
+      --Bits.Mantissa;
+    }
+  }
+
+  Bits.SignExponent = (Bits.SignExponent & 0x8000) | Exponent;
+  return FromBits(Bits);
+}
+
+long double nexttowardl(long double a, long double b) { return nextafterl(a, b); }
+
+double nexttoward(double a, long double b) {
+  if (a != a || b != b) {
+    return a + b;
+  }
+  if (a == b) {
+    return b;
+  }
+  return nextafter(a, a < b ? __builtin_inf() : -__builtin_inf());
+}
+
+float nexttowardf(float a, long double b) {
+  if (a != a || b != b) {
+    return a + b;
+  }
+  if (a == b) {
+    return b;
+  }
+  return nextafterf(a, a < b ? __builtin_inff() : -__builtin_inff());
+}
+
+// lgamma reports the sign through a global that belongs to the guest
+int signgam;
+extern int __signgam __attribute__((alias("signgam")));
+
+double lgamma(double a) { return lgamma_r(a, &signgam); }
+float lgammaf(float a) { return lgammaf_r(a, &signgam); }
+long double lgammal(long double a) { return lgammal_r(a, &signgam); }
+double gamma(double a) { return lgamma(a); }
+float gammaf(float a) { return lgammaf(a); }
+long double gammal(long double a) { return lgammal(a); }
+
+// Trivial complex functions
+double creal(_Complex double a) { return __real__ a; }
+float crealf(_Complex float a) { return __real__ a; }
+long double creall(_Complex long double a) { return __real__ a; }
+double cimag(_Complex double a) { return __imag__ a; }
+float cimagf(_Complex float a) { return __imag__ a; }
+long double cimagl(_Complex long double a) { return __imag__ a; }
+_Complex double conj(_Complex double a) { return ~a; }
+_Complex float conjf(_Complex float a) { return ~a; }
+_Complex long double conjl(_Complex long double a) { return ~a; }
+
+_Complex double __clog10(_Complex double a) { return clog10(a); }
+_Complex float __clog10f(_Complex float a) { return clog10f(a); }
+_Complex long double __clog10l(_Complex long double a) { return clog10l(a); }
+
+// -ffast-math builds from before glibc 2.31 call these directly
+#define FINITE_1(name) \
+  double __##name##_finite(double a) { return name(a); } \
+  float __##name##f_finite(float a) { return name##f(a); } \
+  long double __##name##l_finite(long double a) { return name##l(a); }
+#define FINITE_2(name) \
+  double __##name##_finite(double a, double b) { return name(a, b); } \
+  float __##name##f_finite(float a, float b) { return name##f(a, b); } \
+  long double __##name##l_finite(long double a, long double b) { return name##l(a, b); }
+
+FINITE_1(acos)
+FINITE_1(acosh)
+FINITE_1(asin)
+FINITE_1(atanh)
+FINITE_1(cosh)
+FINITE_1(exp)
+FINITE_1(exp10)
+FINITE_1(exp2)
+FINITE_1(j0)
+FINITE_1(j1)
+FINITE_1(log)
+FINITE_1(log10)
+FINITE_1(log2)
+FINITE_1(sinh)
+FINITE_1(sqrt)
+FINITE_1(y0)
+FINITE_1(y1)
+FINITE_2(atan2)
+FINITE_2(fmod)
+FINITE_2(hypot)
+FINITE_2(pow)
+FINITE_2(remainder)
+
+#undef FINITE_1
+#undef FINITE_2
+
+double __jn_finite(int n, double a) { return jn(n, a); }
+float __jnf_finite(int n, float a) { return jnf(n, a); }
+long double __jnl_finite(int n, long double a) { return jnl(n, a); }
+double __yn_finite(int n, double a) { return yn(n, a); }
+float __ynf_finite(int n, float a) { return ynf(n, a); }
+long double __ynl_finite(int n, long double a) { return ynl(n, a); }
+double __lgamma_r_finite(double a, int *sign) { return lgamma_r(a, sign); }
+float __lgammaf_r_finite(float a, int *sign) { return lgammaf_r(a, sign); }
+long double __lgammal_r_finite(long double a, int *sign) { return lgammal_r(a, sign); }
+double __gamma_r_finite(double a, int *sign) { return lgamma_r(a, sign); }
+float __gammaf_r_finite(float a, int *sign) { return lgammaf_r(a, sign); }
+long double __gammal_r_finite(long double a, int *sign) { return lgammal_r(a, sign); }
+
+// Classification helpers behind the <math.h> macros
+#define CLASSIFY(suffix, type) \
+  int __fpclassify##suffix(type a) { \
+    return __builtin_fpclassify(FEX_FP_NAN, FEX_FP_INFINITE, FEX_FP_NORMAL, FEX_FP_SUBNORMAL, FEX_FP_ZERO, a); \
+  } \
+  int __signbit##suffix(type a) { return __builtin_signbit(a); } \
+  int __finite##suffix(type a) { return __builtin_isfinite(a); } \
+  int __iseqsig##suffix(type a, type b) { \
+    if (__builtin_isunordered(a, b)) { \
+      errno = EDOM; \
+      feraiseexcept(FE_INVALID); \
+      return 0; \
+    } \
+    return a == b; \
+  }
+
+CLASSIFY(, double)
+CLASSIFY(f, float)
+CLASSIFY(l, long double)
+
+#undef CLASSIFY
+
+int __issignaling(double a) {
+  uint64_t Bits;
+  memcpy(&Bits, &a, sizeof(Bits));
+  return (Bits & 0x7ff0'0000'0000'0000ULL) == 0x7ff0'0000'0000'0000ULL &&
+         (Bits & 0x000f'ffff'ffff'ffffULL) != 0 &&
+         !(Bits & 0x0008'0000'0000'0000ULL);
+}
+
+int __issignalingf(float a) {
+  uint32_t Bits;
+  memcpy(&Bits, &a, sizeof(Bits));
+  return (Bits & 0x7f80'0000U) == 0x7f80'0000U &&
+         (Bits & 0x007f'ffffU) != 0 &&
+         !(Bits & 0x0040'0000U);
+}
+
+int __issignalingl(long double a) {
+  auto Bits = ToBits(a);
+  if ((Bits.SignExponent & 0x7fff) != 0x7fff) {
+    return 0;
+  }
+  // Pseudo-NaNs without the integer bit count as signaling too
+  return !(Bits.Mantissa & INTEGER_BIT) ||
+         (!(Bits.Mantissa & QUIET_BIT) && (Bits.Mantissa & (QUIET_BIT - 1)) != 0);
+}
+
+int __iscanonicall(long double a) {
+  auto Bits = ToBits(a);
+  return (Bits.SignExponent & 0x7fff) == 0 || (Bits.Mantissa & INTEGER_BIT) != 0;
+}
+
+#ifndef _M_ARM_64
+// The floating point environment is guest state, these match glibc's x86_64 implementation
+// Exception masks sit at bits 7-12 of MXCSR and rounding at 13-14, x87 keeps the same values at 0-5 and 10-11
+#define MXCSR_EXCEPTION_SHIFT 7
+#define MXCSR_ROUNDING_SHIFT 3
+
+static unsigned GetMXCSR() {
+  unsigned MXCSR;
+  __asm__ __volatile__ ("stmxcsr %0" : "=m" (MXCSR));
+  return MXCSR;
+}
+
+static void SetMXCSR(unsigned MXCSR) {
+  __asm__ __volatile__ ("ldmxcsr %0" : : "m" (MXCSR));
+}
+
+int feclearexcept(int excepts) {
+  excepts &= FE_ALL_EXCEPT;
+
+  fenv_t Env;
+  __asm__ __volatile__ ("fnstenv %0" : "=m" (Env));
+  Env.__status_word &= ~excepts;
+  __asm__ __volatile__ ("fldenv %0" : : "m" (Env));
+
+  SetMXCSR(GetMXCSR() & ~excepts);
+  return 0;
+}
+
+int fegetexceptflag(fexcept_t *flagp, int excepts) {
+  unsigned short Status;
+  __asm__ __volatile__ ("fnstsw %0" : "=m" (Status));
+  *flagp = (Status | GetMXCSR()) & excepts & FE_ALL_EXCEPT;
+  return 0;
+}
+
+int feraiseexcept(int excepts) {
+  // Raised with real operations so unmasked exceptions trap where the caller expects them to
+  if (excepts & FE_INVALID) {
+    float Value = 0.0f;
+    __asm__ __volatile__ ("divss %0, %0" : "+x" (Value));
+  }
+
+  if (excepts & FE_DIVBYZERO) {
+    float Value = 1.0f;
+    float Zero = 0.0f;
+    __asm__ __volatile__ ("divss %1, %0" : "+x" (Value) : "x" (Zero));
+  }
+
+  const int Remaining = excepts & (FE_OVERFLOW | FE_UNDERFLOW | FE_INEXACT);
+  if (Remaining) {
+    fenv_t Env;
+    __asm__ __volatile__ ("fnstenv %0" : "=m" (Env));
+    Env.__status_word |= Remaining;
+    __asm__ __volatile__ ("fldenv %0; fwait" : : "m" (Env));
+  }
+  return 0;
+}
+
+int fesetexceptflag(const fexcept_t *flagp, int excepts) {
+  excepts &= FE_ALL_EXCEPT;
+
+  fenv_t Env;
+  __asm__ __volatile__ ("fnstenv %0" : "=m" (Env));
+  Env.__status_word = (Env.__status_word & ~excepts) | (*flagp & excepts);
+  __asm__ __volatile__ ("fldenv %0" : : "m" (Env));
+
+  SetMXCSR((GetMXCSR() & ~excepts) | (*flagp & excepts));
+  return 0;
+}
+
+int fetestexcept(int excepts) {
+  unsigned short Status;
+  __asm__ __volatile__ ("fnstsw %0" : "=m" (Status));
+  return (Status | GetMXCSR()) & excepts & FE_ALL_EXCEPT;
+}
+
+int fetestexceptflag(const fexcept_t *flagp, int excepts) {
+  return *flagp & excepts & FE_ALL_EXCEPT;
+}
+
+int fesetexcept(int excepts) {
+  SetMXCSR(GetMXCSR() | (excepts & FE_ALL_EXCEPT));
+  return 0;
+}
+
+int fegetround() {
+  unsigned short Control;
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (Control));
+  return Control & FE_TOWARDZERO;
+}
+
+int fesetround(int round) {
+  if (round & ~FE_TOWARDZERO) {
+    return 1;
+  }
+
+  unsigned short Control;
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (Control));
+  Control = (Control & ~FE_TOWARDZERO) | round;
+  __asm__ __volatile__ ("fldcw %0" : : "m" (Control));
+
+  SetMXCSR((GetMXCSR() & ~(FE_TOWARDZERO << MXCSR_ROUNDING_SHIFT)) | (round << MXCSR_ROUNDING_SHIFT));
+  return 0;
+}
+
+int fegetenv(fenv_t *envp) {
+  // fnstenv masks all exceptions, put the old masks back
+  __asm__ __volatile__ ("fnstenv %0; fldenv %0" : "=m" (*envp));
+  envp->__mxcsr = GetMXCSR();
+  return 0;
+}
+
+int feholdexcept(fenv_t *envp) {
+  __asm__ __volatile__ ("fnstenv %0; fnclex" : "=m" (*envp));
+  envp->__mxcsr = GetMXCSR();
+  SetMXCSR((envp->__mxcsr & ~FE_ALL_EXCEPT) | (FE_ALL_EXCEPT << MXCSR_EXCEPTION_SHIFT));
+  return 0;
+}
+
+int fesetenv(const fenv_t *envp) {
+  fenv_t Env;
+  __asm__ __volatile__ ("fnstenv %0" : "=m" (Env));
+
+  if (envp == FE_DFL_ENV || envp == FE_NOMASK_ENV) {
+    const bool Masked = envp == FE_DFL_ENV;
+    // Extended precision, round to nearest
+    Env.__control_word = (Env.__control_word & ~(FE_ALL_EXCEPT | FE_TOWARDZERO)) | 0x300 | (Masked ? FE_ALL_EXCEPT : 0);
+    Env.__status_word &= ~FE_ALL_EXCEPT;
+    Env.__eip = 0;
+    Env.__cs_selector = 0;
+    Env.__opcode = 0;
+    Env.__data_offset = 0;
+    Env.__data_selector = 0;
+    Env.__mxcsr = Masked ? 0x1f80 : 0;
+  }
+  else {
+    Env = *envp;
+  }
+
+  __asm__ __volatile__ ("fldenv %0" : : "m" (Env));
+  SetMXCSR(Env.__mxcsr);
+  return 0;
+}
+
+int feupdateenv(const fenv_t *envp) {
+  const int Raised = fetestexcept(FE_ALL_EXCEPT);
+  fesetenv(envp);
+  feraiseexcept(Raised);
+  return 0;
+}
+
+int feenableexcept(int excepts) {
+  excepts &= FE_ALL_EXCEPT;
+
+  unsigned short Control;
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (Control));
+  const int Old = ~Control & FE_ALL_EXCEPT;
+  Control &= ~excepts;
+  __asm__ __volatile__ ("fldcw %0" : : "m" (Control));
+
+  SetMXCSR(GetMXCSR() & ~(excepts << MXCSR_EXCEPTION_SHIFT));
+  return Old;
+}
+
+int fedisableexcept(int excepts) {
+  excepts &= FE_ALL_EXCEPT;
+
+  unsigned short Control;
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (Control));
+  const int Old = ~Control & FE_ALL_EXCEPT;
+  Control |= excepts;
+  __asm__ __volatile__ ("fldcw %0" : : "m" (Control));
+
+  SetMXCSR(GetMXCSR() | (excepts << MXCSR_EXCEPTION_SHIFT));
+  return Old;
+}
+
+int fegetexcept() {
+  unsigned short Control;
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (Control));
+  return ~Control & FE_ALL_EXCEPT;
+}
+
+int fegetmode(femode_t *modep) {
+  __asm__ __volatile__ ("fnstcw %0" : "=m" (modep->__control_word));
+  modep->__mxcsr = GetMXCSR();
+  return 0;
+}
+
+int fesetmode(const femode_t *modep) {
+  // Only control bits, the raised exceptions stay as they are
+  constexpr unsigned MXCSR_STATUS = 0x3f;
+  unsigned short Control = 0x37f;
+  unsigned MXCSR = (GetMXCSR() & MXCSR_STATUS) | 0x1f80;
+
+  if (modep != FE_DFL_MODE) {
+    Control = modep->__control_word;
+    MXCSR = (GetMXCSR() & MXCSR_STATUS) | (modep->__mxcsr & ~MXCSR_STATUS);
+  }
+
+  __asm__ __volatile__ ("fldcw %0" : : "m" (Control));
+  SetMXCSR(MXCSR);
+  return 0;
+}
+
+#undef MXCSR_EXCEPTION_SHIFT
+#undef MXCSR_ROUNDING_SHIFT
+#endif
+}
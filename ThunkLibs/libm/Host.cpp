@@ -0,0 +1,122 @@
+/*
+$info$
+tags: thunklibs|m
+desc: libmvec entry points run the host scalar functions on each lane
+$end_info$
+*/
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "common/Host.h"
+#include <dlfcn.h>
+
+#include "Types.h"
+
+#include "ldr_ptrs.inl"
+
+template<typename VecType, typename ScalarFn>
+static VecType MapLanes(ScalarFn *Fn, VecType a) {
+  VecType Result;
+  for (size_t i = 0; i < sizeof(VecType) / sizeof(a[0]); ++i) {
+    Result[i] = Fn(a[i]);
+  }
+  return Result;
+}
+
+template<typename VecType, typename ScalarFn>
+static VecType MapLanes(ScalarFn *Fn, VecType a, VecType b) {
+  VecType Result;
+  for (size_t i = 0; i < sizeof(VecType) / sizeof(a[0]); ++i) {
+    Result[i] = Fn(a[i], b[i]);
+  }
+  return Result;
+}
+
+#define VEC_1(name, type, scalar) \
+  static type fexfn_impl_libm_##name(type a) { return MapLanes(fexldr_ptr_libm_##scalar, a); }
+#define VEC_2(name, type, scalar) \
+  static type fexfn_impl_libm_##name(type a, type b) { return MapLanes(fexldr_ptr_libm_##scalar, a, b); }
+
+VEC_1(_ZGVbN2v_acos, fex_v2f64, acos)
+VEC_1(_ZGVbN2v_acosh, fex_v2f64, acosh)
+VEC_1(_ZGVbN2v_asin, fex_v2f64, asin)
+VEC_1(_ZGVbN2v_asinh, fex_v2f64, asinh)
+VEC_1(_ZGVbN2v_atan, fex_v2f64, atan)
+VEC_1(_ZGVbN2v_atanh, fex_v2f64, atanh)
+VEC_1(_ZGVbN2v_cbrt, fex_v2f64, cbrt)
+VEC_1(_ZGVbN2v_cos, fex_v2f64, cos)
+VEC_1(_ZGVbN2v_cosh, fex_v2f64, cosh)
+VEC_1(_ZGVbN2v_erf, fex_v2f64, erf)
+VEC_1(_ZGVbN2v_erfc, fex_v2f64, erfc)
+VEC_1(_ZGVbN2v_exp, fex_v2f64, exp)
+VEC_1(_ZGVbN2v_exp10, fex_v2f64, exp10)
+VEC_1(_ZGVbN2v_exp2, fex_v2f64, exp2)
+VEC_1(_ZGVbN2v_expm1, fex_v2f64, expm1)
+VEC_1(_ZGVbN2v_log, fex_v2f64, log)
+VEC_1(_ZGVbN2v_log10, fex_v2f64, log10)
+VEC_1(_ZGVbN2v_log1p, fex_v2f64, log1p)
+VEC_1(_ZGVbN2v_log2, fex_v2f64, log2)
+VEC_1(_ZGVbN2v_sin, fex_v2f64, sin)
+VEC_1(_ZGVbN2v_sinh, fex_v2f64, sinh)
+VEC_1(_ZGVbN2v_tan, fex_v2f64, tan)
+VEC_1(_ZGVbN2v_tanh, fex_v2f64, tanh)
+VEC_2(_ZGVbN2vv_atan2, fex_v2f64, atan2)
+VEC_2(_ZGVbN2vv_hypot, fex_v2f64, hypot)
+VEC_2(_ZGVbN2vv_pow, fex_v2f64, pow)
+
+VEC_1(_ZGVbN4v_acosf, fex_v4f32, acosf)
+VEC_1(_ZGVbN4v_acoshf, fex_v4f32, acoshf)
+VEC_1(_ZGVbN4v_asinf, fex_v4f32, asinf)
+VEC_1(_ZGVbN4v_asinhf, fex_v4f32, asinhf)
+VEC_1(_ZGVbN4v_atanf, fex_v4f32, atanf)
+VEC_1(_ZGVbN4v_atanhf, fex_v4f32, atanhf)
+VEC_1(_ZGVbN4v_cbrtf, fex_v4f32, cbrtf)
+VEC_1(_ZGVbN4v_cosf, fex_v4f32, cosf)
+VEC_1(_ZGVbN4v_coshf, fex_v4f32, coshf)
+VEC_1(_ZGVbN4v_erfcf, fex_v4f32, erfcf)
+VEC_1(_ZGVbN4v_erff, fex_v4f32, erff)
+VEC_1(_ZGVbN4v_exp10f, fex_v4f32, exp10f)
+VEC_1(_ZGVbN4v_exp2f, fex_v4f32, exp2f)
+VEC_1(_ZGVbN4v_expf, fex_v4f32, expf)
+VEC_1(_ZGVbN4v_expm1f, fex_v4f32, expm1f)
+VEC_1(_ZGVbN4v_log10f, fex_v4f32, log10f)
+VEC_1(_ZGVbN4v_log1pf, fex_v4f32, log1pf)
+VEC_1(_ZGVbN4v_log2f, fex_v4f32, log2f)
+VEC_1(_ZGVbN4v_logf, fex_v4f32, logf)
+VEC_1(_ZGVbN4v_sinf, fex_v4f32, sinf)
+VEC_1(_ZGVbN4v_sinhf, fex_v4f32, sinhf)
+VEC_1(_ZGVbN4v_tanf, fex_v4f32, tanf)
+VEC_1(_ZGVbN4v_tanhf, fex_v4f32, tanhf)
+VEC_2(_ZGVbN4vv_atan2f, fex_v4f32, atan2f)
+VEC_2(_ZGVbN4vv_hypotf, fex_v4f32, hypotf)
+VEC_2(_ZGVbN4vv_powf, fex_v4f32, powf)
+
+#undef VEC_1
+#undef VEC_2
+
+// Each lane gets its own pair of guest pointers to write to
+static void fexfn_impl_libm__ZGVbN2vvv_sincos(fex_v2f64 a, fex_v2u64 SinPtrs, fex_v2u64 CosPtrs) {
+  for (size_t i = 0; i < 2; ++i) {
+    fexldr_ptr_libm_sincos(a[i], reinterpret_cast<double*>(SinPtrs[i]), reinterpret_cast<double*>(CosPtrs[i]));
+  }
+}
+
+static void fexfn_impl_libm__ZGVbN4vvv_sincosf(fex_v4f32 a, fex_v2u64 SinPtrs01, fex_v2u64 SinPtrs23, fex_v2u64 CosPtrs01, fex_v2u64 CosPtrs23) {
+  const uint64_t SinPtrs[4] = { SinPtrs01[0], SinPtrs01[1], SinPtrs23[0], SinPtrs23[1] };
+  const uint64_t CosPtrs[4] = { CosPtrs01[0], CosPtrs01[1], CosPtrs23[0], CosPtrs23[1] };
+  for (size_t i = 0; i < 4; ++i) {
+    fexldr_ptr_libm_sincosf(a[i], reinterpret_cast<float*>(SinPtrs[i]), reinterpret_cast<float*>(CosPtrs[i]));
+  }
+}
+
+#include "function_unpacks.inl"
+
+static ExportEntry exports[] = {
+    #include "tab_function_unpacks.inl"
+    { nullptr, nullptr }
+};
+
+#include "ldr.inl"
+
+EXPORTS(libm)
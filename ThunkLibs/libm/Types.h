@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+
+// Same layout and calling convention as __m128d, __m128 and __m128i on the guest side,
+// without depending on x86 headers on the host side
+typedef double fex_v2f64 __attribute__((vector_size(16)));
+typedef float fex_v4f32 __attribute__((vector_size(16)));
+typedef uint64_t fex_v2u64 __attribute__((vector_size(16)));
+
+extern "C" {
+// <complex.h> can't be used from C++, these match its declarations
+_Complex double cacos(_Complex double);
+_Complex double cacosh(_Complex double);
+_Complex double casin(_Complex double);
+_Complex double casinh(_Complex double);
+_Complex double catan(_Complex double);
+_Complex double catanh(_Complex double);
+_Complex double ccos(_Complex double);
+_Complex double ccosh(_Complex double);
+_Complex double cexp(_Complex double);
+_Complex double clog(_Complex double);
+_Complex double clog10(_Complex double);
+_Complex double cpow(_Complex double, _Complex double);
+_Complex double cproj(_Complex double);
+_Complex double csin(_Complex double);
+_Complex double csinh(_Complex double);
+_Complex double csqrt(_Complex double);
+_Complex double ctan(_Complex double);
+_Complex double ctanh(_Complex double);
+double cabs(_Complex double);
+double carg(_Complex double);
+
+_Complex float cacosf(_Complex float);
+_Complex float cacoshf(_Complex float);
+_Complex float casinf(_Complex float);
+_Complex float casinhf(_Complex float);
+_Complex float catanf(_Complex float);
+_Complex float catanhf(_Complex float);
+_Complex float ccosf(_Complex float);
+_Complex float ccoshf(_Complex float);
+_Complex float cexpf(_Complex float);
+_Complex float clogf(_Complex float);
+_Complex float clog10f(_Complex float);
+_Complex float cpowf(_Complex float, _Complex float);
+_Complex float cprojf(_Complex float);
+_Complex float csinf(_Complex float);
+_Complex float csinhf(_Complex float);
+_Complex float csqrtf(_Complex float);
+_Complex float ctanf(_Complex float);
+_Complex float ctanhf(_Complex float);
+float cabsf(_Complex float);
+float cargf(_Complex float);
+
+// libmvec SSE entry points, see the x86_64 vector function ABI
+// The vvv variants of sincos take a vector of output pointers for each result
+fex_v2f64 _ZGVbN2v_acos(fex_v2f64);
+fex_v2f64 _ZGVbN2v_acosh(fex_v2f64);
+fex_v2f64 _ZGVbN2v_asin(fex_v2f64);
+fex_v2f64 _ZGVbN2v_asinh(fex_v2f64);
+fex_v2f64 _ZGVbN2v_atan(fex_v2f64);
+fex_v2f64 _ZGVbN2v_atanh(fex_v2f64);
+fex_v2f64 _ZGVbN2v_cbrt(fex_v2f64);
+fex_v2f64 _ZGVbN2v_cos(fex_v2f64);
+fex_v2f64 _ZGVbN2v_cosh(fex_v2f64);
+fex_v2f64 _ZGVbN2v_erf(fex_v2f64);
+fex_v2f64 _ZGVbN2v_erfc(fex_v2f64);
+fex_v2f64 _ZGVbN2v_exp(fex_v2f64);
+fex_v2f64 _ZGVbN2v_exp10(fex_v2f64);
+fex_v2f64 _ZGVbN2v_exp2(fex_v2f64);
+fex_v2f64 _ZGVbN2v_expm1(fex_v2f64);
+fex_v2f64 _ZGVbN2v_log(fex_v2f64);
+fex_v2f64 _ZGVbN2v_log10(fex_v2f64);
+fex_v2f64 _ZGVbN2v_log1p(fex_v2f64);
+fex_v2f64 _ZGVbN2v_log2(fex_v2f64);
+fex_v2f64 _ZGVbN2v_sin(fex_v2f64);
+fex_v2f64 _ZGVbN2v_sinh(fex_v2f64);
+fex_v2f64 _ZGVbN2v_tan(fex_v2f64);
+fex_v2f64 _ZGVbN2v_tanh(fex_v2f64);
+fex_v2f64 _ZGVbN2vv_atan2(fex_v2f64, fex_v2f64);
+fex_v2f64 _ZGVbN2vv_hypot(fex_v2f64, fex_v2f64);
+fex_v2f64 _ZGVbN2vv_pow(fex_v2f64, fex_v2f64);
+void _ZGVbN2vvv_sincos(fex_v2f64, fex_v2u64, fex_v2u64);
+
+fex_v4f32 _ZGVbN4v_acosf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_acoshf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_asinf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_asinhf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_atanf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_atanhf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_cbrtf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_cosf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_coshf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_erfcf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_erff(fex_v4f32);
+fex_v4f32 _ZGVbN4v_exp10f(fex_v4f32);
+fex_v4f32 _ZGVbN4v_exp2f(fex_v4f32);
+fex_v4f32 _ZGVbN4v_expf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_expm1f(fex_v4f32);
+fex_v4f32 _ZGVbN4v_log10f(fex_v4f32);
+fex_v4f32 _ZGVbN4v_log1pf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_log2f(fex_v4f32);
+fex_v4f32 _ZGVbN4v_logf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_sinf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_sinhf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_tanf(fex_v4f32);
+fex_v4f32 _ZGVbN4v_tanhf(fex_v4f32);
+fex_v4f32 _ZGVbN4vv_atan2f(fex_v4f32, fex_v4f32);
+fex_v4f32 _ZGVbN4vv_hypotf(fex_v4f32, fex_v4f32);
+fex_v4f32 _ZGVbN4vv_powf(fex_v4f32, fex_v4f32);
+void _ZGVbN4vvv_sincosf(fex_v4f32, fex_v2u64, fex_v2u64, fex_v2u64, fex_v2u64);
+}
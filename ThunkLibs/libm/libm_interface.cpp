@@ -0,0 +1,244 @@
+#include <common/GeneratorInterface.h>
+
+#include <math.h>
+
+#include "Types.h"
+
+template<auto>
+struct fex_gen_config {
+    unsigned version = 6;
+};
+
+// <math.h> brings in the C++ overloads of the double functions, so these are named by their exact type
+using fex_d_d = double(*)(double);
+using fex_d_dd = double(*)(double, double);
+
+// Functions that report domain or range errors forward the host errno, exact ones like fabs or floor never set it.
+// EDOM and ERANGE have the same values on every Linux architecture.
+
+template<> struct fex_gen_config<(fex_d_d)acos> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)acosh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)asin> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)asinh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)atan> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)atanh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)cbrt> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)ceil> {};
+template<> struct fex_gen_config<(fex_d_d)cos> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)cosh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)erf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)erfc> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)exp> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)exp2> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)expm1> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)fabs> {};
+template<> struct fex_gen_config<(fex_d_d)floor> {};
+template<> struct fex_gen_config<(fex_d_d)log> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)log10> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)log1p> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)log2> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)logb> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)nearbyint> {};
+template<> struct fex_gen_config<(fex_d_d)rint> {};
+template<> struct fex_gen_config<(fex_d_d)round> {};
+template<> struct fex_gen_config<(fex_d_d)sin> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)sinh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)sqrt> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)tan> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)tanh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)tgamma> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_d)trunc> {};
+template<> struct fex_gen_config<(fex_d_dd)atan2> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)copysign> {};
+template<> struct fex_gen_config<(fex_d_dd)fdim> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)fmax> {};
+template<> struct fex_gen_config<(fex_d_dd)fmin> {};
+template<> struct fex_gen_config<(fex_d_dd)fmod> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)hypot> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)nextafter> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)pow> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(fex_d_dd)remainder> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(double(*)(double, double, double))fma> {};
+template<> struct fex_gen_config<(double(*)(double, int*))frexp> {};
+template<> struct fex_gen_config<(int(*)(double))ilogb> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(double(*)(double, int))ldexp> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(long long(*)(double))llrint> {};
+template<> struct fex_gen_config<(long long(*)(double))llround> {};
+template<> struct fex_gen_config<(long(*)(double))lrint> {};
+template<> struct fex_gen_config<(long(*)(double))lround> {};
+template<> struct fex_gen_config<(double(*)(double, double*))modf> {};
+template<> struct fex_gen_config<(double(*)(double, double, int*))remquo> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(double(*)(double, long))scalbln> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<(double(*)(double, int))scalbn> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<exp10> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<j0> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<j1> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<y0> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<y1> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<jn> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<lgamma_r> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<nan> {};
+template<> struct fex_gen_config<sincos> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<yn> : fexgen::forwards_errno {};
+
+template<> struct fex_gen_config<acosf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<acoshf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<asinf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<asinhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<atanf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<atan2f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<atanhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cbrtf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ceilf> {};
+template<> struct fex_gen_config<copysignf> {};
+template<> struct fex_gen_config<cosf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<coshf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<erff> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<erfcf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<expf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<exp10f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<exp2f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<expm1f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<fabsf> {};
+template<> struct fex_gen_config<fdimf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<floorf> {};
+template<> struct fex_gen_config<fmaf> {};
+template<> struct fex_gen_config<fmaxf> {};
+template<> struct fex_gen_config<fminf> {};
+template<> struct fex_gen_config<fmodf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<frexpf> {};
+template<> struct fex_gen_config<hypotf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ilogbf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<j0f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<j1f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<jnf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ldexpf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<llrintf> {};
+template<> struct fex_gen_config<llroundf> {};
+template<> struct fex_gen_config<logf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<log10f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<log1pf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<log2f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<logbf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<lrintf> {};
+template<> struct fex_gen_config<lroundf> {};
+template<> struct fex_gen_config<modff> {};
+template<> struct fex_gen_config<nanf> {};
+template<> struct fex_gen_config<nearbyintf> {};
+template<> struct fex_gen_config<nextafterf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<powf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<remainderf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<remquof> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<rintf> {};
+template<> struct fex_gen_config<roundf> {};
+template<> struct fex_gen_config<scalblnf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<scalbnf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<sinf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<sincosf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<sinhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<sqrtf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<tanf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<tanhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<tgammaf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<truncf> {};
+template<> struct fex_gen_config<y0f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<y1f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ynf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<lgammaf_r> : fexgen::forwards_errno {};
+
+template<> struct fex_gen_config<cabs> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cacos> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cacosh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<carg> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<casin> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<casinh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<catan> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<catanh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ccos> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ccosh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cexp> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<clog> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<clog10> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cpow> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cproj> {};
+template<> struct fex_gen_config<csin> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<csinh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<csqrt> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ctan> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ctanh> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cabsf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cacosf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cacoshf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cargf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<casinf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<casinhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<catanf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<catanhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ccosf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ccoshf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cexpf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<clogf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<clog10f> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cpowf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<cprojf> {};
+template<> struct fex_gen_config<csinf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<csinhf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<csqrtf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ctanf> : fexgen::forwards_errno {};
+template<> struct fex_gen_config<ctanhf> : fexgen::forwards_errno {};
+
+// Host libm doesn't have these, Host.cpp runs the scalar functions on each lane
+template<> struct fex_gen_config<_ZGVbN2v_acos> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_acosh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_asin> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_asinh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_atan> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_atanh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_cbrt> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_cos> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_cosh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_erf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_erfc> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_exp> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_exp10> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_exp2> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_expm1> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_log> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_log10> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_log1p> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_log2> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_sin> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_sinh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_tan> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2v_tanh> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2vv_atan2> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2vv_hypot> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2vv_pow> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN2vvv_sincos> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_acosf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_acoshf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_asinf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_asinhf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_atanf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_atanhf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_cbrtf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_cosf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_coshf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_erfcf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_erff> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_exp10f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_exp2f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_expf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_expm1f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_log10f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_log1pf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_log2f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_logf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_sinf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_sinhf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_tanf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4v_tanhf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4vv_atan2f> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4vv_hypotf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4vv_powf> : fexgen::custom_host_impl {};
+template<> struct fex_gen_config<_ZGVbN4vvv_sincosf> : fexgen::custom_host_impl {};
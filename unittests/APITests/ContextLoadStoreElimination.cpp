@@ -0,0 +1,94 @@
+#include "IRPassFixture.h"
+
+#include <string_view>
+
+namespace {
+// RAX and CF are written in %entry and read back in both successors, which can only be reached from %entry
+constexpr std::string_view SinglePredecessorIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    (%Store1 i64) StoreContext #8, GPR, %X i64, #8
+    (%Flag1 i0) StoreFlag %X, #0
+    %Zero i64 = Constant #0
+    (%jump i0) CondJump %X, %Zero, %left, %right, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%left) CodeBlock %left_begin, %left_end, %ssa1
+    (%left_begin i0) BeginBlock %left
+    %L i64 = LoadContext #8, GPR, #8
+    %LFlag i64 = LoadFlag #0
+    %LSum i64 = Add %L, %LFlag
+    (%Store2 i64) StoreContext #8, GPR, %LSum i64, #0x10
+    (%brk1 i0) Break Halt, #4
+    (%left_end i0) EndBlock %left
+  (%right) CodeBlock %right_begin, %right_end, %ssa1
+    (%right_begin i0) BeginBlock %right
+    %R i64 = LoadContext #8, GPR, #8
+    (%Store3 i64) StoreContext #8, GPR, %R i64, #0x18
+    (%Store4 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%brk2 i0) Break Halt, #4
+    (%right_end i0) EndBlock %right
+)";
+
+// %exit can be reached from both sides of the branch, which store different values
+constexpr std::string_view MergeIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    %Zero i64 = Constant #0
+    (%jump i0) CondJump %X, %Zero, %left, %right, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%left) CodeBlock %left_begin, %left_end, %ssa1
+    (%left_begin i0) BeginBlock %left
+    (%Store1 i64) StoreContext #8, GPR, %X i64, #8
+    (%jump1 i0) Jump %exit
+    (%left_end i0) EndBlock %left
+  (%right) CodeBlock %right_begin, %right_end, %ssa1
+    (%right_begin i0) BeginBlock %right
+    (%Store2 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%jump2 i0) Jump %exit
+    (%right_end i0) EndBlock %right
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    %E i64 = LoadContext #8, GPR, #8
+    (%Store3 i64) StoreContext #8, GPR, %E i64, #0x10
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "ContextLoadStoreElimination - Single predecessor") {
+  auto IR = ParseIR(SinglePredecessorIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateContextLoadStoreElimination(false), IR.get()));
+
+  // Both loads and the flag load read the values stored in %entry
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADCONTEXT) == 0);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADFLAG) == 0);
+
+  // %right overwrites RAX, but %left still needs the store from %entry
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STORECONTEXT) == 4);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STOREFLAG) == 1);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "ContextLoadStoreElimination - SRA registers stay block local") {
+  auto IR = ParseIR(SinglePredecessorIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateContextLoadStoreElimination(true), IR.get()));
+
+  // RAX is statically allocated, only the flag is forwarded
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADCONTEXT) == 2);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADFLAG) == 0);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "ContextLoadStoreElimination - Merge points aren't forwarded") {
+  auto IR = ParseIR(MergeIR);
+
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateContextLoadStoreElimination(false), IR.get()));
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADCONTEXT) == 1);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STORECONTEXT) == 3);
+}
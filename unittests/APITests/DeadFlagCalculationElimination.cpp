@@ -0,0 +1,118 @@
+#include "IRPassFixture.h"
+
+#include <string_view>
+
+namespace {
+// CF and ZF are stored at the end of %entry and overwritten by %next before anything can see them
+constexpr std::string_view OverwrittenIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %One i64 = Constant #1
+    (%Flag1 i0) StoreFlag %One, #0
+    (%Flag2 i0) StoreFlag %One, #6
+    (%jump i0) Jump %next
+    (%entry_end i0) EndBlock %entry
+  (%next) CodeBlock %next_begin, %next_end, %ssa1
+    (%next_begin i0) BeginBlock %next
+    %Zero i64 = Constant #0
+    (%Flag3 i0) StoreFlag %Zero, #0
+    (%Flag4 i0) StoreFlag %Zero, #6
+    (%brk i0) Break Halt, #4
+    (%next_end i0) EndBlock %next
+)";
+
+// Same as above, but the load in %next can fault and expose the flags from %entry
+constexpr std::string_view FaultPointIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %One i64 = Constant #1
+    (%Flag1 i0) StoreFlag %One, #0
+    (%Flag2 i0) StoreFlag %One, #6
+    (%jump i0) Jump %next
+    (%entry_end i0) EndBlock %entry
+  (%next) CodeBlock %next_begin, %next_end, %ssa1
+    (%next_begin i0) BeginBlock %next
+    %Addr i64 = Constant #0x1000000
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    (%Flag3 i0) StoreFlag %X, #0
+    (%Flag4 i0) StoreFlag %X, #6
+    (%brk i0) Break Halt, #4
+    (%next_end i0) EndBlock %next
+)";
+
+// Same again with a division, which raises #DE on a zero divisor
+constexpr std::string_view DivideFaultPointIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %One i64 = Constant #1
+    (%Flag1 i0) StoreFlag %One, #0
+    (%Flag2 i0) StoreFlag %One, #6
+    (%jump i0) Jump %next
+    (%entry_end i0) EndBlock %entry
+  (%next) CodeBlock %next_begin, %next_end, %ssa1
+    (%next_begin i0) BeginBlock %next
+    %Divisor i64 = LoadContext #8, GPR, #8
+    %X i64 = UDiv %One, %Divisor
+    (%Flag3 i0) StoreFlag %X, #0
+    (%Flag4 i0) StoreFlag %X, #6
+    (%brk i0) Break Halt, #4
+    (%next_end i0) EndBlock %next
+)";
+
+// CF is overwritten on one side of the branch but read on the other, ZF is overwritten on both
+constexpr std::string_view BranchIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %One i64 = Constant #1
+    %Zero i64 = Constant #0
+    (%Flag1 i0) StoreFlag %One, #0
+    (%Flag2 i0) StoreFlag %One, #6
+    (%jump i0) CondJump %One, %Zero, %left, %right, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%left) CodeBlock %left_begin, %left_end, %ssa1
+    (%left_begin i0) BeginBlock %left
+    (%Flag3 i0) StoreFlag %Zero, #0
+    (%Flag4 i0) StoreFlag %Zero, #6
+    (%brk1 i0) Break Halt, #4
+    (%left_end i0) EndBlock %left
+  (%right) CodeBlock %right_begin, %right_end, %ssa1
+    (%right_begin i0) BeginBlock %right
+    %CF i64 = LoadFlag #0
+    (%Store1 i64) StoreContext #8, GPR, %CF i64, #8
+    (%Flag5 i0) StoreFlag %Zero, #6
+    (%brk2 i0) Break Halt, #4
+    (%right_end i0) EndBlock %right
+)";
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "DeadFlagCalculationElimination - Overwritten in successor") {
+  auto IR = ParseIR(OverwrittenIR);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STOREFLAG) == 4);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateDeadFlagCalculationEliminination(), IR.get()));
+
+  // Only the stores reaching the Break survive
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STOREFLAG) == 2);
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateDeadFlagCalculationEliminination(), IR.get()));
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "DeadFlagCalculationElimination - Fault points observe flags") {
+  auto IR = ParseIR(GENERATE(FaultPointIR, DivideFaultPointIR));
+
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateDeadFlagCalculationEliminination(), IR.get()));
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STOREFLAG) == 4);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "DeadFlagCalculationElimination - Live on one path") {
+  auto IR = ParseIR(BranchIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateDeadFlagCalculationEliminination(), IR.get()));
+
+  // ZF from %entry is dead on both paths, CF is read by %right
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_STOREFLAG) == 4);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADFLAG) == 1);
+}
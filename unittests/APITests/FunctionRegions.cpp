@@ -0,0 +1,156 @@
+#include <catch2/catch.hpp>
+
+#include "Interface/Core/Frontend.h"
+#include "Interface/Core/LookupCache.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/Config/Config.h>
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Core/CPUBackend.h>
+#include <FEXCore/Debug/InternalThreadState.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+namespace {
+constexpr uint64_t GUEST_BASE = 0x10000;
+
+// func: 0x00 - 0x10, next: 0x10 - 0x11
+constexpr std::array<uint8_t, 0x11> Code = {
+  0x31, 0xC0,       // 0x00: xor eax, eax
+  0x83, 0xC0, 0x02, // 0x02: .loop: add eax, 2
+  0xFF, 0xC9,       // 0x05: dec ecx
+  0x75, 0xF9,       // 0x07: jnz .loop
+  0x85, 0xC0,       // 0x09: test eax, eax
+  0x74, 0x03,       // 0x0B: jz next
+  0xC3,             // 0x0D: ret
+  0xCC, 0xCC,       // 0x0E: int3 padding
+  0xC3,             // 0x10: next: ret
+};
+
+constexpr uint64_t FUNC_START = GUEST_BASE;
+constexpr uint64_t FUNC_END = GUEST_BASE + 0x10;
+constexpr uint64_t NEXT_START = FUNC_END;
+constexpr uint64_t SECTION_END = GUEST_BASE + Code.size();
+
+struct FunctionRegionFixture {
+  FunctionRegionFixture() {
+    FEXCore::Config::Initialize();
+    FEXCore::Config::Load();
+    FEXCore::Config::Set(FEXCore::Config::CONFIG_IS64BIT_MODE, "1");
+    FEXCore::Context::InitializeStaticTables(FEXCore::Context::MODE_64BIT);
+    CTX = FEXCore::Context::CreateNewContext();
+    Thread.CTX = CTX;
+
+    // Decoding reads past the last instruction while looking for prefixes
+    Memory.fill(0xCC);
+    std::copy(Code.begin(), Code.end(), Memory.begin());
+  }
+
+  ~FunctionRegionFixture() {
+    Thread.FrontendDecoder.reset();
+    Thread.OpDispatcher.reset();
+    FEXCore::Context::DestroyContext(CTX);
+    FEXCore::Context::ShutdownStaticTables();
+    FEXCore::Config::Shutdown();
+  }
+
+  // Same as the AOT generator, the thread is set up through ConfigureAOTGen before decoding
+  void Decode(uint64_t Entry, std::map<uint64_t, uint64_t> const *Functions, bool Multiblock = true) {
+    ExternalBranches.clear();
+    FEXCore::Context::ConfigureAOTGen(&Thread, &ExternalBranches, SECTION_END, Functions);
+    Thread.FrontendDecoder->DecodeInstructionsAtEntry(&Memory[Entry - GUEST_BASE], Entry, {.Multiblock = Multiblock});
+  }
+
+  std::vector<uint64_t> BlockEntries() const {
+    std::vector<uint64_t> Entries;
+    for (auto &Block : *Thread.FrontendDecoder->GetDecodedBlocks()) {
+      Entries.emplace_back(Block.Entry);
+    }
+    return Entries;
+  }
+
+  FEXCore::Context::Context *CTX;
+  // Like a thread fresh out of CreateThread, without a frontend
+  FEXCore::Core::InternalThreadState Thread{};
+  std::set<uint64_t> ExternalBranches;
+  std::array<uint8_t, 0x40> Memory;
+};
+}
+
+TEST_CASE_METHOD(FunctionRegionFixture, "FunctionRegions - ConfigureAOTGen creates the frontend") {
+  REQUIRE(!Thread.FrontendDecoder);
+
+  FEXCore::Context::ConfigureAOTGen(&Thread, &ExternalBranches, SECTION_END);
+  REQUIRE(Thread.FrontendDecoder);
+  REQUIRE(Thread.OpDispatcher);
+
+  // Configuring again keeps the existing frontend
+  auto *Decoder = Thread.FrontendDecoder.get();
+  FEXCore::Context::ConfigureAOTGen(&Thread, &ExternalBranches, SECTION_END);
+  CHECK(Thread.FrontendDecoder.get() == Decoder);
+}
+
+TEST_CASE_METHOD(FunctionRegionFixture, "FunctionRegions - Function spanning several blocks") {
+  const std::map<uint64_t, uint64_t> Functions = {
+    {FUNC_START, FUNC_END},
+    {NEXT_START, SECTION_END},
+  };
+
+  // Entering in the middle of the loop pulls in the loop header before the entry, the entry stays first
+  Decode(GUEST_BASE + 0x05, &Functions);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x05, GUEST_BASE + 0x02, GUEST_BASE + 0x09});
+
+  // The branch to the next function ends the region
+  CHECK(ExternalBranches.contains(NEXT_START));
+  CHECK(!ExternalBranches.contains(GUEST_BASE + 0x02));
+}
+
+TEST_CASE_METHOD(FunctionRegionFixture, "FunctionRegions - Branches leaving the function") {
+  const std::map<uint64_t, uint64_t> Functions = {
+    {FUNC_START, FUNC_END},
+    {NEXT_START, SECTION_END},
+  };
+
+  Decode(GUEST_BASE + 0x09, &Functions);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x09});
+  CHECK(ExternalBranches.contains(NEXT_START));
+
+  // Without symbols anything up to the end of the section is fair game
+  Decode(GUEST_BASE + 0x09, nullptr);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x09, GUEST_BASE + 0x0D, NEXT_START});
+  CHECK(!ExternalBranches.contains(NEXT_START));
+}
+
+TEST_CASE_METHOD(FunctionRegionFixture, "FunctionRegions - No symbols") {
+  // Code before the entry is unknown without a symbol
+  Decode(GUEST_BASE + 0x05, nullptr);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x05});
+  CHECK(ExternalBranches.contains(GUEST_BASE + 0x02));
+
+  // Same when the entry isn't covered by any of the symbols
+  const std::map<uint64_t, uint64_t> Functions = {
+    {NEXT_START, SECTION_END},
+  };
+
+  Decode(GUEST_BASE + 0x05, &Functions);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x05});
+  CHECK(ExternalBranches.contains(GUEST_BASE + 0x02));
+}
+
+TEST_CASE_METHOD(FunctionRegionFixture, "FunctionRegions - Single block decoding ignores symbols") {
+  const std::map<uint64_t, uint64_t> Functions = {
+    {FUNC_START, FUNC_END},
+  };
+
+  Decode(GUEST_BASE + 0x05, &Functions, false);
+  CHECK(BlockEntries() == std::vector<uint64_t>{GUEST_BASE + 0x05});
+  CHECK(ExternalBranches.contains(GUEST_BASE + 0x02));
+  CHECK(ExternalBranches.contains(GUEST_BASE + 0x09));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <catch2/catch.hpp>
+
+#include "Interface/IR/PassManager.h"
+#include "Interface/IR/Passes.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+#include <FEXCore/Utils/ThreadPoolAllocator.h>
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace APITests {
+// Common helpers for tests that run a single IR pass over textual IR
+struct IRPassFixture {
+  // Returns if the pass changed the IR
+  static bool RunPass(std::unique_ptr<FEXCore::IR::Pass> Pass, FEXCore::IR::IREmitter *IREmit) {
+    return Pass->Run(IREmit);
+  }
+
+  std::unique_ptr<FEXCore::IR::IREmitter> ParseIR(std::string_view Text) {
+    std::stringstream Stream {std::string(Text)};
+    auto IR = FEXCore::IR::Parse(Allocator, &Stream);
+    REQUIRE(IR);
+    return IR;
+  }
+
+  static size_t CountOps(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::IROps Op) {
+    auto CurrentIR = IREmit->ViewIR();
+    size_t Count{};
+    for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+      for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+        Count += IROp->Op == Op;
+      }
+    }
+    return Count;
+  }
+
+  // Counts the ops in the Nth block in IR order
+  static size_t CountOpsInBlock(FEXCore::IR::IREmitter *IREmit, size_t Block, FEXCore::IR::IROps Op) {
+    auto CurrentIR = IREmit->ViewIR();
+    size_t Index{};
+    size_t Count{};
+    for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+      if (Index++ != Block) {
+        continue;
+      }
+
+      for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+        Count += IROp->Op == Op;
+      }
+    }
+    return Count;
+  }
+
+  FEXCore::Utils::PooledAllocatorMalloc Allocator;
+};
+}
@@ -0,0 +1,278 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include <catch2/catch.hpp>
+
+#include "Interface/Core/LookupCache.h"
+
+#include <FEXCore/Config/Config.h>
+#include <FEXCore/Core/Context.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace {
+constexpr uint64_t GUEST_BASE = 0x10000;
+constexpr size_t NUM_BLOCKS = 1024;
+constexpr size_t NUM_LINKS = 8;
+
+// Spacing guest blocks by the L1 size makes all of them collide in the same L1 entry
+constexpr uint64_t L1_COLLIDING_STRIDE = FEXCore::LookupCache::L1_ENTRIES;
+
+constexpr uint64_t FAKE_LINKER = 0x4141'4141'4141'4141ULL;
+
+struct LookupCacheFixture {
+  LookupCacheFixture() {
+    FEXCore::Config::Initialize();
+    FEXCore::Config::Load();
+    CTX = FEXCore::Context::CreateNewContext();
+    Cache = std::make_unique<FEXCore::LookupCache>(CTX);
+  }
+
+  ~LookupCacheFixture() {
+    Cache.reset();
+    FEXCore::Context::DestroyContext(CTX);
+    FEXCore::Config::Shutdown();
+  }
+
+  // The lookup cache never dereferences host code, so any unique value works
+  static void *HostCodeFor(uint64_t Index) {
+    return reinterpret_cast<void*>(0x8000'0000ULL + Index * 0x100);
+  }
+
+  void MapBlocks(uint64_t Stride) {
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+      const uint64_t Guest = GUEST_BASE + i * Stride;
+      Cache->AddBlockMapping(Guest, HostCodeFor(i), Guest, 0x10);
+    }
+  }
+
+  void EraseBlocks(uint64_t Stride) {
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+      Cache->Erase(GUEST_BASE + i * Stride);
+    }
+  }
+
+  // Erase leaves CodePages alone, guest code invalidation drops the pages instead.
+  // Benchmarks that keep mapping blocks do the same so CodePages doesn't grow with every iteration.
+  void DropCodePages() {
+    std::lock_guard<std::recursive_mutex> lk(Cache->WriteLock);
+    Cache->CodePages.clear();
+  }
+
+  FEXCore::Context::Context *CTX;
+  std::unique_ptr<FEXCore::LookupCache> Cache;
+};
+
+// Link records in these tests point at plain memory instead of JIT code
+void DelinkRecord(FEXCore::LookupCache::BlockLinkRecord const &Record) {
+  *reinterpret_cast<uint64_t*>(Record.HostLink) = Record.DelinkerData;
+}
+
+FEXCore::LookupCache::BlockLinkRecord LinkRecordFor(uint64_t *Link) {
+  return FEXCore::LookupCache::BlockLinkRecord {
+    .HostLink = reinterpret_cast<uintptr_t>(Link),
+    .DelinkerData = FAKE_LINKER,
+    .Delinker = DelinkRecord,
+  };
+}
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - Find") {
+  MapBlocks(L1_COLLIDING_STRIDE);
+
+  for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+    REQUIRE(Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE) == reinterpret_cast<uintptr_t>(HostCodeFor(i)));
+  }
+
+  REQUIRE(Cache->FindBlock(GUEST_BASE + 1) == 0);
+
+  EraseBlocks(L1_COLLIDING_STRIDE);
+
+  for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+    REQUIRE(Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE) == 0);
+  }
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - Erase severs links") {
+  MapBlocks(0x100);
+
+  std::array<uint64_t, NUM_LINKS> LinksToFirst{};
+  std::array<uint64_t, NUM_LINKS> LinksToSecond{};
+  for (size_t i = 0; i < NUM_LINKS; ++i) {
+    Cache->AddBlockLink(GUEST_BASE, LinkRecordFor(&LinksToFirst[i]));
+    Cache->AddBlockLink(GUEST_BASE + 0x100, LinkRecordFor(&LinksToSecond[i]));
+  }
+
+  Cache->Erase(GUEST_BASE);
+
+  for (size_t i = 0; i < NUM_LINKS; ++i) {
+    CHECK(LinksToFirst[i] == FAKE_LINKER);
+    CHECK(LinksToSecond[i] == 0);
+  }
+
+  // Links are only severed once
+  LinksToFirst = {};
+  Cache->Erase(GUEST_BASE);
+  for (size_t i = 0; i < NUM_LINKS; ++i) {
+    CHECK(LinksToFirst[i] == 0);
+  }
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - EraseHostCodeRange") {
+  MapBlocks(0x100);
+
+  // First half of the blocks live in the evicted host range
+  const auto HostStart = reinterpret_cast<uintptr_t>(HostCodeFor(0));
+  const auto HostEnd = reinterpret_cast<uintptr_t>(HostCodeFor(NUM_BLOCKS / 2));
+
+  // A link from surviving code in to an evicted block, and a link inside of evicted code to a surviving block
+  uint64_t SurvivorLink{};
+  Cache->AddBlockLink(GUEST_BASE, LinkRecordFor(&SurvivorLink));
+  Cache->AddBlockLink(GUEST_BASE + (NUM_BLOCKS - 1) * 0x100, FEXCore::LookupCache::BlockLinkRecord {
+    .HostLink = HostStart,
+    .DelinkerData = FAKE_LINKER,
+    .Delinker = [](FEXCore::LookupCache::BlockLinkRecord const &) {
+      FAIL("Delinker for a link inside evicted code must not run");
+    },
+  });
+
+  Cache->EraseHostCodeRange(HostStart, HostEnd);
+
+  for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+    const auto Expected = i < (NUM_BLOCKS / 2) ? 0 : reinterpret_cast<uintptr_t>(HostCodeFor(i));
+    REQUIRE(Cache->FindBlock(GUEST_BASE + i * 0x100) == Expected);
+  }
+
+  CHECK(SurvivorLink == FAKE_LINKER);
+
+  // The dropped link must not fire when its destination goes away
+  Cache->Erase(GUEST_BASE + (NUM_BLOCKS - 1) * 0x100);
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - L2 page eviction") {
+  // More guest pages than there is L2 backing for, and every block collides in L1 so lookups go through L2
+  constexpr size_t NUM_PAGES = 4096;
+  for (size_t i = 0; i < NUM_PAGES; ++i) {
+    const uint64_t Guest = GUEST_BASE + i * L1_COLLIDING_STRIDE;
+    Cache->AddBlockMapping(Guest, HostCodeFor(i), Guest, 0x10);
+  }
+
+  // The second pass looks up pages whose backing got taken over during the first one
+  for (size_t Pass = 0; Pass < 2; ++Pass) {
+    for (size_t i = 0; i < NUM_PAGES; ++i) {
+      REQUIRE(Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE) == reinterpret_cast<uintptr_t>(HostCodeFor(i)));
+    }
+  }
+
+  // An erased block must not come back through a reused backing
+  Cache->Erase(GUEST_BASE);
+  for (size_t i = 1; i < NUM_PAGES; ++i) {
+    REQUIRE(Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE) == reinterpret_cast<uintptr_t>(HostCodeFor(i)));
+  }
+  CHECK(Cache->FindBlock(GUEST_BASE) == 0);
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - Indirect branch cache") {
+  using IndirectBranchCache = FEXCore::LookupCache::IndirectBranchCache;
+  constexpr int64_t MissOffset = -16;
+  constexpr size_t NUM_ENTRIES = IndirectBranchCache::NUM_ENTRIES;
+
+  MapBlocks(0x100);
+
+  // Same initial state that the JITs emit
+  IndirectBranchCache Table{};
+  Table.MissOffset = MissOffset;
+  Table.EmptyEntries = NUM_ENTRIES;
+  for (auto &Entry : Table.Entries) {
+    Entry = {0, MissOffset};
+  }
+
+  const auto TableBase = reinterpret_cast<uintptr_t>(&Table);
+  auto TargetOf = [TableBase](FEXCore::LookupCache::IndirectBranchCacheEntry const &Entry) {
+    return TableBase + Entry.HostOffset;
+  };
+
+  for (size_t i = 0; i < NUM_ENTRIES; ++i) {
+    REQUIRE(Cache->LinkIndirectBranchCache(&Table, GUEST_BASE + i * 0x100) == reinterpret_cast<uintptr_t>(HostCodeFor(i)));
+    CHECK(Table.Entries[i].GuestRIP == GUEST_BASE + i * 0x100);
+    CHECK(TargetOf(Table.Entries[i]) == reinterpret_cast<uintptr_t>(HostCodeFor(i)));
+  }
+  CHECK(Table.EmptyEntries == 0);
+
+  // A full table still resolves the target but doesn't replace anything
+  REQUIRE(Cache->LinkIndirectBranchCache(&Table, GUEST_BASE + NUM_ENTRIES * 0x100) == reinterpret_cast<uintptr_t>(HostCodeFor(NUM_ENTRIES)));
+  CHECK(Table.Entries[0].GuestRIP == GUEST_BASE);
+
+  // Targets that aren't compiled leave the table alone
+  REQUIRE(Cache->LinkIndirectBranchCache(&Table, GUEST_BASE + 1) == 0);
+
+  // Erasing a target resets its entry back to the miss path
+  Cache->Erase(GUEST_BASE);
+  CHECK(Table.Entries[0].GuestRIP == 0);
+  CHECK(Table.Entries[0].HostOffset == MissOffset);
+  CHECK(Table.EmptyEntries == 1);
+
+  // Which can then be filled again
+  REQUIRE(Cache->LinkIndirectBranchCache(&Table, GUEST_BASE + NUM_ENTRIES * 0x100) == reinterpret_cast<uintptr_t>(HostCodeFor(NUM_ENTRIES)));
+  CHECK(Table.Entries[0].GuestRIP == GUEST_BASE + NUM_ENTRIES * 0x100);
+  CHECK(Table.EmptyEntries == 0);
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - Cross thread erase") {
+  MapBlocks(L1_COLLIDING_STRIDE);
+
+  // Invalidation is the only operation that is allowed to come from another thread
+  std::thread Invalidator([this] {
+    EraseBlocks(L1_COLLIDING_STRIDE);
+  });
+
+  // Lookups racing with the erase either see the block or nothing, never a torn entry
+  bool Torn = false;
+  for (size_t Pass = 0; Pass < 64; ++Pass) {
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+      const auto Result = Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE);
+      Torn |= Result != 0 && Result != reinterpret_cast<uintptr_t>(HostCodeFor(i));
+    }
+  }
+
+  Invalidator.join();
+  CHECK(!Torn);
+
+  // Nothing may be left behind in L1 once the erase is done
+  for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+    REQUIRE(Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE) == 0);
+  }
+}
+
+TEST_CASE_METHOD(LookupCacheFixture, "LookupCache - Benchmark") {
+  BENCHMARK("Insert and erase") {
+    MapBlocks(0x100);
+    EraseBlocks(0x100);
+    DropCodePages();
+  };
+
+  MapBlocks(L1_COLLIDING_STRIDE);
+  BENCHMARK("Lookup with L1 misses") {
+    uintptr_t Result{};
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+      Result ^= Cache->FindBlock(GUEST_BASE + i * L1_COLLIDING_STRIDE);
+    }
+    return Result;
+  };
+  EraseBlocks(L1_COLLIDING_STRIDE);
+
+  std::array<uint64_t, NUM_LINKS> Links{};
+  BENCHMARK("Link and sever") {
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+      const uint64_t Guest = GUEST_BASE + i * 0x100;
+      Cache->AddBlockMapping(Guest, HostCodeFor(i), Guest, 0x10);
+      for (auto &Link : Links) {
+        Cache->AddBlockLink(Guest, LinkRecordFor(&Link));
+      }
+      Cache->Erase(Guest);
+    }
+    DropCodePages();
+    return Links[0];
+  };
+}
@@ -0,0 +1,173 @@
+#include "IRPassFixture.h"
+
+#include <string_view>
+
+namespace {
+// RAX is the loop counter, RBX is never written in the loop
+constexpr std::string_view InvariantIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Zero i64 = Constant #0
+    (%Store1 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%jump1 i0) Jump %loop
+    (%entry_end i0) EndBlock %entry
+  (%loop) CodeBlock %loop_begin, %loop_end, %ssa1
+    (%loop_begin i0) BeginBlock %loop
+    %Base i64 = LoadContext #8, GPR, #0x10
+    %Count i64 = LoadContext #8, GPR, #8
+    %Disp i64 = Constant #0x100
+    %Addr1 i64 = Add %Count, %Disp
+    %Addr i64 = Add %Addr1, %Base
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    (%Store2 i64) StoreContext #8, GPR, %X i64, #0x18
+    %One i64 = Constant #1
+    %Next i64 = Add %Count, %One
+    (%Store3 i64) StoreContext #8, GPR, %Next i64, #8
+    %Ten i64 = Constant #10
+    (%jump2 i0) CondJump %Next, %Ten, %loop, %exit, NEQ, #8
+    (%loop_end i0) EndBlock %loop
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+
+// Same loop, but the base register is written every iteration
+constexpr std::string_view VariantIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Zero i64 = Constant #0
+    (%Store1 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%jump1 i0) Jump %loop
+    (%entry_end i0) EndBlock %entry
+  (%loop) CodeBlock %loop_begin, %loop_end, %ssa1
+    (%loop_begin i0) BeginBlock %loop
+    %Base i64 = LoadContext #8, GPR, #0x10
+    %Count i64 = LoadContext #8, GPR, #8
+    %Addr i64 = Add %Count, %Base
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    (%Store2 i64) StoreContext #8, GPR, %X i64, #0x10
+    %One i64 = Constant #1
+    %Next i64 = Add %Count, %One
+    (%Store3 i64) StoreContext #8, GPR, %Next i64, #8
+    %Ten i64 = Constant #10
+    (%jump2 i0) CondJump %Next, %Ten, %loop, %exit, NEQ, #8
+    (%loop_end i0) EndBlock %loop
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+
+// Both division operands are invariant, but the division traps when the divisor is zero
+constexpr std::string_view DivisionIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Zero i64 = Constant #0
+    (%Store1 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%jump1 i0) Jump %loop
+    (%entry_end i0) EndBlock %entry
+  (%loop) CodeBlock %loop_begin, %loop_end, %ssa1
+    (%loop_begin i0) BeginBlock %loop
+    %Dividend i64 = LoadContext #8, GPR, #0x10
+    %Divisor i64 = LoadContext #8, GPR, #0x20
+    %Count i64 = LoadContext #8, GPR, #8
+    %Quotient i64 = UDiv %Dividend, %Divisor
+    (%Store2 i64) StoreContext #8, GPR, %Quotient i64, #0x18
+    %One i64 = Constant #1
+    %Next i64 = Add %Count, %One
+    (%Store3 i64) StoreContext #8, GPR, %Next i64, #8
+    %Ten i64 = Constant #10
+    (%jump2 i0) CondJump %Next, %Ten, %loop, %exit, NEQ, #8
+    (%loop_end i0) EndBlock %loop
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+
+// The loop header is entered from both sides of a branch, so there is no block to hoist in to
+constexpr std::string_view NoPreheaderIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Zero i64 = Constant #0
+    %Y i64 = LoadContext #8, GPR, #0x20
+    (%jump1 i0) CondJump %Y, %Zero, %left, %loop, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%left) CodeBlock %left_begin, %left_end, %ssa1
+    (%left_begin i0) BeginBlock %left
+    (%Store1 i64) StoreContext #8, GPR, %Zero i64, #8
+    (%jump2 i0) Jump %loop
+    (%left_end i0) EndBlock %left
+  (%loop) CodeBlock %loop_begin, %loop_end, %ssa1
+    (%loop_begin i0) BeginBlock %loop
+    %Base i64 = LoadContext #8, GPR, #0x10
+    %Count i64 = LoadContext #8, GPR, #8
+    %Addr i64 = Add %Count, %Base
+    (%Store2 i64) StoreContext #8, GPR, %Addr i64, #0x18
+    %One i64 = Constant #1
+    %Next i64 = Add %Count, %One
+    (%Store3 i64) StoreContext #8, GPR, %Next i64, #8
+    %Ten i64 = Constant #10
+    (%jump3 i0) CondJump %Next, %Ten, %loop, %exit, NEQ, #8
+    (%loop_end i0) EndBlock %loop
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "LoopInvariantCodeMotion - Invariant loads and address math") {
+  auto IR = ParseIR(InvariantIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateLoopInvariantCodeMotion(false), IR.get()));
+
+  // RBX is loaded once, and the displacement is added to it before the loop
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_LOADCONTEXT) == 1);
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_ADD) == 1);
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_CONSTANT) == 2);
+
+  // Only the counter load, the address add and the increment stay
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_LOADCONTEXT) == 1);
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_ADD) == 2);
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_CONSTANT) == 2);
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_LOADMEM) == 1);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "LoopInvariantCodeMotion - SRA registers aren't hoisted") {
+  auto IR = ParseIR(InvariantIR);
+
+  // Statically allocated registers are already in host registers, so the address math depends on a loop value
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateLoopInvariantCodeMotion(true), IR.get()));
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_LOADCONTEXT) == 0);
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_LOADCONTEXT) == 2);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "LoopInvariantCodeMotion - Context written in the loop") {
+  auto IR = ParseIR(VariantIR);
+
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateLoopInvariantCodeMotion(false), IR.get()));
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_LOADCONTEXT) == 2);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "LoopInvariantCodeMotion - Loops without a preheader") {
+  auto IR = ParseIR(NoPreheaderIR);
+
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateLoopInvariantCodeMotion(false), IR.get()));
+  CHECK(CountOpsInBlock(IR.get(), 2, FEXCore::IR::OP_LOADCONTEXT) == 2);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "LoopInvariantCodeMotion - Divisions stay in the loop") {
+  auto IR = ParseIR(DivisionIR);
+
+  // The operands are hoisted, the division itself would trap in the preheader if the loop guarded it
+  REQUIRE(RunPass(FEXCore::IR::CreateLoopInvariantCodeMotion(false), IR.get()));
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_LOADCONTEXT) == 2);
+  CHECK(CountOpsInBlock(IR.get(), 0, FEXCore::IR::OP_UDIV) == 0);
+  CHECK(CountOpsInBlock(IR.get(), 1, FEXCore::IR::OP_UDIV) == 1);
+}
@@ -0,0 +1,112 @@
+#include "IRPassFixture.h"
+
+#include <string_view>
+
+namespace {
+// Same IR as unittests/IR/Correctness/ValueNumbering.ir, which checks the results at runtime
+constexpr std::string_view MultiblockIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %AddrX i64 = Constant #0x1000000
+    %AddrY i64 = Constant #0x1000008
+    %X i64 = LoadMem GPR, #8, %AddrX i64, %Invalid, #8, SXTX, #1
+    %Y i64 = LoadMem GPR, #8, %AddrY i64, %Invalid, #8, SXTX, #1
+    %Four i64 = Constant #4
+    %FourAgain i64 = Constant #4
+    %A1 i64 = Add %X, %Y
+    %A2 i64 = Add %X, %Y
+    %S1 i64 = Lshl %A1, %Four
+    %S2 i64 = Lshl %A2, %FourAgain
+    (%Store1 i64) StoreContext #8, GPR, %S1 i64, #8
+    (%Store2 i64) StoreContext #8, GPR, %S2 i64, #0x10
+    %E1 i64 = Sbfe #0x8, #0x0, %X
+    %E2 i64 = Sbfe #0x8, #0x0, %X
+    %E3 i64 = Sbfe #0x8, #0x4, %X
+    %ESum i64 = Add %E1, %E2
+    (%Store3 i64) StoreContext #8, GPR, %ESum i64, #0x18
+    (%Store4 i64) StoreContext #8, GPR, %E3 i64, #0x28
+    %One i64 = Constant #1
+    %YPlusOne i64 = Add %Y, %One
+    (%Store5 i64) StoreMem GPR, #8, %YPlusOne i64, %AddrY i64, %Invalid, #8, SXTX, #1
+    %Y2 i64 = LoadMem GPR, #8, %AddrY i64, %Invalid, #8, SXTX, #1
+    %A3 i64 = Add %X, %Y2
+    (%Store6 i64) StoreContext #8, GPR, %A3 i64, #0x30
+    %Zero i64 = Constant #0
+    (%jump i0) CondJump %X, %Zero, %taken, %not_taken, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%taken) CodeBlock %taken_begin, %taken_end, %ssa1
+    (%taken_begin i0) BeginBlock %taken
+    %A4 i64 = Add %X, %Y
+    %S4 i64 = Lshl %A4, %Four
+    (%Store7 i64) StoreContext #8, GPR, %S4 i64, #0x20
+    (%brk1 i0) Break Halt, #4
+    (%taken_end i0) EndBlock %taken
+  (%not_taken) CodeBlock %not_taken_begin, %not_taken_end, %ssa1
+    (%not_taken_begin i0) BeginBlock %not_taken
+    (%Store8 i64) StoreContext #8, GPR, %Zero i64, #0x20
+    (%brk2 i0) Break Halt, #4
+    (%not_taken_end i0) EndBlock %not_taken
+)";
+
+// Both sides of the branch compute the same value, neither dominates the other
+constexpr std::string_view SiblingIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %X i64 = LoadMem GPR, #8, %Addr i64, %Invalid, #8, SXTX, #1
+    %Zero i64 = Constant #0
+    (%jump i0) CondJump %X, %Zero, %left, %right, NEQ, #8
+    (%entry_end i0) EndBlock %entry
+  (%left) CodeBlock %left_begin, %left_end, %ssa1
+    (%left_begin i0) BeginBlock %left
+    %L i64 = Add %X, %X
+    (%Store1 i64) StoreContext #8, GPR, %L i64, #8
+    (%jump1 i0) Jump %exit
+    (%left_end i0) EndBlock %left
+  (%right) CodeBlock %right_begin, %right_end, %ssa1
+    (%right_begin i0) BeginBlock %right
+    %R i64 = Add %X, %X
+    (%Store2 i64) StoreContext #8, GPR, %R i64, #8
+    (%jump2 i0) Jump %exit
+    (%right_end i0) EndBlock %right
+  (%exit) CodeBlock %exit_begin, %exit_end, %ssa1
+    (%exit_begin i0) BeginBlock %exit
+    %E i64 = Add %X, %X
+    (%Store3 i64) StoreContext #8, GPR, %E i64, #0x10
+    (%brk i0) Break Halt, #4
+    (%exit_end i0) EndBlock %exit
+)";
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "ValueNumbering - Redundant pure ops") {
+  auto IR = ParseIR(MultiblockIR);
+
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_ADD) == 6);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LSHL) == 3);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_SBFE) == 3);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_CONSTANT) == 6);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateValueNumbering(), IR.get()));
+
+  // A2 and A4 fold in to A1, S2 and S4 in to S1, E2 in to E1 and FourAgain in to Four
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_ADD) == 4);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LSHL) == 1);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_SBFE) == 2);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_CONSTANT) == 5);
+
+  // Loads are never merged, the store in between changes the second one
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_LOADMEM) == 3);
+
+  // Nothing left to do
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateValueNumbering(), IR.get()));
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "ValueNumbering - Only dominating values are reused") {
+  auto IR = ParseIR(SiblingIR);
+
+  // The exit block is reached from both sides, so none of the adds dominate each other
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateValueNumbering(), IR.get()));
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_ADD) == 3);
+}
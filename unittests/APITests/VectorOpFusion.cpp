@@ -0,0 +1,95 @@
+#include "IRPassFixture.h"
+
+#include <string_view>
+
+namespace {
+// pxor, punpcklbw against the zero and the psadbw inner chain
+constexpr std::string_view ExtendIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %A i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %B i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %Zero i128 = VXor #0x10, #0x10, %A i128, %A i128
+    %ExtA i128 = VZip #0x10, #0x1, %A i128, %Zero i128
+    %ExtB i128 = VZip #0x10, #0x1, %B i128, %Zero i128
+    %Diff i128 = VSub #0x10, #0x2, %ExtA i128, %ExtB i128
+    %AbsDiff i128 = VAbs #0x10, #0x2, %Diff i128
+    (%Store i128) StoreContext #0x10, FPR, %AbsDiff i128, #0x90
+    (%brk i0) Break Halt, #4
+    (%entry_end i0) EndBlock %entry
+)";
+
+// pshufd with 0x55, the first insert goes in to a different register
+constexpr std::string_view BroadcastIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %A i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %B i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %Dup0 i128 = VInsElement #0x10, #0x4, #0x0, #0x1, %B i128, %A i128
+    %Dup1 i128 = VInsElement #0x10, #0x4, #0x1, #0x1, %Dup0 i128, %A i128
+    %Dup2 i128 = VInsElement #0x10, #0x4, #0x2, #0x1, %Dup1 i128, %A i128
+    %Dup3 i128 = VInsElement #0x10, #0x4, #0x3, #0x1, %Dup2 i128, %A i128
+    (%Store i128) StoreContext #0x10, FPR, %Dup3 i128, #0x90
+    (%brk i0) Break Halt, #4
+    (%entry_end i0) EndBlock %entry
+)";
+
+// None of these match an idiom, an element of %B survives and the MMX sized ops keep their upper bits
+constexpr std::string_view NoFusionIR = R"(
+(%ssa1) IRHeader %entry, #0
+  (%entry) CodeBlock %entry_begin, %entry_end, %ssa1
+    (%entry_begin i0) BeginBlock %entry
+    %Addr i64 = Constant #0x1000000
+    %A i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %B i128 = LoadMem FPR, #0x10, %Addr i64, %Invalid, #0x10, SXTX, #1
+    %Ins0 i128 = VInsElement #0x10, #0x4, #0x0, #0x1, %B i128, %A i128
+    %Ins1 i128 = VInsElement #0x10, #0x4, #0x1, #0x1, %Ins0 i128, %A i128
+    %Ins2 i128 = VInsElement #0x10, #0x4, #0x2, #0x1, %Ins1 i128, %A i128
+    (%Store1 i128) StoreContext #0x10, FPR, %Ins2 i128, #0x90
+    %And i64 = VAnd #0x8, #0x8, %A i128, %A i128
+    (%Store2 i128) StoreContext #0x10, FPR, %And i128, #0xa0
+    %Zip i64 = VZip #0x8, #0x1, %A i128, %B i128
+    (%Store3 i128) StoreContext #0x10, FPR, %Zip i128, #0xb0
+    (%brk i0) Break Halt, #4
+    (%entry_end i0) EndBlock %entry
+)";
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "VectorOpFusion - Zero extend and absolute difference") {
+  auto IR = ParseIR(ExtendIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateVectorOpFusion(), IR.get()));
+  // Fused ops leave the old chain behind, only count what is still used
+  RunPass(FEXCore::IR::CreatePassDeadCodeElimination(), IR.get());
+
+  // The zips became extends, which the absolute then folded in to
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VUABDL) == 1);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VABS) == 0);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VSUB) == 0);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VZIP) == 0);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VXOR) == 0);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "VectorOpFusion - Broadcast") {
+  auto IR = ParseIR(BroadcastIR);
+
+  REQUIRE(RunPass(FEXCore::IR::CreateVectorOpFusion(), IR.get()));
+  // Fused ops leave the old chain behind, only count what is still used
+  RunPass(FEXCore::IR::CreatePassDeadCodeElimination(), IR.get());
+
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VDUPELEMENT) == 1);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VINSELEMENT) == 0);
+}
+
+TEST_CASE_METHOD(APITests::IRPassFixture, "VectorOpFusion - Partial idioms aren't fused") {
+  auto IR = ParseIR(NoFusionIR);
+
+  CHECK_FALSE(RunPass(FEXCore::IR::CreateVectorOpFusion(), IR.get()));
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VINSELEMENT) == 3);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VAND) == 1);
+  CHECK(CountOps(IR.get(), FEXCore::IR::OP_VZIP) == 1);
+}
@@ -0,0 +1,57 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x28",
+    "RBX": "2",
+    "RCX": "0",
+    "RDX": "4"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+jmp label
+label:
+
+mov rsp, 0xe8000000
+
+; Recurse deeper than the return stack so older entries get overwritten
+xor eax, eax
+mov ecx, 40
+call recurse
+
+; The callee replaces its return address, RET must not use the return stack entry
+xor ebx, ebx
+call redirect
+mov rbx, 1
+redirected:
+add rbx, 2
+
+; Returning to the same call site repeatedly goes through the linked landing pad
+xor edx, edx
+mov ecx, 4
+loop_top:
+call increment
+dec ecx
+jnz loop_top
+
+hlt
+
+recurse:
+inc rax
+dec rcx
+jz .done
+call recurse
+.done:
+ret
+
+redirect:
+lea rsi, [rel redirected]
+mov [rsp], rsi
+ret
+
+increment:
+inc rdx
+ret
@@ -0,0 +1,91 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RBX": "0x800",
+    "RCX": "0x41",
+    "RDX": "0x81",
+    "RSI": "0x880",
+    "RDI": "0x41",
+    "RBP": "0x81",
+    "R8":  "0x1F"
+  }
+}
+%endif
+
+; Checks CF/ZF/SF/OF of add/sub/cmp at every operand size, and branches straight after cmp/test
+mov rsp, 0xe0000010
+
+; 8-bit sub, signed overflow without borrow
+mov al, 0x80
+sub al, 1
+pushfq
+pop rbx
+and rbx, 0x8C1
+
+; 16-bit add, carry out and zero
+mov ax, 0xFFFF
+add ax, 1
+pushfq
+pop rcx
+and rcx, 0x8C1
+
+; 32-bit cmp, borrow and negative
+mov eax, 1
+cmp eax, 2
+pushfq
+pop rdx
+and rdx, 0x8C1
+
+; 64-bit add, signed overflow without carry
+mov rax, 0x7FFFFFFFFFFFFFFF
+add rax, 1
+pushfq
+pop rsi
+and rsi, 0x8C1
+
+; inc doesn't touch CF
+stc
+mov eax, -1
+inc eax
+pushfq
+pop rdi
+and rdi, 0x8C1
+
+; neg sets CF for a non-zero source
+mov eax, 5
+neg eax
+pushfq
+pop rbp
+and rbp, 0x8C1
+
+xor r8d, r8d
+mov r9d, -1
+
+cmp r9d, 1
+jge .skip1
+or r8, 1
+.skip1:
+
+cmp r9d, 1
+jbe .skip2
+or r8, 2
+.skip2:
+
+mov r10b, 0x7F
+add r10b, 1
+jno .skip3
+or r8, 4
+.skip3:
+
+test r9d, r9d
+jz .skip4
+or r8, 8
+.skip4:
+
+mov r11w, 0x8000
+cmp r11w, 1
+jg .skip5
+or r8, 0x10
+.skip5:
+
+hlt
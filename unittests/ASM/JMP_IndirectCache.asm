@@ -0,0 +1,47 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x10",
+    "RBX": "0x20",
+    "RDX": "0x30",
+    "RCX": "0"
+  }
+}
+%endif
+
+; One indirect jump site that cycles through more targets than its inline cache holds
+xor eax, eax
+xor ebx, ebx
+xor edx, edx
+mov ecx, 48
+
+lea r8, [rel target_a]
+lea r9, [rel target_b]
+lea r10, [rel target_c]
+
+loop_top:
+jmp r8
+
+target_a:
+add rax, 1
+jmp next
+
+target_b:
+add rbx, 2
+jmp next
+
+target_c:
+add rdx, 3
+jmp next
+
+next:
+; Rotate the targets
+mov r11, r8
+mov r8, r9
+mov r9, r10
+mov r10, r11
+
+dec ecx
+jnz loop_top
+
+hlt
@@ -0,0 +1,61 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x0",
+    "RBX": "0x0",
+    "RCX": "0x1",
+    "RDX": "0x2A",
+    "RSI": "0x1",
+    "R10": "0x1"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  },
+  "Env": { "FEX_ABILOCALFLAGS" : "1" }
+}
+%endif
+
+; With ABILocalFlags, flags still pending at a direct or indirect call are dropped.
+; Flags the callee computes for itself, and ones the caller computes after the call, have to be intact.
+mov rsp, 0x100000800
+xor ecx, ecx
+xor esi, esi
+
+; Flags pending at the indirect call aren't read by anyone
+lea r8, [rel callee]
+mov rdi, 5
+cmp rdi, 4
+call r8
+mov r10, rax
+
+; Flags after the return are recomputed before use
+cmp rdi, 5
+sete cl
+
+; Same again through a direct call
+mov rdi, 6
+cmp rdi, 6
+call callee2
+test eax, eax
+setz sil
+
+mov rdx, 0x2A
+jmp done
+
+callee:
+xor eax, eax
+xor ebx, ebx
+cmp rdi, 5
+sete al
+cmp rdi, 6
+sete bl
+ret
+
+callee2:
+xor eax, eax
+cmp rdi, 5
+sete al
+ret
+
+done:
+hlt
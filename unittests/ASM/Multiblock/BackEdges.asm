@@ -0,0 +1,48 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0xC8",
+    "RBX": "0x3E8",
+    "RCX": "0",
+    "RDX": "0",
+    "RSI": "0x12C"
+  },
+  "Env": { "FEX_TIERUPTHRESHOLD" : "3" }
+}
+%endif
+
+; Loops whose back edge is an unconditional jump to the start of the block
+xor eax, eax
+mov ecx, 100
+loop1:
+add rax, 2
+dec rcx
+jz done1
+jmp loop1
+done1:
+
+; Back edge to a block with more temporaries, any spill slots have to be released before starting over
+xor ebx, ebx
+mov edx, 10
+loop2:
+mov r8, rbx
+mov r9, rdx
+imul r9, r9
+add r8, r9
+lea r10, [r8 + 1]
+lea r11, [r10 + r9]
+sub r11, r10
+sub r11, r9
+add rbx, 100
+add rbx, r11
+dec rdx
+jnz loop2
+
+; Self loop on a conditional branch
+xor esi, esi
+mov ecx, 100
+loop3:
+add rsi, 3
+loop loop3
+
+hlt
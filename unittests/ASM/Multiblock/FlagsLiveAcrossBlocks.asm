@@ -0,0 +1,69 @@
+%ifdef CONFIG
+{
+  "Match": "All",
+  "RegData": {
+    "RAX": "0x1",
+    "RBX": "0x1",
+    "RCX": "0x1",
+    "RDX": "0x0",
+    "RSI": "0x1"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+mov rsp, 0x100000800
+mov rdi, 0x100000000
+mov qword [rdi], 0
+xor eax, eax
+xor ebx, ebx
+xor ecx, ecx
+xor edx, edx
+xor esi, esi
+xor r9d, r9d
+
+; CF and ZF set here are consumed several blocks later
+mov r8, -1
+add r8, 1
+jmp .first
+
+.first:
+; inc leaves CF alone but overwrites ZF
+inc r9
+jmp .second
+
+.second:
+; memory access between the flag producer and consumer
+mov r10, [rdi]
+setc al
+jc .third
+mov edx, 1
+
+.third:
+; ZF from the inc is zero, CF still comes from the add
+setz dl
+pushf
+pop r11
+and r11, 1
+mov rbx, r11
+
+; Flags set on one path and read after the merge
+cmp rax, 1
+jne .skip
+stc
+.skip:
+setc cl
+
+; Flags live in to a loop
+mov r12, 3
+clc
+.loop:
+adc rsi, 0
+stc
+dec r12
+jnz .loop
+sbb rsi, 0
+
+hlt
@@ -0,0 +1,41 @@
+%ifdef CONFIG
+{
+  "Match": "All",
+  "RegData": {
+    "RAX": "0xF",
+    "RBX": "0x100000000",
+    "RCX": "0x4",
+    "RDX": "0x40",
+    "RSI": "0x100000008"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  },
+  "MemoryData": {
+    "0x100000010": "0x0000000000000001",
+    "0x100000018": "0x0000000000000002",
+    "0x100000020": "0x0000000000000004",
+    "0x100000028": "0x0000000000000008"
+  }
+}
+%endif
+
+; RBX and the displacement are the same on every iteration, RCX and RAX change
+mov rbx, 0x100000000
+xor eax, eax
+xor ecx, ecx
+xor edx, edx
+
+.loop:
+add rax, [rbx + rcx * 8 + 0x10]
+lea rsi, [rbx + 0x8]
+add rdx, rsi
+sub rdx, rbx
+inc rcx
+cmp rcx, 4
+jne .loop
+
+; RDX only changes inside of the loop
+add rdx, rdx
+
+hlt
@@ -0,0 +1,74 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RCX": "0x0",
+    "RBX": "0xE00003F8",
+    "RBP": "0xE00002FC",
+    "R8":  "0x4746454443424140",
+    "R9":  "0xE0000148",
+    "R10": "0xE0000048",
+    "R11": "0x0101010101010101",
+    "R12": "0x1122334411223344",
+    "R13": "0x5152535455565758",
+    "R14": "0x0",
+    "R15": "0xE0000500"
+  }
+}
+%endif
+
+mov rdx, 0xe0000000
+
+; Source pattern where byte k is k
+cld
+mov rdi, rdx
+xor eax, eax
+mov ecx, 72
+fill:
+stosb
+inc eax
+dec ecx
+jnz fill
+
+; Large enough to use full width chunks followed by an element tail
+mov rsi, rdx
+lea rdi, [rdx + 0x100]
+mov ecx, 9
+rep movsq
+mov r8, [rdx + 0x140]
+mov r9, rdi
+mov r10, rsi
+
+; Destination one byte after the source must replicate the first byte
+lea rsi, [rdx + 0x101]
+lea rdi, [rdx + 0x102]
+mov ecx, 40
+rep movsb
+mov r11, [rdx + 0x122]
+
+; Walking downwards with the destination one element below the source replicates the top element
+mov dword [rdx + 0x330], 0x11223344
+std
+lea rsi, [rdx + 0x330]
+lea rdi, [rdx + 0x32C]
+mov ecx, 12
+rep movsd
+mov r12, [rdx + 0x300]
+mov rbp, rdi
+
+; Downwards fill must stop at the last element
+mov rax, 0x5152535455565758
+lea rdi, [rdx + 0x448]
+mov ecx, 10
+rep stosq
+cld
+mov r13, [rdx + 0x400]
+mov r14, [rdx + 0x3F8]
+mov rbx, rdi
+
+; Zero count doesn't touch memory or the pointer
+xor ecx, ecx
+lea rdi, [rdx + 0x500]
+rep stosb
+mov r15, rdi
+
+hlt
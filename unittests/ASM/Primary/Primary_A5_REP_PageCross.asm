@@ -0,0 +1,48 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RCX": "0x0",
+    "R8":  "0xE000101C",
+    "R9":  "0xE000101C",
+    "R10": "0xE0003014",
+    "R11": "0x6162636465666768",
+    "R12": "0x6162636465666768",
+    "R13": "0xE0003FF8",
+    "R14": "0x7576777875767778",
+    "R15": "0x0"
+  }
+}
+%endif
+
+mov rdx, 0xe0000000
+
+; Fill upwards with the second element straddling a page boundary
+cld
+mov rax, 0x6162636465666768
+lea rdi, [rdx + 0xFFC]
+mov ecx, 4
+rep stosq
+mov r8, rdi
+
+; Copy where the source and the destination cross their pages at different elements
+lea rsi, [rdx + 0xFFC]
+lea rdi, [rdx + 0x2FF4]
+mov ecx, 4
+rep movsq
+mov r9, rsi
+mov r10, rdi
+mov r11, [rdx + 0x2FFC]
+mov r12, [rdx + 0x300C]
+
+; Fill downwards across a page boundary
+std
+mov rax, 0x7172737475767778
+lea rdi, [rdx + 0x4008]
+mov ecx, 4
+rep stosd
+cld
+mov r13, rdi
+mov r14, [rdx + 0x3FFC]
+mov r15, [rdx + 0x400C]
+
+hlt
@@ -0,0 +1,37 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x12B",
+    "RBX": "0x1F4",
+    "RCX": "0",
+    "RDX": "0"
+  },
+  "Env": { "FEX_TIERUPTHRESHOLD" : "2" }
+}
+%endif
+
+; Enter a loop in the middle so the recompiled region needs code from before its entry
+xor eax, eax
+mov ecx, 100
+jmp body
+
+top:
+add rax, 1
+body:
+add rax, 2
+dec rcx
+jnz top
+
+; Nested loops where the inner loop tiers up while the outer one is still in its first tier
+xor ebx, ebx
+mov edx, 10
+outer:
+mov ecx, 50
+inner:
+inc rbx
+dec rcx
+jnz inner
+dec rdx
+jnz outer
+
+hlt
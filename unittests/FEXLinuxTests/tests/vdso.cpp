@@ -0,0 +1,217 @@
+#include <elf.h>
+#include <errno.h>
+#include <link.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/auxv.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+// Finds the vDSO through AT_SYSINFO_EHDR and compares its time functions with the syscalls.
+// Built for both 32-bit and 64-bit guests, exits with the number of failed checks.
+
+namespace {
+int Failures{};
+
+constexpr clockid_t Clocks[] = {CLOCK_MONOTONIC, CLOCK_REALTIME, CLOCK_BOOTTIME};
+
+void Check(bool Condition, const char *Message) {
+  if (!Condition) {
+    fprintf(stderr, "FAIL: %s\n", Message);
+    ++Failures;
+  }
+}
+
+// Same layout as the kernel's __kernel_timespec on both
+struct KernelTimespec64 {
+  int64_t tv_sec;
+  int64_t tv_nsec;
+};
+
+template<typename T>
+int64_t Nanoseconds(T const &Time) {
+  return static_cast<int64_t>(Time.tv_sec) * 1'000'000'000LL + Time.tv_nsec;
+}
+
+class VDSO {
+public:
+  VDSO() {
+    const uintptr_t Base = getauxval(AT_SYSINFO_EHDR);
+    if (!Base) {
+      return;
+    }
+
+    auto Header = reinterpret_cast<const ElfW(Ehdr)*>(Base);
+    auto ProgramHeaders = reinterpret_cast<const ElfW(Phdr)*>(Base + Header->e_phoff);
+
+    // Addresses in the image are relative to its first load segment
+    const ElfW(Dyn) *Dynamic{};
+    bool FoundLoad{};
+    for (size_t i = 0; i < Header->e_phnum; ++i) {
+      if (ProgramHeaders[i].p_type == PT_LOAD && !FoundLoad) {
+        Bias = Base - ProgramHeaders[i].p_vaddr;
+        FoundLoad = true;
+      }
+      else if (ProgramHeaders[i].p_type == PT_DYNAMIC) {
+        Dynamic = reinterpret_cast<const ElfW(Dyn)*>(Base + ProgramHeaders[i].p_offset);
+      }
+    }
+
+    if (!FoundLoad || !Dynamic) {
+      return;
+    }
+
+    for (; Dynamic->d_tag != DT_NULL; ++Dynamic) {
+      switch (Dynamic->d_tag) {
+        case DT_HASH:
+          // nchain is the number of symbols
+          NumSymbols = reinterpret_cast<const uint32_t*>(Bias + Dynamic->d_un.d_ptr)[1];
+          break;
+        case DT_SYMTAB:
+          Symbols = reinterpret_cast<const ElfW(Sym)*>(Bias + Dynamic->d_un.d_ptr);
+          break;
+        case DT_STRTAB:
+          Strings = reinterpret_cast<const char*>(Bias + Dynamic->d_un.d_ptr);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  bool Valid() const {
+    return NumSymbols && Symbols && Strings;
+  }
+
+  template<typename T>
+  T Lookup(const char *Name) const {
+    for (uint32_t i = 0; i < NumSymbols; ++i) {
+      const auto &Symbol = Symbols[i];
+      // ST_TYPE is the same for both ELF classes
+      if (ELF64_ST_TYPE(Symbol.st_info) == STT_FUNC &&
+          Symbol.st_shndx != SHN_UNDEF &&
+          strcmp(Strings + Symbol.st_name, Name) == 0) {
+        return reinterpret_cast<T>(Bias + Symbol.st_value);
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  uintptr_t Bias{};
+  uint32_t NumSymbols{};
+  const ElfW(Sym) *Symbols{};
+  const char *Strings{};
+};
+
+// vDSO functions return the negated errno directly, like the syscalls
+using ClockGettimeType = int (*)(clockid_t, struct timespec*);
+using ClockGettime64Type = int (*)(clockid_t, KernelTimespec64*);
+using GetTimeOfDayType = int (*)(struct timeval*, struct timezone*);
+using TimeType = time_t (*)(time_t*);
+
+// The vDSO result has to land between two syscall results
+template<typename T, typename Fn, typename SyscallFn>
+void CheckOrdered(const char *Message, Fn VDSOFn, SyscallFn Syscall) {
+  T Before{}, Result{}, After{};
+  Check(Syscall(&Before) == 0, Message);
+  Check(VDSOFn(&Result) == 0, Message);
+  Check(Syscall(&After) == 0, Message);
+  Check(Nanoseconds(Before) <= Nanoseconds(Result) && Nanoseconds(Result) <= Nanoseconds(After), Message);
+}
+
+void CheckClockGettime(VDSO const &Image) {
+  auto ClockGettime = Image.Lookup<ClockGettimeType>("__vdso_clock_gettime");
+  Check(ClockGettime != nullptr, "__vdso_clock_gettime is exported");
+  if (!ClockGettime) {
+    return;
+  }
+
+  for (clockid_t Clock : Clocks) {
+    CheckOrdered<struct timespec>("__vdso_clock_gettime matches the syscall",
+      [&](struct timespec *tp) { return ClockGettime(Clock, tp); },
+      [&](struct timespec *tp) { return ::syscall(SYS_clock_gettime, Clock, tp); });
+  }
+
+  struct timespec tp{};
+  Check(ClockGettime(-1, &tp) == -EINVAL, "__vdso_clock_gettime rejects invalid clocks");
+}
+
+// Only 32-bit has a separate 64-bit time variant
+void CheckClockGettime64([[maybe_unused]] VDSO const &Image) {
+#if defined(__i386__)
+  auto ClockGettime64 = Image.Lookup<ClockGettime64Type>("__vdso_clock_gettime64");
+  Check(ClockGettime64 != nullptr, "__vdso_clock_gettime64 is exported");
+  if (!ClockGettime64) {
+    return;
+  }
+
+  for (clockid_t Clock : Clocks) {
+    CheckOrdered<KernelTimespec64>("__vdso_clock_gettime64 matches the syscall",
+      [&](KernelTimespec64 *tp) { return ClockGettime64(Clock, tp); },
+      [&](KernelTimespec64 *tp) { return ::syscall(SYS_clock_gettime64, Clock, tp); });
+  }
+
+  KernelTimespec64 tp{};
+  Check(ClockGettime64(-1, &tp) == -EINVAL, "__vdso_clock_gettime64 rejects invalid clocks");
+#endif
+}
+
+void CheckGetTimeOfDay(VDSO const &Image) {
+  auto GetTimeOfDay = Image.Lookup<GetTimeOfDayType>("__vdso_gettimeofday");
+  Check(GetTimeOfDay != nullptr, "__vdso_gettimeofday is exported");
+  if (!GetTimeOfDay) {
+    return;
+  }
+
+  struct timeval Before{}, Result{}, After{};
+  Check(::syscall(SYS_gettimeofday, &Before, nullptr) == 0, "gettimeofday syscall");
+  Check(GetTimeOfDay(&Result, nullptr) == 0, "__vdso_gettimeofday succeeds");
+  Check(::syscall(SYS_gettimeofday, &After, nullptr) == 0, "gettimeofday syscall");
+
+  auto Microseconds = [](struct timeval const &Time) {
+    return static_cast<int64_t>(Time.tv_sec) * 1'000'000LL + Time.tv_usec;
+  };
+  Check(Microseconds(Before) <= Microseconds(Result) && Microseconds(Result) <= Microseconds(After),
+    "__vdso_gettimeofday matches the syscall");
+
+  struct timezone TZ{}, SyscallTZ{};
+  Check(GetTimeOfDay(nullptr, &TZ) == 0, "__vdso_gettimeofday with only a timezone");
+  Check(::syscall(SYS_gettimeofday, nullptr, &SyscallTZ) == 0, "gettimeofday syscall");
+  Check(TZ.tz_minuteswest == SyscallTZ.tz_minuteswest && TZ.tz_dsttime == SyscallTZ.tz_dsttime,
+    "__vdso_gettimeofday timezone matches the syscall");
+}
+
+void CheckTime(VDSO const &Image) {
+  auto Time = Image.Lookup<TimeType>("__vdso_time");
+  Check(Time != nullptr, "__vdso_time is exported");
+  if (!Time) {
+    return;
+  }
+
+  const time_t Before = ::syscall(SYS_time, nullptr);
+  time_t Stored{};
+  const time_t Result = Time(&Stored);
+  const time_t After = ::syscall(SYS_time, nullptr);
+  Check(Before <= Result && Result <= After, "__vdso_time matches the syscall");
+  Check(Stored == Result, "__vdso_time stores its result");
+}
+}
+
+int main() {
+  VDSO Image;
+  Check(Image.Valid(), "AT_SYSINFO_EHDR points at a vDSO with a symbol table");
+  if (!Image.Valid()) {
+    return Failures;
+  }
+
+  CheckClockGettime(Image);
+  CheckClockGettime64(Image);
+  CheckGetTimeOfDay(Image);
+  CheckTime(Image);
+
+  return Failures;
+}
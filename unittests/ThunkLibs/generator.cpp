@@ -225,6 +225,7 @@ static void run_tool(clang::tooling::ToolAction& action, std::string_view code,
     const char* common_header_code = R"(namespace fexgen {
 struct returns_guest_pointer {};
 struct custom_host_impl {};
+struct forwards_errno {};
 struct callback_annotation_base { bool prevent_multiple; };
 struct callback_stub : callback_annotation_base {};
 struct callback_guest : callback_annotation_base {};
@@ -529,6 +530,42 @@ TEST_CASE_METHOD(Fixture, "VariadicFunction") {
         )));
 }
 
+// The host errno is carried back in the packed arguments and only set in the guest on failure
+TEST_CASE_METHOD(Fixture, "ForwardsErrno") {
+    const std::string prelude =
+        "int* __errno_location();\n"
+        "#define errno (*__errno_location())\n";
+    const auto output = run_thunkgen(prelude,
+        "#include <thunks_common.h>\n"
+        "double func(double);\n"
+        "template<auto> struct fex_gen_config {};\n"
+        "template<> struct fex_gen_config<func> : fexgen::forwards_errno {};\n");
+
+    CHECK_THAT(output.guest,
+        matches(functionDecl(
+            hasName("fexfn_pack_func"),
+            hasDescendant(ifStmt(
+                hasCondition(hasDescendant(memberExpr(member(hasName("host_errno"))))),
+                hasThen(hasDescendant(callExpr(callee(functionDecl(hasName("__errno_location"))))))
+            ))
+        )));
+
+    CHECK_THAT(output.host,
+        matches(functionDecl(
+            hasName("fexfn_unpack_libtest_func"),
+            hasParameter(0, hasType(pointerType(pointee(
+                recordType(hasDeclaration(decl(
+                    has(fieldDecl(hasName("rv"), hasType(asString("double")))),
+                    has(fieldDecl(hasName("host_errno"), hasType(asString("int"))))
+                    ))))))),
+            hasDescendant(binaryOperator(
+                hasOperatorName("="),
+                hasLHS(memberExpr(member(hasName("host_errno")))),
+                hasRHS(hasDescendant(callExpr(callee(functionDecl(hasName("__errno_location"))))))
+            ))
+        )));
+}
+
 // Variadic functions without annotation trigger an error
 TEST_CASE_METHOD(Fixture, "VariadicFunctionsWithoutAnnotation") {
     REQUIRE_THROWS(run_thunkgen_guest("void func(int arg, ...);\n",
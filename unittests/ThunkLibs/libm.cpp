@@ -0,0 +1,408 @@
+#include <catch2/catch.hpp>
+
+#include <openssl/sha.h>
+
+#include "Types.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Calls the host side of the libm thunk the same way FEX does: look up the
+// function by the SHA256 of "libm:name" and hand it a packed argument struct.
+// Results must match the host libm bit for bit, guest code relies on that.
+// GuestReference additionally compares against what the guest's own x86-64
+// libm returns, errno included. Results are only compared bit for bit where
+// they are exactly specified, otherwise within glibc's known error bounds.
+
+struct ExportEntry { uint8_t* sha256; void(*fn)(void *); };
+extern "C" ExportEntry* fexthunks_exports_libm(void *a0, uintptr_t a1);
+
+namespace {
+using ThunkFn = void(*)(void*);
+
+ThunkFn FindThunk(const std::string& name) {
+    static ExportEntry* exports = fexthunks_exports_libm(nullptr, 0);
+    REQUIRE(exports != nullptr);
+
+    const std::string id = "libm:" + name;
+    uint8_t sha256[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(id.data()), id.size(), sha256);
+
+    for (auto* entry = exports; entry->sha256; ++entry) {
+        if (memcmp(entry->sha256, sha256, sizeof(sha256)) == 0) {
+            return entry->fn;
+        }
+    }
+    FAIL("No thunk for " << name);
+    return nullptr;
+}
+
+// Same layout as the structs emitted by the thunk generator.
+// host_errno is only written by functions annotated with fexgen::forwards_errno.
+template<typename Result, typename Arg>
+struct PackedArgs1 { Arg a_0; Result rv; int host_errno; };
+
+template<typename Result, typename Arg0, typename Arg1>
+struct PackedArgs2 { Arg0 a_0; Arg1 a_1; Result rv; int host_errno; };
+
+template<typename Result, typename Arg>
+PackedArgs1<Result, Arg> CallThunkPacked(const std::string& name, Arg a) {
+    PackedArgs1<Result, Arg> args { a, {}, -1 };
+    FindThunk(name)(&args);
+    return args;
+}
+
+template<typename Result, typename Arg0, typename Arg1>
+PackedArgs2<Result, Arg0, Arg1> CallThunkPacked(const std::string& name, Arg0 a, Arg1 b) {
+    PackedArgs2<Result, Arg0, Arg1> args { a, b, {}, -1 };
+    FindThunk(name)(&args);
+    return args;
+}
+
+template<typename Result, typename... Args>
+Result CallThunk(const std::string& name, Args... args) {
+    return CallThunkPacked<Result>(name, args...).rv;
+}
+
+template<typename T>
+bool SameBits(T a, T b) {
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<typename T>
+const T SpecialValues[] = {
+    T(0), -T(0), T(1), -T(1), T(0.5), T(-0.5), T(2), T(3.75), T(-7.25), T(10), T(100), T(1e6), T(-1e6),
+    std::numeric_limits<T>::min(), std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::max(),
+    -std::numeric_limits<T>::max(), std::numeric_limits<T>::epsilon(),
+    std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+    std::numeric_limits<T>::quiet_NaN(), T(M_PI), T(M_PI_2), T(M_PI_4), T(M_E),
+};
+
+// Functions that IEEE 754 requires to be exact or correctly rounded, every libm agrees on these bit for bit
+bool IsCorrectlyRounded(const std::string& name) {
+    static const std::unordered_set<std::string> Names {
+        "fdim", "fmod", "fmodf", "logb", "nextafter", "remainder", "remainderf", "sqrt", "sqrtf",
+    };
+    return Names.contains(name);
+}
+
+// Known maximum errors of glibc on x86-64 from the glibc manual, in ulps. The float variants use the f suffix.
+unsigned KnownMaxUlps(const std::string& name) {
+    static const std::unordered_map<std::string, unsigned> Ulps {
+        {"acos", 1}, {"acosf", 1}, {"acosh", 2}, {"acoshf", 2}, {"asin", 1}, {"asinf", 1}, {"asinh", 2},
+        {"atan", 1}, {"atanf", 1}, {"atan2", 1}, {"atan2f", 1}, {"atanh", 2}, {"atanhf", 2}, {"cbrt", 4}, {"cbrtf", 1},
+        {"cos", 1}, {"cosf", 1}, {"cosh", 2}, {"coshf", 2}, {"erf", 1}, {"erfc", 5}, {"exp", 1}, {"expf", 1},
+        {"exp10", 2}, {"exp2", 1}, {"exp2f", 1}, {"expm1", 1}, {"expm1f", 1}, {"hypot", 1}, {"hypotf", 1},
+        {"j0", 2}, {"j1", 2}, {"log", 1}, {"logf", 1}, {"log10", 2}, {"log10f", 2}, {"log1p", 1}, {"log1pf", 1},
+        {"log2", 1}, {"log2f", 1}, {"pow", 1}, {"powf", 1}, {"sin", 1}, {"sinf", 1}, {"sinh", 2}, {"sinhf", 2},
+        {"tan", 1}, {"tanf", 1}, {"tanh", 2}, {"tanhf", 2}, {"tgamma", 9}, {"tgammaf", 8}, {"y0", 3}, {"y1", 3},
+    };
+    const auto it = Ulps.find(name);
+    REQUIRE(it != Ulps.end());
+    return it->second;
+}
+
+// Distance in representable values, both have to be finite
+template<typename T>
+uint64_t UlpDistance(T a, T b) {
+    using Bits = std::conditional_t<sizeof(T) == sizeof(uint64_t), int64_t, int32_t>;
+    // Maps the sign-magnitude encoding to a monotonic integer
+    auto Ordered = [](T value) -> int64_t {
+        Bits bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits < 0 ? std::numeric_limits<Bits>::min() - bits : bits;
+    };
+    const int64_t ia = Ordered(a);
+    const int64_t ib = Ordered(b);
+    return ia > ib ? ia - ib : ib - ia;
+}
+
+// Rows whose result IEEE 754 or C Annex F pins down exactly: infinities, NaNs and zeros in or out
+template<typename T>
+bool IsSpecialRow(const std::vector<T>& inputs, T expected) {
+    if (!std::isfinite(expected) || expected == 0) {
+        return true;
+    }
+    for (T input : inputs) {
+        if (!std::isfinite(input)) {
+            return true;
+        }
+    }
+    return false;
+}
+template<typename T>
+T FromHex(const std::string& hex) {
+    using Bits = std::conditional_t<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>;
+    const Bits bits = std::stoull(hex, nullptr, 16);
+    T value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// fields are the inputs, the result and errno of one line of the reference
+template<typename T>
+void CheckReference(const std::string& name, const std::vector<std::string>& fields) {
+    const size_t arity = fields.size() - 2;
+    const T expected = FromHex<T>(fields[arity]);
+    const int expected_errno = std::stoi(fields[arity + 1]);
+
+    std::vector<T> inputs;
+    for (size_t i = 0; i < arity; ++i) {
+        inputs.push_back(FromHex<T>(fields[i]));
+    }
+
+    T result;
+    int host_errno;
+    if (arity == 1) {
+        auto args = CallThunkPacked<T>(name, inputs[0]);
+        result = args.rv;
+        host_errno = args.host_errno;
+    } else {
+        REQUIRE(arity == 2);
+        auto args = CallThunkPacked<T>(name, inputs[0], inputs[1]);
+        result = args.rv;
+        host_errno = args.host_errno;
+    }
+
+    CHECK(host_errno == expected_errno);
+    if (std::isnan(expected)) {
+        // x86 and AArch64 disagree on the sign of the default NaN
+        CHECK(std::isnan(result));
+    } else if (IsCorrectlyRounded(name) || IsSpecialRow(inputs, expected)) {
+        CHECK(SameBits(result, expected));
+    } else {
+        // Both the host libm and the x86-64 reference can be off by the known maximum error, in opposite directions
+        CHECK((std::isfinite(result) && UlpDistance(result, expected) <= 2 * KnownMaxUlps(name)));
+    }
+}
+
+// ULP distance from the more precise long double result, in units of the result type
+template<typename T>
+long double UlpError(T result, long double reference) {
+    if (std::isnan(reference)) {
+        return std::isnan(result) ? 0 : std::numeric_limits<long double>::infinity();
+    }
+    if (std::isinf(reference) || std::isinf(result)) {
+        return static_cast<long double>(result) == reference ? 0 : std::numeric_limits<long double>::infinity();
+    }
+    const T rounded = static_cast<T>(reference);
+    const T ulp = std::nextafter(std::fabs(rounded), std::numeric_limits<T>::infinity()) - std::fabs(rounded);
+    return std::fabs(static_cast<long double>(result) - reference) / ulp;
+}
+}
+
+#define CHECK_UNARY(type, name) \
+    SECTION(#name) { \
+        for (type x : SpecialValues<type>) { \
+            INFO(#name "(" << x << ")"); \
+            CHECK(SameBits(CallThunk<type>(#name, x), static_cast<type(*)(type)>(::name)(x))); \
+        } \
+    }
+
+#define CHECK_BINARY(type, name) \
+    SECTION(#name) { \
+        for (type x : SpecialValues<type>) { \
+            for (type y : SpecialValues<type>) { \
+                INFO(#name "(" << x << ", " << y << ")"); \
+                CHECK(SameBits(CallThunk<type>(#name, x, y), static_cast<type(*)(type, type)>(::name)(x, y))); \
+            } \
+        } \
+    }
+
+TEST_CASE("Double") {
+    CHECK_UNARY(double, acos) CHECK_UNARY(double, acosh) CHECK_UNARY(double, asin) CHECK_UNARY(double, asinh)
+    CHECK_UNARY(double, atan) CHECK_UNARY(double, atanh) CHECK_UNARY(double, cbrt) CHECK_UNARY(double, cos)
+    CHECK_UNARY(double, cosh) CHECK_UNARY(double, erf) CHECK_UNARY(double, erfc) CHECK_UNARY(double, exp)
+    CHECK_UNARY(double, exp2) CHECK_UNARY(double, expm1) CHECK_UNARY(double, log) CHECK_UNARY(double, log10)
+    CHECK_UNARY(double, log1p) CHECK_UNARY(double, log2) CHECK_UNARY(double, sin) CHECK_UNARY(double, sinh)
+    CHECK_UNARY(double, sqrt) CHECK_UNARY(double, tan) CHECK_UNARY(double, tanh) CHECK_UNARY(double, tgamma)
+
+    CHECK_BINARY(double, atan2) CHECK_BINARY(double, fmod) CHECK_BINARY(double, hypot)
+    CHECK_BINARY(double, pow) CHECK_BINARY(double, remainder)
+}
+
+TEST_CASE("Float") {
+    CHECK_UNARY(float, acosf) CHECK_UNARY(float, asinf) CHECK_UNARY(float, atanf) CHECK_UNARY(float, cbrtf)
+    CHECK_UNARY(float, cosf) CHECK_UNARY(float, expf) CHECK_UNARY(float, exp2f) CHECK_UNARY(float, logf)
+    CHECK_UNARY(float, log2f) CHECK_UNARY(float, sinf) CHECK_UNARY(float, sqrtf) CHECK_UNARY(float, tanf)
+    CHECK_UNARY(float, tanhf)
+
+    CHECK_BINARY(float, atan2f) CHECK_BINARY(float, fmodf) CHECK_BINARY(float, hypotf) CHECK_BINARY(float, powf)
+}
+
+TEST_CASE("PointerArguments") {
+    for (double x : SpecialValues<double>) {
+        INFO("x = " << x);
+
+        double s, c;
+        struct { double a_0; double* a_1; double* a_2; int host_errno; } sincos_args { x, &s, &c, -1 };
+        FindThunk("sincos")(&sincos_args);
+        CHECK(SameBits(s, sin(x)));
+        CHECK(SameBits(c, cos(x)));
+
+        int exponent, ref_exponent;
+        CHECK(SameBits(CallThunk<double>("frexp", x, &exponent), frexp(x, &ref_exponent)));
+        CHECK(exponent == ref_exponent);
+
+        double integral, ref_integral;
+        CHECK(SameBits(CallThunk<double>("modf", x, &integral), modf(x, &ref_integral)));
+        CHECK(SameBits(integral, ref_integral));
+
+        int sign, ref_sign;
+        CHECK(SameBits(CallThunk<double>("lgamma_r", x, &sign), lgamma_r(x, &ref_sign)));
+        if (!std::isnan(x)) {
+            CHECK(sign == ref_sign);
+        }
+    }
+}
+
+TEST_CASE("Complex") {
+    for (double re : SpecialValues<double>) {
+        for (double im : { 0.0, -0.0, 0.5, -2.0, 1e6, std::numeric_limits<double>::infinity() }) {
+            _Complex double z;
+            __real__ z = re;
+            __imag__ z = im;
+            INFO("z = " << re << " + " << im << "i");
+
+            CHECK(SameBits(CallThunk<_Complex double>("cexp", z), cexp(z)));
+            CHECK(SameBits(CallThunk<_Complex double>("clog", z), clog(z)));
+            CHECK(SameBits(CallThunk<_Complex double>("csqrt", z), csqrt(z)));
+            CHECK(SameBits(CallThunk<_Complex double>("cpow", z, z), cpow(z, z)));
+            CHECK(SameBits(CallThunk<double>("cabs", z), cabs(z)));
+            CHECK(SameBits(CallThunk<float>("cabsf", static_cast<_Complex float>(z)), cabsf(static_cast<_Complex float>(z))));
+        }
+    }
+}
+
+TEST_CASE("Errno") {
+    // Failures report the host errno, which the guest side stores in its own errno
+    CHECK(CallThunkPacked<double>("log", -1.0).host_errno == EDOM);
+    CHECK(CallThunkPacked<double>("log", 0.0).host_errno == ERANGE);
+    CHECK(CallThunkPacked<double>("sqrt", -1.0).host_errno == EDOM);
+    CHECK(CallThunkPacked<double>("acos", 2.0).host_errno == EDOM);
+    CHECK(CallThunkPacked<double>("exp", 1000.0).host_errno == ERANGE);
+    CHECK(CallThunkPacked<double>("pow", 0.0, -1.0).host_errno == ERANGE);
+    CHECK(CallThunkPacked<float>("expf", 1000.0f).host_errno == ERANGE);
+    CHECK(CallThunkPacked<double>("ldexp", 1.0, 5000).host_errno == ERANGE);
+
+    // Successful calls report zero no matter what errno was before, so the guest's errno stays untouched
+    errno = ERANGE;
+    CHECK(CallThunkPacked<double>("log", 2.0).host_errno == 0);
+    errno = EDOM;
+    CHECK(CallThunkPacked<float>("sinf", 1.0f).host_errno == 0);
+}
+
+TEST_CASE("GuestReference") {
+    // Output of the Conformance guest program on x86-64, this is what the guest gets without the thunk
+    std::ifstream reference(LIBM_REFERENCE);
+    REQUIRE(reference.is_open());
+
+    size_t count = 0;
+    std::string line;
+    while (std::getline(reference, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream stream(line);
+        std::string name, type, field;
+        stream >> name >> type;
+        std::vector<std::string> fields;
+        while (stream >> field) {
+            fields.push_back(field);
+        }
+        // Raised exceptions aren't compared, FEX doesn't report them to the guest with or without the thunk
+        REQUIRE(fields.size() >= 4);
+        fields.pop_back();
+
+        INFO(line);
+        if (type == "d") {
+            CheckReference<double>(name, fields);
+        } else {
+            CheckReference<float>(name, fields);
+        }
+        ++count;
+    }
+    CHECK(count > 1000);
+}
+
+TEST_CASE("VectorLanes") {
+    // Every lane must produce exactly what the scalar function does
+    for (size_t i = 0; i + 3 < std::size(SpecialValues<double>); ++i) {
+        const double a = SpecialValues<double>[i], b = SpecialValues<double>[i + 1];
+        INFO("lanes " << a << ", " << b);
+        const fex_v2f64 v = { a, b };
+        const fex_v2f64 w = { SpecialValues<double>[i + 2], SpecialValues<double>[i + 3] };
+
+        auto sin_result = CallThunk<fex_v2f64>("_ZGVbN2v_sin", v);
+        CHECK(SameBits(sin_result[0], sin(a)));
+        CHECK(SameBits(sin_result[1], sin(b)));
+
+        auto log_result = CallThunk<fex_v2f64>("_ZGVbN2v_log", v);
+        CHECK(SameBits(log_result[0], log(a)));
+        CHECK(SameBits(log_result[1], log(b)));
+
+        auto pow_result = CallThunk<fex_v2f64>("_ZGVbN2vv_pow", v, w);
+        CHECK(SameBits(pow_result[0], pow(a, w[0])));
+        CHECK(SameBits(pow_result[1], pow(b, w[1])));
+
+        double s[2], c[2];
+        struct { fex_v2f64 a_0; fex_v2u64 a_1; fex_v2u64 a_2; } sincos_args {
+            v,
+            { reinterpret_cast<uint64_t>(&s[0]), reinterpret_cast<uint64_t>(&s[1]) },
+            { reinterpret_cast<uint64_t>(&c[0]), reinterpret_cast<uint64_t>(&c[1]) },
+        };
+        FindThunk("_ZGVbN2vvv_sincos")(&sincos_args);
+        CHECK(SameBits(s[0], sin(a)));
+        CHECK(SameBits(s[1], sin(b)));
+        CHECK(SameBits(c[0], cos(a)));
+        CHECK(SameBits(c[1], cos(b)));
+    }
+
+    for (size_t i = 0; i + 3 < std::size(SpecialValues<float>); ++i) {
+        const float* x = &SpecialValues<float>[i];
+        const fex_v4f32 v = { x[0], x[1], x[2], x[3] };
+
+        auto exp_result = CallThunk<fex_v4f32>("_ZGVbN4v_expf", v);
+        auto cos_result = CallThunk<fex_v4f32>("_ZGVbN4v_cosf", v);
+        for (int lane = 0; lane < 4; ++lane) {
+            INFO("lane " << lane << " = " << x[lane]);
+            CHECK(SameBits(exp_result[lane], expf(x[lane])));
+            CHECK(SameBits(cos_result[lane], cosf(x[lane])));
+        }
+    }
+}
+
+TEST_CASE("HostAccuracy") {
+    // The guest gets whatever the host libm computes, make sure that's within the bounds glibc documents for x86
+    constexpr int STEPS = 10000;
+    for (int i = 0; i < STEPS; ++i) {
+        const double x = -50.0 + i * (100.0 / STEPS) + 1.0 / 3.0;
+        const double positive = std::fabs(x) + 1e-3;
+        INFO("x = " << x);
+
+        CHECK(UlpError(CallThunk<double>("sin", x), sinl(x)) <= 1);
+        CHECK(UlpError(CallThunk<double>("cos", x), cosl(x)) <= 1);
+        CHECK(UlpError(CallThunk<double>("tan", x), tanl(x)) <= 2);
+        CHECK(UlpError(CallThunk<double>("atan", x), atanl(x)) <= 1);
+        CHECK(UlpError(CallThunk<double>("exp", x), expl(x)) <= 1);
+        CHECK(UlpError(CallThunk<double>("log", positive), logl(positive)) <= 1);
+        CHECK(UlpError(CallThunk<double>("pow", positive, 1.0 / 3.0), powl(positive, 1.0 / 3.0)) <= 1);
+
+        const float f = static_cast<float>(x);
+        CHECK(UlpError(CallThunk<float>("sinf", f), sinl(f)) <= 1);
+        CHECK(UlpError(CallThunk<float>("expf", f), expl(f)) <= 1);
+        CHECK(UlpError(CallThunk<float>("logf", static_cast<float>(positive)), logl(static_cast<float>(positive))) <= 1);
+    }
+}